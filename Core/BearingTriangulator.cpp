@@ -0,0 +1,282 @@
+/**
+ * @file BearingTriangulator.cpp
+ * @brief 纯方位交叉定位实现文件
+ * @details 实现了方位射线的空间索引、射线对交会和伪观测生成
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "BearingTriangulator.h"
+#include "SensorRegistry.h"
+#include "LogManager.h"
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[BearingTriangulator::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[BearingTriangulator::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[BearingTriangulator::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[BearingTriangulator::" << __FUNCTION__ << "] " << msg
+
+
+BearingTriangulator::BearingTriangulator()
+    : m_enabled(true),
+      m_timeWindow(0.5),
+      m_maxRange(20000.0),
+      m_cellSize(500.0),
+      m_maxMissDistance(50.0),
+      m_minIntersectionAngle(0.0),
+      m_pseudoObserverId(-1)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_enabled = settings.value("Triangulation/enabled", true).toBool();
+    m_timeWindow = settings.value("Triangulation/timeWindow", 0.5).toDouble();
+    m_maxRange = settings.value("Triangulation/maxRange", 20000.0).toDouble();
+    m_cellSize = settings.value("Triangulation/cellSize", 500.0).toDouble();
+    m_maxMissDistance = settings.value("Triangulation/maxMissDistance", 50.0).toDouble();
+    m_minIntersectionAngle = settings.value("Triangulation/minIntersectionAngleDeg", 5.0).toDouble() * EIGEN_PI / 180.0;
+    m_pseudoObserverId = settings.value("Triangulation/pseudoObserverId", -1).toInt();
+
+    LOG_INFO("交叉定位" + QString(m_enabled ? "已启用" : "已禁用") +
+             "，时间窗: " + QString::number(m_timeWindow) + "秒，网格: " +
+             QString::number(m_cellSize) + "米，最大作用距离: " + QString::number(m_maxRange) + "米");
+}
+
+
+int BearingTriangulator::process(std::vector<Measurement>& measurements)
+{
+    if (!m_enabled) {
+        return 0;
+    }
+
+    const SensorRegistry& registry = SensorRegistry::instance();
+
+    // 1. 取出纯方位观测，转换为射线加入时间窗
+    double latestTimestamp = -std::numeric_limits<double>::max();
+    int newRays = 0;
+    for (auto& ray : m_rays) {
+        ray.isNew = false;
+    }
+    auto bearingEnd = std::stable_partition(measurements.begin(), measurements.end(),
+                                            [&registry](const Measurement& m) {
+        return !(m.raw.size() == 2 && registry.sensor(m.observerId).type == SensorConfig::Type::Bearing);
+    });
+    for (auto it = bearingEnd; it != measurements.end(); ++it) {
+        const SensorConfig& config = registry.sensor(it->observerId);
+        Ray ray;
+        ray.origin = config.sensorPosition;
+        ray.direction = SensorRegistry::bearingDirection(config, it->raw(0), it->raw(1));
+        ray.angularStd = std::max(config.sphericalNoiseStd(1), config.sphericalNoiseStd(2));
+        ray.timestamp = it->timestamp;
+        ray.observerId = it->observerId;
+        ray.used = false;
+        ray.isNew = true;
+        m_rays.push_back(ray);
+        latestTimestamp = std::max(latestTimestamp, it->timestamp);
+        newRays++;
+    }
+    measurements.erase(bearingEnd, measurements.end());
+
+    if (newRays == 0) {
+        return 0;
+    }
+
+    // 2. 淘汰超出时间窗或已使用的射线
+    m_rays.erase(std::remove_if(m_rays.begin(), m_rays.end(),
+                                [this, latestTimestamp](const Ray& ray) {
+        return ray.used || ray.timestamp < latestTimestamp - m_timeWindow;
+    }), m_rays.end());
+
+    // 3. 重建射线空间索引
+    m_grid.clear();
+    for (int i = 0; i < static_cast<int>(m_rays.size()); ++i) {
+        insertRay(i);
+    }
+
+    // 4. 只为新射线查询经过的网格及其相邻网格中的其他射线，候选对才求交
+    std::vector<Intersection> candidates;
+    m_visitStamp.assign(m_rays.size(), -1);
+    for (int i = 0; i < static_cast<int>(m_rays.size()); ++i) {
+        if (!m_rays[i].isNew) continue;
+
+        traverseCells(m_rays[i], [&](const Eigen::Vector3i& cell) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dz = -1; dz <= 1; ++dz) {
+                        auto bucket = m_grid.find(cellKey(cell + Eigen::Vector3i(dx, dy, dz)));
+                        if (bucket == m_grid.end()) continue;
+
+                        for (int j : bucket->second) {
+                            // 同一对新射线只从索引较大的一侧评估一次
+                            if (m_visitStamp[j] == i || (m_rays[j].isNew && j >= i)) continue;
+                            m_visitStamp[j] = i;
+                            if (m_rays[j].observerId == m_rays[i].observerId) continue;
+
+                            Intersection candidate;
+                            if (evaluatePair(i, j, candidate)) {
+                                candidates.push_back(candidate);
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    // 5. 按最近距离从小到大贪心选取，每条射线最多参与一个交会点
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Intersection& a, const Intersection& b) {
+        return a.missDistance < b.missDistance;
+    });
+
+    int created = 0;
+    for (const auto& candidate : candidates) {
+        Ray& first = m_rays[candidate.first];
+        Ray& second = m_rays[candidate.second];
+        if (first.used || second.used) continue;
+
+        measurements.push_back(makePseudoMeasurement(candidate));
+        first.used = true;
+        second.used = true;
+        created++;
+    }
+
+    LOG_DEBUG("新增射线 " + QString::number(newRays) + " 条，时间窗内射线 " +
+              QString::number(m_rays.size()) + " 条，候选交会 " + QString::number(candidates.size()) +
+              " 个，生成伪观测 " + QString::number(created) + " 条");
+    return created;
+}
+
+
+long long BearingTriangulator::cellKey(const Eigen::Vector3i& cell)
+{
+    // 每个坐标占21位，覆盖 ±2^20 个网格
+    const long long mask = (1LL << 21) - 1;
+    return ((static_cast<long long>(cell.x()) & mask) << 42) |
+           ((static_cast<long long>(cell.y()) & mask) << 21) |
+           (static_cast<long long>(cell.z()) & mask);
+}
+
+
+template <typename Visitor>
+void BearingTriangulator::traverseCells(const Ray& ray, Visitor visit) const
+{
+    // 三维DDA (Amanatides-Woo) 遍历射线经过的网格
+    const Vector3 start = ray.origin / m_cellSize;
+    Eigen::Vector3i cell(static_cast<int>(std::floor(start.x())),
+                         static_cast<int>(std::floor(start.y())),
+                         static_cast<int>(std::floor(start.z())));
+
+    Eigen::Vector3i step;
+    Vector3 tMax, tDelta;
+    for (int k = 0; k < 3; ++k) {
+        const double d = ray.direction(k);
+        if (d > 0) {
+            step(k) = 1;
+            tMax(k) = ((cell(k) + 1) - start(k)) / d;
+            tDelta(k) = 1.0 / d;
+        } else if (d < 0) {
+            step(k) = -1;
+            tMax(k) = (start(k) - cell(k)) / -d;
+            tDelta(k) = -1.0 / d;
+        } else {
+            step(k) = 0;
+            tMax(k) = std::numeric_limits<double>::max();
+            tDelta(k) = std::numeric_limits<double>::max();
+        }
+    }
+
+    const double tEnd = m_maxRange / m_cellSize;
+    double t = 0.0;
+    while (t <= tEnd) {
+        visit(cell);
+        int axis = 0;
+        if (tMax(1) < tMax(axis)) axis = 1;
+        if (tMax(2) < tMax(axis)) axis = 2;
+        t = tMax(axis);
+        cell(axis) += step(axis);
+        tMax(axis) += tDelta(axis);
+    }
+}
+
+
+void BearingTriangulator::insertRay(int rayIdx)
+{
+    traverseCells(m_rays[rayIdx], [this, rayIdx](const Eigen::Vector3i& cell) {
+        m_grid[cellKey(cell)].push_back(rayIdx);
+    });
+}
+
+
+bool BearingTriangulator::evaluatePair(int i, int j, Intersection& result) const
+{
+    const Ray& a = m_rays[i];
+    const Ray& b = m_rays[j];
+
+    // 交会角过小(近似平行)时无法可靠定位
+    const double cosAngle = a.direction.dot(b.direction);
+    if (std::abs(cosAngle) > std::cos(m_minIntersectionAngle)) {
+        return false;
+    }
+
+    // 两条直线的最近点参数 (方向为单位向量)
+    const Vector3 w0 = a.origin - b.origin;
+    const double d = a.direction.dot(w0);
+    const double e = b.direction.dot(w0);
+    const double denom = 1.0 - cosAngle * cosAngle;
+    const double s = (cosAngle * e - d) / denom;
+    const double t = (e - cosAngle * d) / denom;
+
+    // 交会点必须位于两条射线前方且在作用距离内
+    if (s <= 0 || t <= 0 || s > m_maxRange || t > m_maxRange) {
+        return false;
+    }
+
+    const Vector3 pa = a.origin + s * a.direction;
+    const Vector3 pb = b.origin + t * b.direction;
+    const double miss = (pa - pb).norm();
+
+    // 门限 = 基础门限 + 两射线横向误差的3倍
+    const double lateralA = s * a.angularStd;
+    const double lateralB = t * b.angularStd;
+    if (miss > m_maxMissDistance + 3.0 * std::hypot(lateralA, lateralB)) {
+        return false;
+    }
+
+    result.first = i;
+    result.second = j;
+    result.missDistance = miss;
+    result.rangeFirst = s;
+    result.rangeSecond = t;
+    return true;
+}
+
+
+Measurement BearingTriangulator::makePseudoMeasurement(const Intersection& candidate) const
+{
+    const Ray& a = m_rays[candidate.first];
+    const Ray& b = m_rays[candidate.second];
+
+    // 加权最小二乘交会: 最小化点到各射线的垂直距离平方和，
+    // 权重为 (I - d*d') / sigma^2，sigma 为该射线在交会处的横向误差
+    Eigen::Matrix3d information = Eigen::Matrix3d::Zero();
+    Vector3 weighted = Vector3::Zero();
+    const Ray* rays[2] = {&a, &b};
+    const double ranges[2] = {candidate.rangeFirst, candidate.rangeSecond};
+    for (int k = 0; k < 2; ++k) {
+        const Ray* ray = rays[k];
+        const Eigen::Matrix3d projector = Eigen::Matrix3d::Identity() - ray->direction * ray->direction.transpose();
+        const double lateralStd = std::max(ranges[k] * ray->angularStd, 1e-3);
+        const Eigen::Matrix3d W = projector / (lateralStd * lateralStd);
+        information += W;
+        weighted += W * ray->origin;
+    }
+
+    const Eigen::Matrix3d covariance = information.inverse();
+    Measurement pseudo(Vector3(covariance * weighted), std::max(a.timestamp, b.timestamp), m_pseudoObserverId);
+    pseudo.covariance = covariance;
+    pseudo.hasCovariance = true;
+    return pseudo;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file BearingTriangulator.h
+ * @brief 纯方位交叉定位头文件
+ * @details 定义了BearingTriangulator类，将多个无源观测者的方位线交叉生成三维伪观测，
+ *          用于纯方位目标的航迹起始
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef BEARINGTRIANGULATOR_H
+#define BEARINGTRIANGULATOR_H
+
+#include "DataStructures.h"
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief 纯方位交叉定位类
+ * @details 在数据关联之前运行。收集时间窗内各纯方位观测者的方位线(射线)，
+ *          用均匀网格建立射线的空间索引，只对经过相邻网格的射线对求交，
+ *          避免对所有观测者和观测两两配对。交会点以加权最小二乘求得，
+ *          并附带协方差，作为伪观测送入TrackManager::processMeasurements
+ */
+class BearingTriangulator
+{
+public:
+    /**
+     * @brief 构造函数
+     * @details 从配置文件读取时间窗、网格尺寸和交会门限等参数
+     */
+    BearingTriangulator();
+
+    /**
+     * @brief 处理一个周期的观测数据
+     * @param measurements 观测数据列表(输入/输出参数)
+     * @return 本周期生成的伪观测数
+     * @details 取出其中的纯方位观测放入时间窗，交叉定位后将生成的伪观测追加到列表中
+     */
+    int process(std::vector<Measurement>& measurements);
+
+private:
+    /**
+     * @brief 方位射线
+     */
+    struct Ray {
+        Vector3 origin;       ///< 观测者位置
+        Vector3 direction;    ///< 单位方向向量
+        double angularStd;    ///< 角度噪声标准差(弧度)
+        double timestamp;     ///< 观测时间戳
+        int observerId;       ///< 观测者ID
+        bool used;            ///< 是否已参与生成伪观测
+        bool isNew;           ///< 是否为本周期新到达的射线
+    };
+
+    /**
+     * @brief 候选交会点
+     */
+    struct Intersection {
+        int first;            ///< 第一条射线索引
+        int second;           ///< 第二条射线索引
+        double missDistance;  ///< 两射线最近距离(米)
+        double rangeFirst;    ///< 最近点到第一条射线原点的距离(米)
+        double rangeSecond;   ///< 最近点到第二条射线原点的距离(米)
+    };
+
+    /**
+     * @brief 计算网格坐标对应的哈希键
+     * @param cell 网格坐标
+     * @return 哈希键
+     */
+    static long long cellKey(const Eigen::Vector3i& cell);
+
+    /**
+     * @brief 将射线插入空间索引
+     * @param rayIdx 射线索引
+     * @details 以三维DDA遍历射线经过的网格，直到最大作用距离
+     */
+    void insertRay(int rayIdx);
+
+    /**
+     * @brief 遍历射线经过的网格
+     * @param ray 射线
+     * @param visit 对每个网格坐标调用的函数
+     */
+    template <typename Visitor>
+    void traverseCells(const Ray& ray, Visitor visit) const;
+
+    /**
+     * @brief 评估两条射线的交会
+     * @param i 第一条射线索引
+     * @param j 第二条射线索引
+     * @param result 输出候选交会点
+     * @return 满足几何约束和门限时返回true
+     */
+    bool evaluatePair(int i, int j, Intersection& result) const;
+
+    /**
+     * @brief 由两条射线生成伪观测
+     * @param candidate 候选交会点
+     * @return 带协方差的三维伪观测
+     */
+    Measurement makePseudoMeasurement(const Intersection& candidate) const;
+
+private:
+    /**
+     * @brief 是否启用交叉定位
+     */
+    bool m_enabled;
+
+    /**
+     * @brief 时间窗长度(秒)
+     * @details 只有时间差在此范围内的方位线才会相互交叉
+     */
+    double m_timeWindow;
+
+    /**
+     * @brief 射线最大作用距离(米)
+     */
+    double m_maxRange;
+
+    /**
+     * @brief 空间索引网格边长(米)
+     */
+    double m_cellSize;
+
+    /**
+     * @brief 交会最近距离的基础门限(米)
+     * @details 实际门限再加上两条射线在交会处横向误差的3倍
+     */
+    double m_maxMissDistance;
+
+    /**
+     * @brief 两条射线的最小交会角(弧度)
+     * @details 交会角过小时定位误差沿视线方向急剧增大
+     */
+    double m_minIntersectionAngle;
+
+    /**
+     * @brief 伪观测使用的观测者ID
+     */
+    int m_pseudoObserverId;
+
+    /**
+     * @brief 时间窗内的射线
+     */
+    std::vector<Ray> m_rays;
+
+    /**
+     * @brief 射线空间索引
+     * @details 键为网格哈希，值为经过该网格的射线索引
+     */
+    std::unordered_map<long long, std::vector<int>> m_grid;
+
+    /**
+     * @brief 查询去重标记
+     * @details 记录每条射线最近一次被哪条射线查询过，避免同一对射线重复求交
+     */
+    std::vector<int> m_visitStamp;
+};
+
+#endif // BEARINGTRIANGULATOR_H
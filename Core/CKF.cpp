@@ -1,14 +1,24 @@
 #include "CKF.h"
 
+// 立方点缓冲，每次预测和更新复用，避免每条航迹每周期分配
+static thread_local std::vector<StateVector> t_cubaturePoints;
+
+// 各观测块在全部立方点上的观测及残差，最多 kMaxStackedDim x 2*kMaxStateDim，使用定长存储
+using StackedPoints = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign,
+                                    CKF::kMaxStackedDim, 2 * kMaxStateDim>;
+// 各立方点相对均值的偏差，最多 kMaxStateDim x 2*kMaxStateDim
+using StatePoints = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign,
+                                  kMaxStateDim, 2 * kMaxStateDim>;
+
 CKF::CKF() {}
 
 // 预测步骤 (使用完整协方差矩阵 P)
-void CKF::predict(StateVector& x, Eigen::MatrixXd& P, const IMotionModel& model, double dt)
+void CKF::predict(StateVector& x, StateMatrix& P, const IMotionModel& model, double dt)
 {
     const int n = model.stateDim();
 
     // 1. 生成 2n 个 Cubature 点
-    auto cubaturePoints = generateCubaturePoints(x, P);
+    std::vector<StateVector>& cubaturePoints = generateCubaturePoints(x, P);
 
     // 2. 通过状态转移模型传递 Cubature 点
     for (int i = 0; i < 2 * n; ++i) {
@@ -24,10 +34,10 @@ void CKF::predict(StateVector& x, Eigen::MatrixXd& P, const IMotionModel& model,
     x = x_pred; // 更新状态
 
     // 4. 计算预测的协方差矩阵
-    Eigen::MatrixXd P_pred = Eigen::MatrixXd::Zero(n, n);
+    StateMatrix P_pred = StateMatrix::Zero(n, n);
     for (int i = 0; i < 2 * n; ++i) {
-        StateVector diff = cubaturePoints[i] - x_pred;
-        P_pred += diff * diff.transpose();
+        const StateVector diff = cubaturePoints[i] - x_pred;
+        P_pred.noalias() += diff * diff.transpose();
     }
     P_pred /= (2.0 * n);
 
@@ -37,61 +47,141 @@ void CKF::predict(StateVector& x, Eigen::MatrixXd& P, const IMotionModel& model,
     P = P_pred; // 更新协方差
 }
 
-// ... (update 和 generateCubaturePoints 方法保持不变) ...
-
-// 更新步骤 (使用完整协方差矩阵 P)
-void CKF::update(StateVector& x, Eigen::MatrixXd& P, const IMotionModel& model,
-                 const MeasurementVector& z, const Eigen::MatrixXd& R)
+// 多传感器堆叠更新，堆叠维度超过上限时按观测块顺序分组依次更新
+InnovationStats CKF::updateStacked(StateVector& x, StateMatrix& P,
+                                   const std::vector<ObservationBlock>& blocks)
 {
-    const int n = model.stateDim();
-    const int m = model.measurementDim();
-
-    // 1. 基于预测后的状态，生成新的 Cubature 点
-    auto cubaturePoints = generateCubaturePoints(x, P);
+    InnovationStats total;
+    const ObservationBlock* first = blocks.data();
+    const ObservationBlock* const end = first + blocks.size();
+    while (first != end) {
+        int groupDim = 0;
+        bool allLinear = true;
+        const ObservationBlock* last = first;
+        while (last != end && (last == first || groupDim + last->model->dim() <= kMaxStackedDim)) {
+            groupDim += last->model->dim();
+            allLinear = allLinear && last->model->isLinear();
+            ++last;
+        }
+
+        const InnovationStats stats = allLinear ? updateStackedLinear(x, P, first, last, groupDim)
+                                                : updateStackedCubature(x, P, first, last, groupDim);
+        total.nis += stats.nis;
+        total.logDetS += stats.logDetS;
+        total.dim += stats.dim;
+        first = last;
+    }
+    return total;
+}
 
-    // 2. 通过观测模型传递 Cubature 点
-    std::vector<MeasurementVector> z_points(2 * n);
-    for(int i = 0; i < 2 * n; ++i) {
-        z_points[i] = model.observe(cubaturePoints[i]);
+// 一组观测块的联合更新 (所有观测块共享同一组 Cubature 点)
+InnovationStats CKF::updateStackedCubature(StateVector& x, StateMatrix& P,
+                                           const ObservationBlock* first, const ObservationBlock* last, int totalDim)
+{
+    const int n = x.rows();
+    const int numPoints = 2 * n;
+
+    // 1. 生成 Cubature 点并通过各观测块的观测模型传递
+    std::vector<StateVector>& cubaturePoints = generateCubaturePoints(x, P);
+    StackedPoints z_points(totalDim, numPoints);
+    StackedPoints z_diffs(totalDim, numPoints);
+    StackedVector innovation(totalDim);
+
+    int offset = 0;
+    for (const ObservationBlock* block = first; block != last; ++block) {
+        const int m = block->model->dim();
+        for (int i = 0; i < numPoints; ++i) {
+            z_points.block(offset, i, m, 1) = block->model->observe(cubaturePoints[i]);
+        }
+
+        // 2. 计算预测观测。以第一个点为参考累加残差，避免角度在 ±pi 处直接求平均出错
+        const ObservationVector reference = z_points.block(offset, 0, m, 1);
+        ObservationVector meanResidual = ObservationVector::Zero(m);
+        for (int i = 0; i < numPoints; ++i) {
+            meanResidual += block->model->residual(z_points.block(offset, i, m, 1), reference);
+        }
+        const ObservationVector z_pred = reference + meanResidual / numPoints;
+
+        for (int i = 0; i < numPoints; ++i) {
+            z_diffs.block(offset, i, m, 1) = block->model->residual(z_points.block(offset, i, m, 1), z_pred);
+        }
+        innovation.segment(offset, m) = block->model->residual(block->z, z_pred);
+        offset += m;
     }
 
-    // 3. 计算预测的观测值
-    MeasurementVector z_pred = MeasurementVector::Zero();
-    for (int i = 0; i < 2 * n; ++i) {
-        z_pred += z_points[i];
+    // 3. 计算创新协方差 Pzz 和互协方差 Pxz
+    StatePoints x_diffs(n, numPoints);
+    for (int i = 0; i < numPoints; ++i) {
+        x_diffs.col(i) = cubaturePoints[i] - x;
     }
-    z_pred /= (2.0 * n);
-
-    // 4. 计算创新协方差 Pzz 和互协方差 Pxz
-    Eigen::MatrixXd P_zz = Eigen::MatrixXd::Zero(m, m);
-    Eigen::MatrixXd P_xz = Eigen::MatrixXd::Zero(n, m);
-    for(int i = 0; i < 2 * n; ++i) {
-        MeasurementVector z_diff = z_points[i] - z_pred;
-        StateVector x_diff = cubaturePoints[i] - x;
-        P_zz += z_diff * z_diff.transpose();
-        P_xz += x_diff * z_diff.transpose();
+    StackedMatrix P_zz = z_diffs * z_diffs.transpose() / numPoints;
+    const CrossMatrix P_xz = x_diffs * z_diffs.transpose() / numPoints;
+
+    offset = 0;
+    for (const ObservationBlock* block = first; block != last; ++block) {
+        const int m = block->model->dim();
+        P_zz.block(offset, offset, m, m) += block->R; // 加上各传感器的观测噪声
+        offset += m;
     }
-    P_zz /= (2.0 * n);
-    P_xz /= (2.0 * n);
-    P_zz += R; // 加上观测噪声
 
-    // 5. 计算卡尔曼增益 K
-    Eigen::MatrixXd K = P_xz * P_zz.inverse();
+    // 4. 计算卡尔曼增益 K 并更新
+    return applyGain(x, P, P_xz, P_zz, innovation);
+}
 
-    // 6. 更新状态和协方差
-    x += K * (z - z_pred);
-    P -= K * P_zz * K.transpose();
+// 线性观测模型的堆叠更新 (观测即状态的前若干分量，无需 Cubature 点)
+InnovationStats CKF::updateStackedLinear(StateVector& x, StateMatrix& P,
+                                         const ObservationBlock* first, const ObservationBlock* last, int totalDim)
+{
+    const int n = x.rows();
+
+    StackedMatrix P_zz(totalDim, totalDim);
+    CrossMatrix P_xz(n, totalDim);
+    StackedVector innovation(totalDim);
+
+    int rowOffset = 0;
+    for (const ObservationBlock* rowBlock = first; rowBlock != last; ++rowBlock) {
+        const int ma = rowBlock->model->dim();
+        int colOffset = 0;
+        for (const ObservationBlock* colBlock = first; colBlock != last; ++colBlock) {
+            const int mb = colBlock->model->dim();
+            P_zz.block(rowOffset, colOffset, ma, mb) = P.topLeftCorner(ma, mb);
+            colOffset += mb;
+        }
+        P_zz.block(rowOffset, rowOffset, ma, ma) += rowBlock->R;
+        P_xz.block(0, rowOffset, n, ma) = P.leftCols(ma);
+        innovation.segment(rowOffset, ma) = rowBlock->model->residual(rowBlock->z, x.head(ma));
+        rowOffset += ma;
+    }
+
+    return applyGain(x, P, P_xz, P_zz, innovation);
+}
+
+// K = Pxz * Pzz^-1，通过 Pzz 的 Cholesky 分解求解，分解结果同时用于 NIS 和行列式
+InnovationStats CKF::applyGain(StateVector& x, StateMatrix& P,
+                               const CrossMatrix& P_xz, const StackedMatrix& P_zz,
+                               const StackedVector& innovation)
+{
+    const Eigen::LLT<StackedMatrix> llt(P_zz);
+    const CrossMatrix K = llt.solve(P_xz.transpose()).transpose();
+    x += K * innovation;
+    P -= K * P_xz.transpose();
+
+    InnovationStats stats;
+    stats.dim = static_cast<int>(innovation.size());
+    stats.nis = innovation.dot(llt.solve(innovation));
+    stats.logDetS = 2.0 * llt.matrixLLT().diagonal().array().log().sum();
+    return stats;
 }
 
 
-std::vector<StateVector> CKF::generateCubaturePoints(const StateVector& x, const Eigen::MatrixXd& P)
+std::vector<StateVector>& CKF::generateCubaturePoints(const StateVector& x, const StateMatrix& P)
 {
     const int n = x.rows();
-    std::vector<StateVector> points(2 * n);
+    std::vector<StateVector>& points = t_cubaturePoints;
+    points.resize(2 * n);
 
     // 使用 Cholesky分解计算协方差的平方根
-    Eigen::MatrixXd S = P.llt().matrixL();
-    Eigen::MatrixXd term = std::sqrt(static_cast<double>(n)) * S;
+    const StateMatrix term = std::sqrt(static_cast<double>(n)) * StateMatrix(P.llt().matrixL());
 
     for (int i = 0; i < n; ++i) {
         points[i]       = x + term.col(i);
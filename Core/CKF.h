@@ -10,7 +10,40 @@
 #define CKF_H
 
 #include "IMotionModel.h"
+#include "IMeasurementModel.h"
 #include <vector>
+#include <cmath>
+
+/**
+ * @brief 一次更新的新息统计量
+ * @details 供模型概率计算(IMM)和机动检测使用
+ */
+struct InnovationStats
+{
+    /**
+     * @brief 归一化新息平方 (NIS)，即 v' * S^-1 * v
+     */
+    double nis = 0.0;
+
+    /**
+     * @brief 新息协方差S的行列式的自然对数
+     */
+    double logDetS = 0.0;
+
+    /**
+     * @brief 新息维度
+     */
+    int dim = 0;
+
+    /**
+     * @brief 观测的对数似然
+     * @return 高斯似然 N(v; 0, S) 的自然对数
+     */
+    double logLikelihood() const
+    {
+        return -0.5 * (nis + logDetS + dim * std::log(2.0 * EIGEN_PI));
+    }
+};
 
 /**
  * @brief 立方卡尔曼滤波器类
@@ -19,6 +52,12 @@
 class CKF
 {
 public:
+    /**
+     * @brief 一次联合更新的最大观测维度
+     * @details 超过时按观测块顺序分组依次更新，更新过程中的矩阵均可使用定长存储
+     */
+    static const int kMaxStackedDim = 12;
+
     /**
      * @brief 构造函数
      */
@@ -32,31 +71,89 @@ public:
      * @param dt 时间步长(秒)
      * @details 根据运动模型将状态向前预测，更新状态向量和协方差矩阵
      */
-    void predict(StateVector& x, Eigen::MatrixXd& P,
+    void predict(StateVector& x, StateMatrix& P,
                  const IMotionModel& model, double dt);
 
     /**
-     * @brief 更新步骤
+     * @brief 多传感器堆叠更新步骤
      * @param x 状态向量(输入/输出参数)
      * @param P 状态协方差矩阵(输入/输出参数)
-     * @param model 运动模型
-     * @param z 观测向量
-     * @param R 观测噪声协方差矩阵
-     * @details 根据观测数据更新状态估计，修正状态向量和协方差矩阵
+     * @param blocks 同一周期内来自不同观测者的观测块，各块可使用不同的观测模型和维度
+     * @details 将多个观测堆叠为一个扩维观测完成一次联合更新，各传感器噪声相互独立，
+     *          堆叠后的观测噪声为块对角矩阵。全部观测模型均为线性时直接使用线性卡尔曼更新，
+     *          否则只生成一次立方点，由所有观测块共享。
+     *          堆叠维度超过kMaxStackedDim时分组依次更新，线性模型下与一次联合更新等价，
+     *          各组的NIS、行列式对数和维度累加后返回
+     * @return 本次更新的新息统计量，无观测时维度为0
      */
-    void update(StateVector& x, Eigen::MatrixXd& P,
-                const IMotionModel& model,
-                const MeasurementVector& z, const Eigen::MatrixXd& R);
+    InnovationStats updateStacked(StateVector& x, StateMatrix& P,
+                       const std::vector<ObservationBlock>& blocks);
 
 private:
+    /**
+     * @brief 堆叠观测向量，最多kMaxStackedDim维
+     */
+    using StackedVector = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::DontAlign, kMaxStackedDim, 1>;
+
+    /**
+     * @brief 新息协方差，最多kMaxStackedDim x kMaxStackedDim
+     */
+    using StackedMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign,
+                                        kMaxStackedDim, kMaxStackedDim>;
+
+    /**
+     * @brief 状态与观测的互协方差，最多kMaxStateDim x kMaxStackedDim
+     */
+    using CrossMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign,
+                                      kMaxStateDim, kMaxStackedDim>;
+
     /**
      * @brief 生成立方点
      * @param x 状态向量
      * @param P 状态协方差矩阵
-     * @return 立方点集合
+     * @return 立方点集合，为本线程复用的缓冲，下一次调用时被覆盖
      * @details 根据当前状态和协方差生成用于滤波计算的立方点
      */
-    std::vector<StateVector> generateCubaturePoints(const StateVector& x, const Eigen::MatrixXd& P);
+    std::vector<StateVector>& generateCubaturePoints(const StateVector& x, const StateMatrix& P);
+
+    /**
+     * @brief 由新息和新息协方差完成增益计算和状态更新
+     * @param x 状态向量(输入/输出参数)
+     * @param P 状态协方差矩阵(输入/输出参数)
+     * @param P_xz 状态与观测的互协方差
+     * @param P_zz 新息协方差
+     * @param innovation 新息
+     * @return 新息统计量
+     * @details 对P_zz做一次Cholesky分解，同时用于求增益、NIS和行列式
+     */
+    static InnovationStats applyGain(StateVector& x, StateMatrix& P,
+                                     const CrossMatrix& P_xz, const StackedMatrix& P_zz,
+                                     const StackedVector& innovation);
+
+    /**
+     * @brief 一组观测块的立方点联合更新
+     * @param x 状态向量(输入/输出参数)
+     * @param P 状态协方差矩阵(输入/输出参数)
+     * @param first 第一个观测块
+     * @param last 最后一个观测块之后的位置
+     * @param totalDim 堆叠后的观测维度，不超过kMaxStackedDim
+     * @return 本次更新的新息统计量
+     */
+    InnovationStats updateStackedCubature(StateVector& x, StateMatrix& P,
+                                          const ObservationBlock* first, const ObservationBlock* last, int totalDim);
+
+    /**
+     * @brief 线性观测模型的堆叠更新
+     * @param x 状态向量(输入/输出参数)
+     * @param P 状态协方差矩阵(输入/输出参数)
+     * @param first 第一个观测块(观测模型均为线性)
+     * @param last 最后一个观测块之后的位置
+     * @param totalDim 堆叠后的观测维度，不超过kMaxStackedDim
+     * @details 线性模型的观测即状态的前若干分量，H*P*H'等可直接从P中截取
+     * @return 本次更新的新息统计量
+     */
+    InnovationStats updateStackedLinear(StateVector& x, StateMatrix& P,
+                                        const ObservationBlock* first, const ObservationBlock* last, int totalDim);
 };
 
 #endif // CKF_H
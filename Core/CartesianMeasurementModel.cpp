@@ -0,0 +1,14 @@
+#include "CartesianMeasurementModel.h"
+
+int CartesianMeasurementModel::dim() const { return 3; }
+bool CartesianMeasurementModel::isLinear() const { return true; }
+
+ObservationVector CartesianMeasurementModel::observe(const StateVector& x) const
+{
+    return x.head<3>();
+}
+
+Vector3 CartesianMeasurementModel::toCartesian(const ObservationVector& z) const
+{
+    return z.head<3>();
+}
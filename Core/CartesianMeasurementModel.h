@@ -0,0 +1,48 @@
+/**
+ * @file CartesianMeasurementModel.h
+ * @brief 笛卡尔位置观测模型头文件
+ * @details 定义了CartesianMeasurementModel类，传感器直接给出跟踪坐标系下的位置
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef CARTESIANMEASUREMENTMODEL_H
+#define CARTESIANMEASUREMENTMODEL_H
+
+#include "IMeasurementModel.h"
+
+/**
+ * @brief 笛卡尔位置观测模型类
+ * @details 观测为三维位置(x,y,z)，是线性模型
+ */
+class CartesianMeasurementModel : public IMeasurementModel
+{
+public:
+    /**
+     * @brief 获取观测向量的维度
+     * @return 3
+     */
+    int dim() const override;
+
+    /**
+     * @brief 是否为线性观测模型
+     * @return true
+     */
+    bool isLinear() const override;
+
+    /**
+     * @brief 观测映射函数
+     * @param x 状态向量
+     * @return 状态中的位置分量
+     */
+    ObservationVector observe(const StateVector& x) const override;
+
+    /**
+     * @brief 将观测转换为笛卡尔位置
+     * @param z 观测向量
+     * @return 位置(即观测本身)
+     */
+    Vector3 toCartesian(const ObservationVector& z) const override;
+};
+
+#endif // CARTESIANMEASUREMENTMODEL_H
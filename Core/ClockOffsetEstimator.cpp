@@ -0,0 +1,168 @@
+/**
+ * @file ClockOffsetEstimator.cpp
+ * @brief 观测者时钟偏差估计实现文件
+ * @details 实现了基于航迹残差的时钟偏差估计、基于到达时刻的时延统计和时间戳修正
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "ClockOffsetEstimator.h"
+#include "LogManager.h"
+#include "MetricsRegistry.h"
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[ClockOffsetEstimator::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[ClockOffsetEstimator::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[ClockOffsetEstimator::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[ClockOffsetEstimator::" << __FUNCTION__ << "] " << msg
+
+
+ClockOffsetEstimator& ClockOffsetEstimator::instance()
+{
+    // C++11 保证了静态局部变量的初始化是线程安全的
+    static ClockOffsetEstimator instance;
+    return instance;
+}
+
+
+ClockOffsetEstimator::ClockOffsetEstimator()
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_enabled = settings.value("ClockOffset/enabled", true).toBool();
+    m_gain = std::min(1.0, std::max(0.0, settings.value("ClockOffset/gain", 0.05).toDouble()));
+    m_minSpeed = settings.value("ClockOffset/minSpeed", 5.0).toDouble();
+    m_maxResidualTime = settings.value("ClockOffset/maxResidualTime", 1.0).toDouble();
+    m_maxOffset = settings.value("ClockOffset/maxOffset", 5.0).toDouble();
+    m_latencyWindow = settings.value("ClockOffset/latencyWindow", 10.0).toDouble();
+
+    LOG_INFO(QString("时间戳修正: ") + (m_enabled ? "启用" : "禁用") +
+             "，增益: " + QString::number(m_gain) +
+             "，最小速度: " + QString::number(m_minSpeed) + "米/秒，偏差上限: " +
+             QString::number(m_maxOffset) + "秒");
+}
+
+
+bool ClockOffsetEstimator::isEnabled() const
+{
+    return m_enabled;
+}
+
+
+double ClockOffsetEstimator::correct(int observerId, double timestamp, double arrivalTime)
+{
+    ObserverClock& clock = m_observers[observerId];
+    const double corrected = m_enabled ? timestamp + clock.offset : timestamp;
+
+    // 传输时延 = 到达时刻 - 观测的真实时刻
+    const double latency = arrivalTime - corrected;
+    if (clock.messages == 0) {
+        clock.latencyMean = latency;
+        clock.latencyMin = latency;
+        clock.latencyFloor = latency;
+        clock.windowStart = arrivalTime;
+    } else {
+        clock.latencyMean += 0.1 * (latency - clock.latencyMean);
+        clock.latencyMin = std::min(clock.latencyMin, latency);
+        if (arrivalTime - clock.windowStart >= m_latencyWindow) {
+            clock.latencyFloor = clock.latencyMin;
+            clock.latencyMin = latency;
+            clock.windowStart = arrivalTime;
+        }
+    }
+    clock.messages++;
+
+    return corrected;
+}
+
+
+void ClockOffsetEstimator::addResidual(int observerId, const Vector3& innovation, const Vector3& velocity,
+                                       double timeFromPrediction)
+{
+    const double speed2 = velocity.squaredNorm();
+    if (speed2 < m_minSpeed * m_minSpeed) {
+        return;
+    }
+
+    // 残差沿速度方向折算为时间，扣除观测与预测时刻之差后剩余的部分即为时钟误差
+    const double error = velocity.dot(innovation) / speed2 - timeFromPrediction;
+    if (!std::isfinite(error) || std::abs(error) > m_maxResidualTime) {
+        return;
+    }
+
+    auto it = m_observers.find(observerId);
+    if (it == m_observers.end()) {
+        return;
+    }
+    // 速度越大，同样的位置噪声折算的时间误差越小，按 |v|^2 加权
+    it->second.residualSum += speed2 * error;
+    it->second.weightSum += speed2;
+    it->second.residuals++;
+}
+
+
+void ClockOffsetEstimator::endCycle()
+{
+    // 各观测者共同的偏差无法由残差观测(航迹随之整体平移)，以参与估计的观测者误差均值为零作为参照
+    double errorSum = 0.0;
+    int contributors = 0;
+    for (auto& pair : m_observers) {
+        ObserverClock& clock = pair.second;
+        if (clock.weightSum > 0) {
+            clock.lastError = clock.residualSum / clock.weightSum;
+            errorSum += clock.lastError;
+            contributors++;
+        }
+    }
+    if (contributors == 0) {
+        return;
+    }
+    const double commonError = errorSum / contributors;
+
+    for (auto& pair : m_observers) {
+        ObserverClock& clock = pair.second;
+        if (clock.weightSum <= 0) {
+            continue;
+        }
+        clock.lastError -= commonError;
+        const double previous = clock.offset;
+        clock.offset = std::min(m_maxOffset, std::max(-m_maxOffset, clock.offset + m_gain * clock.lastError));
+        if (std::abs(clock.offset) >= m_maxOffset && std::abs(previous) < m_maxOffset) {
+            LOG_WARN("观测者 " + QString::number(pair.first) + " 时钟偏差估计达到上限 " +
+                     QString::number(clock.offset) + " 秒");
+        }
+        clock.residualSum = 0.0;
+        clock.weightSum = 0.0;
+    }
+}
+
+
+double ClockOffsetEstimator::offset(int observerId) const
+{
+    auto it = m_observers.find(observerId);
+    return it != m_observers.end() ? it->second.offset : 0.0;
+}
+
+
+void ClockOffsetEstimator::publishMetrics() const
+{
+    nlohmann::json metrics;
+    metrics["enabled"] = m_enabled;
+    nlohmann::json observers = nlohmann::json::object();
+    for (const auto& pair : m_observers) {
+        const ObserverClock& clock = pair.second;
+        nlohmann::json item;
+        item["offset"] = clock.offset;
+        item["lastError"] = clock.lastError;
+        item["residuals"] = clock.residuals;
+        item["messages"] = clock.messages;
+        item["latencyMean"] = clock.latencyMean;
+        item["latencyFloor"] = std::min(clock.latencyFloor, clock.latencyMin);
+        observers[std::to_string(pair.first)] = item;
+    }
+    metrics["observers"] = observers;
+    g_Metrics.setSection("clock", metrics);
+}
@@ -0,0 +1,150 @@
+/**
+ * @file ClockOffsetEstimator.h
+ * @brief 观测者时钟偏差估计头文件
+ * @details 定义了ClockOffsetEstimator类，在线估计各观测者的时钟偏差和传输时延，并在接收时修正观测时间戳
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef CLOCKOFFSETESTIMATOR_H
+#define CLOCKOFFSETESTIMATOR_H
+
+#include "DataStructures.h"
+#include <unordered_map>
+
+/**
+ * @brief 观测者时钟偏差估计类
+ * @details 观测时间戳来自各观测者自己的时钟。时钟偏差 d 使观测的真实时刻为 timestamp + d，
+ *          对运动目标而言位置残差沿航迹速度方向的分量约为 v * d。
+ *          处理周期内对每条关联到确认航迹的观测，以残差在速度方向上的投影折算时间误差:
+ *              delta = v·r / |v|^2 - (timestamp - 预测时刻)
+ *          按 |v|^2 加权平均后在周期结束时以增益平滑并入偏差估计。
+ *          所有观测者共同的偏差会被航迹整体吸收而不可观测，估计的是各观测者相对其均值的偏差。
+ *          接收时以到达时刻(本机UTC秒)减去修正后的时间戳得到传输时延，统计均值和窗口内的最小值。
+ *          使用单例模式，只在工作线程中使用
+ */
+class ClockOffsetEstimator
+{
+public:
+    /**
+     * @brief 获取时钟偏差估计单例实例
+     * @return 时钟偏差估计实例的引用
+     */
+    static ClockOffsetEstimator& instance();
+
+    /**
+     * @brief 是否启用时间戳修正
+     * @return 启用返回true
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief 修正观测时间戳并记录传输时延
+     * @param observerId 观测者ID
+     * @param timestamp 观测者给出的时间戳(秒)
+     * @param arrivalTime 到达时刻(本机UTC秒)
+     * @return 修正后的时间戳，未启用时原样返回
+     */
+    double correct(int observerId, double timestamp, double arrivalTime);
+
+    /**
+     * @brief 记录一条观测相对确认航迹的残差
+     * @param observerId 观测者ID
+     * @param innovation 观测位置减航迹预测位置
+     * @param velocity 航迹预测速度
+     * @param timeFromPrediction 观测时间戳减航迹预测时刻(秒)
+     * @details 航迹速度低于最小速度时残差不含可用的时间信息，直接忽略
+     */
+    void addResidual(int observerId, const Vector3& innovation, const Vector3& velocity,
+                     double timeFromPrediction);
+
+    /**
+     * @brief 结束一个处理周期
+     * @details 本周期各观测者的平均时间误差减去其均值后，平滑并入各观测者的偏差估计
+     */
+    void endCycle();
+
+    /**
+     * @brief 获取观测者当前的偏差估计
+     * @param observerId 观测者ID
+     * @return 偏差(秒)，未知观测者返回0
+     */
+    double offset(int observerId) const;
+
+    /**
+     * @brief 发布时钟指标
+     * @details 写入 clock 分区，每个观测者一项
+     */
+    void publishMetrics() const;
+
+private:
+    /**
+     * @brief 单个观测者的时钟状态
+     */
+    struct ObserverClock {
+        double offset = 0.0;             ///< 偏差估计(秒)
+        double residualSum = 0.0;        ///< 本周期加权时间误差之和
+        double weightSum = 0.0;          ///< 本周期权重之和
+        double lastError = 0.0;          ///< 最近一个有残差周期的平均时间误差(秒)
+        long long residuals = 0;         ///< 累计使用的残差数
+        long long messages = 0;          ///< 累计接收的观测数
+        double latencyMean = 0.0;        ///< 传输时延的指数平滑均值(秒)
+        double latencyMin = 0.0;         ///< 当前窗口内的最小传输时延(秒)
+        double latencyFloor = 0.0;       ///< 上一窗口的最小传输时延(秒)
+        double windowStart = 0.0;        ///< 当前窗口起始的到达时刻
+    };
+
+    /**
+     * @brief 私有构造函数
+     * @details 从配置文件 ClockOffset 分组读取参数
+     */
+    ClockOffsetEstimator();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    ClockOffsetEstimator(const ClockOffsetEstimator&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    ClockOffsetEstimator& operator=(const ClockOffsetEstimator&) = delete;
+
+private:
+    /**
+     * @brief 是否启用时间戳修正
+     */
+    bool m_enabled;
+
+    /**
+     * @brief 偏差估计的平滑增益
+     */
+    double m_gain;
+
+    /**
+     * @brief 参与估计的最小航迹速度(米/秒)
+     */
+    double m_minSpeed;
+
+    /**
+     * @brief 单条残差折算时间误差的上限(秒)，超出视为错误关联
+     */
+    double m_maxResidualTime;
+
+    /**
+     * @brief 偏差估计的上限(秒)
+     */
+    double m_maxOffset;
+
+    /**
+     * @brief 时延最小值的统计窗口(秒)
+     */
+    double m_latencyWindow;
+
+    /**
+     * @brief 各观测者的时钟状态，键为观测者ID
+     */
+    std::unordered_map<int, ObserverClock> m_observers;
+};
+
+#endif // CLOCKOFFSETESTIMATOR_H
@@ -0,0 +1,108 @@
+/**
+ * @file CompactCvFilter.cpp
+ * @brief 单精度匀速卡尔曼滤波器实现文件
+ * @details 实现了局部原点下的单精度预测、线性观测更新和双精度状态的导入导出
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "CompactCvFilter.h"
+#include <cmath>
+
+
+CompactCvFilter::CompactCvFilter(double processNoiseStd, double recenterDistance)
+    : m_origin(Vector3::Zero()),
+      m_x(State::Zero()),
+      m_P(Covariance::Identity()),
+      m_q(static_cast<float>(processNoiseStd * processNoiseStd)),
+      m_recenterDistance(recenterDistance > 0 ? recenterDistance : 1000.0)
+{
+}
+
+
+void CompactCvFilter::importState(const StateVector& x, const StateMatrix& P)
+{
+    m_origin = x.head<3>();
+    m_x.head<3>().setZero();
+    m_x.tail<3>() = x.segment<3>(3).cast<float>();
+    m_P = P.topLeftCorner<6, 6>().cast<float>();
+}
+
+
+void CompactCvFilter::exportState(StateVector& x, StateMatrix& P) const
+{
+    x.resize(6);
+    x.head<3>() = m_origin + m_x.head<3>().cast<double>();
+    x.tail<3>() = m_x.tail<3>().cast<double>();
+    P = m_P.cast<double>();
+}
+
+
+void CompactCvFilter::predict(double dt)
+{
+    if (dt <= 0) {
+        return;
+    }
+    const float t = static_cast<float>(dt);
+
+    m_x.head<3>() += m_x.tail<3>() * t;
+
+    // P = F P F' + Q，F = [I tI; 0 I]，Q为离散白噪声加速度模型，按3x3分块闭式计算
+    const Eigen::Matrix3f Ppv = m_P.topRightCorner<3, 3>();
+    const Eigen::Matrix3f Pvv = m_P.bottomRightCorner<3, 3>();
+    const Eigen::Matrix3f PpvNew = Ppv + t * Pvv;
+    m_P.topLeftCorner<3, 3>() += t * (Ppv + Ppv.transpose()) + (t * t) * Pvv;
+    m_P.topLeftCorner<3, 3>().diagonal().array() += m_q * t * t * t * t / 4.0f;
+    m_P.topRightCorner<3, 3>() = PpvNew;
+    m_P.topRightCorner<3, 3>().diagonal().array() += m_q * t * t * t / 2.0f;
+    m_P.bottomLeftCorner<3, 3>() = m_P.topRightCorner<3, 3>().transpose();
+    m_P.bottomRightCorner<3, 3>().diagonal().array() += m_q * t * t;
+
+    recenter();
+}
+
+
+bool CompactCvFilter::update(const std::vector<ObservationBlock>& blocks, InnovationStats& stats)
+{
+    for (const auto& block : blocks) {
+        if (!block.model->isLinear() || block.model->dim() != 3) {
+            return false;
+        }
+    }
+
+    stats = InnovationStats();
+    for (const auto& block : blocks) {
+        // 新息在双精度下计算，原点处的大坐标相减后只剩小量，再转为单精度
+        ObservationVector zPred(3);
+        zPred = m_origin + m_x.head<3>().cast<double>();
+        const Eigen::Vector3f innovation = block.model->residual(block.z, zPred).head<3>().cast<float>();
+        const Eigen::Matrix3f R = block.R.topLeftCorner<3, 3>().cast<float>();
+
+        const Eigen::Matrix3f S = m_P.topLeftCorner<3, 3>() + R;
+        const Eigen::LLT<Eigen::Matrix3f> llt(S);
+        const Eigen::Matrix<float, 6, 3> K = llt.solve(m_P.topRows<3>()).transpose();
+
+        m_x += K * innovation;
+
+        // Joseph形式: P = (I - KH) P (I - KH)' + K R K'
+        Covariance A = Covariance::Identity();
+        A.leftCols<3>() -= K;
+        m_P = A * m_P * A.transpose() + K * R * K.transpose();
+
+        stats.dim += 3;
+        stats.nis += innovation.dot(llt.solve(innovation));
+        stats.logDetS += 2.0 * llt.matrixLLT().diagonal().array().log().sum();
+    }
+
+    recenter();
+    return true;
+}
+
+
+void CompactCvFilter::recenter()
+{
+    if (m_x.head<3>().cast<double>().norm() > m_recenterDistance) {
+        m_origin += m_x.head<3>().cast<double>();
+        m_x.head<3>().setZero();
+    }
+}
@@ -0,0 +1,110 @@
+/**
+ * @file CompactCvFilter.h
+ * @brief 单精度匀速卡尔曼滤波器头文件
+ * @details 定义了CompactCvFilter类，以定长单精度矩阵实现匀速模型的预测和线性观测更新，用于大规模跟踪
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef COMPACTCVFILTER_H
+#define COMPACTCVFILTER_H
+
+#include "DataStructures.h"
+#include "CKF.h"
+#include <vector>
+
+/**
+ * @brief 单精度匀速卡尔曼滤波器类
+ * @details 状态为 [位置, 速度] 共6维，状态和协方差以 float 定长矩阵保存，不做动态分配，
+ *          SIMD每条指令处理的元素数是双精度的两倍。
+ *          位置以双精度局部原点加单精度偏移表示: 偏移超过重定中心距离时并入原点，
+ *          使单精度只需表示原点附近的小量，大坐标下位置精度不受损失。
+ *          匀速模型和笛卡尔观测均为线性，预测和更新按标准卡尔曼滤波的闭式计算，
+ *          与立方卡尔曼滤波的结果在数学上一致；协方差更新使用Joseph形式以保持单精度下的对称正定
+ */
+class CompactCvFilter
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    /**
+     * @brief 单精度状态向量
+     */
+    using State = Eigen::Matrix<float, 6, 1>;
+
+    /**
+     * @brief 单精度协方差矩阵
+     */
+    using Covariance = Eigen::Matrix<float, 6, 6>;
+
+    /**
+     * @brief 构造函数
+     * @param processNoiseStd 加速度过程噪声标准差(米/秒^2)
+     * @param recenterDistance 重定中心距离(米)
+     */
+    CompactCvFilter(double processNoiseStd, double recenterDistance);
+
+    /**
+     * @brief 从双精度状态载入
+     * @param x 6维状态向量
+     * @param P 6x6协方差矩阵
+     * @details 局部原点取为当前位置
+     */
+    void importState(const StateVector& x, const StateMatrix& P);
+
+    /**
+     * @brief 导出为双精度状态
+     * @param x 输出，6维状态向量，位置为原点加偏移
+     * @param P 输出，6x6协方差矩阵
+     */
+    void exportState(StateVector& x, StateMatrix& P) const;
+
+    /**
+     * @brief 预测
+     * @param dt 时间步长(秒)
+     */
+    void predict(double dt);
+
+    /**
+     * @brief 以观测块更新
+     * @param blocks 观测块
+     * @param stats 输出，新息统计量
+     * @return 所有观测块均为三维线性位置观测时更新并返回true，否则不做任何修改并返回false
+     * @details 观测噪声相互独立，各块依次更新，NIS和新息协方差的对数行列式按块累加，与堆叠更新等价
+     */
+    bool update(const std::vector<ObservationBlock>& blocks, InnovationStats& stats);
+
+private:
+    /**
+     * @brief 偏移超过重定中心距离时把位置并入原点
+     */
+    void recenter();
+
+private:
+    /**
+     * @brief 局部原点(双精度)
+     */
+    Vector3 m_origin;
+
+    /**
+     * @brief 相对原点的状态
+     */
+    State m_x;
+
+    /**
+     * @brief 状态协方差
+     */
+    Covariance m_P;
+
+    /**
+     * @brief 加速度过程噪声方差
+     */
+    float m_q;
+
+    /**
+     * @brief 重定中心距离(米)
+     */
+    double m_recenterDistance;
+};
+
+#endif // COMPACTCVFILTER_H
@@ -39,13 +39,13 @@ MeasurementVector ConstantAccelerationModel::observe(const StateVector& x) const
     return x.head<3>();
 }
 
-Eigen::MatrixXd ConstantAccelerationModel::getProcessNoiseMatrix(double dt) const
+StateMatrix ConstantAccelerationModel::getProcessNoiseMatrix(double dt) const
 {
     // 基于离散白噪声加加速度（jerk）模型计算Q矩阵
     double q = std::pow(m_process_noise_std, 2);
 
     // G 矩阵将 3D jerk 噪声映射到 9D 状态
-    Eigen::MatrixXd G(9, 3);
+    Eigen::Matrix<double, 9, 3> G;
     G.setZero();
     G.block<3, 3>(0, 0) = Eigen::Matrix3d::Identity() * 0.5 * dt * dt;
     G.block<3, 3>(3, 0) = Eigen::Matrix3d::Identity() * dt;
@@ -55,7 +55,7 @@ Eigen::MatrixXd ConstantAccelerationModel::getProcessNoiseMatrix(double dt) cons
     // 更精确的模型应该使用更复杂的Q矩阵，但这是一个常用且有效的简化
     // Q = G * G' * q
     // 这里为了简化，我们直接构建Q矩阵
-    Eigen::MatrixXd Q = Eigen::MatrixXd::Zero(9, 9);
+    StateMatrix Q = StateMatrix::Zero(9, 9);
     double dt2 = dt * dt;
     double dt3 = dt2 * dt;
     double dt4 = dt3 * dt;
@@ -83,14 +83,14 @@ Eigen::MatrixXd ConstantAccelerationModel::getProcessNoiseMatrix(double dt) cons
     return Q * q;
 }
 
-Eigen::MatrixXd ConstantAccelerationModel::getInitialCovariance() const
+StateMatrix ConstantAccelerationModel::getInitialCovariance() const
 {
     QSettings settings("Server.ini", QSettings::IniFormat);
     double pos_uncertainty = settings.value("KalmanFilter/initialPositionUncertainty", 10.0).toDouble();
     double vel_uncertainty = settings.value("KalmanFilter/initialVelocityUncertainty", 100.0).toDouble();
     double acc_uncertainty = settings.value("KalmanFilter/initialAccelerationUncertainty", 10.0).toDouble();
 
-    Eigen::MatrixXd P = Eigen::MatrixXd::Identity(m_stateDim, m_stateDim);
+    StateMatrix P = StateMatrix::Identity(m_stateDim, m_stateDim);
     P.block<3, 3>(0, 0) *= pos_uncertainty;
     P.block<3, 3>(3, 3) *= vel_uncertainty;
     P.block<3, 3>(6, 6) *= acc_uncertainty;
@@ -60,14 +60,14 @@ public:
      * @return 过程噪声协方差矩阵
      * @details 基于加加速度(jerk)噪声模型计算过程噪声协方差
      */
-    Eigen::MatrixXd getProcessNoiseMatrix(double dt) const override;
+    StateMatrix getProcessNoiseMatrix(double dt) const override;
 
     /**
      * @brief 获取初始协方差矩阵
      * @return 初始状态协方差矩阵
      * @details 从配置文件读取参数，构建初始状态不确定性矩阵
      */
-    Eigen::MatrixXd getInitialCovariance() const override;
+    StateMatrix getInitialCovariance() const override;
 
 private:
     /**
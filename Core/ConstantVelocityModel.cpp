@@ -28,14 +28,14 @@ MeasurementVector ConstantVelocityModel::observe(const StateVector& x) const
 
 
 // --- 修改点: 实现新的、依赖于 dt 的 Q 矩阵计算 ---
-Eigen::MatrixXd ConstantVelocityModel::getProcessNoiseMatrix(double dt) const
+StateMatrix ConstantVelocityModel::getProcessNoiseMatrix(double dt) const
 {
     // 基于离散白噪声加速度模型，计算依赖于 dt 的 Q 矩阵
     // Q = G * G' * q, 其中 q 是加速度噪声的方差
 
     double q = std::pow(m_process_noise_std, 2);
 
-    Eigen::MatrixXd G(6, 3);
+    Eigen::Matrix<double, 6, 3> G;
     G << 0.5 * dt * dt, 0, 0,
          0, 0.5 * dt * dt, 0,
          0, 0, 0.5 * dt * dt,
@@ -47,14 +47,14 @@ Eigen::MatrixXd ConstantVelocityModel::getProcessNoiseMatrix(double dt) const
 }
 
 
-Eigen::MatrixXd ConstantVelocityModel::getInitialCovariance() const
+StateMatrix ConstantVelocityModel::getInitialCovariance() const
 {
     // (可选) 同样可以将这些值配置化
     QSettings settings("Server.ini", QSettings::IniFormat);
     double pos_uncertainty = settings.value("KalmanFilter/initialPositionUncertainty", 10.0).toDouble();
     double vel_uncertainty = settings.value("KalmanFilter/initialVelocityUncertainty", 100.0).toDouble();
 
-    Eigen::MatrixXd P = Eigen::MatrixXd::Identity(m_stateDim, m_stateDim);
+    StateMatrix P = StateMatrix::Identity(m_stateDim, m_stateDim);
     P.block<3, 3>(0, 0) *= pos_uncertainty;
     P.block<3, 3>(3, 3) *= vel_uncertainty;
     return P;
@@ -16,9 +16,9 @@ public:
     MeasurementVector observe(const StateVector& x) const override;
 
 
-    Eigen::MatrixXd getProcessNoiseMatrix(double dt) const override;
+    StateMatrix getProcessNoiseMatrix(double dt) const override;
 
-    Eigen::MatrixXd getInitialCovariance() const override;
+    StateMatrix getInitialCovariance() const override;
 
 private:
     int m_stateDim;
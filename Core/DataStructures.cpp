@@ -1,5 +1,10 @@
 #include "DataStructures.h"
 
+constexpr int Measurement::kFusedObserverId;
 
 Measurement::Measurement(const Vector3& pos, double time, int obsId)
-    : position(pos), timestamp(time), observerId(obsId) {}
+    : position(pos), covariance(Eigen::Matrix3d::Zero()), timestamp(time), observerId(obsId) {}
+
+Measurement::Measurement(const ObservationVector& rawObservation, double time, int obsId)
+    : position(Vector3::Zero()), raw(rawObservation), covariance(Eigen::Matrix3d::Zero()),
+      timestamp(time), observerId(obsId) {}
@@ -9,6 +9,7 @@
 #pragma once
 #include <Eigen/Dense>
 #include "nlohmann/json.hpp"
+#include <limits>
 
 /**
  * @brief 3D向量类型别名
@@ -16,6 +17,19 @@
  */
 using Vector3 = Eigen::Vector3d;
 
+/**
+ * @brief 传感器原始观测向量类型别名
+ * @details 维度可变(最多4维，如距离、方位、俯仰、径向速度)，使用定长存储避免堆内存分配；
+ *          不要求对齐，可以安全地放入标准容器
+ */
+using ObservationVector = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::DontAlign, 4, 1>;
+
+/**
+ * @brief 传感器原始观测噪声协方差类型别名
+ * @details 与ObservationVector对应，最多4x4，使用定长存储
+ */
+using ObservationNoise = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign, 4, 4>;
+
 /**
  * @brief JSON类型别名
  * @details 使用nlohmann/json库实现JSON数据处理
@@ -34,18 +48,63 @@ public:
      */
     Vector3 position;
 
+    /**
+     * @brief 传感器原始观测
+     * @details 非笛卡尔传感器(如雷达的距离、方位、俯仰)的原始观测值，
+     *          滤波更新使用原始观测以保持正确的噪声特性；笛卡尔传感器为空
+     */
+    ObservationVector raw;
+
+    /**
+     * @brief 观测自带的位置协方差
+     * @details 由前置处理阶段(如纯方位交叉定位)生成的伪观测携带自身的协方差，
+     *          仅当hasCovariance为true时有效，优先于传感器注册表中的噪声配置
+     */
+    Eigen::Matrix3d covariance;
+
+    /**
+     * @brief 是否携带位置协方差
+     */
+    bool hasCovariance = false;
+
+    /**
+     * @brief 位置是否为经纬高
+     * @details 为true时position依次为纬度、经度(弧度)和椭球高(米)，
+     *          在处理周期内由坐标系转换批量换算为跟踪坐标系位置后置为false
+     */
+    bool isGeodetic = false;
+
+    /**
+     * @brief 目标外形尺寸
+     * @details 由点云聚类得到的包围盒边长(x,y,z)，点目标为零
+     */
+    Vector3 extent = Vector3::Zero();
+
     /**
      * @brief 观测时间戳
      * @details 观测数据的获取时间
      */
     double timestamp;
 
+    /**
+     * @brief 接收时刻
+     * @details 本机收到观测消息时的UTC时间(秒)，用于统计接收到处理的时延；处理阶段生成的观测为0
+     */
+    double arrivalTime = 0.0;
+
     /**
      * @brief 观测者ID
      * @details 产生此观测数据的观测者标识
      */
     int observerId;
 
+    /**
+     * @brief 融合观测的观测者ID
+     * @details 由多个观测者的观测合并而成的观测不属于任何单一观测者，
+     *          观测者统计和时钟偏差估计均跳过该ID
+     */
+    static constexpr int kFusedObserverId = std::numeric_limits<int>::min() + 1;
+
     /**
      * @brief 默认构造函数
      */
@@ -58,4 +117,13 @@ public:
      * @param obsId 观测者ID
      */
     Measurement(const Vector3& pos, double time, int obsId);
+
+    /**
+     * @brief 带原始观测的构造函数
+     * @param rawObservation 传感器原始观测
+     * @param time 观测时间戳
+     * @param obsId 观测者ID
+     * @details 笛卡尔位置由观测模型在处理前批量换算得到
+     */
+    Measurement(const ObservationVector& rawObservation, double time, int obsId);
 };
@@ -0,0 +1,412 @@
+/**
+ * @file GeodeticFrame.cpp
+ * @brief 大地坐标系转换实现文件
+ * @details 实现了WGS84经纬高、ECEF与东北天坐标的批量转换、观测统一和跟踪原点重定中心
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "GeodeticFrame.h"
+#include "LogManager.h"
+#include "MetricsRegistry.h"
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[GeodeticFrame::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[GeodeticFrame::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[GeodeticFrame::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[GeodeticFrame::" << __FUNCTION__ << "] " << msg
+
+namespace {
+
+const double kSemiMajor = 6378137.0;                    ///< WGS84长半轴(米)
+const double kFlattening = 1.0 / 298.257223563;         ///< WGS84扁率
+const double kSemiMinor = kSemiMajor * (1.0 - kFlattening);
+const double kE2 = kFlattening * (2.0 - kFlattening);   ///< 第一偏心率平方
+const double kEp2 = kE2 / (1.0 - kE2);                  ///< 第二偏心率平方
+const double kDeg2Rad = EIGEN_PI / 180.0;
+
+/**
+ * @brief 逐元素atan2
+ */
+struct Atan2Op {
+    double operator()(double y, double x) const { return std::atan2(y, x); }
+};
+
+} // namespace
+
+
+GeodeticFrame& GeodeticFrame::instance()
+{
+    // C++11 保证了静态局部变量的初始化是线程安全的
+    static GeodeticFrame instance;
+    return instance;
+}
+
+
+GeodeticFrame::GeodeticFrame()
+    : m_hasOrigin(false),
+      m_autoRecenter(false),
+      m_recenterDistance(100000.0),
+      m_outputFrame(OutputFrame::Enu),
+      m_recenters(0)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_autoRecenter = settings.value("Frame/autoRecenter", false).toBool();
+    m_recenterDistance = settings.value("Frame/recenterDistance", 100000.0).toDouble();
+
+    if (settings.contains("Frame/originLatitude") && settings.contains("Frame/originLongitude")) {
+        setOrigin(settings.value("Frame/originLatitude").toDouble() * kDeg2Rad,
+                  settings.value("Frame/originLongitude").toDouble() * kDeg2Rad,
+                  settings.value("Frame/originAltitude", 0.0).toDouble());
+    }
+
+    const QString output = settings.value("Frame/outputFrame", "enu").toString().toLower();
+    if (output == "ecef") {
+        m_outputFrame = OutputFrame::Ecef;
+    } else if (output == "geodetic") {
+        m_outputFrame = OutputFrame::Geodetic;
+    }
+    if (m_outputFrame != OutputFrame::Enu && !m_hasOrigin) {
+        LOG_WARN("未配置跟踪原点，输出坐标系 " + output + " 不可用，改为东北天坐标");
+        m_outputFrame = OutputFrame::Enu;
+    }
+
+    if (m_hasOrigin) {
+        LOG_INFO("跟踪原点: (" + QString::number(m_base.latitude / kDeg2Rad, 'f', 7) + ", " +
+                 QString::number(m_base.longitude / kDeg2Rad, 'f', 7) + ", " +
+                 QString::number(m_base.altitude, 'f', 1) + ")，自动重定中心: " +
+                 (m_autoRecenter ? QString::number(m_recenterDistance) + "米" : QString("禁用")) +
+                 "，输出坐标系: " + outputFrameName());
+    } else {
+        LOG_INFO("未配置跟踪原点，不接收经纬高观测");
+    }
+}
+
+
+bool GeodeticFrame::hasOrigin() const
+{
+    return m_hasOrigin;
+}
+
+
+void GeodeticFrame::setOrigin(double latitude, double longitude, double altitude)
+{
+    m_base = makeOrigin(latitude, longitude, altitude);
+    m_current = m_base;
+    m_hasOrigin = true;
+}
+
+
+GeodeticFrame::OutputFrame GeodeticFrame::outputFrame() const
+{
+    return m_outputFrame;
+}
+
+
+const char* GeodeticFrame::outputFrameName() const
+{
+    return frameName(m_outputFrame);
+}
+
+
+GeodeticFrame::OutputFrame GeodeticFrame::publishFrame() const
+{
+    // 经纬高不是笛卡尔坐标，网格索引和区域过滤改用基准东北天坐标系
+    return m_hasOrigin && m_outputFrame == OutputFrame::Ecef ? OutputFrame::Ecef : OutputFrame::Enu;
+}
+
+
+const char* GeodeticFrame::publishFrameName() const
+{
+    return frameName(publishFrame());
+}
+
+
+bool GeodeticFrame::publishTransform(Eigen::Matrix3d& rotation, Vector3& translation) const
+{
+    rotation.setIdentity();
+    translation.setZero();
+    if (!m_hasOrigin) {
+        return false;
+    }
+    if (publishFrame() == OutputFrame::Ecef) {
+        rotation = m_current.rotation.transpose();
+        translation = m_current.ecef;
+        return true;
+    }
+    if (m_recenters == 0) {
+        return false;
+    }
+    // 当前跟踪坐标 -> 基准坐标
+    rotation = m_base.rotation * m_current.rotation.transpose();
+    translation = m_base.rotation * (m_current.ecef - m_base.ecef);
+    return true;
+}
+
+
+const char* GeodeticFrame::frameName(OutputFrame frame)
+{
+    switch (frame) {
+    case OutputFrame::Enu: return "enu";
+    case OutputFrame::Ecef: return "ecef";
+    case OutputFrame::Geodetic: return "geodetic";
+    }
+    return "enu";
+}
+
+
+void GeodeticFrame::geodeticToEcef(const Eigen::ArrayXd& latitude, const Eigen::ArrayXd& longitude,
+                                   const Eigen::ArrayXd& altitude, Eigen::Matrix3Xd& ecef)
+{
+    const Eigen::Index count = latitude.size();
+    ecef.resize(3, count);
+
+    const Eigen::ArrayXd sinLat = latitude.sin();
+    const Eigen::ArrayXd cosLat = latitude.cos();
+    // 卯酉圈曲率半径 N = a / sqrt(1 - e^2 sin^2(lat))
+    const Eigen::ArrayXd N = kSemiMajor / (1.0 - kE2 * sinLat.square()).sqrt();
+    const Eigen::ArrayXd horizontal = (N + altitude) * cosLat;
+
+    ecef.row(0) = (horizontal * longitude.cos()).matrix().transpose();
+    ecef.row(1) = (horizontal * longitude.sin()).matrix().transpose();
+    ecef.row(2) = ((N * (1.0 - kE2) + altitude) * sinLat).matrix().transpose();
+}
+
+
+void GeodeticFrame::ecefToGeodetic(const Eigen::Matrix3Xd& ecef, Eigen::ArrayXd& latitude,
+                                   Eigen::ArrayXd& longitude, Eigen::ArrayXd& altitude)
+{
+    const Eigen::ArrayXd x = ecef.row(0).transpose().array();
+    const Eigen::ArrayXd y = ecef.row(1).transpose().array();
+    const Eigen::ArrayXd z = ecef.row(2).transpose().array();
+
+    const double a2 = kSemiMajor * kSemiMajor;
+    const double b2 = kSemiMinor * kSemiMinor;
+
+    // Heikkinen闭式解
+    const Eigen::ArrayXd r2 = x.square() + y.square();
+    const Eigen::ArrayXd r = r2.sqrt();
+    const Eigen::ArrayXd z2 = z.square();
+    const Eigen::ArrayXd F = 54.0 * b2 * z2;
+    const Eigen::ArrayXd G = r2 + (1.0 - kE2) * z2 - kE2 * (a2 - b2);
+    const Eigen::ArrayXd c = kE2 * kE2 * F * r2 / G.cube();
+    const Eigen::ArrayXd s = (1.0 + c + (c.square() + 2.0 * c).sqrt()).pow(1.0 / 3.0);
+    const Eigen::ArrayXd P = F / (3.0 * (s + 1.0 / s + 1.0).square() * G.square());
+    const Eigen::ArrayXd Q = (1.0 + 2.0 * kE2 * kE2 * P).sqrt();
+    const Eigen::ArrayXd r0 = -(P * kE2 * r) / (1.0 + Q) +
+                              (0.5 * a2 * (1.0 + 1.0 / Q) - P * (1.0 - kE2) * z2 / (Q * (1.0 + Q)) -
+                               0.5 * P * r2).max(0.0).sqrt();
+    const Eigen::ArrayXd d2 = (r - kE2 * r0).square();
+    const Eigen::ArrayXd U = (d2 + z2).sqrt();
+    const Eigen::ArrayXd V = (d2 + (1.0 - kE2) * z2).sqrt();
+    const Eigen::ArrayXd z0 = b2 * z / (kSemiMajor * V);
+
+    altitude = U * (1.0 - b2 / (kSemiMajor * V));
+    latitude = (z + kEp2 * z0).binaryExpr(r, Atan2Op());
+    longitude = y.binaryExpr(x, Atan2Op());
+}
+
+
+void GeodeticFrame::ecefToLocal(const Eigen::Matrix3Xd& ecef, Eigen::Matrix3Xd& local) const
+{
+    local.noalias() = m_current.rotation * (ecef.colwise() - m_current.ecef);
+}
+
+
+void GeodeticFrame::localToEcef(const Eigen::Matrix3Xd& local, Eigen::Matrix3Xd& ecef) const
+{
+    ecef.noalias() = m_current.rotation.transpose() * local;
+    ecef.colwise() += m_current.ecef;
+}
+
+
+int GeodeticFrame::convertToLocal(std::vector<Measurement>& measurements) const
+{
+    // 经纬高观测和需要从基准坐标系变换的笛卡尔观测分别收集
+    std::vector<size_t> geodetic;
+    std::vector<size_t> cartesian;
+    const bool moved = m_hasOrigin && m_recenters > 0;
+    for (size_t i = 0; i < measurements.size(); ++i) {
+        const Measurement& m = measurements[i];
+        if (m.isGeodetic) {
+            geodetic.push_back(i);
+        } else if (moved && m.raw.size() == 0 && !m.hasCovariance) {
+            cartesian.push_back(i);
+        }
+    }
+
+    int dropped = 0;
+    if (!geodetic.empty() && !m_hasOrigin) {
+        for (size_t idx : geodetic) {
+            measurements[idx].observerId = std::numeric_limits<int>::min();
+        }
+        dropped = static_cast<int>(geodetic.size());
+        LOG_WARN("未配置跟踪原点，丢弃 " + QString::number(dropped) + " 条经纬高观测");
+        measurements.erase(std::remove_if(measurements.begin(), measurements.end(),
+                                          [](const Measurement& m) {
+            return m.observerId == std::numeric_limits<int>::min();
+        }), measurements.end());
+        return dropped;
+    }
+
+    if (!geodetic.empty()) {
+        const Eigen::Index count = static_cast<Eigen::Index>(geodetic.size());
+        Eigen::ArrayXd latitude(count), longitude(count), altitude(count);
+        for (Eigen::Index k = 0; k < count; ++k) {
+            const Vector3& lla = measurements[geodetic[k]].position;
+            latitude(k) = lla(0);
+            longitude(k) = lla(1);
+            altitude(k) = lla(2);
+        }
+
+        Eigen::Matrix3Xd ecef, local;
+        geodeticToEcef(latitude, longitude, altitude, ecef);
+        ecefToLocal(ecef, local);
+        for (Eigen::Index k = 0; k < count; ++k) {
+            Measurement& m = measurements[geodetic[k]];
+            m.position = local.col(k);
+            m.isGeodetic = false;
+        }
+    }
+
+    if (!cartesian.empty()) {
+        // 基准坐标 -> ECEF -> 当前跟踪坐标，合并为一次旋转加平移
+        const Eigen::Matrix3d rotation = m_current.rotation * m_base.rotation.transpose();
+        const Vector3 translation = m_current.rotation * (m_base.ecef - m_current.ecef);
+        const Eigen::Index count = static_cast<Eigen::Index>(cartesian.size());
+        Eigen::Matrix3Xd positions(3, count);
+        for (Eigen::Index k = 0; k < count; ++k) {
+            positions.col(k) = measurements[cartesian[k]].position;
+        }
+        positions = (rotation * positions).colwise() + translation;
+        for (Eigen::Index k = 0; k < count; ++k) {
+            measurements[cartesian[k]].position = positions.col(k);
+        }
+    }
+
+    return dropped;
+}
+
+
+bool GeodeticFrame::needsRecenter(const Vector3& center) const
+{
+    return m_hasOrigin && m_autoRecenter && center.head<2>().norm() > m_recenterDistance;
+}
+
+
+void GeodeticFrame::recenter(const Vector3& center, Eigen::Matrix3d& rotation, Vector3& translation)
+{
+    Eigen::Matrix3Xd local(3, 1), ecef;
+    local.col(0) = center;
+    localToEcef(local, ecef);
+
+    Eigen::ArrayXd latitude, longitude, altitude;
+    ecefToGeodetic(ecef, latitude, longitude, altitude);
+
+    const Origin next = makeOrigin(latitude(0), longitude(0), m_base.altitude);
+    rotation = next.rotation * m_current.rotation.transpose();
+    translation = next.rotation * (m_current.ecef - next.ecef);
+    m_current = next;
+    m_recenters++;
+
+    LOG_INFO("活动区域偏离跟踪原点 " + QString::number(center.head<2>().norm(), 'f', 0) +
+             "米，跟踪原点移动到 (" + QString::number(next.latitude / kDeg2Rad, 'f', 7) + ", " +
+             QString::number(next.longitude / kDeg2Rad, 'f', 7) + ")");
+}
+
+
+void GeodeticFrame::toOutputFrame(Eigen::Matrix3Xd& positions, Eigen::Matrix3Xd* velocities) const
+{
+    if (!m_hasOrigin) {
+        return;
+    }
+
+    switch (m_outputFrame) {
+    case OutputFrame::Enu: {
+        if (m_recenters == 0) {
+            return;
+        }
+        // 当前跟踪坐标 -> 基准坐标
+        const Eigen::Matrix3d rotation = m_base.rotation * m_current.rotation.transpose();
+        const Vector3 translation = m_base.rotation * (m_current.ecef - m_base.ecef);
+        positions = (rotation * positions).colwise() + translation;
+        if (velocities) {
+            *velocities = rotation * *velocities;
+        }
+        return;
+    }
+    case OutputFrame::Ecef: {
+        Eigen::Matrix3Xd ecef;
+        localToEcef(positions, ecef);
+        positions.swap(ecef);
+        if (velocities) {
+            *velocities = m_current.rotation.transpose() * *velocities;
+        }
+        return;
+    }
+    case OutputFrame::Geodetic: {
+        Eigen::Matrix3Xd ecef;
+        localToEcef(positions, ecef);
+        Eigen::ArrayXd latitude, longitude, altitude;
+        ecefToGeodetic(ecef, latitude, longitude, altitude);
+
+        if (velocities) {
+            // 速度先转到ECEF，再投影到每个目标自身的东北天方向
+            const Eigen::Matrix3Xd v = m_current.rotation.transpose() * *velocities;
+            const Eigen::ArrayXd vx = v.row(0).transpose().array();
+            const Eigen::ArrayXd vy = v.row(1).transpose().array();
+            const Eigen::ArrayXd vz = v.row(2).transpose().array();
+            const Eigen::ArrayXd sinLat = latitude.sin(), cosLat = latitude.cos();
+            const Eigen::ArrayXd sinLon = longitude.sin(), cosLon = longitude.cos();
+            velocities->row(0) = (-sinLon * vx + cosLon * vy).matrix().transpose();
+            velocities->row(1) = (-sinLat * cosLon * vx - sinLat * sinLon * vy + cosLat * vz).matrix().transpose();
+            velocities->row(2) = (cosLat * cosLon * vx + cosLat * sinLon * vy + sinLat * vz).matrix().transpose();
+        }
+
+        positions.row(0) = (latitude / kDeg2Rad).matrix().transpose();
+        positions.row(1) = (longitude / kDeg2Rad).matrix().transpose();
+        positions.row(2) = altitude.matrix().transpose();
+        return;
+    }
+    }
+}
+
+
+void GeodeticFrame::publishMetrics() const
+{
+    nlohmann::json metrics;
+    metrics["hasOrigin"] = m_hasOrigin;
+    metrics["outputFrame"] = outputFrameName();
+    if (m_hasOrigin) {
+        metrics["origin"] = {m_base.latitude / kDeg2Rad, m_base.longitude / kDeg2Rad, m_base.altitude};
+        metrics["trackingOrigin"] = {m_current.latitude / kDeg2Rad, m_current.longitude / kDeg2Rad,
+                                     m_current.altitude};
+        metrics["recenters"] = m_recenters;
+    }
+    g_Metrics.setSection("frame", metrics);
+}
+
+
+GeodeticFrame::Origin GeodeticFrame::makeOrigin(double latitude, double longitude, double altitude)
+{
+    Origin origin;
+    origin.latitude = latitude;
+    origin.longitude = longitude;
+    origin.altitude = altitude;
+
+    Eigen::Matrix3Xd ecef;
+    geodeticToEcef(Eigen::ArrayXd::Constant(1, latitude), Eigen::ArrayXd::Constant(1, longitude),
+                   Eigen::ArrayXd::Constant(1, altitude), ecef);
+    origin.ecef = ecef.col(0);
+
+    const double sinLat = std::sin(latitude), cosLat = std::cos(latitude);
+    const double sinLon = std::sin(longitude), cosLon = std::cos(longitude);
+    origin.rotation << -sinLon, cosLon, 0.0,
+                       -sinLat * cosLon, -sinLat * sinLon, cosLat,
+                       cosLat * cosLon, cosLat * sinLon, sinLat;
+    return origin;
+}
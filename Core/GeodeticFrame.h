@@ -0,0 +1,244 @@
+/**
+ * @file GeodeticFrame.h
+ * @brief 大地坐标系转换头文件
+ * @details 定义了GeodeticFrame类，负责WGS84大地坐标、地心地固坐标(ECEF)与跟踪用东北天坐标(ENU)之间的批量转换
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef GEODETICFRAME_H
+#define GEODETICFRAME_H
+
+#include "DataStructures.h"
+#include <QString>
+#include <vector>
+
+/**
+ * @brief 大地坐标系转换类
+ * @details 跟踪在以原点为切点的东北天坐标系中进行。配置的原点定义基准坐标系，
+ *          笛卡尔观测和传感器位置均以基准坐标系给出；经纬高观测在接收时标记，
+ *          在处理周期内批量换算到当前跟踪坐标系。
+ *          大范围跟踪时东北天坐标系远离原点处的地球曲率误差增大，启用自动重定中心后，
+ *          活动区域偏离原点超过重定中心距离时跟踪原点移动到活动区域，
+ *          调用方按返回的刚体变换同步航迹、候选和传感器位姿。
+ *          所有批量转换都以Eigen数组表达式整体计算，由Eigen向量化为SIMD指令。
+ *          使用单例模式，只在工作线程中使用
+ */
+class GeodeticFrame
+{
+public:
+    /**
+     * @brief 输出坐标系
+     */
+    enum class OutputFrame {
+        Enu,       ///< 基准东北天坐标系(米)
+        Ecef,      ///< 地心地固坐标系(米)
+        Geodetic   ///< 经纬高(度、度、米)，速度为目标处的东北天分量
+    };
+
+    /**
+     * @brief 获取坐标系转换单例实例
+     * @return 坐标系转换实例的引用
+     */
+    static GeodeticFrame& instance();
+
+    /**
+     * @brief 是否配置了原点
+     * @return 配置了原点返回true，未配置时不能接收经纬高观测，输出只能为东北天坐标
+     */
+    bool hasOrigin() const;
+
+    /**
+     * @brief 设置基准原点，同时重置跟踪原点
+     * @param latitude 纬度(弧度)
+     * @param longitude 经度(弧度)
+     * @param altitude 椭球高(米)
+     */
+    void setOrigin(double latitude, double longitude, double altitude);
+
+    /**
+     * @brief 获取输出坐标系
+     * @return 输出坐标系
+     */
+    OutputFrame outputFrame() const;
+
+    /**
+     * @brief 获取输出坐标系名称
+     * @return "enu"、"ecef" 或 "geodetic"
+     */
+    const char* outputFrameName() const;
+
+    /**
+     * @brief 获取发布坐标系
+     * @return 输出坐标系为ECEF时为ECEF，否则为基准东北天坐标系
+     * @details 航迹快照、外推、共享内存航迹表和区域过滤使用的笛卡尔坐标系，不随跟踪原点移动
+     */
+    OutputFrame publishFrame() const;
+
+    /**
+     * @brief 获取发布坐标系名称
+     * @return "enu" 或 "ecef"
+     */
+    const char* publishFrameName() const;
+
+    /**
+     * @brief 当前跟踪坐标系到发布坐标系的刚体变换
+     * @param rotation 输出，旋转矩阵
+     * @param translation 输出，平移，x' = R x + t
+     * @return 两坐标系不同时返回true；相同时返回false，输出为单位变换
+     */
+    bool publishTransform(Eigen::Matrix3d& rotation, Vector3& translation) const;
+
+    /**
+     * @brief 批量将经纬高转换为ECEF
+     * @param latitude 纬度数组(弧度)
+     * @param longitude 经度数组(弧度)
+     * @param altitude 椭球高数组(米)
+     * @param ecef 输出，每列为一个ECEF位置
+     */
+    static void geodeticToEcef(const Eigen::ArrayXd& latitude, const Eigen::ArrayXd& longitude,
+                               const Eigen::ArrayXd& altitude, Eigen::Matrix3Xd& ecef);
+
+    /**
+     * @brief 批量将ECEF转换为经纬高
+     * @param ecef 每列为一个ECEF位置
+     * @param latitude 输出，纬度数组(弧度)
+     * @param longitude 输出，经度数组(弧度)
+     * @param altitude 输出，椭球高数组(米)
+     * @details 使用Heikkinen闭式解，无迭代，全椭球范围内精度优于毫米
+     */
+    static void ecefToGeodetic(const Eigen::Matrix3Xd& ecef, Eigen::ArrayXd& latitude,
+                               Eigen::ArrayXd& longitude, Eigen::ArrayXd& altitude);
+
+    /**
+     * @brief 批量将ECEF位置转换到当前跟踪坐标系
+     * @param ecef 每列为一个ECEF位置
+     * @param local 输出，每列为一个跟踪坐标系位置
+     */
+    void ecefToLocal(const Eigen::Matrix3Xd& ecef, Eigen::Matrix3Xd& local) const;
+
+    /**
+     * @brief 批量将当前跟踪坐标系位置转换为ECEF
+     * @param local 每列为一个跟踪坐标系位置
+     * @param ecef 输出，每列为一个ECEF位置
+     */
+    void localToEcef(const Eigen::Matrix3Xd& local, Eigen::Matrix3Xd& ecef) const;
+
+    /**
+     * @brief 将本周期观测统一到当前跟踪坐标系
+     * @param measurements 观测数据，原地修改
+     * @return 因未配置原点而丢弃的经纬高观测数
+     * @details 经纬高观测批量换算为跟踪坐标系位置；跟踪原点已移动时，
+     *          以基准坐标系给出的笛卡尔观测变换到当前跟踪坐标系。带原始观测的非笛卡尔观测不处理
+     */
+    int convertToLocal(std::vector<Measurement>& measurements) const;
+
+    /**
+     * @brief 活动区域是否需要重定中心
+     * @param center 活动区域中心(当前跟踪坐标系)
+     * @return 启用自动重定中心且中心的水平距离超过重定中心距离时返回true
+     */
+    bool needsRecenter(const Vector3& center) const;
+
+    /**
+     * @brief 将跟踪原点移动到指定位置
+     * @param center 新原点(当前跟踪坐标系)，高度取基准原点高度
+     * @param rotation 输出，旧跟踪坐标到新跟踪坐标的旋转
+     * @param translation 输出，旧跟踪坐标到新跟踪坐标的平移，x' = R x + t
+     */
+    void recenter(const Vector3& center, Eigen::Matrix3d& rotation, Vector3& translation);
+
+    /**
+     * @brief 将跟踪坐标系下的位置和速度批量转换到输出坐标系
+     * @param positions 每列为一个位置，原地转换；经纬高输出时各行为纬度、经度(度)和高度
+     * @param velocities 每列为一个速度，原地转换；经纬高输出时各行为东、北、天分量；可为nullptr
+     */
+    void toOutputFrame(Eigen::Matrix3Xd& positions, Eigen::Matrix3Xd* velocities) const;
+
+    /**
+     * @brief 发布坐标系指标
+     */
+    void publishMetrics() const;
+
+private:
+    /**
+     * @brief 东北天坐标系原点
+     */
+    struct Origin {
+        double latitude = 0.0;                                ///< 纬度(弧度)
+        double longitude = 0.0;                               ///< 经度(弧度)
+        double altitude = 0.0;                                ///< 椭球高(米)
+        Vector3 ecef = Vector3::Zero();                       ///< 原点的ECEF位置
+        Eigen::Matrix3d rotation = Eigen::Matrix3d::Identity(); ///< ECEF到东北天的旋转
+    };
+
+    /**
+     * @brief 私有构造函数
+     * @details 从配置文件 Frame 分组读取原点、自动重定中心和输出坐标系
+     */
+    GeodeticFrame();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    GeodeticFrame(const GeodeticFrame&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    GeodeticFrame& operator=(const GeodeticFrame&) = delete;
+
+    /**
+     * @brief 由经纬高构造原点
+     * @param latitude 纬度(弧度)
+     * @param longitude 经度(弧度)
+     * @param altitude 椭球高(米)
+     * @return 原点
+     */
+    static Origin makeOrigin(double latitude, double longitude, double altitude);
+
+    /**
+     * @brief 坐标系名称
+     * @param frame 坐标系
+     * @return "enu"、"ecef" 或 "geodetic"
+     */
+    static const char* frameName(OutputFrame frame);
+
+private:
+    /**
+     * @brief 是否配置了原点
+     */
+    bool m_hasOrigin;
+
+    /**
+     * @brief 基准原点，笛卡尔观测、传感器位置和东北天输出使用的坐标系
+     */
+    Origin m_base;
+
+    /**
+     * @brief 当前跟踪原点
+     */
+    Origin m_current;
+
+    /**
+     * @brief 是否启用自动重定中心
+     */
+    bool m_autoRecenter;
+
+    /**
+     * @brief 重定中心距离(米)
+     */
+    double m_recenterDistance;
+
+    /**
+     * @brief 输出坐标系
+     */
+    OutputFrame m_outputFrame;
+
+    /**
+     * @brief 累计重定中心次数
+     */
+    int m_recenters;
+};
+
+#endif // GEODETICFRAME_H
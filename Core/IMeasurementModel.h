@@ -0,0 +1,93 @@
+/**
+ * @file IMeasurementModel.h
+ * @brief 观测模型接口头文件
+ * @details 定义了观测模型的抽象接口，用于将目标状态映射到不同类型传感器的观测空间
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef IMEASUREMENTMODEL_H
+#define IMEASUREMENTMODEL_H
+
+#include "IMotionModel.h"
+#include "DataStructures.h"
+
+/**
+ * @brief 观测模型接口类
+ * @details 不同传感器的观测维度和观测方程各不相同(笛卡尔位置、距离/方位/俯仰等)，
+ *          观测模型描述状态到观测的映射，与运动模型相互独立，可任意组合
+ */
+class IMeasurementModel
+{
+public:
+    /**
+     * @brief 虚析构函数
+     */
+    virtual ~IMeasurementModel() = default;
+
+    /**
+     * @brief 获取观测向量的维度
+     * @return 观测向量的维度(不超过4)
+     */
+    virtual int dim() const = 0;
+
+    /**
+     * @brief 是否为线性观测模型
+     * @return 线性模型返回true
+     * @details 约定线性模型的观测即状态向量的前dim()个分量，
+     *          滤波器可据此跳过立方点计算，直接使用线性卡尔曼更新
+     */
+    virtual bool isLinear() const = 0;
+
+    /**
+     * @brief 观测映射函数
+     * @param x 状态向量(前3维为位置，其后3维为速度)
+     * @return 对应的观测向量
+     */
+    virtual ObservationVector observe(const StateVector& x) const = 0;
+
+    /**
+     * @brief 计算观测残差
+     * @param z 实际观测
+     * @param zPred 预测观测
+     * @return 残差 z - zPred
+     * @details 含角度分量的模型需要重写此函数，将角度差规整到(-pi, pi]
+     */
+    virtual ObservationVector residual(const ObservationVector& z, const ObservationVector& zPred) const
+    {
+        return z - zPred;
+    }
+
+    /**
+     * @brief 将观测转换为笛卡尔位置
+     * @param z 观测向量
+     * @return 跟踪坐标系下的位置
+     * @details 用于数据关联和航迹起始
+     */
+    virtual Vector3 toCartesian(const ObservationVector& z) const = 0;
+};
+
+/**
+ * @brief 一个传感器观测块
+ * @details 多传感器联合更新时，每个观测者的观测连同其观测模型和噪声组成一个块，
+ *          所有块堆叠后进行一次更新
+ */
+struct ObservationBlock
+{
+    /**
+     * @brief 观测模型
+     */
+    const IMeasurementModel* model;
+
+    /**
+     * @brief 观测向量
+     */
+    ObservationVector z;
+
+    /**
+     * @brief 观测噪声协方差矩阵
+     */
+    ObservationNoise R;
+};
+
+#endif // IMEASUREMENTMODEL_H
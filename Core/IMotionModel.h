@@ -12,11 +12,24 @@
 #include <Eigen/Dense>
 #include <functional>
 
+/**
+ * @brief 状态向量的最大维度
+ * @details 匀加速模型为9维，其余模型不超过该维度
+ */
+const int kMaxStateDim = 9;
+
 /**
  * @brief 状态向量类型别名
- * @details 使用Eigen的动态向量表示目标状态
+ * @details 维度可变(匀速6维、匀加速9维)，使用最多kMaxStateDim维的定长存储，预测和更新时不分配堆内存；
+ *          不要求对齐，可以安全地放入标准容器
  */
-using StateVector = Eigen::VectorXd;
+using StateVector = Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::DontAlign, kMaxStateDim, 1>;
+
+/**
+ * @brief 状态协方差类型别名
+ * @details 与StateVector对应，最多kMaxStateDim x kMaxStateDim，使用定长存储
+ */
+using StateMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign, kMaxStateDim, kMaxStateDim>;
 
 /**
  * @brief 观测向量类型别名
@@ -24,6 +37,12 @@ using StateVector = Eigen::VectorXd;
  */
 using MeasurementVector = Eigen::Vector3d;
 
+/**
+ * @brief 观测噪声协方差类型别名
+ * @details 与观测向量维度一致的定长矩阵，避免每次更新时的堆内存分配
+ */
+using MeasurementNoise = Eigen::Matrix3d;
+
 /**
  * @brief 运动模型接口类
  * @details 定义了所有运动模型必须实现的方法，用于目标状态预测和观测映射
@@ -74,14 +93,14 @@ public:
      * @return 过程噪声协方差矩阵Q
      * @details 计算与时间步长相关的过程噪声协方差矩阵
      */
-    virtual Eigen::MatrixXd getProcessNoiseMatrix(double dt) const = 0;
+    virtual StateMatrix getProcessNoiseMatrix(double dt) const = 0;
 
     /**
      * @brief 获取初始协方差矩阵
      * @return 初始状态协方差矩阵P0
      * @details 返回新创建航迹的初始不确定性矩阵
      */
-    virtual Eigen::MatrixXd getInitialCovariance() const = 0;
+    virtual StateMatrix getInitialCovariance() const = 0;
 };
 
 #endif // IMOTIONMODEL_H
@@ -0,0 +1,583 @@
+/**
+ * @file ImmFilter.cpp
+ * @brief 交互式多模型滤波器实现文件
+ * @details 实现了CV/CA/CT三模型的交互、预测、共享观测更新和模型概率计算
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "ImmFilter.h"
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/**
+ * @brief IMM参数
+ * @details 所有航迹共用，首次使用时从配置文件读取一次
+ */
+struct ImmParameters {
+    double cvNoiseStd;            ///< CV模型加速度噪声标准差
+    double caNoiseStd;            ///< CA模型加加速度噪声标准差
+    double ctNoiseStd;            ///< CT模型加速度噪声标准差
+    double ctTurnRateNoiseStd;    ///< CT模型转弯率噪声标准差
+    double initialPosition;       ///< 初始位置方差
+    double initialVelocity;       ///< 初始速度方差
+    double initialAcceleration;   ///< 初始加速度方差
+    double initialTurnRate;       ///< 初始转弯率方差
+    double skipThreshold;         ///< 模型休眠概率阈值
+    double revivalNis;            ///< 唤醒休眠模型的NIS门限(按3维观测)
+    Eigen::Matrix3d transition;   ///< 模型转移概率矩阵，transition(i, j) 为 i->j 的概率
+
+    ImmParameters()
+    {
+        QSettings settings("Server.ini", QSettings::IniFormat);
+        const double processNoiseStd = settings.value("KalmanFilter/processNoiseStd", 1.0).toDouble();
+        cvNoiseStd = settings.value("IMM/cvProcessNoiseStd", 0.5).toDouble();
+        caNoiseStd = settings.value("IMM/caProcessNoiseStd", processNoiseStd).toDouble();
+        ctNoiseStd = settings.value("IMM/ctProcessNoiseStd", 0.5).toDouble();
+        ctTurnRateNoiseStd = settings.value("IMM/ctTurnRateNoiseStd", 0.05).toDouble();
+        initialPosition = settings.value("KalmanFilter/initialPositionUncertainty", 10.0).toDouble();
+        initialVelocity = settings.value("KalmanFilter/initialVelocityUncertainty", 100.0).toDouble();
+        initialAcceleration = settings.value("KalmanFilter/initialAccelerationUncertainty", 10.0).toDouble();
+        initialTurnRate = settings.value("IMM/initialTurnRateUncertainty", 0.01).toDouble();
+        skipThreshold = settings.value("IMM/skipThreshold", 0.01).toDouble();
+        revivalNis = settings.value("IMM/revivalNis", 11.34).toDouble();
+
+        const double stay = settings.value("IMM/stayProbability", 0.95).toDouble();
+        transition.setConstant((1.0 - stay) / (ImmFilter::ModelCount - 1));
+        transition.diagonal().setConstant(stay);
+    }
+};
+
+const ImmParameters& parameters()
+{
+    static const ImmParameters params;
+    return params;
+}
+
+// 各模型在公共空间 [p(0-2), v(3-5), a(6-8), omega(9)] 中直接含有的分量
+const int kCvIndex[6] = {0, 1, 2, 3, 4, 5};
+const int kCaIndex[9] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+const int kCtIndex[7] = {0, 1, 2, 3, 4, 5, 9};
+
+const int kCvMask = 0x03F;
+const int kCaMask = 0x1FF;
+const int kCtMask = 0x3FF;  // 加速度由 omega x v 导出
+
+template <int N>
+void scatter(const Eigen::Matrix<double, N, 1>& x, const Eigen::Matrix<double, N, N>& P, const int* index,
+             ImmFilter::CommonVector& xc, ImmFilter::CommonMatrix& Pc)
+{
+    for (int r = 0; r < N; ++r) {
+        xc(index[r]) = x(r);
+        for (int c = 0; c < N; ++c) {
+            Pc(index[r], index[c]) = P(r, c);
+        }
+    }
+}
+
+template <int N>
+void gather(const ImmFilter::CommonVector& xc, const ImmFilter::CommonMatrix& Pc, const int* index,
+            Eigen::Matrix<double, N, 1>& x, Eigen::Matrix<double, N, N>& P)
+{
+    for (int r = 0; r < N; ++r) {
+        x(r) = xc(index[r]);
+        for (int c = 0; c < N; ++c) {
+            P(r, c) = Pc(index[r], index[c]);
+        }
+    }
+}
+
+// 位置观测的线性卡尔曼更新，H = [I 0]
+template <int N>
+InnovationStats positionUpdate(Eigen::Matrix<double, N, 1>& x, Eigen::Matrix<double, N, N>& P,
+                               const Vector3& z, const Eigen::Matrix3d& R)
+{
+    const Eigen::Matrix3d S = P.template topLeftCorner<3, 3>() + R;
+    const Eigen::LLT<Eigen::Matrix3d> llt(S);
+    const Vector3 innovation = z - x.template head<3>();
+    const Eigen::Matrix<double, N, 3> PHt = P.template leftCols<3>();
+    const Eigen::Matrix<double, N, 3> K = llt.solve(PHt.transpose()).transpose();
+    x += K * innovation;
+    P -= K * PHt.transpose();
+
+    InnovationStats stats;
+    stats.dim = 3;
+    stats.nis = innovation.dot(llt.solve(innovation));
+    stats.logDetS = 2.0 * llt.matrixLLT().diagonal().array().log().sum();
+    return stats;
+}
+
+// 任意观测块的更新，借用可变维度的CKF堆叠更新，状态和协方差均为定长存储
+template <int N>
+InnovationStats stackedUpdate(CKF& ckf, Eigen::Matrix<double, N, 1>& x, Eigen::Matrix<double, N, N>& P,
+                              const std::vector<ObservationBlock>& blocks)
+{
+    StateVector xd = x;
+    StateMatrix Pd = P;
+    const InnovationStats stats = ckf.updateStacked(xd, Pd, blocks);
+    x = xd;
+    P = Pd;
+    return stats;
+}
+
+} // namespace
+
+
+ImmFilter::ImmFilter(const Vector3& position)
+{
+    const ImmParameters& params = parameters();
+
+    m_cv.x.setZero();
+    m_cv.x.head<3>() = position;
+    m_cv.P.setZero();
+    m_cv.P.diagonal() << Vector3::Constant(params.initialPosition), Vector3::Constant(params.initialVelocity);
+
+    m_ca.x.setZero();
+    m_ca.x.head<3>() = position;
+    m_ca.P.setZero();
+    m_ca.P.diagonal() << Vector3::Constant(params.initialPosition), Vector3::Constant(params.initialVelocity),
+                         Vector3::Constant(params.initialAcceleration);
+
+    m_ct.x.setZero();
+    m_ct.x.head<3>() = position;
+    m_ct.P.setZero();
+    m_ct.P.diagonal() << Vector3::Constant(params.initialPosition), Vector3::Constant(params.initialVelocity),
+                         params.initialTurnRate;
+
+    m_probabilities.setConstant(1.0 / ModelCount);
+    for (int j = 0; j < ModelCount; ++j) {
+        m_active[j] = true;
+    }
+    m_skipThreshold = params.skipThreshold;
+    combine(m_combinedX, m_combinedP);
+}
+
+
+void ImmFilter::seed(const Vector3& velocity, const StateMatrix& covariance)
+{
+    m_cv.x.segment<3>(3) = velocity;
+    m_cv.P = covariance;
+
+    m_ca.x.segment<3>(3) = velocity;
+    m_ca.P.topLeftCorner<6, 6>() = covariance;
+    m_ca.P.topRightCorner<6, 3>().setZero();
+    m_ca.P.bottomLeftCorner<3, 6>().setZero();
+
+    m_ct.x.segment<3>(3) = velocity;
+    m_ct.P.topLeftCorner<6, 6>() = covariance;
+    m_ct.P.topRightCorner<6, 1>().setZero();
+    m_ct.P.bottomLeftCorner<1, 6>().setZero();
+
+    combine(m_combinedX, m_combinedP);
+}
+
+
+void ImmFilter::transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation)
+{
+    Eigen::Matrix<double, 9, 9> T = Eigen::Matrix<double, 9, 9>::Zero();
+    for (int k = 0; k < 9; k += 3) {
+        T.block<3, 3>(k, k) = rotation;
+    }
+
+    const Eigen::Matrix<double, 6, 6> Tcv = T.topLeftCorner<6, 6>();
+    m_cv.x = Tcv * m_cv.x;
+    m_cv.x.head<3>() += translation;
+    m_cv.P = Tcv * m_cv.P * Tcv.transpose();
+
+    m_ca.x = T * m_ca.x;
+    m_ca.x.head<3>() += translation;
+    m_ca.P = T * m_ca.P * T.transpose();
+
+    Eigen::Matrix<double, 7, 7> Tct = Eigen::Matrix<double, 7, 7>::Identity();
+    Tct.topLeftCorner<6, 6>() = Tcv;
+    m_ct.x = Tct * m_ct.x;
+    m_ct.x.head<3>() += translation;
+    m_ct.P = Tct * m_ct.P * Tct.transpose();
+
+    combine(m_combinedX, m_combinedP);
+}
+
+
+void ImmFilter::predict(double dt)
+{
+    const ImmParameters& params = parameters();
+
+    // 1. 确定本周期活跃的模型，概率最大的模型始终活跃；由休眠转为活跃的模型从组合估计重新初始化
+    int best = 0;
+    m_probabilities.maxCoeff(&best);
+    for (int j = 0; j < ModelCount; ++j) {
+        const bool active = j == best || m_probabilities(j) >= m_skipThreshold;
+        if (active && !m_active[j]) {
+            fromCommon(j, m_combinedX, m_combinedP);
+        }
+        m_active[j] = active;
+    }
+
+    // 2. 模型预测概率 c_j = sum_i p_ij * mu_i
+    const Eigen::Vector3d predicted = params.transition.transpose() * m_probabilities;
+
+    // 3. 在公共空间中交互，源模型缺少的分量用目标模型自身的估计补齐
+    CommonVector sourceX[ModelCount];
+    CommonMatrix sourceP[ModelCount];
+    int sourceMask[ModelCount];
+    for (int i = 0; i < ModelCount; ++i) {
+        if (m_active[i]) {
+            sourceMask[i] = toCommon(i, sourceX[i], sourceP[i]);
+        }
+    }
+
+    CommonVector mixedX[ModelCount];
+    CommonMatrix mixedP[ModelCount];
+    for (int j = 0; j < ModelCount; ++j) {
+        if (!m_active[j]) continue;
+
+        double weightSum = 0.0;
+        for (int i = 0; i < ModelCount; ++i) {
+            if (m_active[i]) weightSum += params.transition(i, j) * m_probabilities(i);
+        }
+
+        mixedX[j].setZero();
+        mixedP[j].setZero();
+        CommonVector filledX[ModelCount];
+        CommonMatrix filledP[ModelCount];
+        for (int i = 0; i < ModelCount; ++i) {
+            if (!m_active[i]) continue;
+
+            filledX[i] = sourceX[i];
+            filledP[i] = sourceP[i];
+            if (i != j) {
+                for (int k = 0; k < kCommonDim; ++k) {
+                    if (sourceMask[i] & (1 << k)) continue;
+                    filledX[i](k) = sourceX[j](k);
+                    for (int l = 0; l < kCommonDim; ++l) {
+                        const double value = (sourceMask[i] & (1 << l)) ? 0.0 : sourceP[j](k, l);
+                        filledP[i](k, l) = value;
+                        filledP[i](l, k) = value;
+                    }
+                }
+            }
+            const double weight = weightSum > 0.0 ? params.transition(i, j) * m_probabilities(i) / weightSum : 0.0;
+            mixedX[j] += weight * filledX[i];
+        }
+        for (int i = 0; i < ModelCount; ++i) {
+            if (!m_active[i]) continue;
+            const double weight = weightSum > 0.0 ? params.transition(i, j) * m_probabilities(i) / weightSum : 0.0;
+            const CommonVector diff = filledX[i] - mixedX[j];
+            mixedP[j] += weight * (filledP[i] + diff * diff.transpose());
+        }
+    }
+
+    // 4. 各活跃模型以交互后的初值预测
+    for (int j = 0; j < ModelCount; ++j) {
+        if (!m_active[j]) continue;
+        fromCommon(j, mixedX[j], mixedP[j]);
+        predictModel(j, dt);
+    }
+
+    m_probabilities = predicted;
+    combine(m_combinedX, m_combinedP);
+}
+
+
+InnovationStats ImmFilter::update(const std::vector<ObservationBlock>& blocks)
+{
+    const ImmParameters& params = parameters();
+
+    // 1. 全部为三维笛卡尔观测时，先融合为一个等效观测，所有模型共享
+    bool allPosition = !blocks.empty();
+    for (const auto& block : blocks) {
+        allPosition = allPosition && block.model->isLinear() && block.model->dim() == 3;
+    }
+
+    Vector3 zFused = Vector3::Zero();
+    Eigen::Matrix3d RFused = Eigen::Matrix3d::Zero();
+    if (allPosition) {
+        if (blocks.size() == 1) {
+            zFused = blocks.front().z;
+            RFused = blocks.front().R;
+        } else {
+            Eigen::Matrix3d information = Eigen::Matrix3d::Zero();
+            Vector3 informationVector = Vector3::Zero();
+            for (const auto& block : blocks) {
+                const Eigen::Matrix3d Rinv = Eigen::Matrix3d(block.R).inverse();
+                information += Rinv;
+                informationVector += Rinv * Vector3(block.z);
+            }
+            RFused = information.inverse();
+            zFused = RFused * informationVector;
+        }
+    }
+
+    auto updateModel = [&](int j) {
+        return allPosition ? updateModelPosition(j, zFused, RFused) : updateModelStacked(j, blocks);
+    };
+
+    // 2. 更新活跃模型
+    InnovationStats stats[ModelCount];
+    double minNisRatio = std::numeric_limits<double>::max();
+    for (int j = 0; j < ModelCount; ++j) {
+        if (!m_active[j]) continue;
+        stats[j] = updateModel(j);
+        if (stats[j].dim > 0) {
+            minNisRatio = std::min(minNisRatio, stats[j].nis / stats[j].dim);
+        }
+    }
+    if (minNisRatio == std::numeric_limits<double>::max()) {
+        return InnovationStats();
+    }
+
+    // 3. 所有活跃模型都无法解释观测时唤醒休眠模型
+    if (minNisRatio > params.revivalNis / 3.0) {
+        for (int j = 0; j < ModelCount; ++j) {
+            if (m_active[j]) continue;
+            fromCommon(j, m_combinedX, m_combinedP);
+            stats[j] = updateModel(j);
+            m_active[j] = true;
+        }
+    }
+
+    // 4. 模型概率更新 mu_j ∝ c_j * L_j，休眠模型的似然取活跃模型中的最小值
+    double maxLog = -std::numeric_limits<double>::max();
+    double minLog = std::numeric_limits<double>::max();
+    for (int j = 0; j < ModelCount; ++j) {
+        if (!m_active[j]) continue;
+        maxLog = std::max(maxLog, stats[j].logLikelihood());
+        minLog = std::min(minLog, stats[j].logLikelihood());
+    }
+    for (int j = 0; j < ModelCount; ++j) {
+        const double logLikelihood = m_active[j] ? stats[j].logLikelihood() : minLog;
+        m_probabilities(j) *= std::exp(logLikelihood - maxLog);
+    }
+    const double total = m_probabilities.sum();
+    if (total > 0.0 && std::isfinite(total)) {
+        m_probabilities /= total;
+    } else {
+        m_probabilities.setConstant(1.0 / ModelCount);
+    }
+
+    combine(m_combinedX, m_combinedP);
+
+    int best = 0;
+    m_probabilities.maxCoeff(&best);
+    return m_active[best] ? stats[best] : InnovationStats();
+}
+
+
+void ImmFilter::getEstimate(StateVector& x, StateMatrix& P) const
+{
+    x = m_combinedX.head<9>();
+    P = m_combinedP.topLeftCorner<9, 9>();
+}
+
+
+const Eigen::Vector3d& ImmFilter::modelProbabilities() const
+{
+    return m_probabilities;
+}
+
+
+int ImmFilter::activeModelCount() const
+{
+    return static_cast<int>(std::count(m_active, m_active + ModelCount, true));
+}
+
+
+void ImmFilter::setSkipThreshold(double threshold)
+{
+    m_skipThreshold = std::max(0.0, threshold);
+}
+
+
+int ImmFilter::toCommon(int model, CommonVector& x, CommonMatrix& P) const
+{
+    const ImmParameters& params = parameters();
+
+    x.setZero();
+    P.setZero();
+    P.diagonal().segment<3>(6).setConstant(params.initialAcceleration);
+    P(9, 9) = params.initialTurnRate;
+
+    switch (model) {
+    case CV:
+        scatter<6>(m_cv.x, m_cv.P, kCvIndex, x, P);
+        return kCvMask;
+    case CA:
+        scatter<9>(m_ca.x, m_ca.P, kCaIndex, x, P);
+        return kCaMask;
+    default: {
+        // CT的加速度 a = omega x v (水平面)，协方差经雅可比矩阵线性化
+        Eigen::Matrix<double, kCommonDim, 7> J = Eigen::Matrix<double, kCommonDim, 7>::Zero();
+        J.topLeftCorner<6, 6>().setIdentity();
+        J(9, 6) = 1.0;
+        const double vx = m_ct.x(3), vy = m_ct.x(4), omega = m_ct.x(6);
+        J(6, 4) = -omega;
+        J(6, 6) = -vy;
+        J(7, 3) = omega;
+        J(7, 6) = vx;
+
+        x.head<6>() = m_ct.x.head<6>();
+        x(6) = -omega * vy;
+        x(7) = omega * vx;
+        x(9) = omega;
+        P = J * m_ct.P * J.transpose();
+        return kCtMask;
+    }
+    }
+}
+
+
+void ImmFilter::fromCommon(int model, const CommonVector& x, const CommonMatrix& P)
+{
+    switch (model) {
+    case CV:
+        gather<6>(x, P, kCvIndex, m_cv.x, m_cv.P);
+        break;
+    case CA:
+        gather<9>(x, P, kCaIndex, m_ca.x, m_ca.P);
+        break;
+    default:
+        gather<7>(x, P, kCtIndex, m_ct.x, m_ct.P);
+        break;
+    }
+}
+
+
+void ImmFilter::combine(CommonVector& x, CommonMatrix& P) const
+{
+    CommonVector modelX[ModelCount];
+    CommonMatrix modelP[ModelCount];
+    double weightSum = 0.0;
+    for (int j = 0; j < ModelCount; ++j) {
+        if (!m_active[j]) continue;
+        toCommon(j, modelX[j], modelP[j]);
+        weightSum += m_probabilities(j);
+    }
+
+    x.setZero();
+    for (int j = 0; j < ModelCount; ++j) {
+        if (m_active[j]) x += m_probabilities(j) / weightSum * modelX[j];
+    }
+    P.setZero();
+    for (int j = 0; j < ModelCount; ++j) {
+        if (!m_active[j]) continue;
+        const CommonVector diff = modelX[j] - x;
+        P += m_probabilities(j) / weightSum * (modelP[j] + diff * diff.transpose());
+    }
+}
+
+
+void ImmFilter::predictModel(int model, double dt)
+{
+    const ImmParameters& params = parameters();
+    const double dt2 = dt * dt;
+    const Eigen::Matrix3d I = Eigen::Matrix3d::Identity();
+
+    switch (model) {
+    case CV: {
+        Eigen::Matrix<double, 6, 6> F = Eigen::Matrix<double, 6, 6>::Identity();
+        F.topRightCorner<3, 3>() = I * dt;
+        Eigen::Matrix<double, 6, 3> G;
+        G << I * (0.5 * dt2), I * dt;
+
+        m_cv.x.head<3>() += m_cv.x.tail<3>() * dt;
+        m_cv.P = F * m_cv.P * F.transpose() + G * G.transpose() * (params.cvNoiseStd * params.cvNoiseStd);
+        break;
+    }
+    case CA: {
+        Eigen::Matrix<double, 9, 9> F = Eigen::Matrix<double, 9, 9>::Identity();
+        F.block<3, 3>(0, 3) = I * dt;
+        F.block<3, 3>(0, 6) = I * (0.5 * dt2);
+        F.block<3, 3>(3, 6) = I * dt;
+
+        // 离散白噪声加加速度模型，与ConstantAccelerationModel一致
+        const double dt3 = dt2 * dt, dt4 = dt3 * dt, dt5 = dt4 * dt;
+        Eigen::Matrix<double, 9, 9> Q;
+        Q << I * (dt5 / 20.0), I * (dt4 / 8.0), I * (dt3 / 6.0),
+             I * (dt4 / 8.0),  I * (dt3 / 3.0), I * (dt2 / 2.0),
+             I * (dt3 / 6.0),  I * (dt2 / 2.0), I * dt;
+
+        m_ca.x = F * m_ca.x;
+        m_ca.P = F * m_ca.P * F.transpose() + Q * (params.caNoiseStd * params.caNoiseStd);
+        break;
+    }
+    default: {
+        // 水平面协调转弯，垂直方向匀速；转弯率趋近零时取极限形式
+        const double vx = m_ct.x(3), vy = m_ct.x(4), omega = m_ct.x(6);
+        const double wt = omega * dt;
+        const double s = std::sin(wt), c = std::cos(wt);
+
+        double sinTerm, cosTerm, dSinTerm, dCosTerm;  // sin(wT)/w, (1-cos(wT))/w 及其对w的导数
+        if (std::abs(omega) > 1e-6) {
+            sinTerm = s / omega;
+            cosTerm = (1.0 - c) / omega;
+            dSinTerm = (dt * c * omega - s) / (omega * omega);
+            dCosTerm = (dt * s * omega - (1.0 - c)) / (omega * omega);
+        } else {
+            sinTerm = dt;
+            cosTerm = 0.5 * omega * dt2;
+            dSinTerm = -omega * dt2 * dt / 3.0;
+            dCosTerm = 0.5 * dt2;
+        }
+
+        Eigen::Matrix<double, 7, 7> F = Eigen::Matrix<double, 7, 7>::Identity();
+        F(0, 3) = sinTerm;
+        F(0, 4) = -cosTerm;
+        F(0, 6) = vx * dSinTerm - vy * dCosTerm;
+        F(1, 3) = cosTerm;
+        F(1, 4) = sinTerm;
+        F(1, 6) = vx * dCosTerm + vy * dSinTerm;
+        F(2, 5) = dt;
+        F(3, 3) = c;
+        F(3, 4) = -s;
+        F(3, 6) = -dt * (s * vx + c * vy);
+        F(4, 3) = s;
+        F(4, 4) = c;
+        F(4, 6) = dt * (c * vx - s * vy);
+
+        m_ct.x(0) += sinTerm * vx - cosTerm * vy;
+        m_ct.x(1) += cosTerm * vx + sinTerm * vy;
+        m_ct.x(2) += m_ct.x(5) * dt;
+        m_ct.x(3) = c * vx - s * vy;
+        m_ct.x(4) = s * vx + c * vy;
+
+        Eigen::Matrix<double, 7, 7> Q = Eigen::Matrix<double, 7, 7>::Zero();
+        Eigen::Matrix<double, 6, 3> G;
+        G << I * (0.5 * dt2), I * dt;
+        Q.topLeftCorner<6, 6>() = G * G.transpose() * (params.ctNoiseStd * params.ctNoiseStd);
+        Q(6, 6) = params.ctTurnRateNoiseStd * params.ctTurnRateNoiseStd * dt;
+
+        m_ct.P = F * m_ct.P * F.transpose() + Q;
+        break;
+    }
+    }
+}
+
+
+InnovationStats ImmFilter::updateModelPosition(int model, const Vector3& z, const Eigen::Matrix3d& R)
+{
+    switch (model) {
+    case CV:
+        return positionUpdate<6>(m_cv.x, m_cv.P, z, R);
+    case CA:
+        return positionUpdate<9>(m_ca.x, m_ca.P, z, R);
+    default:
+        return positionUpdate<7>(m_ct.x, m_ct.P, z, R);
+    }
+}
+
+
+InnovationStats ImmFilter::updateModelStacked(int model, const std::vector<ObservationBlock>& blocks)
+{
+    switch (model) {
+    case CV:
+        return stackedUpdate<6>(m_ckf, m_cv.x, m_cv.P, blocks);
+    case CA:
+        return stackedUpdate<9>(m_ckf, m_ca.x, m_ca.P, blocks);
+    default:
+        return stackedUpdate<7>(m_ckf, m_ct.x, m_ct.P, blocks);
+    }
+}
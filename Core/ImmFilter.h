@@ -0,0 +1,229 @@
+/**
+ * @file ImmFilter.h
+ * @brief 交互式多模型滤波器头文件
+ * @details 定义了ImmFilter类，混合匀速(CV)、匀加速(CA)和协调转弯(CT)三个运动模型跟踪机动目标
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef IMMFILTER_H
+#define IMMFILTER_H
+
+#include "DataStructures.h"
+#include "CKF.h"
+#include <vector>
+
+/**
+ * @brief 交互式多模型(IMM)滤波器类
+ * @details 每个模型使用各自维度的定长滤波器:
+ *          - CV: [p, v] 6维，线性卡尔曼滤波
+ *          - CA: [p, v, a] 9维，线性卡尔曼滤波
+ *          - CT: [p, v, omega] 7维，水平面协调转弯+垂直匀速，扩展卡尔曼滤波
+ *          模型间的交互在10维公共空间 [p, v, a, omega] 中完成，某模型不含的分量
+ *          用目标模型自身的估计补齐。
+ *          观测均为笛卡尔位置时，多个观测者的观测只融合一次，所有模型共享同一等效观测；
+ *          含非线性观测时各模型调用CKF的堆叠更新。
+ *          后验概率低于阈值的模型进入休眠，不参与交互、预测和更新；
+ *          当所有活跃模型的NIS都超出门限(疑似机动)时，休眠模型从组合估计重新初始化并参与本次更新
+ */
+class ImmFilter
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    /**
+     * @brief 模型编号
+     */
+    enum Model {
+        CV = 0,          ///< 匀速模型
+        CA = 1,          ///< 匀加速模型
+        CT = 2,          ///< 协调转弯模型
+        ModelCount = 3   ///< 模型数量
+    };
+
+    /**
+     * @brief 公共空间维度 [p(3), v(3), a(3), omega(1)]
+     */
+    static const int kCommonDim = 10;
+
+    /**
+     * @brief 公共空间状态向量类型
+     */
+    using CommonVector = Eigen::Matrix<double, kCommonDim, 1>;
+
+    /**
+     * @brief 公共空间协方差矩阵类型
+     */
+    using CommonMatrix = Eigen::Matrix<double, kCommonDim, kCommonDim>;
+
+    /**
+     * @brief 构造函数
+     * @param position 初始位置
+     * @details 各模型以初始位置、零速度起始，初始协方差和模型参数从配置文件读取
+     */
+    explicit ImmFilter(const Vector3& position);
+
+    /**
+     * @brief 设置各模型的初始速度和位置速度协方差
+     * @param velocity 速度估计
+     * @param covariance 位置和速度 [p, v] 的6x6协方差
+     * @details 用于由起始阶段的多点拟合结果初始化新航迹，其余分量保持初始不确定度
+     */
+    void seed(const Vector3& velocity, const StateMatrix& covariance);
+
+    /**
+     * @brief 对各模型状态做刚体坐标变换
+     * @param rotation 旋转矩阵
+     * @param translation 平移，x' = R x + t
+     * @details 位置、速度、加速度按3维块旋转，转弯率保持不变，用于跟踪原点移动
+     */
+    void transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation);
+
+    /**
+     * @brief 模型交互并预测
+     * @param dt 时间步长(秒)
+     */
+    void predict(double dt);
+
+    /**
+     * @brief 使用观测更新各模型并计算模型概率
+     * @param blocks 同一周期内的观测块
+     * @return 更新后概率最大的模型的新息统计量
+     */
+    InnovationStats update(const std::vector<ObservationBlock>& blocks);
+
+    /**
+     * @brief 获取组合估计
+     * @param x 输出，9维 [p, v, a] 状态向量
+     * @param P 输出，9x9 协方差矩阵
+     */
+    void getEstimate(StateVector& x, StateMatrix& P) const;
+
+    /**
+     * @brief 获取模型概率
+     * @return 依次为CV、CA、CT的概率
+     */
+    const Eigen::Vector3d& modelProbabilities() const;
+
+    /**
+     * @brief 获取当前活跃(未休眠)的模型数
+     * @return 活跃模型数
+     */
+    int activeModelCount() const;
+
+    /**
+     * @brief 设置模型休眠概率阈值
+     * @param threshold 后验概率低于该值的模型休眠，为0时所有模型始终活跃
+     * @details 默认取配置 IMM/skipThreshold。模型转移使各模型的预测概率不低于 (1 - 停留概率) / 2，
+     *          阈值低于该值时模型很少进入休眠
+     */
+    void setSkipThreshold(double threshold);
+
+private:
+    /**
+     * @brief 定长模型滤波器
+     * @tparam N 模型状态维度
+     */
+    template <int N>
+    struct ModelFilter {
+        Eigen::Matrix<double, N, 1> x;   ///< 状态向量
+        Eigen::Matrix<double, N, N> P;   ///< 协方差矩阵
+    };
+
+    /**
+     * @brief 将模型状态映射到公共空间
+     * @param model 模型编号
+     * @param x 输出，公共空间状态，模型不含的分量取先验值(零)
+     * @param P 输出，公共空间协方差，模型不含的分量取先验方差
+     * @return 模型含有的分量掩码(按位)
+     */
+    int toCommon(int model, CommonVector& x, CommonMatrix& P) const;
+
+    /**
+     * @brief 由公共空间状态设置模型状态
+     * @param model 模型编号
+     * @param x 公共空间状态
+     * @param P 公共空间协方差
+     */
+    void fromCommon(int model, const CommonVector& x, const CommonMatrix& P);
+
+    /**
+     * @brief 按模型概率组合活跃模型的估计
+     * @param x 输出，公共空间组合状态
+     * @param P 输出，公共空间组合协方差
+     */
+    void combine(CommonVector& x, CommonMatrix& P) const;
+
+    /**
+     * @brief 预测单个模型
+     * @param model 模型编号
+     * @param dt 时间步长(秒)
+     */
+    void predictModel(int model, double dt);
+
+    /**
+     * @brief 以笛卡尔位置观测更新单个模型
+     * @param model 模型编号
+     * @param z 等效位置观测
+     * @param R 等效观测噪声
+     * @return 新息统计量
+     */
+    InnovationStats updateModelPosition(int model, const Vector3& z, const Eigen::Matrix3d& R);
+
+    /**
+     * @brief 以任意观测块更新单个模型
+     * @param model 模型编号
+     * @param blocks 观测块
+     * @return 新息统计量
+     */
+    InnovationStats updateModelStacked(int model, const std::vector<ObservationBlock>& blocks);
+
+private:
+    /**
+     * @brief CV模型滤波器
+     */
+    ModelFilter<6> m_cv;
+
+    /**
+     * @brief CA模型滤波器
+     */
+    ModelFilter<9> m_ca;
+
+    /**
+     * @brief CT模型滤波器
+     */
+    ModelFilter<7> m_ct;
+
+    /**
+     * @brief 模型概率
+     */
+    Eigen::Vector3d m_probabilities;
+
+    /**
+     * @brief 模型是否活跃
+     */
+    bool m_active[ModelCount];
+
+    /**
+     * @brief 模型休眠概率阈值
+     */
+    double m_skipThreshold;
+
+    /**
+     * @brief 组合估计(公共空间)
+     * @details 预测后为组合先验，更新后为组合后验，用于输出和休眠模型的重新初始化
+     */
+    CommonVector m_combinedX;
+
+    /**
+     * @brief 组合估计协方差(公共空间)
+     */
+    CommonMatrix m_combinedP;
+
+    /**
+     * @brief 非线性观测时使用的立方卡尔曼滤波器
+     */
+    CKF m_ckf;
+};
+
+#endif // IMMFILTER_H
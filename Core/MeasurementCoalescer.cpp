@@ -0,0 +1,178 @@
+/**
+ * @file MeasurementCoalescer.cpp
+ * @brief 跨观测者重复观测合并实现文件
+ * @details 实现了基于哈希网格的重复观测查找和信息加权合并
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "MeasurementCoalescer.h"
+#include "SensorRegistry.h"
+#include "MetricsRegistry.h"
+#include "LogManager.h"
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[MeasurementCoalescer::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[MeasurementCoalescer::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[MeasurementCoalescer::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[MeasurementCoalescer::" << __FUNCTION__ << "] " << msg
+
+
+MeasurementCoalescer::MeasurementCoalescer()
+    : m_enabled(false),
+      m_distance(5.0),
+      m_timeTolerance(0.05),
+      m_gateThreshold(11.34),
+      m_totalInput(0),
+      m_totalOutput(0)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_enabled = settings.value("Coalescing/enabled", false).toBool();
+    m_distance = settings.value("Coalescing/distance", 5.0).toDouble();
+    m_timeTolerance = settings.value("Coalescing/timeTolerance", 0.05).toDouble();
+    m_gateThreshold = settings.value("Coalescing/gateThreshold", 11.34).toDouble();
+
+    LOG_INFO("重复观测合并" + QString(m_enabled ? "已启用" : "已禁用") +
+             "，合并距离: " + QString::number(m_distance) + "米，时间容差: " +
+             QString::number(m_timeTolerance) + "秒");
+}
+
+
+int MeasurementCoalescer::process(std::vector<Measurement>& measurements)
+{
+    if (!m_enabled || measurements.empty()) {
+        return 0;
+    }
+
+    const SensorRegistry& registry = SensorRegistry::instance();
+    const int inputCount = static_cast<int>(measurements.size());
+    const double distance2 = m_distance * m_distance;
+
+    m_groups.clear();
+    m_grid.clear();
+    for (int i = 0; i < inputCount; ++i) {
+        const Measurement& m = measurements[i];
+
+        // 原始观测保留给滤波器按原生观测模型更新，不参与合并，也不进入索引
+        if (m.raw.size() > 0) {
+            Group group;
+            group.first = i;
+            group.observers.push_back(m.observerId);
+            m_groups.push_back(group);
+            continue;
+        }
+
+        const Eigen::Matrix3d covariance = registry.cartesianCovariance(m);
+
+        const long long cx = static_cast<long long>(std::floor(m.position.x() / m_distance));
+        const long long cy = static_cast<long long>(std::floor(m.position.y() / m_distance));
+        const long long cz = static_cast<long long>(std::floor(m.position.z() / m_distance));
+
+        // 在相邻网格中查找马氏距离最小的可合并组
+        int best = -1;
+        double bestDist = m_gateThreshold;
+        for (long long dx = -1; dx <= 1; ++dx) {
+            for (long long dy = -1; dy <= 1; ++dy) {
+                for (long long dz = -1; dz <= 1; ++dz) {
+                    auto bucket = m_grid.find(cellKey(cx + dx, cy + dy, cz + dz));
+                    if (bucket == m_grid.end()) continue;
+
+                    for (int g : bucket->second) {
+                        const Group& group = m_groups[g];
+                        if (std::abs(group.timestamp - m.timestamp) > m_timeTolerance) continue;
+                        if (std::find(group.observers.begin(), group.observers.end(), m.observerId) != group.observers.end()) continue;
+
+                        const Vector3 diff = m.position - group.position;
+                        if (diff.squaredNorm() > distance2) continue;
+
+                        const Eigen::Matrix3d S = covariance + group.covariance;
+                        const double mahalanobis = diff.dot(S.ldlt().solve(diff));
+                        if (mahalanobis < bestDist) {
+                            bestDist = mahalanobis;
+                            best = g;
+                        }
+                    }
+                }
+            }
+        }
+
+        const Eigen::Matrix3d information = covariance.inverse();
+        if (best < 0) {
+            Group group;
+            group.information = information;
+            group.informationVector = information * m.position;
+            group.position = m.position;
+            group.covariance = covariance;
+            group.extent = m.extent;
+            group.timestamp = m.timestamp;
+            group.first = i;
+            group.observers.push_back(m.observerId);
+            m_grid[cellKey(cx, cy, cz)].push_back(static_cast<int>(m_groups.size()));
+            m_groups.push_back(group);
+            continue;
+        }
+
+        Group& group = m_groups[best];
+        group.information += information;
+        group.informationVector += information * m.position;
+        group.covariance = group.information.inverse();
+        group.position = group.covariance * group.informationVector;
+        group.extent = group.extent.cwiseMax(m.extent);
+        group.timestamp = std::max(group.timestamp, m.timestamp);
+        group.observers.push_back(m.observerId);
+    }
+
+    const int outputCount = static_cast<int>(m_groups.size());
+    if (outputCount < inputCount) {
+        std::vector<Measurement> output;
+        output.reserve(m_groups.size());
+        for (const auto& group : m_groups) {
+            if (group.observers.size() == 1) {
+                // 未合并的观测原样保留(包括原始球坐标观测)
+                output.push_back(measurements[group.first]);
+                continue;
+            }
+
+            // 融合观测不属于任何单一观测者，位置和协方差取融合结果
+            Measurement fused(group.position, group.timestamp, Measurement::kFusedObserverId);
+            fused.covariance = group.covariance;
+            fused.hasCovariance = true;
+            fused.extent = group.extent;
+            output.push_back(fused);
+        }
+        measurements.swap(output);
+
+        LOG_DEBUG("观测 " + QString::number(inputCount) + " 条合并为 " + QString::number(outputCount) + " 条");
+    }
+
+    publishMetrics(inputCount, outputCount);
+    return inputCount - outputCount;
+}
+
+
+long long MeasurementCoalescer::cellKey(long long x, long long y, long long z)
+{
+    // 每个坐标占21位，覆盖 ±2^20 个网格
+    const long long mask = (1LL << 21) - 1;
+    return ((x & mask) << 42) | ((y & mask) << 21) | (z & mask);
+}
+
+
+void MeasurementCoalescer::publishMetrics(int input, int output)
+{
+    m_totalInput += input;
+    m_totalOutput += output;
+
+    nlohmann::json metrics;
+    metrics["lastInput"] = input;
+    metrics["lastOutput"] = output;
+    metrics["lastRatio"] = input > 0 ? static_cast<double>(output) / input : 1.0;
+    metrics["totalInput"] = m_totalInput;
+    metrics["totalOutput"] = m_totalOutput;
+    metrics["ratio"] = m_totalInput > 0 ? static_cast<double>(m_totalOutput) / m_totalInput : 1.0;
+    g_Metrics.setSection("coalescing", metrics);
+}
@@ -0,0 +1,123 @@
+/**
+ * @file MeasurementCoalescer.h
+ * @brief 跨观测者重复观测合并头文件
+ * @details 定义了MeasurementCoalescer类，在数据关联之前将不同观测者对同一目标的重复观测合并为一条融合观测
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef MEASUREMENTCOALESCER_H
+#define MEASUREMENTCOALESCER_H
+
+#include "DataStructures.h"
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief 跨观测者重复观测合并类
+ * @details 多个观测者覆盖同一区域时，同一目标在一个周期内会产生多条观测，
+ *          使后续数据关联的规模成倍增加。本类在解码和坐标换算之后运行:
+ *          以边长为合并距离的哈希网格索引当前周期的观测，只在相邻网格内查找
+ *          来自其他观测者、时间差和空间距离均在容差内且通过马氏距离检验的观测，
+ *          按信息加权合并为一条带协方差的融合观测。
+ *          同一观测者的观测不会相互合并，每个融合组中每个观测者最多贡献一条观测。
+ *          带原始观测(如雷达球坐标)的观测不参与合并，原样交给滤波器按原生观测模型更新；
+ *          融合观测的观测者ID为 Measurement::kFusedObserverId，不计入任何单一观测者的统计。
+ *          多观测者联合更新已能在一次更新中使用同一目标的多条观测，本阶段默认关闭，
+ *          仅在关联规模成为瓶颈时启用
+ */
+class MeasurementCoalescer
+{
+public:
+    /**
+     * @brief 构造函数
+     * @details 从配置文件读取合并距离、时间容差和马氏距离门限
+     */
+    MeasurementCoalescer();
+
+    /**
+     * @brief 处理一个周期的观测数据
+     * @param measurements 观测数据列表(输入/输出参数)
+     * @return 本周期被合并掉的观测数
+     * @details 处理后发布合并比例等指标
+     */
+    int process(std::vector<Measurement>& measurements);
+
+private:
+    /**
+     * @brief 融合组
+     * @details 以信息形式累加组内各观测，合并结果为 P = (sum C^-1)^-1, x = P * sum C^-1 z
+     */
+    struct Group {
+        Eigen::Matrix3d information;  ///< 信息矩阵之和
+        Vector3 informationVector;    ///< 信息向量之和
+        Vector3 position;             ///< 当前融合位置
+        Eigen::Matrix3d covariance;   ///< 当前融合协方差
+        Vector3 extent;               ///< 组内最大外形尺寸
+        double timestamp;             ///< 组内最新时间戳
+        int first;                    ///< 组内第一条观测的索引
+        std::vector<int> observers;   ///< 组内观测者ID
+    };
+
+    /**
+     * @brief 计算网格坐标的哈希键
+     * @param x 网格x坐标
+     * @param y 网格y坐标
+     * @param z 网格z坐标
+     * @return 哈希键
+     */
+    static long long cellKey(long long x, long long y, long long z);
+
+    /**
+     * @brief 发布合并指标
+     * @param input 本周期输入观测数
+     * @param output 本周期输出观测数
+     */
+    void publishMetrics(int input, int output);
+
+private:
+    /**
+     * @brief 是否启用重复观测合并
+     */
+    bool m_enabled;
+
+    /**
+     * @brief 合并距离(米)
+     * @details 同时作为哈希网格边长
+     */
+    double m_distance;
+
+    /**
+     * @brief 合并时间容差(秒)
+     */
+    double m_timeTolerance;
+
+    /**
+     * @brief 马氏距离平方门限
+     * @details 两条观测之差按两者协方差之和计算的马氏距离平方超过此值时不合并
+     */
+    double m_gateThreshold;
+
+    /**
+     * @brief 当前周期的融合组
+     */
+    std::vector<Group> m_groups;
+
+    /**
+     * @brief 融合组空间索引
+     * @details 键为网格哈希，值为融合组索引
+     */
+    std::unordered_map<long long, std::vector<int>> m_grid;
+
+    /**
+     * @brief 累计输入观测数
+     */
+    long long m_totalInput;
+
+    /**
+     * @brief 累计输出观测数
+     */
+    long long m_totalOutput;
+};
+
+#endif // MEASUREMENTCOALESCER_H
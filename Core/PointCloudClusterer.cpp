@@ -0,0 +1,251 @@
+/**
+ * @file PointCloudClusterer.cpp
+ * @brief 点云预聚类实现文件
+ * @details 实现了体素网格降采样、DBSCAN聚类和质心观测生成
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "PointCloudClusterer.h"
+#include "SensorRegistry.h"
+#include "LogManager.h"
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[PointCloudClusterer::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[PointCloudClusterer::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[PointCloudClusterer::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[PointCloudClusterer::" << __FUNCTION__ << "] " << msg
+
+namespace {
+const int kUnvisited = -1;
+const int kNoise = -2;
+}
+
+
+PointCloudClusterer::PointCloudClusterer()
+    : m_enabled(true),
+      m_voxelSize(0.5),
+      m_eps(2.0),
+      m_minPoints(3),
+      m_keepNoise(true),
+      m_centroidStdFloor(0.1)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_enabled = settings.value("Clustering/enabled", true).toBool();
+    m_voxelSize = settings.value("Clustering/voxelSize", 0.5).toDouble();
+    m_eps = settings.value("Clustering/eps", 2.0).toDouble();
+    m_minPoints = settings.value("Clustering/minPoints", 3).toInt();
+    m_keepNoise = settings.value("Clustering/keepNoise", true).toBool();
+    m_centroidStdFloor = settings.value("Clustering/centroidStdFloor", 0.1).toDouble();
+
+    LOG_INFO("点云聚类" + QString(m_enabled ? "已启用" : "已禁用") +
+             "，体素: " + QString::number(m_voxelSize) + "米，邻域半径: " +
+             QString::number(m_eps) + "米，最少点数: " + QString::number(m_minPoints));
+}
+
+
+int PointCloudClusterer::process(std::vector<Measurement>& measurements)
+{
+    if (!m_enabled || measurements.empty()) {
+        return 0;
+    }
+
+    const SensorRegistry& registry = SensorRegistry::instance();
+
+    // 按观测者收集点云类观测
+    std::unordered_map<int, std::vector<const Measurement*>> clouds;
+    for (const auto& m : measurements) {
+        if (registry.sensor(m.observerId).pointCloud) {
+            clouds[m.observerId].push_back(&m);
+        }
+    }
+    if (clouds.empty()) {
+        return 0;
+    }
+
+    std::vector<Measurement> output;
+    output.reserve(measurements.size());
+    for (const auto& m : measurements) {
+        if (!registry.sensor(m.observerId).pointCloud) {
+            output.push_back(m);
+        }
+    }
+
+    const size_t passthrough = output.size();
+    for (const auto& cloud : clouds) {
+        clusterObserver(cloud.second, output);
+    }
+
+    const int inputCount = static_cast<int>(measurements.size());
+    const int reduced = inputCount - static_cast<int>(output.size());
+    LOG_DEBUG("点云观测 " + QString::number(inputCount - static_cast<int>(passthrough)) +
+              " 条聚类为 " + QString::number(output.size() - passthrough) + " 条质心观测");
+
+    measurements.swap(output);
+    return reduced;
+}
+
+
+long long PointCloudClusterer::cellKey(long long x, long long y, long long z)
+{
+    // 每个坐标占21位，覆盖 ±2^20 个网格
+    const long long mask = (1LL << 21) - 1;
+    return ((x & mask) << 42) | ((y & mask) << 21) | (z & mask);
+}
+
+
+long long PointCloudClusterer::cellKey(const Vector3& position, double cellSize)
+{
+    return cellKey(static_cast<long long>(std::floor(position.x() / cellSize)),
+                   static_cast<long long>(std::floor(position.y() / cellSize)),
+                   static_cast<long long>(std::floor(position.z() / cellSize)));
+}
+
+
+void PointCloudClusterer::clusterObserver(const std::vector<const Measurement*>& points,
+                                          std::vector<Measurement>& output)
+{
+    const int observerId = points.front()->observerId;
+
+    // 1. 体素网格降采样
+    m_voxels.clear();
+    m_voxelIndex.clear();
+    for (const Measurement* m : points) {
+        const long long key = cellKey(m->position, m_voxelSize);
+        auto it = m_voxelIndex.find(key);
+        if (it == m_voxelIndex.end()) {
+            Voxel voxel;
+            voxel.sum = Vector3::Zero();
+            voxel.sumSq = Eigen::Matrix3d::Zero();
+            voxel.minCorner = m->position;
+            voxel.maxCorner = m->position;
+            voxel.count = 0;
+            voxel.timestamp = m->timestamp;
+            voxel.cluster = kUnvisited;
+            it = m_voxelIndex.emplace(key, static_cast<int>(m_voxels.size())).first;
+            m_voxels.push_back(voxel);
+        }
+
+        Voxel& voxel = m_voxels[it->second];
+        voxel.sum += m->position;
+        voxel.sumSq += m->position * m->position.transpose();
+        voxel.minCorner = voxel.minCorner.cwiseMin(m->position);
+        voxel.maxCorner = voxel.maxCorner.cwiseMax(m->position);
+        voxel.count++;
+        voxel.timestamp = std::max(voxel.timestamp, m->timestamp);
+    }
+
+    // 2. 以体素质心建立邻域查询网格
+    m_neighborGrid.clear();
+    for (int i = 0; i < static_cast<int>(m_voxels.size()); ++i) {
+        const Vector3 centroid = m_voxels[i].sum / m_voxels[i].count;
+        m_neighborGrid[cellKey(centroid, m_eps)].push_back(i);
+    }
+
+    // 3. DBSCAN (核心点判定按体素内点数加权)
+    int clusterCount = 0;
+    std::vector<int> neighbors;
+    std::vector<int> seeds;
+    for (int i = 0; i < static_cast<int>(m_voxels.size()); ++i) {
+        if (m_voxels[i].cluster != kUnvisited) continue;
+
+        if (regionQuery(i, neighbors) < m_minPoints) {
+            m_voxels[i].cluster = kNoise;
+            continue;
+        }
+
+        const int clusterId = clusterCount++;
+        m_voxels[i].cluster = clusterId;
+        seeds = neighbors;
+        for (size_t k = 0; k < seeds.size(); ++k) {
+            Voxel& voxel = m_voxels[seeds[k]];
+            if (voxel.cluster == kNoise) {
+                voxel.cluster = clusterId;  // 边界点
+            }
+            if (voxel.cluster != kUnvisited) continue;
+
+            voxel.cluster = clusterId;
+            if (regionQuery(seeds[k], neighbors) >= m_minPoints) {
+                seeds.insert(seeds.end(), neighbors.begin(), neighbors.end());
+            }
+        }
+    }
+
+    // 4. 由体素累加量归约每个聚类的统计量
+    struct ClusterStats {
+        Vector3 sum = Vector3::Zero();
+        Eigen::Matrix3d sumSq = Eigen::Matrix3d::Zero();
+        Vector3 minCorner = Vector3::Constant(std::numeric_limits<double>::max());
+        Vector3 maxCorner = Vector3::Constant(std::numeric_limits<double>::lowest());
+        int count = 0;
+        double timestamp = std::numeric_limits<double>::lowest();
+    };
+    std::vector<ClusterStats> clusters(clusterCount);
+    for (const auto& voxel : m_voxels) {
+        if (voxel.cluster < 0) {
+            if (m_keepNoise) {
+                // 噪声体素保留为单独观测
+                Measurement single(Vector3(voxel.sum / voxel.count), voxel.timestamp, observerId);
+                output.push_back(single);
+            }
+            continue;
+        }
+        ClusterStats& stats = clusters[voxel.cluster];
+        stats.sum += voxel.sum;
+        stats.sumSq += voxel.sumSq;
+        stats.minCorner = stats.minCorner.cwiseMin(voxel.minCorner);
+        stats.maxCorner = stats.maxCorner.cwiseMax(voxel.maxCorner);
+        stats.count += voxel.count;
+        stats.timestamp = std::max(stats.timestamp, voxel.timestamp);
+    }
+
+    // 5. 生成质心观测: 质心协方差 = (点分布协方差 + 传感器噪声) / 点数，并设下限
+    const SensorRegistry& registry = SensorRegistry::instance();
+    const double floorVar = m_centroidStdFloor * m_centroidStdFloor;
+    for (const auto& stats : clusters) {
+        const double n = static_cast<double>(stats.count);
+        const Vector3 centroid = stats.sum / n;
+        const Eigen::Matrix3d spread = stats.sumSq / n - centroid * centroid.transpose();
+
+        Measurement m(centroid, stats.timestamp, observerId);
+        m.covariance = (spread + registry.noiseCovariance(observerId, centroid)) / n;
+        m.covariance.diagonal() = m.covariance.diagonal().cwiseMax(floorVar);
+        m.hasCovariance = true;
+        m.extent = stats.maxCorner - stats.minCorner;
+        output.push_back(m);
+    }
+}
+
+
+int PointCloudClusterer::regionQuery(int voxelIdx, std::vector<int>& neighbors) const
+{
+    neighbors.clear();
+    const Vector3 center = m_voxels[voxelIdx].sum / m_voxels[voxelIdx].count;
+    const long long cx = static_cast<long long>(std::floor(center.x() / m_eps));
+    const long long cy = static_cast<long long>(std::floor(center.y() / m_eps));
+    const long long cz = static_cast<long long>(std::floor(center.z() / m_eps));
+    const double eps2 = m_eps * m_eps;
+
+    int pointCount = 0;
+    for (long long dx = -1; dx <= 1; ++dx) {
+        for (long long dy = -1; dy <= 1; ++dy) {
+            for (long long dz = -1; dz <= 1; ++dz) {
+                auto bucket = m_neighborGrid.find(cellKey(cx + dx, cy + dy, cz + dz));
+                if (bucket == m_neighborGrid.end()) continue;
+
+                for (int j : bucket->second) {
+                    const Voxel& other = m_voxels[j];
+                    if ((other.sum / other.count - center).squaredNorm() <= eps2) {
+                        neighbors.push_back(j);
+                        pointCount += other.count;
+                    }
+                }
+            }
+        }
+    }
+    return pointCount;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file PointCloudClusterer.h
+ * @brief 点云预聚类头文件
+ * @details 定义了PointCloudClusterer类，在数据关联之前将点云类传感器的密集观测聚类为质心观测
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef POINTCLOUDCLUSTERER_H
+#define POINTCLOUDCLUSTERER_H
+
+#include "DataStructures.h"
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief 点云预聚类类
+ * @details 对配置为点云类(pointCloud=true)的观测者，按观测者分别处理:
+ *          1. 体素网格降采样，落在同一体素内的点合并为一个带权体素;
+ *          2. 在体素上运行DBSCAN，邻域查询通过边长为eps的哈希网格完成;
+ *          3. 每个聚类归约为一个质心观测，附带外形尺寸和协方差。
+ *          其他观测者的观测原样通过
+ */
+class PointCloudClusterer
+{
+public:
+    /**
+     * @brief 构造函数
+     * @details 从配置文件读取体素尺寸、DBSCAN参数等
+     */
+    PointCloudClusterer();
+
+    /**
+     * @brief 处理一个周期的观测数据
+     * @param measurements 观测数据列表(输入/输出参数)
+     * @return 本周期被聚类合并掉的观测数
+     * @details 点云类观测替换为聚类质心观测，其余观测保持不变
+     */
+    int process(std::vector<Measurement>& measurements);
+
+private:
+    /**
+     * @brief 体素
+     * @details 保存落入其中的点的一阶、二阶累加量，聚类统计量可直接由体素累加得到
+     */
+    struct Voxel {
+        Vector3 sum;             ///< 点坐标之和
+        Eigen::Matrix3d sumSq;   ///< 点坐标外积之和
+        Vector3 minCorner;       ///< 包围盒最小角点
+        Vector3 maxCorner;       ///< 包围盒最大角点
+        int count;               ///< 点数
+        double timestamp;        ///< 最新观测时间戳
+        int cluster;             ///< 所属聚类编号，-1为未访问，-2为噪声
+    };
+
+    /**
+     * @brief 计算坐标所在网格的哈希键
+     * @param position 位置
+     * @param cellSize 网格边长
+     * @return 哈希键
+     */
+    static long long cellKey(const Vector3& position, double cellSize);
+
+    /**
+     * @brief 计算网格坐标的哈希键
+     * @param x 网格x坐标
+     * @param y 网格y坐标
+     * @param z 网格z坐标
+     * @return 哈希键
+     */
+    static long long cellKey(long long x, long long y, long long z);
+
+    /**
+     * @brief 聚类同一观测者的点
+     * @param points 同一观测者的观测
+     * @param output 输出的聚类质心观测(追加)
+     */
+    void clusterObserver(const std::vector<const Measurement*>& points, std::vector<Measurement>& output);
+
+    /**
+     * @brief 查询体素的邻域
+     * @param voxelIdx 体素索引
+     * @param neighbors 输出，距离不超过eps的体素索引(含自身)
+     * @return 邻域内的点数(按体素权重累加)
+     */
+    int regionQuery(int voxelIdx, std::vector<int>& neighbors) const;
+
+private:
+    /**
+     * @brief 是否启用点云聚类
+     */
+    bool m_enabled;
+
+    /**
+     * @brief 体素边长(米)
+     */
+    double m_voxelSize;
+
+    /**
+     * @brief DBSCAN邻域半径(米)
+     */
+    double m_eps;
+
+    /**
+     * @brief DBSCAN核心点所需的最少点数
+     */
+    int m_minPoints;
+
+    /**
+     * @brief 是否保留DBSCAN噪声点
+     * @details 保留时噪声点作为单独观测输出，可能是小目标
+     */
+    bool m_keepNoise;
+
+    /**
+     * @brief 质心位置标准差下限(米)
+     */
+    double m_centroidStdFloor;
+
+    /**
+     * @brief 当前观测者的体素
+     */
+    std::vector<Voxel> m_voxels;
+
+    /**
+     * @brief 体素哈希表
+     * @details 键为体素网格哈希，值为体素索引
+     */
+    std::unordered_map<long long, int> m_voxelIndex;
+
+    /**
+     * @brief 邻域查询网格
+     * @details 边长为eps的网格，键为网格哈希，值为体素索引列表
+     */
+    std::unordered_map<long long, std::vector<int>> m_neighborGrid;
+};
+
+#endif // POINTCLOUDCLUSTERER_H
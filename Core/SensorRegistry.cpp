@@ -0,0 +1,353 @@
+/**
+ * @file SensorRegistry.cpp
+ * @brief 传感器注册表实现文件
+ * @details 实现了传感器噪声模型的加载和按观测者ID查询
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "SensorRegistry.h"
+#include "LogManager.h"
+#include "CartesianMeasurementModel.h"
+#include "SphericalMeasurementModel.h"
+#include <QSettings>
+#include <QStringList>
+#include <QThread>
+#include <QFile>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[SensorRegistry::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[SensorRegistry::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[SensorRegistry::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[SensorRegistry::" << __FUNCTION__ << "] " << msg
+
+/**
+ * @brief 获取传感器注册表单例实例
+ * @return 传感器注册表实例的引用
+ */
+SensorRegistry& SensorRegistry::instance()
+{
+    // C++11 保证了静态局部变量的初始化是线程安全的
+    static SensorRegistry instance;
+    return instance;
+}
+
+/**
+ * @brief 构造函数
+ * @details 默认噪声沿用 KalmanFilter/measurementNoiseStd，
+ *          传感器表可写在 Server.ini 中，也可通过 Sensors/file 指定单独的文件
+ */
+SensorRegistry::SensorRegistry()
+    : m_cartesianModel(std::make_shared<CartesianMeasurementModel>()),
+      m_frameThread(nullptr)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    double measurement_noise_std = settings.value("KalmanFilter/measurementNoiseStd", 2.0).toDouble();
+    m_default.noiseStd = Vector3::Constant(measurement_noise_std);
+    m_default.model = m_cartesianModel;
+
+    QString sensorFile = settings.value("Sensors/file", "Server.ini").toString();
+    if (!QFile::exists(sensorFile)) {
+        LOG_WARN("传感器配置文件 " + sensorFile + " 不存在，所有观测者使用默认噪声");
+        sensorFile = "Server.ini";
+    }
+    loadSensors(sensorFile);
+
+    LOG_INFO("传感器注册表初始化完成，已注册 " + QString::number(m_sensors.size()) +
+             " 个传感器，默认噪声标准差: " + QString::number(measurement_noise_std));
+}
+
+/**
+ * @brief 从配置文件加载传感器表
+ * @param fileName 配置文件名
+ */
+void SensorRegistry::loadSensors(const QString& fileName)
+{
+    QSettings settings(fileName, QSettings::IniFormat);
+
+    for (const QString& group : settings.childGroups()) {
+        if (!group.startsWith("Sensor_")) {
+            continue;
+        }
+
+        bool ok = false;
+        int observerId = group.mid(7).toInt(&ok);
+        if (!ok) {
+            LOG_WARN("无法解析传感器配置组名: " + group);
+            continue;
+        }
+
+        settings.beginGroup(group);
+        SensorConfig config;
+        config.observerId = observerId;
+
+        // noiseStd 为各轴统一值，noiseStdX/Y/Z 可单独覆盖
+        double noiseStd = settings.value("noiseStd", m_default.noiseStd.x()).toDouble();
+        config.noiseStd = Vector3(settings.value("noiseStdX", noiseStd).toDouble(),
+                                  settings.value("noiseStdY", noiseStd).toDouble(),
+                                  settings.value("noiseStdZ", noiseStd).toDouble());
+        config.rangeNoiseCoeff = settings.value("rangeNoiseCoeff", 0.0).toDouble();
+        config.sensorPosition = Vector3(settings.value("positionX", 0.0).toDouble(),
+                                        settings.value("positionY", 0.0).toDouble(),
+                                        settings.value("positionZ", 0.0).toDouble());
+
+        // 姿态以角度配置: 偏航角顺时针为正(与方位角一致)，俯仰角抬头为正
+        const double deg2rad = EIGEN_PI / 180.0;
+        double yaw = settings.value("yaw", 0.0).toDouble() * deg2rad;
+        double pitch = settings.value("pitch", 0.0).toDouble() * deg2rad;
+        double roll = settings.value("roll", 0.0).toDouble() * deg2rad;
+        config.orientation = (Eigen::AngleAxisd(-yaw, Eigen::Vector3d::UnitZ()) *
+                              Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitX()) *
+                              Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitY())).toRotationMatrix();
+
+        config.pointCloud = settings.value("pointCloud", false).toBool();
+
+        QString type = settings.value("type", "cartesian").toString().toLower();
+        if (type == "bearing") {
+            // 纯方位传感器的观测不直接进入滤波，由交叉定位阶段生成伪观测
+            config.type = SensorConfig::Type::Bearing;
+            config.sphericalNoiseStd(1) = settings.value("azimuthStdDeg", 0.5).toDouble() * deg2rad;
+            config.sphericalNoiseStd(2) = settings.value("elevationStdDeg", 0.5).toDouble() * deg2rad;
+            config.model = m_cartesianModel;
+        } else if (type == "spherical") {
+            config.type = SensorConfig::Type::Spherical;
+            config.hasRangeRate = settings.value("hasRangeRate", false).toBool();
+            config.sphericalNoiseStd = Eigen::Vector4d(settings.value("rangeStd", 1.0).toDouble(),
+                                                       settings.value("azimuthStdDeg", 0.5).toDouble() * deg2rad,
+                                                       settings.value("elevationStdDeg", 0.5).toDouble() * deg2rad,
+                                                       settings.value("rangeRateStd", 1.0).toDouble());
+            config.model = std::make_shared<SphericalMeasurementModel>(config.sensorPosition,
+                                                                       config.orientation,
+                                                                       config.hasRangeRate);
+        } else {
+            config.model = m_cartesianModel;
+        }
+        settings.endGroup();
+
+        m_sensors[observerId] = config;
+        LOG_DEBUG("注册传感器 " + QString::number(observerId) +
+                  (config.type == SensorConfig::Type::Spherical ? "(球坐标)" :
+                   config.type == SensorConfig::Type::Bearing ? "(纯方位)" : "(笛卡尔)") + "，噪声标准差: (" +
+                  QString::number(config.noiseStd.x()) + ", " +
+                  QString::number(config.noiseStd.y()) + ", " +
+                  QString::number(config.noiseStd.z()) + ")，距离系数: " +
+                  QString::number(config.rangeNoiseCoeff));
+    }
+}
+
+/**
+ * @brief 获取观测者配置
+ * @param observerId 观测者ID
+ * @return 观测者配置，未注册时返回默认配置
+ */
+const SensorConfig& SensorRegistry::sensor(int observerId) const
+{
+    auto it = m_sensors.find(observerId);
+    return it != m_sensors.end() ? it->second : m_default;
+}
+
+/**
+ * @brief 查询观测噪声协方差矩阵
+ * @param observerId 观测者ID
+ * @param position 观测位置
+ * @return 观测噪声协方差矩阵R
+ */
+MeasurementNoise SensorRegistry::noiseCovariance(int observerId, const Vector3& position) const
+{
+    const SensorConfig& config = sensor(observerId);
+
+    Vector3 sigma = config.noiseStd;
+    if (config.rangeNoiseCoeff > 0.0) {
+        double range = (position - config.sensorPosition).norm();
+        sigma.array() += config.rangeNoiseCoeff * range;
+    }
+
+    return sigma.array().square().matrix().asDiagonal();
+}
+
+/**
+ * @brief 查询原始观测的噪声协方差矩阵
+ * @param measurement 观测数据
+ * @return 与观测模型维度一致的噪声协方差矩阵
+ */
+ObservationNoise SensorRegistry::observationNoise(const Measurement& measurement) const
+{
+    const SensorConfig& config = sensor(measurement.observerId);
+
+    if (measurement.hasCovariance) {
+        return measurement.covariance;
+    }
+    if (measurement.raw.size() == 0 || config.type != SensorConfig::Type::Spherical) {
+        return noiseCovariance(measurement.observerId, measurement.position);
+    }
+
+    const int m = config.model->dim();
+    Eigen::Vector4d sigma = config.sphericalNoiseStd;
+    sigma(0) += config.rangeNoiseCoeff * measurement.raw(0);
+    return sigma.head(m).array().square().matrix().asDiagonal();
+}
+
+/**
+ * @brief 查询观测在笛卡尔坐标下的位置协方差
+ * @param measurement 观测数据
+ * @return 3x3位置协方差矩阵
+ */
+MeasurementNoise SensorRegistry::cartesianCovariance(const Measurement& measurement) const
+{
+    if (measurement.hasCovariance) {
+        return measurement.covariance;
+    }
+
+    const SensorConfig& config = sensor(measurement.observerId);
+    if (measurement.raw.size() < 3 || config.type != SensorConfig::Type::Spherical) {
+        return noiseCovariance(measurement.observerId, measurement.position);
+    }
+
+    // 局部坐标 (r*cosE*sinA, r*cosE*cosA, r*sinE) 对 (r, A, E) 的雅可比矩阵
+    const double range = measurement.raw(0);
+    const double sinA = std::sin(measurement.raw(1));
+    const double cosA = std::cos(measurement.raw(1));
+    const double sinE = std::sin(measurement.raw(2));
+    const double cosE = std::cos(measurement.raw(2));
+    Eigen::Matrix3d J;
+    J << cosE * sinA,  range * cosE * cosA, -range * sinE * sinA,
+         cosE * cosA, -range * cosE * sinA, -range * sinE * cosA,
+         sinE,         0.0,                  range * cosE;
+    J = config.orientation * J;
+
+    const Eigen::Matrix3d R = observationNoise(measurement).topLeftCorner<3, 3>();
+    return J * R * J.transpose();
+}
+
+/**
+ * @brief 构建观测块
+ * @param measurement 观测数据
+ * @return 包含观测模型、观测向量和噪声的观测块
+ */
+ObservationBlock SensorRegistry::observationBlock(const Measurement& measurement) const
+{
+    const SensorConfig& config = sensor(measurement.observerId);
+
+    ObservationBlock block;
+    if (measurement.raw.size() == 0 || config.type != SensorConfig::Type::Spherical) {
+        block.model = m_cartesianModel.get();
+        block.z = measurement.position;
+    } else {
+        block.model = config.model.get();
+        block.z = measurement.raw;
+    }
+    block.R = observationNoise(measurement);
+    return block;
+}
+
+/**
+ * @brief 批量将原始观测换算为笛卡尔位置
+ * @param measurements 观测数据列表(输入/输出参数)
+ * @return 被丢弃的观测数
+ */
+int SensorRegistry::convertToCartesian(std::vector<Measurement>& measurements) const
+{
+    // 按观测者分组收集需要换算的观测索引
+    std::unordered_map<int, std::vector<size_t>> groups;
+    int dropped = 0;
+    for (size_t i = 0; i < measurements.size(); ++i) {
+        Measurement& m = measurements[i];
+        if (m.raw.size() == 0) {
+            continue;
+        }
+
+        const SensorConfig& config = sensor(m.observerId);
+        if (config.type != SensorConfig::Type::Spherical || m.raw.size() != config.model->dim()) {
+            // 观测者未配置为球坐标传感器或维度不符，标记后丢弃
+            m.observerId = std::numeric_limits<int>::min();
+            ++dropped;
+            continue;
+        }
+        groups[m.observerId].push_back(i);
+    }
+
+    Eigen::Matrix3Xd positions;
+    for (const auto& group : groups) {
+        const auto& indices = group.second;
+        const Eigen::Index count = static_cast<Eigen::Index>(indices.size());
+        Eigen::ArrayXd range(count), azimuth(count), elevation(count);
+        for (Eigen::Index k = 0; k < count; ++k) {
+            const ObservationVector& raw = measurements[indices[k]].raw;
+            range(k) = raw(0);
+            azimuth(k) = raw(1);
+            elevation(k) = raw(2);
+        }
+
+        const auto* model = static_cast<const SphericalMeasurementModel*>(sensor(group.first).model.get());
+        model->toCartesianBatch(range, azimuth, elevation, positions);
+        for (Eigen::Index k = 0; k < count; ++k) {
+            measurements[indices[k]].position = positions.col(k);
+        }
+    }
+
+    if (dropped > 0) {
+        LOG_WARN("丢弃 " + QString::number(dropped) + " 条无法换算的原始观测 (观测者未配置为球坐标传感器或维度不符)");
+        measurements.erase(std::remove_if(measurements.begin(), measurements.end(),
+                                          [](const Measurement& m) {
+            return m.observerId == std::numeric_limits<int>::min();
+        }), measurements.end());
+    }
+    return dropped;
+}
+
+/**
+ * @brief 计算纯方位观测的视线方向
+ * @param config 观测者配置
+ * @param azimuth 方位角(弧度)
+ * @param elevation 俯仰角(弧度)
+ * @return 跟踪坐标系下的单位方向向量
+ */
+Vector3 SensorRegistry::bearingDirection(const SensorConfig& config, double azimuth, double elevation)
+{
+    const double cosEl = std::cos(elevation);
+    const Vector3 local(cosEl * std::sin(azimuth), cosEl * std::cos(azimuth), std::sin(elevation));
+    return config.orientation * local;
+}
+
+/**
+ * @brief 已注册的传感器数量
+ * @return 传感器数量(不含默认配置)
+ */
+int SensorRegistry::sensorCount() const
+{
+    return static_cast<int>(m_sensors.size());
+}
+
+/**
+ * @brief 对所有传感器位姿做刚体坐标变换
+ * @param rotation 旋转矩阵
+ * @param translation 平移
+ * @return 已变换返回true，调用线程不是工作线程时返回false
+ */
+bool SensorRegistry::transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation)
+{
+    // 位姿修改不加锁，只允许第一次调用的线程(工作线程)修改
+    QThread* expected = nullptr;
+    QThread* current = QThread::currentThread();
+    if (!m_frameThread.compare_exchange_strong(expected, current) && expected != current) {
+        LOG_ERROR("传感器位姿只能在工作线程中变换，已忽略");
+        return false;
+    }
+
+    for (auto& pair : m_sensors) {
+        SensorConfig& config = pair.second;
+        config.sensorPosition = rotation * config.sensorPosition + translation;
+        config.orientation = rotation * config.orientation;
+        if (config.type == SensorConfig::Type::Spherical) {
+            config.model = std::make_shared<SphericalMeasurementModel>(config.sensorPosition,
+                                                                       config.orientation,
+                                                                       config.hasRangeRate);
+        }
+    }
+    m_default.sensorPosition = rotation * m_default.sensorPosition + translation;
+    m_default.orientation = rotation * m_default.orientation;
+    return true;
+}
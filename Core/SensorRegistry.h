@@ -0,0 +1,238 @@
+/**
+ * @file SensorRegistry.h
+ * @brief 传感器注册表头文件
+ * @details 定义了SensorRegistry类，按观测者ID管理各传感器的观测噪声模型
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef SENSORREGISTRY_H
+#define SENSORREGISTRY_H
+
+#include "DataStructures.h"
+#include "IMotionModel.h"
+#include "IMeasurementModel.h"
+#include <atomic>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <QString>
+
+class QThread;
+
+/**
+ * @brief 传感器配置
+ * @details 描述单个观测者的观测类型、安装位置姿态和观测噪声特性。
+ *          笛卡尔传感器的噪声标准差可随距离线性增长:
+ *          sigma = noiseStd + rangeNoiseCoeff * |position - sensorPosition|
+ */
+struct SensorConfig
+{
+    /**
+     * @brief 传感器观测类型
+     */
+    enum class Type {
+        Cartesian,  ///< 直接给出笛卡尔位置
+        Spherical,  ///< 给出距离、方位、俯仰(及径向速度)
+        Bearing     ///< 无源传感器，只给出方位和俯仰
+    };
+
+    /**
+     * @brief 观测者ID
+     */
+    int observerId = -1;
+
+    /**
+     * @brief 观测类型
+     */
+    Type type = Type::Cartesian;
+
+    /**
+     * @brief 各坐标轴的基础噪声标准差(米)
+     */
+    Vector3 noiseStd = Vector3::Ones();
+
+    /**
+     * @brief 距离相关的噪声系数
+     * @details 每米距离增加的噪声标准差，为0时噪声与距离无关
+     */
+    double rangeNoiseCoeff = 0.0;
+
+    /**
+     * @brief 传感器位置
+     * @details 用于计算观测点到传感器的距离
+     */
+    Vector3 sensorPosition = Vector3::Zero();
+
+    /**
+     * @brief 传感器姿态
+     * @details 传感器本体坐标系到跟踪坐标系的旋转矩阵
+     */
+    Eigen::Matrix3d orientation = Eigen::Matrix3d::Identity();
+
+    /**
+     * @brief 球坐标观测噪声标准差
+     * @details 依次为距离(米)、方位(弧度)、俯仰(弧度)、径向速度(米/秒)，
+     *          纯方位传感器只使用方位和俯仰两项
+     */
+    Eigen::Matrix<double, 4, 1, Eigen::DontAlign> sphericalNoiseStd{1.0, 0.01, 0.01, 1.0};
+
+    /**
+     * @brief 球坐标观测是否包含径向速度
+     */
+    bool hasRangeRate = false;
+
+    /**
+     * @brief 是否为点云类传感器
+     * @details 点云类传感器对单个目标返回大量观测点，需在关联前聚类
+     */
+    bool pointCloud = false;
+
+    /**
+     * @brief 观测模型
+     * @details 由上述参数构建，所有航迹共享
+     */
+    std::shared_ptr<IMeasurementModel> model;
+};
+
+/**
+ * @brief 传感器注册表类
+ * @details 启动时从配置文件加载全部传感器的噪声模型，所有航迹在更新时按观测者ID查询，
+ *          不再各自持有观测噪声矩阵。加载后只有跟踪原点移动时由transformFrame()修改传感器位姿，
+ *          该修改不加锁: 查询和变换都只能在工作线程的处理周期内进行，变换位于各处理阶段之间，
+ *          不与并行的航迹更新重叠；其他线程不得使用本类。
+ *          使用单例模式确保全局只有一份配置
+ */
+class SensorRegistry
+{
+public:
+    /**
+     * @brief 获取传感器注册表单例实例
+     * @return 传感器注册表实例的引用
+     */
+    static SensorRegistry& instance();
+
+    /**
+     * @brief 查询观测噪声协方差矩阵
+     * @param observerId 观测者ID
+     * @param position 观测位置，用于计算距离相关的噪声
+     * @return 观测噪声协方差矩阵R
+     * @details 未注册的观测者使用默认噪声配置
+     */
+    MeasurementNoise noiseCovariance(int observerId, const Vector3& position) const;
+
+    /**
+     * @brief 查询原始观测的噪声协方差矩阵
+     * @param measurement 观测数据
+     * @return 与观测模型维度一致的噪声协方差矩阵
+     */
+    ObservationNoise observationNoise(const Measurement& measurement) const;
+
+    /**
+     * @brief 查询观测在笛卡尔坐标下的位置协方差
+     * @param measurement 观测数据(位置已换算为笛卡尔坐标)
+     * @return 3x3位置协方差矩阵
+     * @details 观测自带协方差时直接使用；球坐标原始观测将其噪声经雅可比矩阵线性化到笛卡尔坐标；
+     *          其余按笛卡尔噪声配置计算
+     */
+    MeasurementNoise cartesianCovariance(const Measurement& measurement) const;
+
+    /**
+     * @brief 构建观测块
+     * @param measurement 观测数据
+     * @return 包含观测模型、观测向量和噪声的观测块
+     * @details 有原始观测时使用该观测者的观测模型，否则按笛卡尔位置观测处理
+     */
+    ObservationBlock observationBlock(const Measurement& measurement) const;
+
+    /**
+     * @brief 批量将原始观测换算为笛卡尔位置
+     * @param measurements 观测数据列表(输入/输出参数)
+     * @return 因观测者未配置对应观测模型而被丢弃的观测数
+     * @details 按观测者分组后使用向量化的三角函数批量换算，结果写入Measurement::position
+     */
+    int convertToCartesian(std::vector<Measurement>& measurements) const;
+
+    /**
+     * @brief 获取观测者配置
+     * @param observerId 观测者ID
+     * @return 观测者配置，未注册时返回默认配置
+     */
+    const SensorConfig& sensor(int observerId) const;
+
+    /**
+     * @brief 已注册的传感器数量
+     * @return 传感器数量(不含默认配置)
+     */
+    int sensorCount() const;
+
+    /**
+     * @brief 对所有传感器位姿做刚体坐标变换
+     * @param rotation 旋转矩阵
+     * @param translation 平移，x' = R x + t
+     * @details 跟踪原点移动时调用，球坐标传感器按新位姿重建观测模型。
+     *          第一次调用的线程即为工作线程，之后从其他线程调用时记录错误并忽略
+     * @return 已变换返回true，调用线程不是工作线程时返回false
+     */
+    bool transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation);
+
+    /**
+     * @brief 计算纯方位观测的视线方向
+     * @param config 观测者配置
+     * @param azimuth 方位角(弧度)
+     * @param elevation 俯仰角(弧度)
+     * @return 跟踪坐标系下的单位方向向量
+     */
+    static Vector3 bearingDirection(const SensorConfig& config, double azimuth, double elevation);
+
+private:
+    /**
+     * @brief 私有构造函数
+     * @details 从配置文件加载传感器表，确保单例模式
+     */
+    SensorRegistry();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    SensorRegistry(const SensorRegistry&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    SensorRegistry& operator=(const SensorRegistry&) = delete;
+
+    /**
+     * @brief 从配置文件加载传感器表
+     * @param fileName 配置文件名
+     * @details 每个传感器对应一个名为 Sensor_<观测者ID> 的配置组
+     */
+    void loadSensors(const QString& fileName);
+
+private:
+    /**
+     * @brief 笛卡尔观测模型
+     * @details 无原始观测的测量统一使用此模型
+     */
+    std::shared_ptr<IMeasurementModel> m_cartesianModel;
+
+    /**
+     * @brief 默认传感器配置
+     * @details 用于未在配置文件中注册的观测者
+     */
+    SensorConfig m_default;
+
+    /**
+     * @brief 传感器配置表
+     * @details 键为观测者ID
+     */
+    std::unordered_map<int, SensorConfig> m_sensors;
+
+    /**
+     * @brief 允许变换传感器位姿的线程
+     * @details 第一次调用transformFrame()时记录，为空表示尚未变换过
+     */
+    std::atomic<QThread*> m_frameThread;
+};
+
+#endif // SENSORREGISTRY_H
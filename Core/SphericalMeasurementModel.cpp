@@ -0,0 +1,65 @@
+#include "SphericalMeasurementModel.h"
+#include <cmath>
+
+SphericalMeasurementModel::SphericalMeasurementModel(const Vector3& sensorPosition,
+                                                     const Eigen::Matrix3d& orientation,
+                                                     bool hasRangeRate)
+    : m_sensorPosition(sensorPosition), m_orientation(orientation), m_hasRangeRate(hasRangeRate)
+{
+}
+
+int SphericalMeasurementModel::dim() const { return m_hasRangeRate ? 4 : 3; }
+bool SphericalMeasurementModel::isLinear() const { return false; }
+
+ObservationVector SphericalMeasurementModel::observe(const StateVector& x) const
+{
+    // 转换到传感器本体坐标系
+    const Vector3 local = m_orientation.transpose() * (x.head<3>() - m_sensorPosition);
+    const double horizontal = std::hypot(local.x(), local.y());
+    const double range = local.norm();
+
+    ObservationVector z(dim());
+    z(0) = range;
+    z(1) = std::atan2(local.x(), local.y());
+    z(2) = std::atan2(local.z(), horizontal);
+
+    if (m_hasRangeRate) {
+        // 径向速度为速度在视线方向上的投影 (传感器视为静止)
+        const Vector3 los = x.head<3>() - m_sensorPosition;
+        z(3) = range > 1e-9 ? los.dot(x.segment<3>(3)) / range : 0.0;
+    }
+    return z;
+}
+
+ObservationVector SphericalMeasurementModel::residual(const ObservationVector& z, const ObservationVector& zPred) const
+{
+    ObservationVector r = z - zPred;
+    r(1) = std::remainder(r(1), 2.0 * EIGEN_PI);
+    return r;
+}
+
+Vector3 SphericalMeasurementModel::toCartesian(const ObservationVector& z) const
+{
+    const double cosEl = std::cos(z(2));
+    const Vector3 local(z(0) * cosEl * std::sin(z(1)),
+                        z(0) * cosEl * std::cos(z(1)),
+                        z(0) * std::sin(z(2)));
+    return m_orientation * local + m_sensorPosition;
+}
+
+void SphericalMeasurementModel::toCartesianBatch(const Eigen::ArrayXd& range,
+                                                 const Eigen::ArrayXd& azimuth,
+                                                 const Eigen::ArrayXd& elevation,
+                                                 Eigen::Matrix3Xd& positions) const
+{
+    const Eigen::Index count = range.size();
+    positions.resize(3, count);
+
+    // 三角函数以数组表达式整体计算，Eigen会将其向量化
+    const Eigen::ArrayXd horizontal = range * elevation.cos();
+    positions.row(0) = (horizontal * azimuth.sin()).matrix().transpose();
+    positions.row(1) = (horizontal * azimuth.cos()).matrix().transpose();
+    positions.row(2) = (range * elevation.sin()).matrix().transpose();
+
+    positions = (m_orientation * positions).colwise() + m_sensorPosition;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file SphericalMeasurementModel.h
+ * @brief 球坐标观测模型头文件
+ * @details 定义了SphericalMeasurementModel类，用于输出距离、方位、俯仰(及径向速度)的雷达类传感器
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef SPHERICALMEASUREMENTMODEL_H
+#define SPHERICALMEASUREMENTMODEL_H
+
+#include "IMeasurementModel.h"
+
+/**
+ * @brief 球坐标观测模型类
+ * @details 观测向量为 (距离, 方位, 俯仰[, 径向速度])，角度单位为弧度。
+ *          方位角在传感器本体坐标系中从y轴(北)起顺时针度量，俯仰角从水平面起向上为正。
+ *          传感器本体坐标系由传感器位置和姿态(偏航、俯仰、横滚)确定。
+ *          该模型是非线性的，滤波更新走立方卡尔曼路径
+ */
+class SphericalMeasurementModel : public IMeasurementModel
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param sensorPosition 传感器在跟踪坐标系中的位置
+     * @param orientation 传感器本体坐标系到跟踪坐标系的旋转矩阵
+     * @param hasRangeRate 观测中是否包含径向速度
+     */
+    SphericalMeasurementModel(const Vector3& sensorPosition,
+                              const Eigen::Matrix3d& orientation,
+                              bool hasRangeRate);
+
+    /**
+     * @brief 获取观测向量的维度
+     * @return 含径向速度时为4，否则为3
+     */
+    int dim() const override;
+
+    /**
+     * @brief 是否为线性观测模型
+     * @return false
+     */
+    bool isLinear() const override;
+
+    /**
+     * @brief 观测映射函数
+     * @param x 状态向量(前3维为位置，其后3维为速度)
+     * @return (距离, 方位, 俯仰[, 径向速度])
+     */
+    ObservationVector observe(const StateVector& x) const override;
+
+    /**
+     * @brief 计算观测残差
+     * @param z 实际观测
+     * @param zPred 预测观测
+     * @return 残差，方位角差规整到(-pi, pi]
+     */
+    ObservationVector residual(const ObservationVector& z, const ObservationVector& zPred) const override;
+
+    /**
+     * @brief 将观测转换为笛卡尔位置
+     * @param z 观测向量
+     * @return 跟踪坐标系下的位置
+     */
+    Vector3 toCartesian(const ObservationVector& z) const override;
+
+    /**
+     * @brief 批量将球坐标观测转换为笛卡尔位置
+     * @param range 距离数组
+     * @param azimuth 方位角数组(弧度)
+     * @param elevation 俯仰角数组(弧度)
+     * @param positions 输出，每列为一个跟踪坐标系下的位置
+     * @details 使用Eigen数组表达式计算三角函数，由Eigen向量化为SIMD指令，
+     *          适合一个周期内同一传感器的大量观测一次性换算
+     */
+    void toCartesianBatch(const Eigen::ArrayXd& range,
+                          const Eigen::ArrayXd& azimuth,
+                          const Eigen::ArrayXd& elevation,
+                          Eigen::Matrix3Xd& positions) const;
+
+private:
+    /**
+     * @brief 传感器位置
+     */
+    Vector3 m_sensorPosition;
+
+    /**
+     * @brief 传感器本体坐标系到跟踪坐标系的旋转矩阵
+     */
+    Eigen::Matrix3d m_orientation;
+
+    /**
+     * @brief 是否包含径向速度
+     */
+    bool m_hasRangeRate;
+};
+
+#endif // SPHERICALMEASUREMENTMODEL_H
@@ -0,0 +1,426 @@
+/**
+ * @file TentativeTrackPool.cpp
+ * @brief 暂定航迹池实现文件
+ * @details 实现了候选目标的关联、alpha-beta滤波和M/N确认逻辑
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TentativeTrackPool.h"
+#include "MetricsRegistry.h"
+#include "SensorRegistry.h"
+#include "LogManager.h"
+#include <QSettings>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[TentativeTrackPool::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[TentativeTrackPool::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[TentativeTrackPool::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[TentativeTrackPool::" << __FUNCTION__ << "] " << msg
+
+namespace {
+
+// 统计命中历史中置位的个数
+int countHits(uint32_t history)
+{
+    int count = 0;
+    for (; history != 0; history &= history - 1) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+
+TentativeTrackPool::TentativeTrackPool()
+    : m_enabled(true),
+      m_confirmM(2),
+      m_confirmN(3),
+      m_alpha(0.5),
+      m_beta(0.2),
+      m_gateDistance(10.0),
+      m_birthDistance(5.0),
+      m_maxSpeed(300.0),
+      m_positionGate(3.0),
+      m_initialVelocityVariance(100.0),
+      m_cellSize(50.0),
+      m_maxCandidates(10000),
+      m_births(0),
+      m_promotions(0),
+      m_deaths(0),
+      m_shedBirths(0),
+      m_shedLastCycle(0)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_enabled = settings.value("Tentative/enabled", true).toBool();
+    m_confirmM = settings.value("Tentative/confirmM", 2).toInt();
+    m_confirmN = settings.value("Tentative/confirmN", 3).toInt();
+    m_alpha = settings.value("Tentative/alpha", 0.5).toDouble();
+    m_beta = settings.value("Tentative/beta", 0.2).toDouble();
+    m_gateDistance = settings.value("Tentative/gateDistance",
+                                    settings.value("KalmanFilter/associationGateDistance", 10.0)).toDouble();
+    m_birthDistance = settings.value("KalmanFilter/newTrackGateDistance", 5.0).toDouble();
+    m_maxSpeed = settings.value("Tentative/maxSpeed", 300.0).toDouble();
+    m_positionGate = settings.value("Tentative/positionGate", 3.0).toDouble();
+    m_initialVelocityVariance = settings.value("KalmanFilter/initialVelocityUncertainty", 100.0).toDouble();
+    m_cellSize = settings.value("Tentative/cellSize", 50.0).toDouble();
+    m_maxCandidates = settings.value("Capacity/maxCandidates", 10000).toInt();
+
+    // 命中历史为32位，N不能超过32
+    m_confirmN = std::max(1, std::min(m_confirmN, 32));
+    m_confirmM = std::max(1, std::min(m_confirmM, m_confirmN));
+
+    LOG_INFO("暂定航迹层" + QString(m_enabled ? "已启用" : "已禁用") + "，确认逻辑: " +
+             QString::number(m_confirmM) + "/" + QString::number(m_confirmN) +
+             "，关联门限: " + QString::number(m_gateDistance) + "米，候选上限: " +
+             QString::number(m_maxCandidates));
+}
+
+
+bool TentativeTrackPool::isEnabled() const
+{
+    return m_enabled;
+}
+
+
+int TentativeTrackPool::size() const
+{
+    return static_cast<int>(m_candidates.size());
+}
+
+
+void TentativeTrackPool::transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation)
+{
+    for (auto& candidate : m_candidates) {
+        const Vector3 position = rotation * Vector3(candidate.position[0], candidate.position[1],
+                                                    candidate.position[2]) + translation;
+        const Vector3 velocity = rotation * Vector3(candidate.velocity[0], candidate.velocity[1],
+                                                    candidate.velocity[2]);
+        // sumP = Σp，sumTP = Σt·p，平移部分分别累加 n·t 和 Σt·t
+        const Vector3 sumP = rotation * Vector3(candidate.sumP[0], candidate.sumP[1], candidate.sumP[2]) +
+                             candidate.hits * translation;
+        const Vector3 sumTP = rotation * Vector3(candidate.sumTP[0], candidate.sumTP[1], candidate.sumTP[2]) +
+                              candidate.sumT * translation;
+        for (int k = 0; k < 3; ++k) {
+            candidate.position[k] = static_cast<float>(position(k));
+            candidate.velocity[k] = static_cast<float>(velocity(k));
+            candidate.sumP[k] = sumP(k);
+            candidate.sumTP[k] = sumTP(k);
+        }
+        // 协方差之和随坐标轴旋转: ΣR' = rotation * ΣR * rotation^T
+        const Eigen::Matrix3d sumR = rotation * (meanNoise(candidate) * candidate.hits) * rotation.transpose();
+        std::fill(std::begin(candidate.sumR), std::end(candidate.sumR), 0.0f);
+        accumulateNoise(candidate, sumR);
+    }
+}
+
+
+size_t TentativeTrackPool::memoryFootprint() const
+{
+    // 空间索引在周期分配区上，计入分配区的占用
+    return m_candidates.capacity() * sizeof(Candidate);
+}
+
+
+void TentativeTrackPool::process(const ArenaVector<int>& unmatched, const std::vector<Measurement>& measurements,
+                                 ArenaVector<Promotion>& promoted, MonotonicArena& arena)
+{
+    // 1. 未关联观测建立空间索引
+    ArenaCellIndex grid(unmatched.size(), arena);
+    double latestTimestamp = -std::numeric_limits<double>::max();
+    for (int idx : unmatched) {
+        const Measurement& m = measurements[idx];
+        grid.insert(cellKey(static_cast<long long>(std::floor(m.position.x() / m_cellSize)),
+                            static_cast<long long>(std::floor(m.position.y() / m_cellSize)),
+                            static_cast<long long>(std::floor(m.position.z() / m_cellSize))), idx);
+        latestTimestamp = std::max(latestTimestamp, m.timestamp);
+    }
+
+    // 2. 候选只查询门限覆盖的网格，按距离从小到大贪心分配
+    //    尚无速度的候选使用运动学可行性门限: 最大速度 x 时间差 + 位置误差门限
+    struct Pair {
+        int candidate;
+        int measurement;
+        double dist;
+    };
+    ArenaVector<Pair> pairs(arena);
+    for (int c = 0; c < static_cast<int>(m_candidates.size()) && !unmatched.empty(); ++c) {
+        const Candidate& candidate = m_candidates[c];
+        const double reach = candidate.hasVelocity ? 0.0 : m_maxSpeed;
+        const double base = candidate.hasVelocity ? m_gateDistance : m_positionGate;
+        const double radius = base + reach * std::max(0.0, latestTimestamp - candidate.lastTime);
+        const Vector3 center = predictedPosition(candidate, latestTimestamp);
+
+        const long long x0 = static_cast<long long>(std::floor((center.x() - radius) / m_cellSize));
+        const long long x1 = static_cast<long long>(std::floor((center.x() + radius) / m_cellSize));
+        const long long y0 = static_cast<long long>(std::floor((center.y() - radius) / m_cellSize));
+        const long long y1 = static_cast<long long>(std::floor((center.y() + radius) / m_cellSize));
+        const long long z0 = static_cast<long long>(std::floor((center.z() - radius) / m_cellSize));
+        const long long z1 = static_cast<long long>(std::floor((center.z() + radius) / m_cellSize));
+        auto test = [&](int idx) {
+            const Measurement& m = measurements[idx];
+            const double gate = base + reach * std::abs(m.timestamp - candidate.lastTime);
+            const double dist2 = (predictedPosition(candidate, m.timestamp) - m.position).squaredNorm();
+            if (dist2 < gate * gate) {
+                pairs.push_back({c, idx, dist2});
+            }
+        };
+
+        // 门限覆盖的网格数多于观测数时(长时间未命中的候选)直接遍历观测
+        const double cellCount = static_cast<double>(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+        if (cellCount > static_cast<double>(unmatched.size())) {
+            for (int idx : unmatched) {
+                test(idx);
+            }
+            continue;
+        }
+        for (long long x = x0; x <= x1; ++x) {
+            for (long long y = y0; y <= y1; ++y) {
+                for (long long z = z0; z <= z1; ++z) {
+                    grid.forEach(cellKey(x, y, z), [&](int idx) {
+                        test(idx);
+                        return false;
+                    });
+                }
+            }
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) { return a.dist < b.dist; });
+
+    ArenaBitset candidateHit(m_candidates.size(), arena);
+    ArenaBitset measurementUsed(measurements.size(), arena);
+    for (const auto& pair : pairs) {
+        if (candidateHit.test(pair.candidate) || measurementUsed.test(pair.measurement)) continue;
+        candidateHit.set(pair.candidate);
+        measurementUsed.set(pair.measurement);
+        updateCandidate(m_candidates[pair.candidate], measurements[pair.measurement]);
+    }
+
+    // 3. 推进命中历史，满足M/N的升级，无望满足的淘汰
+    const uint32_t window = m_confirmN >= 32 ? 0xFFFFFFFFu : ((1u << m_confirmN) - 1u);
+    const uint32_t nextWindow = (1u << (m_confirmN - 1)) - 1u;
+    size_t kept = 0;
+    for (size_t c = 0; c < m_candidates.size(); ++c) {
+        Candidate& candidate = m_candidates[c];
+        candidate.history = (candidate.history << 1) | (candidateHit.test(c) ? 1u : 0u);
+
+        if (countHits(candidate.history & window) >= m_confirmM) {
+            promoted.push_back(makePromotion(candidate));
+            m_promotions++;
+            continue;
+        }
+        // 下个周期仍在窗口内的命中数加上下个周期可能的一次命中仍不足M，则淘汰
+        if (countHits(candidate.history & nextWindow) + 1 < m_confirmM) {
+            m_deaths++;
+            continue;
+        }
+        m_candidates[kept++] = candidate;
+    }
+    m_candidates.resize(kept);
+
+    // 4. 剩余观测建立新候选，同一周期内相距过近的观测只建立一个候选。
+    //    候选数达到上限时已有候选优先，新观测不再建立候选
+    const size_t firstNew = m_candidates.size();
+    m_shedLastCycle = 0;
+    const double birth2 = m_birthDistance * m_birthDistance;
+    ArenaCellIndex birthGrid(unmatched.size(), arena);
+    for (int idx : unmatched) {
+        if (measurementUsed.test(idx)) continue;
+        const Measurement& m = measurements[idx];
+
+        const long long cx = static_cast<long long>(std::floor(m.position.x() / m_birthDistance));
+        const long long cy = static_cast<long long>(std::floor(m.position.y() / m_birthDistance));
+        const long long cz = static_cast<long long>(std::floor(m.position.z() / m_birthDistance));
+        bool duplicate = false;
+        for (long long dx = -1; dx <= 1 && !duplicate; ++dx) {
+            for (long long dy = -1; dy <= 1 && !duplicate; ++dy) {
+                for (long long dz = -1; dz <= 1 && !duplicate; ++dz) {
+                    duplicate = birthGrid.forEach(cellKey(cx + dx, cy + dy, cz + dz), [&](int c) {
+                        const Candidate& other = m_candidates[c];
+                        const Vector3 otherPosition(other.position[0], other.position[1], other.position[2]);
+                        return (otherPosition - m.position).squaredNorm() < birth2;
+                    });
+                }
+            }
+        }
+        if (duplicate) continue;
+
+        if (static_cast<int>(m_candidates.size()) >= m_maxCandidates) {
+            m_shedLastCycle++;
+            continue;
+        }
+
+        Candidate candidate;
+        for (int k = 0; k < 3; ++k) {
+            candidate.position[k] = static_cast<float>(m.position(k));
+            candidate.velocity[k] = 0.0f;
+            candidate.sumP[k] = m.position(k);
+            candidate.sumTP[k] = 0.0;
+        }
+        candidate.lastTime = m.timestamp;
+        candidate.history = 1u;
+        candidate.hits = 1;
+        candidate.hasVelocity = 0;
+        candidate.observerId = m.observerId;
+        candidate.firstTime = m.timestamp;
+        candidate.sumT = 0.0;
+        candidate.sumTT = 0.0;
+        std::fill(std::begin(candidate.sumR), std::end(candidate.sumR), 0.0f);
+        accumulateNoise(candidate, SensorRegistry::instance().cartesianCovariance(m));
+        birthGrid.insert(cellKey(cx, cy, cz), static_cast<int>(m_candidates.size()));
+        m_candidates.push_back(candidate);
+        m_births++;
+    }
+
+    if (m_shedLastCycle > 0) {
+        m_shedBirths += m_shedLastCycle;
+        LOG_WARN("候选数已达上限 " + QString::number(m_maxCandidates) + "，本周期丢弃 " +
+                 QString::number(m_shedLastCycle) + " 条新候选");
+    }
+
+    LOG_DEBUG("候选数: " + QString::number(m_candidates.size()) + "，本周期升级: " +
+              QString::number(promoted.size()) + "，新建: " + QString::number(m_candidates.size() - firstNew));
+}
+
+
+Vector3 TentativeTrackPool::predictedPosition(const Candidate& candidate, double timestamp)
+{
+    const double dt = timestamp - candidate.lastTime;
+    return Vector3(candidate.position[0] + candidate.velocity[0] * dt,
+                   candidate.position[1] + candidate.velocity[1] * dt,
+                   candidate.position[2] + candidate.velocity[2] * dt);
+}
+
+
+void TentativeTrackPool::updateCandidate(Candidate& candidate, const Measurement& measurement) const
+{
+    const double dt = measurement.timestamp - candidate.lastTime;
+    const Vector3 predicted = predictedPosition(candidate, measurement.timestamp);
+    const Vector3 residual = measurement.position - predicted;
+
+    Vector3 position, velocity(candidate.velocity[0], candidate.velocity[1], candidate.velocity[2]);
+    if (!candidate.hasVelocity) {
+        // 两点初始化: 速度取两次观测的差分
+        position = measurement.position;
+        if (dt > 0.0) {
+            velocity = residual / dt;
+            candidate.hasVelocity = 1;
+        }
+    } else {
+        position = predicted + m_alpha * residual;
+        if (dt > 0.0) {
+            velocity += m_beta * residual / dt;
+        }
+    }
+
+    for (int k = 0; k < 3; ++k) {
+        candidate.position[k] = static_cast<float>(position(k));
+        candidate.velocity[k] = static_cast<float>(velocity(k));
+    }
+    candidate.lastTime = std::max(candidate.lastTime, measurement.timestamp);
+
+    // 累加最小二乘拟合所需的和
+    const double t = measurement.timestamp - candidate.firstTime;
+    candidate.sumT += t;
+    candidate.sumTT += t * t;
+    for (int k = 0; k < 3; ++k) {
+        candidate.sumP[k] += measurement.position(k);
+        candidate.sumTP[k] += t * measurement.position(k);
+    }
+    accumulateNoise(candidate, SensorRegistry::instance().cartesianCovariance(measurement));
+    candidate.hits = static_cast<uint8_t>(std::min<int>(candidate.hits + 1, 255));
+    candidate.observerId = measurement.observerId;
+}
+
+
+TentativeTrackPool::Promotion TentativeTrackPool::makePromotion(const Candidate& candidate) const
+{
+    const double n = candidate.hits;
+    const double meanT = candidate.sumT / n;
+    const double Stt = candidate.sumTT - n * meanT * meanT;
+    const double lastT = candidate.lastTime - candidate.firstTime;
+
+    Promotion promotion;
+    promotion.hits = candidate.hits;
+    promotion.covariance.setZero();
+
+    Vector3 position(candidate.position[0], candidate.position[1], candidate.position[2]);
+    Vector3 velocity(candidate.velocity[0], candidate.velocity[1], candidate.velocity[2]);
+    // 各次命中的协方差可能不同(不同观测者、交叉定位伪观测自带几何相关的协方差)，取其平均值
+    const Eigen::Matrix3d R = meanNoise(candidate);
+
+    if (n >= 2 && Stt > 1e-9) {
+        // 各轴 p(t) = p + v*(t - meanT) 的最小二乘拟合，外推到最后一次命中时刻
+        for (int k = 0; k < 3; ++k) {
+            const double meanP = candidate.sumP[k] / n;
+            velocity(k) = (candidate.sumTP[k] - n * meanT * meanP) / Stt;
+            position(k) = meanP + velocity(k) * (lastT - meanT);
+        }
+        const double d = lastT - meanT;
+        promotion.covariance.topLeftCorner<3, 3>() = R * (1.0 / n + d * d / Stt);
+        promotion.covariance.topRightCorner<3, 3>() = R * (d / Stt);
+        promotion.covariance.bottomLeftCorner<3, 3>() = R * (d / Stt);
+        promotion.covariance.bottomRightCorner<3, 3>() = R / Stt;
+    } else {
+        // 只有一次命中(M=1)时没有速度信息，速度方差取初始配置
+        promotion.covariance.topLeftCorner<3, 3>() = R;
+        promotion.covariance.bottomRightCorner<3, 3>() = Eigen::Matrix3d::Identity() * m_initialVelocityVariance;
+    }
+
+    promotion.measurement = Measurement(position, candidate.lastTime, candidate.observerId);
+    promotion.measurement.covariance = promotion.covariance.topLeftCorner<3, 3>();
+    promotion.measurement.hasCovariance = true;
+    promotion.velocity = velocity;
+    return promotion;
+}
+
+
+void TentativeTrackPool::accumulateNoise(Candidate& candidate, const Eigen::Matrix3d& covariance)
+{
+    candidate.sumR[0] += static_cast<float>(covariance(0, 0));
+    candidate.sumR[1] += static_cast<float>(covariance(0, 1));
+    candidate.sumR[2] += static_cast<float>(covariance(0, 2));
+    candidate.sumR[3] += static_cast<float>(covariance(1, 1));
+    candidate.sumR[4] += static_cast<float>(covariance(1, 2));
+    candidate.sumR[5] += static_cast<float>(covariance(2, 2));
+}
+
+
+Eigen::Matrix3d TentativeTrackPool::meanNoise(const Candidate& candidate)
+{
+    Eigen::Matrix3d R;
+    R << candidate.sumR[0], candidate.sumR[1], candidate.sumR[2],
+         candidate.sumR[1], candidate.sumR[3], candidate.sumR[4],
+         candidate.sumR[2], candidate.sumR[4], candidate.sumR[5];
+    return R / std::max<int>(1, candidate.hits);
+}
+
+
+long long TentativeTrackPool::cellKey(long long x, long long y, long long z)
+{
+    // 每个坐标占21位，覆盖 ±2^20 个网格
+    const long long mask = (1LL << 21) - 1;
+    return ((x & mask) << 42) | ((y & mask) << 21) | (z & mask);
+}
+
+
+void TentativeTrackPool::publishMetrics() const
+{
+    nlohmann::json metrics;
+    metrics["candidates"] = m_candidates.size();
+    metrics["births"] = m_births;
+    metrics["promotions"] = m_promotions;
+    metrics["deaths"] = m_deaths;
+    g_Metrics.setSection("tentative", metrics);
+
+    nlohmann::json capacity;
+    capacity["count"] = m_candidates.size();
+    capacity["limit"] = m_maxCandidates;
+    capacity["shed"] = m_shedBirths;
+    capacity["shedLastCycle"] = m_shedLastCycle;
+    g_Metrics.setValue("capacity", "candidates", capacity);
+}
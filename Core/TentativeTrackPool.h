@@ -0,0 +1,254 @@
+/**
+ * @file TentativeTrackPool.h
+ * @brief 暂定航迹池头文件
+ * @details 定义了TentativeTrackPool类，以紧凑记录保存尚未确认的候选目标，
+ *          通过M/N逻辑确认后才升级为完整的滤波航迹
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef TENTATIVETRACKPOOL_H
+#define TENTATIVETRACKPOOL_H
+
+#include "DataStructures.h"
+#include "MonotonicArena.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 暂定航迹池类
+ * @details 杂波环境下大多数未匹配观测只会存在几个周期。候选目标以紧凑记录
+ *          保存在连续数组中，只用alpha-beta滤波(首次关联时为两点差分)估计位置和速度，
+ *          每周期的开销只有几次浮点运算。候选在最近N个周期内命中至少M次后升级为完整航迹，
+ *          已不可能满足M/N条件的候选被淘汰。
+ *          未关联观测按网格建立空间索引，候选只查询其关联门限覆盖的网格；
+ *          尚无速度估计的候选使用运动学可行性门限(最大速度 x 时间差 + 位置误差门限)。
+ *          升级时以全部命中点的最小二乘直线拟合给出位置、速度及其协方差
+ */
+class TentativeTrackPool
+{
+public:
+    /**
+     * @brief 升级为完整航迹的候选
+     */
+    struct Promotion {
+        Measurement measurement;   ///< 用于创建航迹的观测，位置为拟合位置
+        Vector3 velocity;          ///< 拟合速度
+        Eigen::Matrix<double, 6, 6, Eigen::DontAlign> covariance;  ///< [p, v] 的协方差
+        int hits;                  ///< 候选阶段的命中次数
+    };
+
+    /**
+     * @brief 构造函数
+     * @details 从配置文件读取M/N参数、alpha-beta增益和关联门限
+     */
+    TentativeTrackPool();
+
+    /**
+     * @brief 是否启用暂定航迹层
+     * @return 启用返回true
+     */
+    bool isEnabled() const;
+
+    /**
+     * @brief 处理一个周期中未被航迹关联的观测
+     * @param unmatched 未关联观测的索引
+     * @param measurements 本周期观测数据
+     * @param promoted 输出，本周期满足M/N条件的候选
+     * @param arena 周期分配区，本周期的临时数据在其上分配
+     * @details 先将观测关联到已有候选并更新，再淘汰无望确认的候选，
+     *          剩余观测建立新候选
+     */
+    void process(const ArenaVector<int>& unmatched, const std::vector<Measurement>& measurements,
+                 ArenaVector<Promotion>& promoted, MonotonicArena& arena);
+
+    /**
+     * @brief 当前候选数
+     * @return 候选数
+     */
+    int size() const;
+
+    /**
+     * @brief 估算候选池占用的内存
+     * @return 字节数，即候选数组的容量，空间索引在周期分配区上不计入
+     */
+    size_t memoryFootprint() const;
+
+    /**
+     * @brief 发布候选池指标
+     * @details 由航迹管理器在周期末统一发布
+     */
+    void publishMetrics() const;
+
+    /**
+     * @brief 对候选做刚体坐标变换
+     * @param rotation 旋转矩阵
+     * @param translation 平移，x' = R x + t
+     * @details 位置、速度和拟合累加量随坐标系变换，拟合结果与在新坐标系下重新累加一致
+     */
+    void transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation);
+
+private:
+    /**
+     * @brief 候选目标紧凑记录
+     * @details 位置和速度以单精度保存，足以满足候选阶段的关联需要
+     */
+    struct Candidate {
+        float position[3];    ///< 滤波位置
+        float velocity[3];    ///< 估计速度
+        double lastTime;      ///< 最近一次命中的时间戳
+        uint32_t history;     ///< 命中历史，最低位为最近一个周期
+        uint8_t hits;         ///< 累计命中次数
+        uint8_t hasVelocity;  ///< 是否已有速度估计(命中两次以上)
+        int observerId;       ///< 最近一次命中的观测者ID
+        double firstTime;     ///< 首次命中的时间戳，拟合时间的原点
+        double sumT;          ///< 命中时间之和
+        double sumTT;         ///< 命中时间平方之和
+        double sumP[3];       ///< 命中位置之和
+        double sumTP[3];      ///< 命中时间与位置乘积之和
+        float sumR[6];        ///< 命中位置协方差之和，上三角 xx, xy, xz, yy, yz, zz
+    };
+
+    /**
+     * @brief 候选在指定时刻的预测位置
+     * @param candidate 候选
+     * @param timestamp 时间戳
+     * @return 预测位置
+     */
+    static Vector3 predictedPosition(const Candidate& candidate, double timestamp);
+
+    /**
+     * @brief 将一次命中的位置协方差累加到候选
+     * @param candidate 候选
+     * @param covariance 位置协方差
+     */
+    static void accumulateNoise(Candidate& candidate, const Eigen::Matrix3d& covariance);
+
+    /**
+     * @brief 候选各次命中的平均位置协方差
+     * @param candidate 候选
+     * @return 3x3位置协方差
+     */
+    static Eigen::Matrix3d meanNoise(const Candidate& candidate);
+
+    /**
+     * @brief 以观测更新候选
+     * @param candidate 候选
+     * @param measurement 观测
+     */
+    void updateCandidate(Candidate& candidate, const Measurement& measurement) const;
+
+    /**
+     * @brief 由候选的命中点拟合升级所需的状态
+     * @param candidate 候选
+     * @return 升级记录
+     * @details 对各轴做 p = p0 + v*t 的最小二乘拟合，协方差按观测噪声传播
+     */
+    Promotion makePromotion(const Candidate& candidate) const;
+
+    /**
+     * @brief 计算网格坐标的哈希键
+     * @param x 网格x坐标
+     * @param y 网格y坐标
+     * @param z 网格z坐标
+     * @return 哈希键
+     */
+    static long long cellKey(long long x, long long y, long long z);
+
+private:
+    /**
+     * @brief 是否启用暂定航迹层
+     */
+    bool m_enabled;
+
+    /**
+     * @brief M/N确认逻辑中的M
+     */
+    int m_confirmM;
+
+    /**
+     * @brief M/N确认逻辑中的N
+     */
+    int m_confirmN;
+
+    /**
+     * @brief alpha-beta滤波的位置增益
+     */
+    double m_alpha;
+
+    /**
+     * @brief alpha-beta滤波的速度增益
+     */
+    double m_beta;
+
+    /**
+     * @brief 候选关联门限(米)
+     */
+    double m_gateDistance;
+
+    /**
+     * @brief 新候选去重距离(米)
+     * @details 同一周期内距离新建候选小于此值的观测不再单独建立候选
+     */
+    double m_birthDistance;
+
+    /**
+     * @brief 目标最大速度(米/秒)
+     * @details 尚无速度估计的候选以 最大速度 x 时间差 + 位置误差门限 作为可行性门限
+     */
+    double m_maxSpeed;
+
+    /**
+     * @brief 运动学可行性门限中的位置误差部分(米)
+     */
+    double m_positionGate;
+
+    /**
+     * @brief 只有一次命中时升级航迹的速度方差
+     * @details 与运动模型的初始速度方差取同一配置项，构造时读取一次
+     */
+    double m_initialVelocityVariance;
+
+    /**
+     * @brief 空间索引网格边长(米)
+     */
+    double m_cellSize;
+
+    /**
+     * @brief 候选数上限
+     * @details 达到上限后不再建立新候选，防止杂波突发时候选池无限增长
+     */
+    int m_maxCandidates;
+
+    /**
+     * @brief 候选记录
+     */
+    std::vector<Candidate> m_candidates;
+
+    /**
+     * @brief 累计新建候选数
+     */
+    long long m_births;
+
+    /**
+     * @brief 累计升级为航迹的候选数
+     */
+    long long m_promotions;
+
+    /**
+     * @brief 累计淘汰的候选数
+     */
+    long long m_deaths;
+
+    /**
+     * @brief 累计因候选数达到上限而丢弃的新候选数
+     */
+    long long m_shedBirths;
+
+    /**
+     * @brief 最近一个周期丢弃的新候选数
+     */
+    int m_shedLastCycle;
+};
+
+#endif // TENTATIVETRACKPOOL_H
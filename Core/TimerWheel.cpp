@@ -0,0 +1,202 @@
+/**
+ * @file TimerWheel.cpp
+ * @brief 分层时间轮实现文件
+ * @details 实现了条目的调度、级联和到期处理
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TimerWheel.h"
+#include <algorithm>
+#include <cmath>
+
+
+TimerWheel::TimerWheel(double resolution)
+    : m_resolution(resolution > 0 ? resolution : 0.05),
+      m_currentTick(0),
+      m_started(false)
+{
+    std::fill(m_heads, m_heads + kLevels * kSlots, -1);
+}
+
+
+void TimerWheel::schedule(int id, double deadline)
+{
+    // 到期刻度取到期时间所在刻度的下一个刻度，保证触发时已严格超过到期时间
+    const long long expiry = static_cast<long long>(std::floor(deadline / m_resolution)) + 1;
+    if (!m_started) {
+        // 尚不知道当前时间，先把起点放到足够早的位置，第一次推进时整体重建
+        m_currentTick = expiry - (1LL << (kSlotBits * (kLevels - 1)));
+        m_started = true;
+    }
+
+    int nodeIdx;
+    auto it = m_index.find(id);
+    if (it != m_index.end()) {
+        nodeIdx = it->second;
+        unlink(nodeIdx);
+    } else {
+        if (m_freeNodes.empty()) {
+            nodeIdx = static_cast<int>(m_nodes.size());
+            m_nodes.push_back(Node());
+        } else {
+            nodeIdx = m_freeNodes.back();
+            m_freeNodes.pop_back();
+        }
+        m_nodes[nodeIdx].id = id;
+        m_index.emplace(id, nodeIdx);
+    }
+
+    m_nodes[nodeIdx].expiry = expiry;
+    // 当前刻度的槽已处理过，已到期的条目在下一个刻度触发
+    insert(nodeIdx, m_currentTick + 1);
+}
+
+
+void TimerWheel::cancel(int id)
+{
+    auto it = m_index.find(id);
+    if (it != m_index.end()) {
+        release(it->second);
+    }
+}
+
+
+void TimerWheel::advance(double now, std::vector<int>& expired)
+{
+    const long long nowTick = static_cast<long long>(std::floor(now / m_resolution));
+    if (!m_started || m_index.empty()) {
+        m_currentTick = m_started ? std::max(m_currentTick, nowTick) : nowTick;
+        m_started = true;
+        return;
+    }
+    if (nowTick <= m_currentTick) {
+        return;
+    }
+
+    // 时间跳变远超第1层的覆盖范围时，逐刻度推进不划算，直接重建
+    if (nowTick - m_currentTick > static_cast<long long>(kSlots) * kSlots) {
+        m_currentTick = nowTick;
+        std::vector<int> pending;
+        pending.reserve(m_index.size());
+        for (const auto& entry : m_index) {
+            pending.push_back(entry.second);
+        }
+        for (int nodeIdx : pending) {
+            unlink(nodeIdx);
+            if (m_nodes[nodeIdx].expiry <= m_currentTick) {
+                expired.push_back(m_nodes[nodeIdx].id);
+                release(nodeIdx);
+            } else {
+                insert(nodeIdx, m_currentTick + 1);
+            }
+        }
+        return;
+    }
+
+    while (m_currentTick < nowTick) {
+        m_currentTick++;
+
+        // 下层转完一圈时，把上层当前槽的条目级联到下层
+        for (int level = 1; level < kLevels; ++level) {
+            if ((m_currentTick & ((1LL << (kSlotBits * level)) - 1)) != 0) break;
+            cascade(level * kSlots + static_cast<int>((m_currentTick >> (kSlotBits * level)) & (kSlots - 1)));
+        }
+
+        const int slot = static_cast<int>(m_currentTick & (kSlots - 1));
+        int nodeIdx = m_heads[slot];
+        m_heads[slot] = -1;
+        while (nodeIdx >= 0) {
+            const int next = m_nodes[nodeIdx].next;
+            m_nodes[nodeIdx].slot = -1;
+            if (m_nodes[nodeIdx].expiry <= m_currentTick) {
+                expired.push_back(m_nodes[nodeIdx].id);
+                release(nodeIdx);
+            } else {
+                // 超出时间轮覆盖范围而被截断的条目重新分配
+                insert(nodeIdx, m_currentTick + 1);
+            }
+            nodeIdx = next;
+        }
+    }
+}
+
+
+int TimerWheel::size() const
+{
+    return static_cast<int>(m_index.size());
+}
+
+
+size_t TimerWheel::memoryFootprint() const
+{
+    return sizeof(TimerWheel) + m_nodes.capacity() * sizeof(Node) + m_freeNodes.capacity() * sizeof(int) +
+           m_index.bucket_count() * sizeof(void*) +
+           m_index.size() * (sizeof(std::pair<const int, int>) + 2 * sizeof(void*));
+}
+
+
+void TimerWheel::insert(int nodeIdx, long long earliest)
+{
+    Node& node = m_nodes[nodeIdx];
+
+    long long expiry = std::max(node.expiry, earliest);
+    const long long delta = expiry - m_currentTick;
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= (1LL << (kSlotBits * (level + 1)))) {
+        level++;
+    }
+    const long long range = 1LL << (kSlotBits * kLevels);
+    if (delta >= range) {
+        expiry = m_currentTick + range - 1;
+    }
+
+    const int slot = level * kSlots + static_cast<int>((expiry >> (kSlotBits * level)) & (kSlots - 1));
+    node.slot = slot;
+    node.prev = -1;
+    node.next = m_heads[slot];
+    if (node.next >= 0) {
+        m_nodes[node.next].prev = nodeIdx;
+    }
+    m_heads[slot] = nodeIdx;
+}
+
+
+void TimerWheel::unlink(int nodeIdx)
+{
+    Node& node = m_nodes[nodeIdx];
+    if (node.slot < 0) {
+        return;
+    }
+    if (node.prev >= 0) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        m_heads[node.slot] = node.next;
+    }
+    if (node.next >= 0) {
+        m_nodes[node.next].prev = node.prev;
+    }
+    node.slot = -1;
+}
+
+
+void TimerWheel::cascade(int slot)
+{
+    int nodeIdx = m_heads[slot];
+    m_heads[slot] = -1;
+    while (nodeIdx >= 0) {
+        const int next = m_nodes[nodeIdx].next;
+        m_nodes[nodeIdx].slot = -1;
+        insert(nodeIdx, m_currentTick);
+        nodeIdx = next;
+    }
+}
+
+
+void TimerWheel::release(int nodeIdx)
+{
+    unlink(nodeIdx);
+    m_index.erase(m_nodes[nodeIdx].id);
+    m_freeNodes.push_back(nodeIdx);
+}
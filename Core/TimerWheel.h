@@ -0,0 +1,157 @@
+/**
+ * @file TimerWheel.h
+ * @brief 分层时间轮头文件
+ * @details 定义了TimerWheel类，按到期时间管理大量定时条目，用于航迹超时删除
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief 分层时间轮类
+ * @details 时间按固定分辨率离散为刻度。共4层，每层64个槽:
+ *          第0层每槽1个刻度，第k层每槽64^k个刻度，覆盖 64^4 个刻度。
+ *          条目按距离到期的刻度数放入对应层，时间推进到上层槽的边界时把该槽条目重新分配到下层(级联)。
+ *          条目以双向链表挂在槽上，调度、改期和取消均为O(1)，
+ *          推进时间的开销只与经过的刻度数和到期(或级联)的条目数有关，与条目总数无关
+ */
+class TimerWheel
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param resolution 刻度分辨率(秒)
+     */
+    explicit TimerWheel(double resolution);
+
+    /**
+     * @brief 调度或改期一个条目
+     * @param id 条目ID
+     * @param deadline 到期时间(秒)
+     * @details 条目已存在时移动到新的到期时间。
+     *          条目只在时间推进到严格晚于到期时间的刻度时触发，最多晚一个分辨率
+     */
+    void schedule(int id, double deadline);
+
+    /**
+     * @brief 取消一个条目
+     * @param id 条目ID
+     */
+    void cancel(int id);
+
+    /**
+     * @brief 推进时间并取出到期条目
+     * @param now 当前时间(秒)
+     * @param expired 输出，本次到期的条目ID(追加)
+     */
+    void advance(double now, std::vector<int>& expired);
+
+    /**
+     * @brief 获取条目数
+     * @return 尚未到期的条目数
+     */
+    int size() const;
+
+    /**
+     * @brief 估算时间轮占用的内存
+     * @return 字节数，含节点池和ID索引
+     */
+    size_t memoryFootprint() const;
+
+private:
+    /**
+     * @brief 链表节点
+     */
+    struct Node {
+        int id;               ///< 条目ID
+        long long expiry;     ///< 到期刻度
+        int prev;             ///< 前一节点，-1表示链表头
+        int next;             ///< 后一节点，-1表示链表尾
+        int slot;             ///< 所在槽的全局编号(层 x 64 + 槽)，-1表示空闲
+    };
+
+    /**
+     * @brief 按到期刻度把节点挂到对应的槽
+     * @param nodeIdx 节点索引
+     * @param earliest 最早可挂入的刻度，早于它到期的节点挂到该刻度
+     */
+    void insert(int nodeIdx, long long earliest);
+
+    /**
+     * @brief 把节点从所在槽摘下
+     * @param nodeIdx 节点索引
+     */
+    void unlink(int nodeIdx);
+
+    /**
+     * @brief 把一个槽的全部节点重新分配到下层
+     * @param slot 槽的全局编号
+     */
+    void cascade(int slot);
+
+    /**
+     * @brief 释放节点
+     * @param nodeIdx 节点索引
+     */
+    void release(int nodeIdx);
+
+private:
+    /**
+     * @brief 层数
+     */
+    static const int kLevels = 4;
+
+    /**
+     * @brief 每层槽位数的位数
+     */
+    static const int kSlotBits = 6;
+
+    /**
+     * @brief 每层槽位数
+     */
+    static const int kSlots = 1 << kSlotBits;
+
+    /**
+     * @brief 刻度分辨率(秒)
+     */
+    double m_resolution;
+
+    /**
+     * @brief 当前刻度
+     * @details 刻度不大于它的条目均已触发
+     */
+    long long m_currentTick;
+
+    /**
+     * @brief 是否已确定起始刻度
+     */
+    bool m_started;
+
+    /**
+     * @brief 各槽的链表头节点索引，-1表示空槽
+     */
+    int m_heads[kLevels * kSlots];
+
+    /**
+     * @brief 节点池
+     */
+    std::vector<Node> m_nodes;
+
+    /**
+     * @brief 空闲节点索引
+     */
+    std::vector<int> m_freeNodes;
+
+    /**
+     * @brief 条目ID到节点索引的映射
+     */
+    std::unordered_map<int, int> m_index;
+};
+
+#endif // TIMERWHEEL_H
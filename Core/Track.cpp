@@ -8,7 +8,11 @@
 
 #include "Track.h"
 #include "LogManager.h"
+#include "SensorRegistry.h"
+#include "ConstantVelocityModel.h"
+#include "ConstantAccelerationModel.h"
 #include <QSettings>
+#include <algorithm>
 
 // 定义统一的日志宏
 #define LOG_DEBUG(msg) qDebug() << "[Track::" << __FUNCTION__ << "] " << msg
@@ -35,6 +39,11 @@ static QString vectorToString(const StateVector& v) {
     return s;
 }
 
+/**
+ * @brief 观测块缓冲，每次更新复用，避免每条航迹每周期分配
+ */
+static thread_local std::vector<ObservationBlock> t_blocks;
+
 /**
  * @brief 构造函数
  * @param initialMeasurement 初始观测数据
@@ -47,39 +56,41 @@ Track::Track(const Measurement& initialMeasurement, int trackId, std::unique_ptr
       m_model(std::move(model)),
       m_age(0),
       m_hits(1),
-      m_misses(0),
       m_confirmationHits(0),
-      maxMissesToDelete(0)
+      m_modelSwitching(false),
+      m_nisAverage(1.0),
+      m_quietUpdates(0),
+      m_nisAlpha(0.3),
+      m_promoteNis(2.6),
+      m_demoteNis(1.5),
+      m_demoteUpdates(10),
+      m_accelerationGate(7.81),
+      m_accelerationUncertainty(10.0),
+      m_recenterDistance(0.0)
 {
     LOG_FUNCTION_BEGIN();
 
     // 从配置文件读取参数
     QSettings settings("Server.ini", QSettings::IniFormat);
 
-    // 读取观测噪声
-    double measurement_noise_std = settings.value("KalmanFilter/measurementNoiseStd", 2.0).toDouble();
-    LOG_DEBUG("观测噪声标准差: " + QString::number(measurement_noise_std));
-
     // 读取生命周期参数
     m_confirmationHits = settings.value("KalmanFilter/confirmationHits", 3).toInt();
-    maxMissesToDelete = settings.value("KalmanFilter/maxMissesToDelete", 5).toInt();
-    LOG_DEBUG("确认所需命中次数: " + QString::number(m_confirmationHits) +
-              ", 删除所需丢失次数: " + QString::number(maxMissesToDelete));
+    LOG_DEBUG("确认所需命中次数: " + QString::number(m_confirmationHits));
 
     // 初始化状态向量
     m_x.resize(m_model->stateDim());
     m_x.head<3>() = initialMeasurement.position;
     m_x.tail(m_model->stateDim() - 3).setZero();
 
-    // 初始化协方差矩阵 P
+    // 初始化协方差矩阵 P，观测自带协方差(交叉定位伪观测、融合观测)时位置部分取观测协方差
     m_P = m_model->getInitialCovariance();
-
-    // 初始化观测噪声矩阵
-    m_R = Eigen::MatrixXd::Identity(m_model->measurementDim(), m_model->measurementDim()) *
-          std::pow(measurement_noise_std, 2);
+    if (initialMeasurement.hasCovariance) {
+        m_P.topLeftCorner<3, 3>() = initialMeasurement.covariance;
+    }
 
     // 设置最后更新时间
     m_lastUpdateTime = initialMeasurement.timestamp;
+    m_extent = initialMeasurement.extent;
 
     LOG_INFO("航迹 " + QString::number(m_id) + " 已创建。初始位置: (" +
              QString::number(initialMeasurement.position.x(), 'f', 2) + ", " +
@@ -91,13 +102,31 @@ Track::Track(const Measurement& initialMeasurement, int trackId, std::unique_ptr
     LOG_FUNCTION_END();
 }
 
+/**
+ * @brief 构造交互式多模型航迹
+ * @param initialMeasurement 初始观测数据
+ * @param trackId 航迹ID
+ * @param imm 交互式多模型滤波器
+ */
+Track::Track(const Measurement& initialMeasurement, int trackId, std::unique_ptr<ImmFilter> imm)
+    : Track(initialMeasurement, trackId, std::unique_ptr<IMotionModel>(new ConstantAccelerationModel()))
+{
+    m_imm = std::move(imm);
+    m_imm->getEstimate(m_x, m_P);
+    if (initialMeasurement.hasCovariance) {
+        StateMatrix P = m_P.topLeftCorner<6, 6>();
+        P.topLeftCorner<3, 3>() = initialMeasurement.covariance;
+        m_imm->seed(m_x.segment<3>(3), P);
+        m_imm->getEstimate(m_x, m_P);
+    }
+}
+
 /**
  * @brief 析构函数
  */
 Track::~Track() {
     LOG_INFO("航迹 " + QString::number(m_id) + " 已销毁。生命周期统计 - 年龄: " +
-             QString::number(m_age) + ", 命中数: " + QString::number(m_hits) +
-             ", 最后丢失数: " + QString::number(m_misses));
+             QString::number(m_age) + ", 命中数: " + QString::number(m_hits));
 }
 
 /**
@@ -115,7 +144,15 @@ void Track::predict(double dt)
     LOG_DEBUG("航迹 " + QString::number(m_id) + " 预测前状态: " + vectorToString(m_x));
 
     // 调用滤波器进行预测
-    m_filter.predict(m_x, m_P, *m_model, dt);
+    if (m_imm) {
+        m_imm->predict(dt);
+        m_imm->getEstimate(m_x, m_P);
+    } else if (m_compact) {
+        m_compact->predict(dt);
+        m_compact->exportState(m_x, m_P);
+    } else {
+        m_filter.predict(m_x, m_P, *m_model, dt);
+    }
     m_age++;
 
     LOG_DEBUG("航迹 " + QString::number(m_id) + " 预测后状态: " + vectorToString(m_x) +
@@ -135,19 +172,150 @@ void Track::update(const Measurement& measurement)
               QString::number(measurement.position.y(), 'f', 2) + ", " +
               QString::number(measurement.position.z(), 'f', 2) + ")");
 
-    // 调用滤波器进行更新
-    m_filter.update(m_x, m_P, *m_model, measurement.position, m_R);
+    // 按观测者查询观测模型和观测噪声，调用滤波器进行更新
+    t_blocks.clear();
+    t_blocks.push_back(SensorRegistry::instance().observationBlock(measurement));
+    updateFilter(t_blocks);
 
     // 更新航迹统计信息
     m_hits++;
-    m_misses = 0;
     m_lastUpdateTime = measurement.timestamp;
+    if (!measurement.extent.isZero()) {
+        m_extent = measurement.extent;
+    }
 
     LOG_DEBUG("航迹 " + QString::number(m_id) + " 更新后状态: " + vectorToString(m_x));
     LOG_DEBUG("命中计数增加到: " + QString::number(m_hits) +
               ", 确认状态: " + (isConfirmed() ? "已确认" : "未确认"));
 }
 
+/**
+ * @brief 使用多个观测者的观测联合更新航迹状态
+ * @param measurements 同一周期内来自不同观测者的观测数据
+ * @details 所有观测堆叠为一次更新，避免逐个顺序更新带来的重复计算
+ */
+void Track::update(const std::vector<const Measurement*>& measurements)
+{
+    if (measurements.empty()) {
+        return;
+    }
+    if (measurements.size() == 1) {
+        update(*measurements.front());
+        return;
+    }
+
+    LOG_DEBUG("航迹 " + QString::number(m_id) + " 联合更新前状态: " + vectorToString(m_x) +
+              ", 观测数: " + QString::number(measurements.size()));
+
+    t_blocks.clear();
+    double latestTimestamp = m_lastUpdateTime;
+    Vector3 extent = Vector3::Zero();
+    for (const Measurement* measurement : measurements) {
+        t_blocks.push_back(SensorRegistry::instance().observationBlock(*measurement));
+        latestTimestamp = std::max(latestTimestamp, measurement->timestamp);
+        extent = extent.cwiseMax(measurement->extent);
+    }
+
+    // 与单观测更新一致，外形尺寸取本次观测的值(多个观测取各轴最大值)，而不是与历史值累积
+    if (!extent.isZero()) {
+        m_extent = extent;
+    }
+
+    // 调用滤波器进行堆叠更新，各观测者可使用不同的观测模型
+    updateFilter(t_blocks);
+
+    // 一次联合更新只计为一次命中，避免多传感器加速航迹确认
+    m_hits++;
+    m_lastUpdateTime = latestTimestamp;
+
+    LOG_DEBUG("航迹 " + QString::number(m_id) + " 联合更新后状态: " + vectorToString(m_x));
+}
+
+/**
+ * @brief 以观测块更新滤波器
+ * @param blocks 观测块
+ * @return 新息统计量
+ */
+InnovationStats Track::updateFilter(const std::vector<ObservationBlock>& blocks)
+{
+    if (m_imm) {
+        const InnovationStats stats = m_imm->update(blocks);
+        m_imm->getEstimate(m_x, m_P);
+        return stats;
+    }
+
+    InnovationStats stats;
+    if (m_compact && m_compact->update(blocks, stats)) {
+        m_compact->exportState(m_x, m_P);
+    } else {
+        // 含非线性观测时以双精度立方卡尔曼滤波更新，再载回单精度滤波器
+        stats = m_filter.updateStacked(m_x, m_P, blocks);
+        if (m_compact) {
+            m_compact->importState(m_x, m_P);
+        }
+    }
+    if (m_modelSwitching) {
+        manageModel(stats);
+    }
+    return stats;
+}
+
+/**
+ * @brief 根据新息统计量在CV与CA之间切换
+ * @param stats 本次更新的新息统计量
+ */
+void Track::manageModel(const InnovationStats& stats)
+{
+    if (stats.dim == 0) {
+        return;
+    }
+
+    m_nisAverage = (1.0 - m_nisAlpha) * m_nisAverage + m_nisAlpha * stats.nis / stats.dim;
+
+    if (m_model->stateDim() == 6) {
+        if (m_nisAverage <= m_promoteNis) {
+            return;
+        }
+
+        // CV -> CA: 加速度初值为零，与原状态不相关
+        StateVector x = StateVector::Zero(9);
+        x.head<6>() = m_x;
+        StateMatrix P = StateMatrix::Zero(9, 9);
+        P.topLeftCorner<6, 6>() = m_P;
+        P.bottomRightCorner<3, 3>() = Eigen::Matrix3d::Identity() * m_accelerationUncertainty;
+
+        m_x = x;
+        m_P = P;
+        m_model.swap(m_standbyModel);
+        syncCompactFilter();
+        m_nisAverage = 1.0;
+        m_quietUpdates = 0;
+        LOG_INFO("航迹 " + QString::number(m_id) + " 检测到机动，升级为CA模型");
+        return;
+    }
+
+    // CA -> CV: 新息平稳且加速度不显著时边缘化掉加速度
+    const Vector3 acceleration = m_x.segment<3>(6);
+    const Eigen::Matrix3d accCovariance = m_P.block<3, 3>(6, 6);
+    const double significance = acceleration.dot(accCovariance.ldlt().solve(acceleration));
+    if (m_nisAverage < m_demoteNis && significance < m_accelerationGate) {
+        m_quietUpdates++;
+    } else {
+        m_quietUpdates = 0;
+    }
+    if (m_quietUpdates < m_demoteUpdates) {
+        return;
+    }
+
+    m_x.conservativeResize(6);
+    m_P.conservativeResize(6, 6);
+    m_model.swap(m_standbyModel);
+    syncCompactFilter();
+    m_nisAverage = 1.0;
+    m_quietUpdates = 0;
+    LOG_INFO("航迹 " + QString::number(m_id) + " 机动结束，降级为CV模型");
+}
+
 /**
  * @brief 预测未来轨迹
  * @param timeHorizon 预测时间范围(秒)
@@ -208,6 +376,14 @@ const StateVector& Track::getState() const {
     return m_x;
 }
 
+/**
+ * @brief 获取当前状态协方差
+ * @return 协方差矩阵的常引用
+ */
+const StateMatrix& Track::getCovariance() const {
+    return m_P;
+}
+
 /**
  * @brief 获取命中次数
  * @return 命中次数
@@ -217,49 +393,178 @@ int Track::getHits() const {
 }
 
 /**
- * @brief 获取丢失次数
- * @return 连续丢失次数
+ * @brief 获取目标外形尺寸
+ * @return 包围盒边长
  */
-int Track::getMisses() const {
-    return m_misses;
+const Vector3& Track::getExtent() const {
+    return m_extent;
 }
 
 /**
- * @brief 获取最后更新时间
- * @return 最后一次更新的时间戳
+ * @brief 获取交互式多模型滤波器
+ * @return IMM航迹返回滤波器指针，否则返回nullptr
  */
-double Track::getLastUpdateTime() const {
-    return m_lastUpdateTime;
+const ImmFilter* Track::getImm() const {
+    return m_imm.get();
 }
 
 /**
- * @brief 检查航迹是否已确认
- * @return 如果航迹已确认则返回true
+ * @brief 以起始阶段的估计初始化航迹
+ * @param velocity 估计速度
+ * @param covariance 位置和速度的协方差
+ * @param hits 起始阶段已累计的命中次数
  */
-bool Track::isConfirmed() const {
-    return m_hits >= m_confirmationHits;
+void Track::seed(const Vector3& velocity, const StateMatrix& covariance, int hits)
+{
+    if (m_imm) {
+        m_imm->seed(velocity, covariance);
+        m_imm->getEstimate(m_x, m_P);
+    } else {
+        // 加速度等其余分量保持初始不确定度，与位置速度不相关
+        const int n = m_model->stateDim();
+        m_x.segment<3>(3) = velocity;
+        m_P.topLeftCorner<6, 6>() = covariance;
+        m_P.topRightCorner(6, n - 6).setZero();
+        m_P.bottomLeftCorner(n - 6, 6).setZero();
+        if (m_compact) {
+            m_compact->importState(m_x, m_P);
+        }
+    }
+    m_hits = std::max(m_hits, hits);
+
+    LOG_DEBUG("航迹 " + QString::number(m_id) + " 初始速度: (" +
+              QString::number(velocity.x(), 'f', 2) + ", " +
+              QString::number(velocity.y(), 'f', 2) + ", " +
+              QString::number(velocity.z(), 'f', 2) + ")，命中数: " + QString::number(m_hits));
+}
+
+/**
+ * @brief 对航迹状态做刚体坐标变换
+ * @param rotation 旋转矩阵
+ * @param translation 平移
+ */
+void Track::transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation)
+{
+    if (m_imm) {
+        m_imm->transformFrame(rotation, translation);
+        m_imm->getEstimate(m_x, m_P);
+        return;
+    }
+
+    // 状态按 [p, v, a] 的3维块排列，变换矩阵为块对角的旋转
+    const int n = static_cast<int>(m_x.size());
+    StateMatrix T = StateMatrix::Identity(n, n);
+    for (int k = 0; k + 3 <= n; k += 3) {
+        T.block<3, 3>(k, k) = rotation;
+    }
+    m_x = T * m_x;
+    m_x.head<3>() += translation;
+    m_P = T * m_P * T.transpose();
+    if (m_compact) {
+        m_compact->importState(m_x, m_P);
+    }
+}
+
+/**
+ * @brief 启用CV/CA自动切换
+ */
+void Track::enableModelSwitching()
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_nisAlpha = settings.value("ModelSwitching/nisAlpha", 0.3).toDouble();
+    m_promoteNis = settings.value("ModelSwitching/promoteNis", 2.6).toDouble();
+    m_demoteNis = settings.value("ModelSwitching/demoteNis", 1.5).toDouble();
+    m_demoteUpdates = settings.value("ModelSwitching/demoteUpdates", 10).toInt();
+    m_accelerationGate = settings.value("ModelSwitching/accelerationGate", 7.81).toDouble();
+    m_accelerationUncertainty = settings.value("KalmanFilter/initialAccelerationUncertainty", 10.0).toDouble();
+    if (m_model->stateDim() == 6) {
+        m_standbyModel.reset(new ConstantAccelerationModel());
+    } else {
+        m_standbyModel.reset(new ConstantVelocityModel());
+    }
+    m_modelSwitching = true;
+}
+
+/**
+ * @brief 启用单精度滤波
+ * @param recenterDistance 局部原点的重定中心距离(米)
+ */
+void Track::enableSinglePrecision(double recenterDistance)
+{
+    m_recenterDistance = recenterDistance > 0 ? recenterDistance : 1000.0;
+    syncCompactFilter();
 }
 
 /**
- * @brief 检查航迹是否已丢失
- * @return 如果航迹已丢失则返回true
+ * @brief 是否正在使用单精度滤波器
+ * @return 使用返回true
  */
-bool Track::isLost() const {
-    return m_misses > maxMissesToDelete;
+bool Track::isSinglePrecision() const
+{
+    return m_compact != nullptr;
 }
 
 /**
- * @brief 增加航迹丢失计数
- * @details 当航迹与任何观测都不匹配时调用
+ * @brief 按当前运动模型创建或释放单精度滤波器
  */
-void Track::incrementMisses()
+void Track::syncCompactFilter()
 {
-    m_misses++;
-    LOG_DEBUG("航迹 " + QString::number(m_id) + " 丢失计数增加到: " +
-              QString::number(m_misses) + "/" + QString::number(maxMissesToDelete));
-    if (isLost()) {
-        LOG_INFO("航迹 " + QString::number(m_id) + " 已达到丢失阈值，将被删除");
+    if (m_recenterDistance <= 0 || m_imm || m_model->stateDim() != 6) {
+        if (m_compact) {
+            m_standbyCompact = std::move(m_compact);
+        }
+        return;
+    }
+    if (!m_compact && m_standbyCompact) {
+        m_compact = std::move(m_standbyCompact);
+    }
+    if (!m_compact) {
+        QSettings settings("Server.ini", QSettings::IniFormat);
+        const double processNoiseStd = settings.value("KalmanFilter/processNoiseStd", 5.0).toDouble();
+        m_compact.reset(new CompactCvFilter(processNoiseStd, m_recenterDistance));
+    }
+    m_compact->importState(m_x, m_P);
+}
+
+/**
+ * @brief 获取当前运动模型名称
+ * @return "cv"、"ca" 或 "imm"
+ */
+const char* Track::getModelName() const {
+    if (m_imm) {
+        return "imm";
+    }
+    return m_model->stateDim() == 6 ? "cv" : "ca";
+}
+
+/**
+ * @brief 估算航迹占用的内存
+ * @return 字节数
+ */
+size_t Track::memoryFootprint() const {
+    size_t bytes = sizeof(Track) + (m_x.size() + m_P.size()) * sizeof(double);
+    if (m_imm) {
+        bytes += sizeof(ImmFilter);
+    }
+    if (m_compact) {
+        bytes += sizeof(CompactCvFilter);
     }
+    return bytes;
 }
 
+/**
+ * @brief 获取最后更新时间
+ * @return 最后一次更新的时间戳
+ */
+double Track::getLastUpdateTime() const {
+    return m_lastUpdateTime;
+}
+
+/**
+ * @brief 检查航迹是否已确认
+ * @return 如果航迹已确认则返回true
+ */
+bool Track::isConfirmed() const {
+    return m_hits >= m_confirmationHits;
+}
 
@@ -13,6 +13,8 @@
 #include "IMotionModel.h"
 #include "SRCKF.h"
 #include "CKF.h"
+#include "ImmFilter.h"
+#include "CompactCvFilter.h"
 #include <memory>
 
 /**
@@ -31,6 +33,16 @@ public:
      */
     Track(const Measurement& initialMeasurement, int trackId, std::unique_ptr<IMotionModel> model);
 
+    /**
+     * @brief 构造交互式多模型航迹
+     * @param initialMeasurement 初始观测数据
+     * @param trackId 航迹ID
+     * @param imm 交互式多模型滤波器
+     * @details 状态估计由IMM完成，航迹对外的状态为9维 [p, v, a] 组合估计，
+     *          未来轨迹按匀加速模型外推
+     */
+    Track(const Measurement& initialMeasurement, int trackId, std::unique_ptr<ImmFilter> imm);
+
     /**
      * @brief 析构函数
      */
@@ -50,6 +62,13 @@ public:
      */
     void update(const Measurement& measurement);
 
+    /**
+     * @brief 使用多个观测者的观测联合更新航迹状态
+     * @param measurements 同一周期内来自不同观测者的观测数据，指向调用方的观测列表
+     * @details 所有观测堆叠为一次更新，避免逐个顺序更新带来的重复计算
+     */
+    void update(const std::vector<const Measurement*>& measurements);
+
     /**
      * @brief 预测未来轨迹
      * @param timeHorizon 预测时间范围(秒)
@@ -72,25 +91,18 @@ public:
      */
     bool isConfirmed() const;
 
-    /**
-     * @brief 检查航迹是否已丢失
-     * @return 如果航迹已丢失则返回true
-     * @details 当连续丢失次数超过阈值时航迹被标记为丢失
-     */
-    bool isLost() const;
-
-    /**
-     * @brief 增加航迹丢失计数
-     * @details 当航迹与任何观测都不匹配时调用
-     */
-    void incrementMisses();
-
     /**
      * @brief 获取当前状态向量
      * @return 状态向量的常引用
      */
     const StateVector& getState() const;
 
+    /**
+     * @brief 获取当前状态协方差
+     * @return 协方差矩阵的常引用，维数与状态向量一致
+     */
+    const StateMatrix& getCovariance() const;
+
     /**
      * @brief 获取最后更新时间
      * @return 最后一次更新的时间戳
@@ -104,10 +116,91 @@ public:
     int getHits() const;
 
     /**
-     * @brief 获取丢失次数
-     * @return 连续丢失次数
+     * @brief 获取目标外形尺寸
+     * @return 最近一次聚类观测给出的包围盒边长，点目标为零
+     */
+    const Vector3& getExtent() const;
+
+    /**
+     * @brief 获取交互式多模型滤波器
+     * @return IMM航迹返回滤波器指针，否则返回nullptr
+     */
+    const ImmFilter* getImm() const;
+
+    /**
+     * @brief 以起始阶段的估计初始化航迹
+     * @param velocity 估计速度
+     * @param covariance 位置和速度 [p, v] 的6x6协方差
+     * @param hits 起始阶段已累计的命中次数
+     * @details 由暂定航迹升级而来的航迹使用候选阶段的多点拟合结果，
+     *          以较小的初始协方差代替默认的大速度不确定度
      */
-    int getMisses() const;
+    void seed(const Vector3& velocity, const StateMatrix& covariance, int hits);
+
+    /**
+     * @brief 对航迹状态做刚体坐标变换
+     * @param rotation 旋转矩阵
+     * @param translation 平移，x' = R x + t
+     * @details 跟踪原点移动时调用，位置、速度、加速度及其协方差随坐标系旋转
+     */
+    void transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation);
+
+    /**
+     * @brief 启用CV/CA自动切换
+     * @details 航迹以CV模型运行，NIS显示机动时升级为CA，机动结束后降回CV。
+     *          切换参数从配置文件 ModelSwitching 分组读取
+     */
+    void enableModelSwitching();
+
+    /**
+     * @brief 启用单精度滤波
+     * @param recenterDistance 局部原点的重定中心距离(米)
+     * @details 航迹为CV模型时改用单精度定长滤波器，CA和IMM航迹仍使用双精度立方卡尔曼滤波；
+     *          启用模型切换的航迹在降回CV时重新使用单精度滤波器
+     */
+    void enableSinglePrecision(double recenterDistance);
+
+    /**
+     * @brief 是否正在使用单精度滤波器
+     * @return 使用返回true
+     */
+    bool isSinglePrecision() const;
+
+    /**
+     * @brief 获取当前运动模型名称
+     * @return "cv"、"ca" 或 "imm"
+     */
+    const char* getModelName() const;
+
+    /**
+     * @brief 估算航迹占用的内存
+     * @return 字节数，含航迹对象、状态与协方差存储、IMM滤波器和单精度滤波器
+     */
+    size_t memoryFootprint() const;
+
+private:
+    /**
+     * @brief 以观测块更新滤波器
+     * @param blocks 观测块
+     * @return 新息统计量
+     * @details IMM航迹由IMM更新，否则使用立方卡尔曼滤波器的堆叠更新
+     */
+    InnovationStats updateFilter(const std::vector<ObservationBlock>& blocks);
+
+    /**
+     * @brief 根据新息统计量在CV与CA之间切换
+     * @param stats 本次更新的新息统计量
+     * @details 按维度归一化的NIS做指数平滑:
+     *          CV下平滑值超过升级门限时扩维为CA，加速度初值为零、方差取初始加速度不确定度；
+     *          CA下平滑值连续若干次低于降级门限且加速度估计不显著时，边缘化掉加速度降为CV
+     */
+    void manageModel(const InnovationStats& stats);
+
+    /**
+     * @brief 按当前运动模型创建或释放单精度滤波器
+     * @details 启用单精度且为CV模型时从双精度状态载入，否则释放
+     */
+    void syncCompactFilter();
 
 private:
     /**
@@ -122,6 +215,30 @@ private:
      */
     std::unique_ptr<IMotionModel> m_model;
 
+    /**
+     * @brief 备用运动模型
+     * @details 启用CV/CA自动切换时预先创建另一种模型，切换时与 m_model 交换，不在更新过程中分配内存
+     */
+    std::unique_ptr<IMotionModel> m_standbyModel;
+
+    /**
+     * @brief 交互式多模型滤波器
+     * @details 非空时由其代替单模型滤波器完成预测和更新
+     */
+    std::unique_ptr<ImmFilter> m_imm;
+
+    /**
+     * @brief 单精度匀速滤波器
+     * @details 非空时代替立方卡尔曼滤波器完成预测和线性观测更新，m_x 和 m_P 为其导出的双精度副本
+     */
+    std::unique_ptr<CompactCvFilter> m_compact;
+
+    /**
+     * @brief 升级为CA期间保留的单精度滤波器
+     * @details 降级回CV时直接复用
+     */
+    std::unique_ptr<CompactCvFilter> m_standbyCompact;
+
     /**
      * @brief 状态向量
      * @details 当前估计的目标状态
@@ -132,12 +249,7 @@ private:
      * @brief 状态协方差矩阵
      * @details 表示状态估计的不确定性
      */
-    Eigen::MatrixXd m_P;
-
-    /**
-     * @brief 观测噪声矩阵
-     */
-    Eigen::MatrixXd m_R;
+    StateMatrix m_P;
 
     /**
      * @brief 航迹ID
@@ -157,15 +269,15 @@ private:
     int m_hits;
 
     /**
-     * @brief 丢失次数
-     * @details 航迹连续未匹配的次数
+     * @brief 最后更新时间
      */
-    int m_misses;
+    double m_lastUpdateTime;
 
     /**
-     * @brief 最后更新时间
+     * @brief 目标外形尺寸
+     * @details 来自点云聚类观测的包围盒边长
      */
-    double m_lastUpdateTime;
+    Vector3 m_extent;
 
     /**
      * @brief 确认所需命中次数
@@ -174,10 +286,56 @@ private:
     int m_confirmationHits;
 
     /**
-     * @brief 删除所需丢失次数
-     * @details 航迹被删除所需的连续丢失次数
+     * @brief 是否启用CV/CA自动切换
+     */
+    bool m_modelSwitching;
+
+    /**
+     * @brief 按维度归一化的NIS指数平滑值
+     */
+    double m_nisAverage;
+
+    /**
+     * @brief CA模型下连续满足降级条件的更新次数
+     */
+    int m_quietUpdates;
+
+    /**
+     * @brief NIS指数平滑系数
+     */
+    double m_nisAlpha;
+
+    /**
+     * @brief 升级为CA的平滑NIS门限(每维)
+     */
+    double m_promoteNis;
+
+    /**
+     * @brief 降级为CV的平滑NIS门限(每维)
+     */
+    double m_demoteNis;
+
+    /**
+     * @brief 降级前需连续满足条件的更新次数
+     */
+    int m_demoteUpdates;
+
+    /**
+     * @brief 加速度显著性门限
+     * @details a' * Paa^-1 * a 低于此值时认为加速度不显著
+     */
+    double m_accelerationGate;
+
+    /**
+     * @brief 升级为CA模型时加速度的初始方差
+     * @details 与匀加速模型的初始协方差取同一配置项，启用自动切换时读取一次
+     */
+    double m_accelerationUncertainty;
+
+    /**
+     * @brief 单精度滤波的重定中心距离(米)，为零表示未启用单精度
      */
-    int maxMissesToDelete;
+    double m_recenterDistance;
 };
 
 /**
@@ -0,0 +1,153 @@
+/**
+ * @file TrackExtrapolator.cpp
+ * @brief 航迹外推实现文件
+ * @details 实现了基于航迹快照的闭式状态和协方差外推
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TrackExtrapolator.h"
+#include "TrackSnapshotStore.h"
+#include "LogManager.h"
+#include <QSettings>
+#include <cmath>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[TrackExtrapolator::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[TrackExtrapolator::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[TrackExtrapolator::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[TrackExtrapolator::" << __FUNCTION__ << "] " << msg
+
+
+TrackExtrapolator& TrackExtrapolator::instance()
+{
+    // C++11 保证了静态局部变量的初始化是线程安全的
+    static TrackExtrapolator instance;
+    return instance;
+}
+
+
+TrackExtrapolator::TrackExtrapolator()
+{
+    // 默认值与 ConstantVelocityModel、ConstantAccelerationModel 保持一致
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    const double cvStd = settings.value("KalmanFilter/processNoiseStd", 5.0).toDouble();
+    const double caStd = settings.value("KalmanFilter/processNoiseStd", 1.0).toDouble();
+    m_cvNoiseVariance = cvStd * cvStd;
+    m_caNoiseVariance = caStd * caStd;
+    m_maxHorizon = settings.value("Extrapolation/maxHorizon", 10.0).toDouble();
+    if (m_maxHorizon <= 0) {
+        LOG_WARN("最大外推时长无效: " + QString::number(m_maxHorizon) + "，使用10秒");
+        m_maxHorizon = 10.0;
+    }
+}
+
+
+TrackExtrapolator::Result TrackExtrapolator::extrapolate(int id, double time, ExtrapolatedState& state) const
+{
+    std::shared_ptr<const TrackSnapshot> snapshot = TrackSnapshotStore::instance().current();
+    if (!snapshot) {
+        return Result::NoSnapshot;
+    }
+    const TrackRecord* record = snapshot->findById(id);
+    if (!record) {
+        return Result::NotFound;
+    }
+    const double dt = time - snapshot->timestamp();
+    if (!std::isfinite(dt) || std::abs(dt) > m_maxHorizon) {
+        return Result::OutOfHorizon;
+    }
+
+    propagate(*record, dt, state);
+    state.time = time;
+    return Result::Ok;
+}
+
+
+TrackExtrapolator::Result TrackExtrapolator::extrapolateAll(double time, std::vector<ExtrapolatedState>& states) const
+{
+    states.clear();
+    std::shared_ptr<const TrackSnapshot> snapshot = TrackSnapshotStore::instance().current();
+    if (!snapshot) {
+        return Result::NoSnapshot;
+    }
+    const double dt = time - snapshot->timestamp();
+    if (!std::isfinite(dt) || std::abs(dt) > m_maxHorizon) {
+        return Result::OutOfHorizon;
+    }
+
+    const std::vector<TrackRecord>& records = snapshot->records();
+    states.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        propagate(records[i], dt, states[i]);
+        states[i].time = time;
+    }
+    return Result::Ok;
+}
+
+
+void TrackExtrapolator::propagate(const TrackRecord& record, double dt, ExtrapolatedState& state) const
+{
+    const bool constantAcceleration = record.stateDim >= 9;
+    const double dt2 = dt * dt;
+
+    state.id = record.id;
+    state.horizon = dt;
+    state.stateDim = record.stateDim;
+
+    // 每个坐标轴的转移矩阵 f 相同，完整转移矩阵为 F = f ⊗ I3
+    Eigen::Matrix3d f = Eigen::Matrix3d::Identity();
+    f(0, 1) = dt;
+    if (constantAcceleration) {
+        f(0, 2) = 0.5 * dt2;
+        f(1, 2) = dt;
+        state.position = record.position + record.velocity * dt + record.acceleration * (0.5 * dt2);
+        state.velocity = record.velocity + record.acceleration * dt;
+        state.acceleration = record.acceleration;
+    } else {
+        state.position = record.position + record.velocity * dt;
+        state.velocity = record.velocity;
+        state.acceleration.setZero();
+    }
+
+    // 过程噪声同样为 q ⊗ I3。向后外推时按 |dt| 计算，保证协方差不因外推方向而减小
+    const double h = std::abs(dt);
+    const double h2 = h * h;
+    const double h3 = h2 * h;
+    const double h4 = h3 * h;
+    Eigen::Matrix3d q = Eigen::Matrix3d::Zero();
+    if (constantAcceleration) {
+        q << h4 * h / 20.0, h4 / 8.0, h3 / 6.0,
+             h4 / 8.0,      h3 / 3.0, h2 / 2.0,
+             h3 / 6.0,      h2 / 2.0, h;
+        q *= m_caNoiseVariance;
+    } else {
+        q(0, 0) = h4 / 4.0;
+        q(0, 1) = q(1, 0) = h3 / 2.0;
+        q(1, 1) = h2;
+        q *= m_cvNoiseVariance;
+    }
+
+    // 按 3x3 分块计算 F P F' + Q，每个分块为 Σ f(i,k) f(j,l) P(k,l)
+    const Eigen::Matrix<double, 9, 9>& P = record.covariance;
+    Eigen::Matrix<double, 9, 9> FP;
+    for (int i = 0; i < 3; ++i) {
+        FP.middleRows<3>(3 * i) = f(i, 0) * P.middleRows<3>(0) + f(i, 1) * P.middleRows<3>(3) + f(i, 2) * P.middleRows<3>(6);
+    }
+    for (int j = 0; j < 3; ++j) {
+        state.covariance.middleCols<3>(3 * j) = FP.middleCols<3>(0) * f(j, 0) + FP.middleCols<3>(3) * f(j, 1) + FP.middleCols<3>(6) * f(j, 2);
+    }
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            if (q(i, j) != 0.0) {
+                state.covariance.block<3, 3>(3 * i, 3 * j).diagonal().array() += q(i, j);
+            }
+        }
+    }
+}
+
+
+double TrackExtrapolator::maxHorizon() const
+{
+    return m_maxHorizon;
+}
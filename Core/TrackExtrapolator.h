@@ -0,0 +1,124 @@
+/**
+ * @file TrackExtrapolator.h
+ * @brief 航迹外推头文件
+ * @details 定义了ExtrapolatedState结构和TrackExtrapolator类，由最近发布的航迹快照计算任意时刻的航迹状态和协方差
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef TRACKEXTRAPOLATOR_H
+#define TRACKEXTRAPOLATOR_H
+
+#include "TrackSnapshot.h"
+#include <vector>
+
+/**
+ * @brief 外推后的航迹状态
+ * @details 状态与快照一致统一为 [位置, 速度, 加速度] 9维，匀速模型航迹的加速度及其协方差为零
+ */
+struct ExtrapolatedState {
+    int id = 0;                                        ///< 航迹ID
+    double time = 0.0;                                 ///< 外推目标时刻(秒)
+    double horizon = 0.0;                              ///< 相对快照时间戳的外推时长(秒)，可为负
+    int stateDim = 6;                                  ///< 滤波状态维数，6为匀速、9为匀加速/IMM
+    Vector3 position = Vector3::Zero();                ///< 位置
+    Vector3 velocity = Vector3::Zero();                ///< 速度
+    Vector3 acceleration = Vector3::Zero();            ///< 加速度
+    Eigen::Matrix<double, 9, 9> covariance = Eigen::Matrix<double, 9, 9>::Zero(); ///< [p, v, a] 协方差
+};
+
+/**
+ * @brief 航迹外推类
+ * @details 以快照中的状态为起点按闭式运动模型外推: 6维航迹按匀速模型，9维航迹(匀加速、IMM)按匀加速模型，
+ *          协方差按 P' = F P F' + Q(dt) 传播，Q 与滤波器使用的离散白噪声模型一致。
+ *          只读取 TrackSnapshotStore 的当前快照，不接触TrackManager的锁；结果与快照同为发布坐标系，
+ *          各轴过程噪声相同，在发布坐标系中外推与在跟踪坐标系中外推后再变换等价；
+ *          配置在构造时读取，之后全部接口为const，可在任意多个线程中同时调用。
+ *          使用单例模式
+ */
+class TrackExtrapolator
+{
+public:
+    /**
+     * @brief 外推结果
+     */
+    enum class Result {
+        Ok,             ///< 成功
+        NoSnapshot,     ///< 尚未发布快照
+        NotFound,       ///< 快照中没有该航迹
+        OutOfHorizon    ///< 外推时长超过允许范围
+    };
+
+    /**
+     * @brief 获取航迹外推单例实例
+     * @return 航迹外推实例的引用
+     */
+    static TrackExtrapolator& instance();
+
+    /**
+     * @brief 外推单条航迹
+     * @param id 航迹ID
+     * @param time 目标时刻(秒)，与观测时间戳同一时间基准
+     * @param state 输出，外推后的状态
+     * @return 外推结果
+     */
+    Result extrapolate(int id, double time, ExtrapolatedState& state) const;
+
+    /**
+     * @brief 外推快照中的全部航迹
+     * @param time 目标时刻(秒)
+     * @param states 输出，外推后的状态，按快照中的记录顺序
+     * @return 外推结果，成功时 states 可能为空(没有确认航迹)
+     */
+    Result extrapolateAll(double time, std::vector<ExtrapolatedState>& states) const;
+
+    /**
+     * @brief 由一条快照记录外推
+     * @param record 快照中的航迹记录
+     * @param dt 外推时长(秒)
+     * @param state 输出，外推后的状态，time 字段由调用者填写
+     * @details 不检查外推时长，供已持有快照的调用者批量使用
+     */
+    void propagate(const TrackRecord& record, double dt, ExtrapolatedState& state) const;
+
+    /**
+     * @brief 获取允许的最大外推时长
+     * @return 最大外推时长(秒)
+     */
+    double maxHorizon() const;
+
+private:
+    /**
+     * @brief 私有构造函数
+     * @details 从配置文件 KalmanFilter 和 Extrapolation 分组读取过程噪声和最大外推时长
+     */
+    TrackExtrapolator();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    TrackExtrapolator(const TrackExtrapolator&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    TrackExtrapolator& operator=(const TrackExtrapolator&) = delete;
+
+private:
+    /**
+     * @brief 匀速模型的加速度噪声方差
+     */
+    double m_cvNoiseVariance;
+
+    /**
+     * @brief 匀加速模型的加加速度噪声方差
+     */
+    double m_caNoiseVariance;
+
+    /**
+     * @brief 最大外推时长(秒)，向前和向后外推均受此限制
+     */
+    double m_maxHorizon;
+};
+
+#endif // TRACKEXTRAPOLATOR_H
@@ -8,10 +8,14 @@
 
 #include "TrackManager.h"
 #include "LogManager.h"
+#include "MetricsRegistry.h"
+#include "ObserverRegistry.h"
 #include "ConstantVelocityModel.h"
 #include "ConstantAccelerationModel.h"
+#include "ClockOffsetEstimator.h"
 #include <limits>
-#include <set>
+#include <cstring>
+#include <algorithm>
 #include <QSettings>
 #include <vector> // 确保包含<vector>
 
@@ -30,17 +34,46 @@ TrackManager::TrackManager()
     : m_nextTrackId(0),
       m_lastProcessTime(0.0),
       m_associationGateDistance(0.0),
-      m_newTrackGateDistance(0.0)
+      m_newTrackGateDistance(0.0),
+      m_multiSensorFusion(true),
+      m_motionModel("ca"),
+      m_singlePrecision(false),
+      m_recenterDistance(1000.0),
+      m_modelPromotions(0),
+      m_modelDemotions(0),
+      m_maxTracks(5000),
+      m_shedBirths(0),
+      m_shedLastCycle(0),
+      m_cheapInitiation(false),
+      m_maxBirthsPerCycle(-1),
+      m_maxCoastTime(0.6),
+      m_expiryWheel(0.05),
+      m_expiredTracks(0),
+      m_preemptedTracks(0)
 {
     LOG_FUNCTION_BEGIN();
 
     QSettings settings("Server.ini", QSettings::IniFormat);
     m_associationGateDistance = settings.value("KalmanFilter/associationGateDistance", 10.0).toDouble();
     m_newTrackGateDistance = settings.value("KalmanFilter/newTrackGateDistance", 5.0).toDouble();
+    m_multiSensorFusion = settings.value("KalmanFilter/multiSensorFusion", true).toBool();
+    m_motionModel = settings.value("KalmanFilter/motionModel", "ca").toString().toLower();
+    m_singlePrecision = settings.value("Precision/singlePrecision", false).toBool();
+    m_recenterDistance = settings.value("Precision/recenterDistance", 1000.0).toDouble();
+    m_maxTracks = settings.value("Capacity/maxTracks", 5000).toInt();
+
+    // 未配置最大外推时间时按旧的丢失次数和周期间隔换算，保持原有删除时机
+    const double legacyCoastTime = (settings.value("KalmanFilter/maxMissesToDelete", 5).toInt() + 1) *
+                                   settings.value("General/workerInterval", 100).toInt() / 1000.0;
+    m_maxCoastTime = settings.value("KalmanFilter/maxCoastTime", legacyCoastTime).toDouble();
 
 
     LOG_INFO("初始化完成，关联门限: " + QString::number(m_associationGateDistance) +
-             "米，新航迹门限: " + QString::number(m_newTrackGateDistance) + "米");
+             "米，新航迹门限: " + QString::number(m_newTrackGateDistance) + "米，多传感器联合更新: " +
+             (m_multiSensorFusion ? "启用" : "禁用") + "，运动模型: " + m_motionModel +
+             (m_singlePrecision ? "(CV单精度)" : "") +
+             "，航迹上限: " + QString::number(m_maxTracks) +
+             "，最大外推时间: " + QString::number(m_maxCoastTime) + "秒");
 
     LOG_FUNCTION_END();
 }
@@ -65,39 +98,44 @@ void TrackManager::processMeasurements(const std::vector<Measurement>& measureme
     LOG_DEBUG("开始处理 " + QString::number(measurements.size()) +
               " 条观测数据，当前航迹数: " + QString::number(m_tracks.size()));
 
-    // 1. 数据关联
-    std::vector<std::pair<int, int>> matches;
-    std::vector<int> unmatchedTracks;
-    std::vector<int> unmatchedMeasurements;
-    // ========================[核心修改点 1: 获取已匹配航迹ID]========================
-    // dataAssociation现在返回成功匹配的航迹ID集合，供后续使用
-    std::set<int> matched_track_ids = dataAssociation(measurements, matches, unmatchedTracks, unmatchedMeasurements);
-
-    // 2. 更新匹配的航迹
-    LOG_DEBUG("开始更新 " + QString::number(matches.size()) + " 个匹配的航迹");
-    updateMatchedTracks(matches, measurements);
-
-    // 3. 为未匹配的观测创建新航迹
-    LOG_DEBUG("处理 " + QString::number(unmatchedMeasurements.size()) + " 个未匹配的观测");
-    // ========================[核心修改点 2: 传递已匹配航迹ID]========================
-    // 将已匹配的航迹ID列表传递给createNewTracks，以防止创建重复航迹
-    createNewTracks(unmatchedMeasurements, measurements, matched_track_ids);
+    // 本周期的临时数据全部分配在周期分配区上，周期结束时整体回收
+    {
+        // 1. 数据关联
+        // 航迹按本周期的遍历顺序编号为槽位，匹配结果和已匹配标记都按槽位索引
+        ArenaVector<Track*> trackSlots(m_arena);
+        ArenaVector<std::pair<int, int>> matches(m_arena);
+        ArenaVector<int> unmatchedMeasurements(m_arena);
+        ArenaBitset matchedSlots(m_tracks.size(), m_arena);
+        dataAssociation(measurements, trackSlots, matches, matchedSlots, unmatchedMeasurements);
+
+        // 2. 更新匹配的航迹
+        LOG_DEBUG("开始更新 " + QString::number(matches.size()) + " 个匹配的航迹");
+        updateMatchedTracks(matches, trackSlots, measurements);
+
+        // 3. 为未匹配的观测创建新航迹
+        // 将已匹配的航迹传递给createNewTracks，以防止创建重复航迹
+        LOG_DEBUG("处理 " + QString::number(unmatchedMeasurements.size()) + " 个未匹配的观测");
+        createNewTracks(unmatchedMeasurements, measurements, trackSlots, matchedSlots);
+
+        LOG_DEBUG("关联与起始完成。匹配数: " + QString::number(matches.size()) +
+                  "，已匹配航迹数: " + QString::number(matchedSlots.count()) +
+                  "，未匹配观测数: " + QString::number(unmatchedMeasurements.size()));
+    }
 
 
-    // 4. 管理未匹配的航迹
-    LOG_DEBUG("管理 " + QString::number(unmatchedTracks.size()) + " 个未匹配的航迹");
-    manageUnmatchedTracks(unmatchedTracks);
+    // 4. 删除超过最大外推时间未更新的航迹
+    expireTracks(measurements.back().timestamp);
 
     // 只有在处理完一批数据后才更新时间戳
     if (!measurements.empty()) {
         m_lastProcessTime = measurements.back().timestamp;
+        m_sinceLastProcess.start();
     }
 
 
-    LOG_DEBUG("处理完成。匹配数: " + QString::number(matches.size()) +
-              "，未匹配航迹数: " + QString::number(unmatchedTracks.size()) +
-              "，未匹配观测数: " + QString::number(unmatchedMeasurements.size()) +
-              "，当前航迹总数: " + QString::number(m_tracks.size()));
+    m_arena.reset();
+
+    LOG_DEBUG("处理完成，当前航迹总数: " + QString::number(m_tracks.size()));
 }
 
 
@@ -129,6 +167,40 @@ void TrackManager::predictTo(double timestamp)
 }
 
 
+double TrackManager::getLastProcessTime() const
+{
+    QReadLocker locker(&m_lock);
+    return m_lastProcessTime;
+}
+
+
+void TrackManager::expireIdle()
+{
+    QWriteLocker locker(&m_lock);
+
+    if (m_lastProcessTime == 0.0 || !m_sinceLastProcess.isValid()) {
+        return;
+    }
+
+    // 观测时间与本机时间同速流逝，中断期间的观测时间按本机经过的时间外推
+    expireTracks(m_lastProcessTime + m_sinceLastProcess.elapsed() / 1000.0);
+}
+
+
+void TrackManager::transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation)
+{
+    QWriteLocker locker(&m_lock);
+
+    for (const auto& pair : m_tracks) {
+        pair.second->transformFrame(rotation, translation);
+    }
+    m_tentativePool.transformFrame(rotation, translation);
+
+    LOG_INFO("跟踪坐标系已变换，航迹数: " + QString::number(m_tracks.size()) +
+             "，候选数: " + QString::number(m_tentativePool.size()));
+}
+
+
 std::vector<TrackPtr> TrackManager::getTracks() const
 {
     QReadLocker locker(&m_lock);
@@ -146,13 +218,19 @@ std::vector<TrackPtr> TrackManager::getTracks() const
 
 
 // ========================[核心修改点 3: 修改dataAssociation返回值]========================
-std::set<int> TrackManager::dataAssociation(const std::vector<Measurement>& measurements,
-                                            std::vector<std::pair<int, int>>& matches,
-                                            std::vector<int>& unmatchedTracks,
-                                            std::vector<int>& unmatchedMeasurements)
+void TrackManager::dataAssociation(const std::vector<Measurement>& measurements,
+                                   ArenaVector<Track*>& trackSlots,
+                                   ArenaVector<std::pair<int, int>>& matches,
+                                   ArenaBitset& matchedSlots,
+                                   ArenaVector<int>& unmatchedMeasurements)
 {
     LOG_FUNCTION_BEGIN();
-    std::set<int> matched_track_ids;
+
+    trackSlots.reserve(m_tracks.size());
+    for (const auto& pair : m_tracks) {
+        trackSlots.push_back(pair.second.get());
+    }
+    unmatchedMeasurements.reserve(measurements.size());
 
     if (m_tracks.empty()) {
         LOG_DEBUG("无现有航迹，所有 " + QString::number(measurements.size()) + " 条观测都标记为未匹配");
@@ -160,86 +238,123 @@ std::set<int> TrackManager::dataAssociation(const std::vector<Measurement>& meas
             unmatchedMeasurements.push_back(i);
         }
         LOG_FUNCTION_END();
-        return matched_track_ids;
+        return;
     }
 
-    std::vector<bool> meas_matched(measurements.size(), false);
+    ArenaBitset meas_matched(measurements.size(), m_arena);
 
 
     LOG_DEBUG("开始关联 " + QString::number(m_tracks.size()) + " 条航迹和 " +
               QString::number(measurements.size()) + " 个观测");
 
-    for (const auto& pair : m_tracks) {
-        int trackId = pair.first;
-        const TrackPtr& track = pair.second;
+    // 每个观测者对应的最佳候选 (观测者ID, 观测索引, 距离)，观测者数量通常很少，线性查找即可
+    struct ObserverCandidate {
+        int observerId;
+        int measIdx;
+        double dist;
+    };
+    ArenaVector<ObserverCandidate> candidates(m_arena);
+    candidates.reserve(8);
 
-        double min_dist = std::numeric_limits<double>::max();
-        int best_match_idx = -1;
+    for (int slot = 0; slot < static_cast<int>(trackSlots.size()); ++slot) {
+        const Track* track = trackSlots[slot];
 
+        candidates.clear();
         Vector3 predicted_pos = track->getState().head<3>();
 
         for (size_t j = 0; j < measurements.size(); ++j) {
-            if (meas_matched[j]) continue;
+            if (meas_matched.test(j)) continue;
 
             double dist = (predicted_pos - measurements[j].position).norm();
-
-            if (dist < min_dist) {
-                min_dist = dist;
-                best_match_idx = j;
+            if (dist >= m_associationGateDistance) continue;
+
+            // 未启用多传感器联合更新时，所有观测视为同一观测者，只保留最近的一条
+            int observerKey = m_multiSensorFusion ? measurements[j].observerId : 0;
+            auto it = std::find_if(candidates.begin(), candidates.end(),
+                                   [observerKey](const ObserverCandidate& c) {
+                return c.observerId == observerKey;
+            });
+
+            if (it == candidates.end()) {
+                candidates.push_back({observerKey, static_cast<int>(j), dist});
+            } else if (dist < it->dist) {
+                it->measIdx = static_cast<int>(j);
+                it->dist = dist;
             }
         }
 
-        if (best_match_idx != -1 && min_dist < m_associationGateDistance) {
-            // 防止一个观测被多个航迹匹配，需要再次检查
-            if (!meas_matched[best_match_idx]) {
-                matches.push_back({trackId, best_match_idx});
-                meas_matched[best_match_idx] = true;
-                matched_track_ids.insert(trackId);
-                LOG_DEBUG("航迹 " + QString::number(trackId) + " 与观测 " +
-                          QString::number(best_match_idx) + " 匹配成功，距离: " +
-                          QString::number(min_dist, 'f', 2) + " 米");
-            }
-        } else {
-            // LOG_DEBUG("航迹 " + QString::number(trackId) + " 无匹配");
+        // 同一航迹的匹配连续写入matches，供updateMatchedTracks合并为一次联合更新
+        for (const auto& c : candidates) {
+            matches.push_back({slot, c.measIdx});
+            meas_matched.set(c.measIdx);
+            LOG_DEBUG("航迹 " + QString::number(track->getId()) + " 与观测 " +
+                      QString::number(c.measIdx) + " (观测者 " + QString::number(measurements[c.measIdx].observerId) +
+                      ") 匹配成功，距离: " + QString::number(c.dist, 'f', 2) + " 米");
         }
-    }
-
-    for (const auto& pair : m_tracks) {
-        if (matched_track_ids.find(pair.first) == matched_track_ids.end()) {
-            unmatchedTracks.push_back(pair.first);
+        if (!candidates.empty()) {
+            matchedSlots.set(slot);
         }
     }
 
     for (size_t i = 0; i < measurements.size(); ++i) {
-        if (!meas_matched[i]) {
+        if (!meas_matched.test(i)) {
             unmatchedMeasurements.push_back(i);
         }
     }
 
     LOG_DEBUG("关联完成，匹配数: " + QString::number(matches.size()) +
-              "，未匹配航迹数: " + QString::number(unmatchedTracks.size()) +
               "，未匹配观测数: " + QString::number(unmatchedMeasurements.size()));
 
     LOG_FUNCTION_END();
-    return matched_track_ids;
 }
 
 
-void TrackManager::updateMatchedTracks(const std::vector<std::pair<int, int>>& matches,
+void TrackManager::updateMatchedTracks(const ArenaVector<std::pair<int, int>>& matches,
+                                       const ArenaVector<Track*>& trackSlots,
                                        const std::vector<Measurement>& measurements)
 {
     LOG_FUNCTION_BEGIN();
 
-    for (const auto& match : matches) {
-        int trackId = match.first;
-        int measIdx = match.second;
+    ClockOffsetEstimator& clock = ClockOffsetEstimator::instance();
+    const double predictionTime = measurements.back().timestamp;
 
-        if(m_tracks.count(trackId)) {
-            LOG_DEBUG("更新航迹 " + QString::number(trackId) + " 使用观测索引 " +
-                      QString::number(measIdx));
-            m_tracks[trackId]->update(measurements[measIdx]);
-        } else {
-            LOG_WARN("尝试更新不存在的航迹ID: " + QString::number(trackId));
+    // 同一航迹的匹配在matches中连续排列，逐组取出后进行一次联合更新
+    size_t i = 0;
+    while (i < matches.size()) {
+        const int slot = matches[i].first;
+        m_trackMeasurements.clear();
+        for (; i < matches.size() && matches[i].first == slot; ++i) {
+            m_trackMeasurements.push_back(&measurements[matches[i].second]);
+        }
+
+        Track* track = trackSlots[slot];
+
+        // 更新前的预测状态作为参照: 新息距离计入观测者统计，确认航迹的残差用于估计各观测者的时钟偏差
+        // 融合观测不属于单一观测者，不计入统计
+        const StateVector& state = track->getState();
+        for (const Measurement* m : m_trackMeasurements) {
+            if (m->observerId != Measurement::kFusedObserverId) {
+                g_Observers.recordAssociation(m->observerId, (m->position - state.head<3>()).norm());
+            }
+        }
+        if (clock.isEnabled() && track->isConfirmed()) {
+            for (const Measurement* m : m_trackMeasurements) {
+                if (m->observerId == Measurement::kFusedObserverId) {
+                    continue;
+                }
+                clock.addResidual(m->observerId, m->position - state.head<3>(), state.segment<3>(3),
+                                  m->timestamp - predictionTime);
+            }
+        }
+
+        LOG_DEBUG("更新航迹 " + QString::number(track->getId()) + " 使用 " +
+                  QString::number(m_trackMeasurements.size()) + " 条观测");
+        const char* modelBefore = track->getModelName();
+        track->update(m_trackMeasurements);
+        scheduleExpiry(*track);
+        const char* modelAfter = track->getModelName();
+        if (std::strcmp(modelBefore, modelAfter) != 0) {
+            (std::strcmp(modelAfter, "ca") == 0 ? m_modelPromotions : m_modelDemotions)++;
         }
     }
 
@@ -250,34 +365,44 @@ void TrackManager::updateMatchedTracks(const std::vector<std::pair<int, int>>& m
 
 
 // ========================[核心修改点 4: 重构createNewTracks逻辑]========================
-void TrackManager::createNewTracks(const std::vector<int>& unmatchedMeasurements,
+void TrackManager::createNewTracks(const ArenaVector<int>& unmatchedMeasurements,
                                    const std::vector<Measurement>& measurements,
-                                   const std::set<int>& matchedTrackIds)
+                                   const ArenaVector<Track*>& trackSlots,
+                                   const ArenaBitset& matchedSlots)
 {
     LOG_FUNCTION_BEGIN();
 
-    if (unmatchedMeasurements.empty()) {
+    m_shedLastCycle = 0;
+    if (unmatchedMeasurements.empty() && !m_tentativePool.isEnabled()) {
         LOG_DEBUG("无未匹配观测，跳过创建");
         LOG_FUNCTION_END();
         return;
     }
 
-    std::vector<int> trulyUnmatchedMeasurements;
+    ArenaVector<int> trulyUnmatchedMeasurements(m_arena);
+    trulyUnmatchedMeasurements.reserve(unmatchedMeasurements.size());
+
+    // 已匹配航迹的槽位按位集取出，避免逐个观测重复查表
+    ArenaVector<int> matchedTrackSlots(m_arena);
+    matchedTrackSlots.reserve(trackSlots.size());
+    for (int slot = 0; slot < static_cast<int>(trackSlots.size()); ++slot) {
+        if (matchedSlots.test(slot)) {
+            matchedTrackSlots.push_back(slot);
+        }
+    }
 
     for (int measIdx : unmatchedMeasurements) {
         const auto& measurement = measurements[measIdx];
         bool isCloseToExistingTrack = false;
 
         // 检查这个“未匹配”的观测点是否离任何一个“已匹配”的航迹很近
-        for (int trackId : matchedTrackIds) {
-            if (m_tracks.count(trackId)) {
-                double dist = (m_tracks[trackId]->getState().head<3>() - measurement.position).norm();
-                if (dist < m_newTrackGateDistance) {
-                    isCloseToExistingTrack = true;
-                    LOG_DEBUG("未匹配观测 " + QString::number(measIdx) + " 因距离已更新的航迹 " +
-                              QString::number(trackId) + " 过近 (" + QString::number(dist, 'f', 2) + "米)，被忽略");
-                    break;
-                }
+        for (int slot : matchedTrackSlots) {
+            double dist = (trackSlots[slot]->getState().head<3>() - measurement.position).norm();
+            if (dist < m_newTrackGateDistance) {
+                isCloseToExistingTrack = true;
+                LOG_DEBUG("未匹配观测 " + QString::number(measIdx) + " 因距离已更新的航迹 " +
+                          QString::number(trackSlots[slot]->getId()) + " 过近 (" + QString::number(dist, 'f', 2) + "米)，被忽略");
+                break;
             }
         }
 
@@ -287,6 +412,47 @@ void TrackManager::createNewTracks(const std::vector<int>& unmatchedMeasurements
         }
     }
 
+    // 启用暂定航迹层时，未匹配观测先进入候选池，满足M/N确认后才创建完整航迹
+    if (m_tentativePool.isEnabled()) {
+        ArenaVector<TentativeTrackPool::Promotion> promoted(m_arena);
+        m_tentativePool.process(trulyUnmatchedMeasurements, measurements, promoted, m_arena);
+
+        // 航迹表容量或本周期起始限额不足时升级请求按质量排序，命中多、位置协方差小的先入表；
+        // 表已满时质量更高的升级请求可替换最差的未确认航迹，确认航迹始终保留
+        const int count = static_cast<int>(promoted.size());
+        const int room = birthRoom();
+        if (count > room) {
+            std::sort(promoted.begin(), promoted.end(),
+                      [](const TentativeTrackPool::Promotion& a, const TentativeTrackPool::Promotion& b) {
+                if (a.hits != b.hits) return a.hits > b.hits;
+                return a.covariance.topLeftCorner<3, 3>().trace() < b.covariance.topLeftCorner<3, 3>().trace();
+            });
+            const int cycleRoom = m_maxBirthsPerCycle >= 0 ? std::min(count, m_maxBirthsPerCycle) : count;
+            int admitted = room;
+            if (cycleRoom > room) {
+                admitted += preemptUnconfirmed(promoted, room, cycleRoom);
+            }
+            m_shedLastCycle = count - admitted;
+            promoted.erase(promoted.begin() + admitted, promoted.end());
+        }
+
+        for (const auto& promotion : promoted) {
+            TrackPtr newTrack = createTrack(promotion.measurement);
+            newTrack->seed(promotion.velocity, StateMatrix(promotion.covariance), promotion.hits);
+            m_tracks[newTrack->getId()] = newTrack;
+            scheduleExpiry(*newTrack);
+            LOG_INFO("候选升级为航迹，ID: " + QString::number(newTrack->getId()) +
+                     "，候选命中数: " + QString::number(promotion.hits));
+        }
+        if (m_shedLastCycle > 0) {
+            m_shedBirths += m_shedLastCycle;
+            LOG_WARN("航迹容量或起始限额不足，本周期丢弃 " +
+                     QString::number(m_shedLastCycle) + " 个候选升级");
+        }
+        LOG_FUNCTION_END();
+        return;
+    }
+
     if (trulyUnmatchedMeasurements.empty()) {
         LOG_DEBUG("所有未匹配观测都因靠近现有航迹而被忽略，无新航迹创建");
         LOG_FUNCTION_END();
@@ -294,37 +460,49 @@ void TrackManager::createNewTracks(const std::vector<int>& unmatchedMeasurements
     }
 
     LOG_DEBUG("处理 " + QString::number(trulyUnmatchedMeasurements.size()) + " 个真正未匹配的观测");
-    std::vector<bool> meas_processed(measurements.size(), false);
+    ArenaBitset meas_processed(measurements.size(), m_arena);
     int newTracksCreated = 0;
+    const int room = birthRoom();
 
     for (int idx1 : trulyUnmatchedMeasurements) {
-        if (meas_processed[idx1]) {
+        if (meas_processed.test(idx1)) {
+            continue;
+        }
+
+        // 先将邻近的观测聚为同一新目标(处理来自同一目标的密集点云)，丢弃时每个目标只计一次
+        for (int idx2 : trulyUnmatchedMeasurements) {
+            if (idx1 == idx2 || meas_processed.test(idx2)) continue;
+            double dist = (measurements[idx1].position - measurements[idx2].position).norm();
+            if (dist < m_newTrackGateDistance) {
+                meas_processed.set(idx2);
+                LOG_DEBUG("观测 " + QString::number(idx2) + " 与初始点 " + QString::number(idx1) +
+                          " 聚类，不再单独创建航迹");
+            }
+        }
+
+        // 航迹表已满或达到本周期起始限额时已有航迹优先，不再创建新航迹
+        if (newTracksCreated >= room) {
+            m_shedLastCycle++;
             continue;
         }
 
         // 为这个真正无归属的观测点创建新航迹
-        auto model = std::make_unique<ConstantAccelerationModel>();
-        TrackPtr newTrack = std::make_shared<Track>(measurements[idx1], m_nextTrackId++, std::move(model));
+        TrackPtr newTrack = createTrack(measurements[idx1]);
 
         m_tracks[newTrack->getId()] = newTrack;
+        scheduleExpiry(*newTrack);
         newTracksCreated++;
 
         LOG_INFO("创建新航迹，ID: " + QString::number(newTrack->getId()) +
                  "，位置: (" + QString::number(measurements[idx1].position.x(), 'f', 2) +
                  ", " + QString::number(measurements[idx1].position.y(), 'f', 2) +
                  ", " + QString::number(measurements[idx1].position.z(), 'f', 2) + ")");
+    }
 
-        // (可选) 仍然可以保留内部聚类，以处理来自同一新目标的密集点云
-        for (int idx2 : trulyUnmatchedMeasurements) {
-            if (idx1 == idx2 || meas_processed[idx2]) continue;
-            double dist = (measurements[idx1].position - measurements[idx2].position).norm();
-            if (dist < m_newTrackGateDistance) {
-                meas_processed[idx2] = true;
-                LOG_DEBUG("观测 " + QString::number(idx2) + " 与新航迹 " +
-                          QString::number(newTrack->getId()) + " 的初始点 " + QString::number(idx1) +
-                          " 聚类，不再单独创建航迹");
-            }
-        }
+    if (m_shedLastCycle > 0) {
+        m_shedBirths += m_shedLastCycle;
+        LOG_WARN("航迹容量或起始限额不足，本周期丢弃 " +
+                 QString::number(m_shedLastCycle) + " 个新目标");
     }
 
     LOG_DEBUG("共创建 " + QString::number(newTracksCreated) + " 条新航迹");
@@ -332,31 +510,232 @@ void TrackManager::createNewTracks(const std::vector<int>& unmatchedMeasurements
 }
 
 
-void TrackManager::manageUnmatchedTracks(const std::vector<int>& unmatchedTracks)
+void TrackManager::setDegradation(bool cheapInitiation, int maxBirthsPerCycle)
 {
-    LOG_FUNCTION_BEGIN();
+    QWriteLocker locker(&m_lock);
+    if (cheapInitiation != m_cheapInitiation || maxBirthsPerCycle != m_maxBirthsPerCycle) {
+        LOG_INFO("降级设置变更，低开销起始: " + QString(cheapInitiation ? "是" : "否") +
+                 "，每周期起始上限: " + QString::number(maxBirthsPerCycle));
+    }
+    m_cheapInitiation = cheapInitiation;
+    m_maxBirthsPerCycle = maxBirthsPerCycle;
+}
 
-    int deletedCount = 0;
 
-    for (int trackId : unmatchedTracks) {
-        if(m_tracks.count(trackId)) {
-            LOG_DEBUG("增加航迹 " + QString::number(trackId) + " 的丢失计数");
-            m_tracks[trackId]->incrementMisses();
+int TrackManager::birthRoom() const
+{
+    int room = std::max(0, m_maxTracks - static_cast<int>(m_tracks.size()));
+    if (m_maxBirthsPerCycle >= 0) {
+        room = std::min(room, m_maxBirthsPerCycle);
+    }
+    return room;
+}
 
-            if (m_tracks[trackId]->isLost()) {
-                LOG_INFO("删除航迹 " + QString::number(trackId) + "，丢失次数: " +
-                         QString::number(m_tracks[trackId]->getMisses()));
-                m_tracks.erase(trackId);
-                deletedCount++;
+
+int TrackManager::preemptUnconfirmed(const ArenaVector<TentativeTrackPool::Promotion>& promoted, int first, int last)
+{
+    struct Victim {
+        int id;
+        int hits;
+        double trace;
+    };
+
+    ArenaVector<Victim> victims(m_arena);
+    for (const auto& pair : m_tracks) {
+        const Track& track = *pair.second;
+        if (!track.isConfirmed()) {
+            victims.push_back({track.getId(), track.getHits(), track.getCovariance().topLeftCorner<3, 3>().trace()});
+        }
+    }
+    // 最差的排在最前: 命中少、位置协方差大
+    std::sort(victims.begin(), victims.end(), [](const Victim& a, const Victim& b) {
+        if (a.hits != b.hits) return a.hits < b.hits;
+        return a.trace > b.trace;
+    });
+
+    int preempted = 0;
+    for (int i = first; i < last && preempted < static_cast<int>(victims.size()); ++i) {
+        const Victim& victim = victims[preempted];
+        const int hits = promoted[i].hits;
+        const double trace = promoted[i].covariance.topLeftCorner<3, 3>().trace();
+        if (hits < victim.hits || (hits == victim.hits && trace >= victim.trace)) {
+            // 升级请求已按质量降序、待替换航迹按质量升序，后续的都不会更优
+            break;
+        }
+        LOG_INFO("未确认航迹 " + QString::number(victim.id) + " (命中数 " + QString::number(victim.hits) +
+                 ") 被命中数为 " + QString::number(hits) + " 的候选升级替换");
+        m_tracks.erase(victim.id);
+        m_expiryWheel.cancel(victim.id);
+        preempted++;
+    }
+    m_preemptedTracks += preempted;
+    return preempted;
+}
+
+
+TrackPtr TrackManager::createTrack(const Measurement& measurement)
+{
+    TrackPtr track;
+    if (m_cheapInitiation) {
+        // 过载时新航迹以6维匀速模型起始，出现机动再按NIS升级为匀加速
+        auto model = std::make_unique<ConstantVelocityModel>();
+        track = std::make_shared<Track>(measurement, m_nextTrackId++, std::move(model));
+        track->enableModelSwitching();
+    } else if (m_motionModel == "imm") {
+        auto imm = std::make_unique<ImmFilter>(measurement.position);
+        track = std::make_shared<Track>(measurement, m_nextTrackId++, std::move(imm));
+    } else if (m_motionModel == "adaptive") {
+        auto model = std::make_unique<ConstantVelocityModel>();
+        track = std::make_shared<Track>(measurement, m_nextTrackId++, std::move(model));
+        track->enableModelSwitching();
+    } else if (m_motionModel == "cv") {
+        auto model = std::make_unique<ConstantVelocityModel>();
+        track = std::make_shared<Track>(measurement, m_nextTrackId++, std::move(model));
+    } else {
+        auto model = std::make_unique<ConstantAccelerationModel>();
+        track = std::make_shared<Track>(measurement, m_nextTrackId++, std::move(model));
+    }
+    if (m_singlePrecision) {
+        track->enableSinglePrecision(m_recenterDistance);
+    }
+    return track;
+}
+
+
+void TrackManager::publishMetrics() const
+{
+    QReadLocker locker(&m_lock);
+
+    publishModelMetrics();
+    publishCapacityMetrics();
+    publishArenaMetrics();
+    publishMemoryMetrics();
+    m_tentativePool.publishMetrics();
+}
+
+
+void TrackManager::publishModelMetrics() const
+{
+    int cvCount = 0, caCount = 0, immCount = 0, singlePrecisionCount = 0;
+    Eigen::Vector3d immProbabilities = Eigen::Vector3d::Zero();
+    for (const auto& pair : m_tracks) {
+        const Track& track = *pair.second;
+        if (const ImmFilter* imm = track.getImm()) {
+            immProbabilities += imm->modelProbabilities();
+            immCount++;
+        } else if (std::strcmp(track.getModelName(), "cv") == 0) {
+            cvCount++;
+            if (track.isSinglePrecision()) {
+                singlePrecisionCount++;
             }
         } else {
-            LOG_WARN("尝试管理不存在的航迹ID: " + QString::number(trackId));
+            caCount++;
+        }
+    }
+
+    nlohmann::json metrics;
+    metrics["cv"] = cvCount;
+    metrics["ca"] = caCount;
+    metrics["imm"] = immCount;
+    metrics["singlePrecision"] = singlePrecisionCount;
+    metrics["promotions"] = m_modelPromotions;
+    metrics["demotions"] = m_modelDemotions;
+    if (immCount > 0) {
+        immProbabilities /= immCount;
+        metrics["immMeanProbabilities"] = {immProbabilities(0), immProbabilities(1), immProbabilities(2)};
+    }
+    g_Metrics.setSection("motionModels", metrics);
+}
+
+
+void TrackManager::expireTracks(double now)
+{
+    LOG_FUNCTION_BEGIN();
+
+    m_expiredIds.clear();
+    m_expiryWheel.advance(now, m_expiredIds);
+
+    for (int trackId : m_expiredIds) {
+        auto it = m_tracks.find(trackId);
+        if (it == m_tracks.end()) {
+            LOG_WARN("到期的航迹ID不存在: " + QString::number(trackId));
+            continue;
         }
+        LOG_INFO("删除航迹 " + QString::number(trackId) + "，已 " +
+                 QString::number(now - it->second->getLastUpdateTime(), 'f', 2) + " 秒未更新");
+        m_tracks.erase(it);
     }
+    m_expiredTracks += static_cast<long long>(m_expiredIds.size());
 
-    LOG_DEBUG("共删除 " + QString::number(deletedCount) + " 条丢失航迹");
+    LOG_DEBUG("共删除 " + QString::number(m_expiredIds.size()) + " 条超时航迹");
     LOG_FUNCTION_END();
 }
 
 
+void TrackManager::scheduleExpiry(const Track& track)
+{
+    m_expiryWheel.schedule(track.getId(), track.getLastUpdateTime() + m_maxCoastTime);
+}
+
+
+void TrackManager::publishCapacityMetrics() const
+{
+    int confirmed = 0;
+    for (const auto& pair : m_tracks) {
+        if (pair.second->isConfirmed()) {
+            confirmed++;
+        }
+    }
+
+    nlohmann::json capacity;
+    capacity["count"] = m_tracks.size();
+    capacity["confirmed"] = confirmed;
+    capacity["limit"] = m_maxTracks;
+    capacity["shed"] = m_shedBirths;
+    capacity["shedLastCycle"] = m_shedLastCycle;
+    capacity["expired"] = m_expiredTracks;
+    capacity["preempted"] = m_preemptedTracks;
+    g_Metrics.setValue("capacity", "tracks", capacity);
+}
+
+
+void TrackManager::publishArenaMetrics() const
+{
+    nlohmann::json metrics;
+    metrics["bytesLastCycle"] = m_arena.lastCycleBytes();
+    metrics["highWater"] = m_arena.highWater();
+    metrics["capacity"] = m_arena.capacity();
+    metrics["blockAllocations"] = m_arena.blockAllocations();
+    metrics["blockAllocationsLastCycle"] = m_arena.lastCycleBlockAllocations();
+    g_Metrics.setSection("cycleArena", metrics);
+}
 
+
+void TrackManager::publishMemoryMetrics() const
+{
+    // 航迹表: 航迹对象本身、共享指针控制块和哈希表节点
+    size_t trackBytes = m_tracks.bucket_count() * sizeof(void*);
+    for (const auto& pair : m_tracks) {
+        trackBytes += pair.second->memoryFootprint() + sizeof(pair) + 4 * sizeof(void*);
+    }
+
+    nlohmann::json tracks;
+    tracks["count"] = m_tracks.size();
+    tracks["bytes"] = trackBytes;
+    tracks["bytesPerTrack"] = m_tracks.empty() ? 0 : trackBytes / m_tracks.size();
+    g_Metrics.setValue("memory", "tracks", tracks);
+
+    nlohmann::json tentative;
+    tentative["count"] = m_tentativePool.size();
+    tentative["bytes"] = m_tentativePool.memoryFootprint();
+    g_Metrics.setValue("memory", "tentativeCandidates", tentative);
+
+    nlohmann::json wheel;
+    wheel["count"] = m_expiryWheel.size();
+    wheel["bytes"] = m_expiryWheel.memoryFootprint();
+    g_Metrics.setValue("memory", "expiryWheel", wheel);
+
+    nlohmann::json arena;
+    arena["bytes"] = m_arena.capacity() + m_trackMeasurements.capacity() * sizeof(const Measurement*);
+    g_Metrics.setValue("memory", "cycleScratch", arena);
+}
@@ -11,12 +11,16 @@
 
 #include "DataStructures.h"
 #include "Track.h"
+#include "TentativeTrackPool.h"
+#include "TimerWheel.h"
+#include "MonotonicArena.h"
 #include <vector>
-#include <set>
 #include <unordered_map>
 #include <memory>
 #include <QMutex>
 #include <QReadWriteLock>
+#include <QElapsedTimer>
+#include <QString>
 
 /**
  * @brief 航迹管理器类
@@ -57,6 +61,44 @@ public:
      */
     std::vector<TrackPtr> getTracks() const;
 
+    /**
+     * @brief 获取航迹状态对应的时间戳
+     * @return 最近一次处理的观测批次的最新时间戳，航迹状态均已预测到该时刻
+     */
+    double getLastProcessTime() const;
+
+    /**
+     * @brief 无观测周期的航迹删除
+     * @details 没有观测时 processMeasurements() 不运行，时间轮也不推进。
+     *          此时按上次处理的观测时间加上此后经过的本机时间推进时间轮，
+     *          使输入中断后航迹仍按最大外推时间删除，不会一直以过期状态发布
+     */
+    void expireIdle();
+
+    /**
+     * @brief 设置过载降级选项
+     * @param cheapInitiation 为true时新航迹一律以匀速模型起始(机动时自动升级)，不使用IMM等高开销滤波器
+     * @param maxBirthsPerCycle 每周期最多创建的新航迹数，负数表示不限制
+     * @details 由工作线程的负载调节器按当前降级等级调用
+     */
+    void setDegradation(bool cheapInitiation, int maxBirthsPerCycle);
+
+    /**
+     * @brief 对所有航迹和候选做刚体坐标变换
+     * @param rotation 旋转矩阵
+     * @param translation 平移，x' = R x + t
+     * @details 跟踪原点移动时由工作线程调用
+     */
+    void transformFrame(const Eigen::Matrix3d& rotation, const Vector3& translation);
+
+    /**
+     * @brief 发布航迹管理器的全部指标
+     * @details 运动模型分布、容量、周期分配区、内存占用和候选池指标。
+     *          指标以JSON构建，会分配内存，因此不在 processMeasurements() 中发布，
+     *          由工作线程在周期末调用，关联和更新阶段稳态下不分配内存
+     */
+    void publishMetrics() const;
+
 private:
 
     //    void dataAssociation(const std::vector<Measurement>& measurements,
@@ -64,18 +106,30 @@ private:
     //                         std::vector<int>& unmatchedTracks,
     //                         std::vector<int>& unmatchedMeasurements);
 
-    std::set<int> dataAssociation(const std::vector<Measurement>& measurements,
-                                  std::vector<std::pair<int, int>>& matches,
-                                  std::vector<int>& unmatchedTracks,
-                                  std::vector<int>& unmatchedMeasurements);
+    /**
+     * @brief 数据关联
+     * @param measurements 观测数据列表
+     * @param trackSlots 输出，本周期航迹槽位表，槽位号即航迹在表中的下标
+     * @param matches 输出，匹配的 (航迹槽位, 观测索引) 对，同一航迹的匹配连续排列
+     * @param matchedSlots 输出，已匹配航迹的槽位位集
+     * @param unmatchedMeasurements 输出，未匹配的观测索引
+     */
+    void dataAssociation(const std::vector<Measurement>& measurements,
+                         ArenaVector<Track*>& trackSlots,
+                         ArenaVector<std::pair<int, int>>& matches,
+                         ArenaBitset& matchedSlots,
+                         ArenaVector<int>& unmatchedMeasurements);
 
     /**
      * @brief 更新匹配的航迹
-     * @param matches 成功匹配的航迹ID和观测索引对
+     * @param matches 成功匹配的航迹槽位和观测索引对
+     * @param trackSlots 航迹槽位表
      * @param measurements 观测数据列表
-     * @details 使用匹配的观测数据更新相应的航迹
+     * @details 使用匹配的观测数据更新相应的航迹，同一航迹的多条匹配
+     *          (来自不同观测者) 在matches中连续排列，并合并为一次联合更新
      */
-    void updateMatchedTracks(const std::vector<std::pair<int, int>>& matches,
+    void updateMatchedTracks(const ArenaVector<std::pair<int, int>>& matches,
+                             const ArenaVector<Track*>& trackSlots,
                              const std::vector<Measurement>& measurements);
 
     /**
@@ -87,16 +141,74 @@ private:
     //    void createNewTracks(const std::vector<int>& unmatchedMeasurements,
     //                         const std::vector<Measurement>& measurements);
 
-    void createNewTracks(const std::vector<int>& unmatchedMeasurements,
+    void createNewTracks(const ArenaVector<int>& unmatchedMeasurements,
                          const std::vector<Measurement>& measurements,
-                         const std::set<int>& matchedTrackIds);
+                         const ArenaVector<Track*>& trackSlots,
+                         const ArenaBitset& matchedSlots);
 
     /**
-     * @brief 管理未匹配的航迹
-     * @param unmatchedTracks 未匹配的航迹ID列表
-     * @details 增加未匹配航迹的丢失计数，删除丢失过久的航迹
+     * @brief 删除超时未更新的航迹
+     * @param now 当前时间(本批次最新观测的时间戳)
+     * @details 航迹按 最后更新时间 + 最大外推时间 登记在时间轮中，
+     *          只处理本周期到期的航迹，开销与航迹总数无关
      */
-    void manageUnmatchedTracks(const std::vector<int>& unmatchedTracks);
+    void expireTracks(double now);
+
+    /**
+     * @brief 按航迹最后更新时间登记或改期超时删除
+     * @param track 航迹
+     */
+    void scheduleExpiry(const Track& track);
+
+    /**
+     * @brief 按配置的运动模型创建航迹
+     * @param measurement 初始观测
+     * @return 新航迹，ID已分配
+     */
+    TrackPtr createTrack(const Measurement& measurement);
+
+    /**
+     * @brief 本周期还可创建的新航迹数
+     * @return 航迹表剩余容量与每周期起始上限中的较小值
+     */
+    int birthRoom() const;
+
+    /**
+     * @brief 航迹表已满时，以升级请求替换质量更差的未确认航迹
+     * @details 未确认航迹按命中少、位置协方差大的顺序依次与 promoted[first, last) 比较，
+     *          升级请求的命中数更多，或命中数相同而位置协方差更小时删除该航迹为其腾出位置。
+     *          确认航迹从不被替换
+     * @param promoted 已按质量从高到低排序的升级请求
+     * @param first 第一个无剩余容量的升级请求下标
+     * @param last 本周期起始限额内最后一个升级请求之后的下标
+     * @return 被替换的航迹数
+     */
+    int preemptUnconfirmed(const ArenaVector<TentativeTrackPool::Promotion>& promoted, int first, int last);
+
+    /**
+     * @brief 发布全部航迹的运动模型分布指标
+     * @details 统计各运动模型的航迹数、累计升降级次数及IMM航迹的平均模型概率
+     */
+    void publishModelMetrics() const;
+
+    /**
+     * @brief 发布航迹表容量指标
+     * @details 航迹数、确认航迹数、上限、因容量不足丢弃的新航迹数及被替换的未确认航迹数
+     */
+    void publishCapacityMetrics() const;
+
+    /**
+     * @brief 发布周期分配区指标
+     * @details 本周期分配字节数、峰值、持有容量及新增内存块的次数。
+     *          内存块次数只反映分配区是否还在增长，工作线程的全部堆分配见 allocations 指标
+     */
+    void publishArenaMetrics() const;
+
+    /**
+     * @brief 发布航迹管理各部分的内存占用
+     * @details 航迹表、暂定候选池、超时时间轮和周期分配区的估算字节数，用于观察长期运行中的内存增长
+     */
+    void publishMemoryMetrics() const;
 
 private:
     /**
@@ -115,6 +227,11 @@ private:
      */
     double m_lastProcessTime;
 
+    /**
+     * @brief 上一次处理观测批次以来经过的本机时间
+     */
+    QElapsedTimer m_sinceLastProcess;
+
     /**
      * @brief 关联门限距离(米)
      * @details 航迹与观测数据关联的最大允许距离
@@ -127,6 +244,108 @@ private:
      */
     double m_newTrackGateDistance;
 
+    /**
+     * @brief 是否启用多传感器联合更新
+     * @details 启用时每条航迹每个观测者最多关联一条观测，并在一次更新中融合
+     */
+    bool m_multiSensorFusion;
+
+    /**
+     * @brief 新航迹使用的运动模型
+     * @details "ca" 为单一匀加速模型，"cv" 为单一匀速模型，"imm" 为CV/CA/CT交互式多模型，
+     *          "adaptive" 为按NIS在CV与CA之间自动切换
+     */
+    QString m_motionModel;
+
+    /**
+     * @brief CV航迹是否使用单精度滤波器
+     */
+    bool m_singlePrecision;
+
+    /**
+     * @brief 单精度滤波的局部原点重定中心距离(米)
+     */
+    double m_recenterDistance;
+
+    /**
+     * @brief 累计CV升级为CA的次数
+     */
+    long long m_modelPromotions;
+
+    /**
+     * @brief 累计CA降级为CV的次数
+     */
+    long long m_modelDemotions;
+
+    /**
+     * @brief 暂定航迹池
+     * @details 未匹配观测先作为候选保存，满足M/N确认后才创建完整航迹
+     */
+    TentativeTrackPool m_tentativePool;
+
+    /**
+     * @brief 航迹数上限
+     * @details 达到上限后已有航迹(确认航迹和未确认航迹)保留，不再创建新航迹
+     */
+    int m_maxTracks;
+
+    /**
+     * @brief 累计因航迹数达到上限而丢弃的新航迹数
+     */
+    long long m_shedBirths;
+
+    /**
+     * @brief 最近一个周期丢弃的新航迹数
+     */
+    int m_shedLastCycle;
+
+    /**
+     * @brief 过载降级: 新航迹以低开销模型起始
+     */
+    bool m_cheapInitiation;
+
+    /**
+     * @brief 过载降级: 每周期最多创建的新航迹数，负数表示不限制
+     */
+    int m_maxBirthsPerCycle;
+
+    /**
+     * @brief 最大外推时间(秒)
+     * @details 航迹超过此时长未被观测更新即删除，与工作周期间隔无关
+     */
+    double m_maxCoastTime;
+
+    /**
+     * @brief 航迹超时删除时间轮
+     * @details 键为航迹ID，到期时间为 最后更新时间 + 最大外推时间
+     */
+    TimerWheel m_expiryWheel;
+
+    /**
+     * @brief 本周期到期的航迹ID(复用缓冲)
+     */
+    std::vector<int> m_expiredIds;
+
+    /**
+     * @brief 累计超时删除的航迹数
+     */
+    long long m_expiredTracks;
+
+    /**
+     * @brief 累计被质量更高的升级请求替换的未确认航迹数
+     */
+    long long m_preemptedTracks;
+
+    /**
+     * @brief 周期分配区
+     * @details 数据关联和航迹起始的临时数据在其上分配，每个处理周期结束时整体回收
+     */
+    MonotonicArena m_arena;
+
+    /**
+     * @brief 单条航迹本周期匹配的观测(复用缓冲)，指向本周期的观测列表
+     */
+    std::vector<const Measurement*> m_trackMeasurements;
 
     mutable QReadWriteLock m_lock;
 };
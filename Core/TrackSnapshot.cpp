@@ -0,0 +1,261 @@
+/**
+ * @file TrackSnapshot.cpp
+ * @brief 航迹快照实现文件
+ * @details 实现了按ID、区域、半径和最近邻的航迹查询
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TrackSnapshot.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <queue>
+
+namespace {
+
+/**
+ * @brief 网格坐标的取值范围，与散列键每个坐标21位一致
+ */
+const int kCellLimit = (1 << 20) - 1;
+
+} // namespace
+
+
+TrackSnapshot::TrackSnapshot(long long sequence, double timestamp, double cellSize,
+                             std::vector<TrackRecord> records, std::vector<Cell> cells, std::vector<int> order,
+                             const char* frame)
+    : m_sequence(sequence),
+      m_timestamp(timestamp),
+      m_cellSize(cellSize),
+      m_records(std::move(records)),
+      m_cells(std::move(cells)),
+      m_order(std::move(order)),
+      m_frame(frame)
+{
+    m_minCell[0] = m_minCell[1] = m_minCell[2] = INT_MAX;
+    m_maxCell[0] = m_maxCell[1] = m_maxCell[2] = INT_MIN;
+    for (const Cell& cell : m_cells) {
+        const int coords[3] = {cell.x, cell.y, cell.z};
+        for (int k = 0; k < 3; ++k) {
+            m_minCell[k] = std::min(m_minCell[k], coords[k]);
+            m_maxCell[k] = std::max(m_maxCell[k], coords[k]);
+        }
+    }
+}
+
+
+long long TrackSnapshot::sequence() const
+{
+    return m_sequence;
+}
+
+
+double TrackSnapshot::timestamp() const
+{
+    return m_timestamp;
+}
+
+
+const char* TrackSnapshot::frame() const
+{
+    return m_frame;
+}
+
+
+const std::vector<TrackRecord>& TrackSnapshot::records() const
+{
+    return m_records;
+}
+
+
+int TrackSnapshot::cellCount() const
+{
+    return static_cast<int>(m_cells.size());
+}
+
+
+const TrackRecord* TrackSnapshot::findById(int id) const
+{
+    auto it = std::lower_bound(m_records.begin(), m_records.end(), id,
+                               [](const TrackRecord& record, int value) { return record.id < value; });
+    return it != m_records.end() && it->id == id ? &*it : nullptr;
+}
+
+
+std::vector<int> TrackSnapshot::queryBox(const Vector3& minCorner, const Vector3& maxCorner) const
+{
+    std::vector<int> result;
+    if (m_cells.empty()) {
+        return result;
+    }
+
+    int lo[3], hi[3];
+    cellOf(minCorner, m_cellSize, lo[0], lo[1], lo[2]);
+    cellOf(maxCorner, m_cellSize, hi[0], hi[1], hi[2]);
+    double span = 1.0;
+    for (int k = 0; k < 3; ++k) {
+        lo[k] = std::max(lo[k], m_minCell[k]);
+        hi[k] = std::min(hi[k], m_maxCell[k]);
+        if (lo[k] > hi[k]) {
+            return result;
+        }
+        span *= hi[k] - lo[k] + 1;
+    }
+
+    auto collect = [&](const Cell& cell) {
+        for (int i = cell.begin; i < cell.end; ++i) {
+            const Vector3& p = m_records[m_order[i]].position;
+            if ((p.array() >= minCorner.array()).all() && (p.array() <= maxCorner.array()).all()) {
+                result.push_back(m_order[i]);
+            }
+        }
+    };
+
+    // 区域覆盖的网格多于非空网格时直接遍历非空网格
+    if (span > static_cast<double>(m_cells.size())) {
+        for (const auto& cell : m_cells) {
+            if (cell.x >= lo[0] && cell.x <= hi[0] && cell.y >= lo[1] && cell.y <= hi[1] &&
+                cell.z >= lo[2] && cell.z <= hi[2]) {
+                collect(cell);
+            }
+        }
+    } else {
+        for (int x = lo[0]; x <= hi[0]; ++x) {
+            for (int y = lo[1]; y <= hi[1]; ++y) {
+                for (int z = lo[2]; z <= hi[2]; ++z) {
+                    if (const Cell* cell = findCell(x, y, z)) {
+                        collect(*cell);
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+
+std::vector<int> TrackSnapshot::queryRadius(const Vector3& center, double radius) const
+{
+    std::vector<int> candidates = queryBox(center.array() - radius, center.array() + radius);
+
+    std::vector<std::pair<double, int>> hits;
+    hits.reserve(candidates.size());
+    const double radius2 = radius * radius;
+    for (int index : candidates) {
+        const double d2 = (m_records[index].position - center).squaredNorm();
+        if (d2 <= radius2) {
+            hits.emplace_back(d2, index);
+        }
+    }
+    std::sort(hits.begin(), hits.end());
+
+    std::vector<int> result;
+    result.reserve(hits.size());
+    for (const auto& hit : hits) {
+        result.push_back(hit.second);
+    }
+    return result;
+}
+
+
+std::vector<int> TrackSnapshot::queryNearest(const Vector3& point, int k) const
+{
+    std::vector<int> result;
+    if (k <= 0 || m_records.empty()) {
+        return result;
+    }
+    k = std::min<int>(k, static_cast<int>(m_records.size()));
+
+    // 大顶堆保存当前最近的k条，堆顶为其中最远的一条
+    std::priority_queue<std::pair<double, int>> best;
+    auto consider = [&](const Cell& cell) {
+        for (int i = cell.begin; i < cell.end; ++i) {
+            const double d2 = (m_records[m_order[i]].position - point).squaredNorm();
+            if (static_cast<int>(best.size()) < k) {
+                best.emplace(d2, m_order[i]);
+            } else if (d2 < best.top().first) {
+                best.pop();
+                best.emplace(d2, m_order[i]);
+            }
+        }
+    };
+
+    int c[3];
+    cellOf(point, m_cellSize, c[0], c[1], c[2]);
+    int maxRing = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        maxRing = std::max(maxRing, std::max(std::abs(c[axis] - m_minCell[axis]), std::abs(m_maxCell[axis] - c[axis])));
+    }
+
+    // 由中心网格逐圈向外扩展。查询点位于中心网格内，第 r+1 圈的网格与查询点的距离不小于 r 个网格边长，
+    // 已有k条且第k近的距离不超过该下界时即可停止
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        // 逐圈访问的网格数远多于非空网格数时，剩余部分改为直接遍历非空网格
+        const double side = 2.0 * ring + 1.0;
+        if (side * side * side > 8.0 * m_cells.size()) {
+            for (const auto& cell : m_cells) {
+                const int distance = std::max(std::abs(cell.x - c[0]), std::max(std::abs(cell.y - c[1]), std::abs(cell.z - c[2])));
+                if (distance >= ring) {
+                    consider(cell);
+                }
+            }
+            break;
+        }
+
+        for (int x = c[0] - ring; x <= c[0] + ring; ++x) {
+            for (int y = c[1] - ring; y <= c[1] + ring; ++y) {
+                const bool shellXY = std::abs(x - c[0]) == ring || std::abs(y - c[1]) == ring;
+                for (int z = c[2] - ring; z <= c[2] + ring; z += (shellXY || ring == 0) ? 1 : 2 * ring) {
+                    if (const Cell* cell = findCell(x, y, z)) {
+                        consider(*cell);
+                    }
+                }
+            }
+        }
+
+        if (static_cast<int>(best.size()) == k) {
+            const double bound = ring * m_cellSize;
+            if (best.top().first <= bound * bound) {
+                break;
+            }
+        }
+    }
+
+    result.resize(best.size());
+    for (int i = static_cast<int>(best.size()) - 1; i >= 0; --i) {
+        result[i] = best.top().second;
+        best.pop();
+    }
+    return result;
+}
+
+
+long long TrackSnapshot::cellKey(long long x, long long y, long long z)
+{
+    // 每个坐标占21位，覆盖 ±2^20 个网格
+    const long long mask = (1LL << 21) - 1;
+    return ((x & mask) << 42) | ((y & mask) << 21) | (z & mask);
+}
+
+
+void TrackSnapshot::cellOf(const Vector3& position, double cellSize, int& x, int& y, int& z)
+{
+    const double limit = kCellLimit;
+    x = static_cast<int>(std::max(-limit, std::min(limit, std::floor(position.x() / cellSize))));
+    y = static_cast<int>(std::max(-limit, std::min(limit, std::floor(position.y() / cellSize))));
+    z = static_cast<int>(std::max(-limit, std::min(limit, std::floor(position.z() / cellSize))));
+}
+
+
+const TrackSnapshot::Cell* TrackSnapshot::findCell(int x, int y, int z) const
+{
+    if (x < m_minCell[0] || x > m_maxCell[0] || y < m_minCell[1] || y > m_maxCell[1] ||
+        z < m_minCell[2] || z > m_maxCell[2]) {
+        return nullptr;
+    }
+    const long long key = cellKey(x, y, z);
+    auto it = std::lower_bound(m_cells.begin(), m_cells.end(), key,
+                               [](const Cell& cell, long long value) { return cell.key < value; });
+    return it != m_cells.end() && it->key == key ? &*it : nullptr;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file TrackSnapshot.h
+ * @brief 航迹快照头文件
+ * @details 定义了TrackRecord结构和TrackSnapshot类，保存一个处理周期结束时的确认航迹及其空间网格索引
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef TRACKSNAPSHOT_H
+#define TRACKSNAPSHOT_H
+
+#include "DataStructures.h"
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 快照中的单条航迹
+ * @details 状态统一为 [位置, 速度, 加速度] 9维，匀速模型航迹的加速度及其协方差为零
+ */
+struct TrackRecord {
+    int id = 0;                                        ///< 航迹ID
+    int hits = 0;                                      ///< 命中次数
+    const char* model = "cv";                          ///< 运动模型名称
+    int stateDim = 6;                                  ///< 滤波状态维数，6为匀速、9为匀加速/IMM
+    Vector3 position = Vector3::Zero();                ///< 位置
+    Vector3 velocity = Vector3::Zero();                ///< 速度
+    Vector3 acceleration = Vector3::Zero();            ///< 加速度
+    Vector3 extent = Vector3::Zero();                  ///< 外形尺寸
+    Eigen::Matrix<double, 9, 9> covariance = Eigen::Matrix<double, 9, 9>::Zero(); ///< [p, v, a] 协方差
+};
+
+/**
+ * @brief 航迹快照类
+ * @details 构造后只读，可被任意多个线程同时查询。
+ *          航迹按所在网格排列，每个非空网格对应 m_order 中的一段连续区间，
+ *          区域、半径查询只访问与查询范围相交的网格，最近邻查询由中心网格逐圈向外扩展。
+ *          记录按航迹ID升序、网格按散列键升序由发布方排好，按ID和按网格的查找均为二分查找，
+ *          构造时不建立散列索引。
+ *          位置、速度、加速度和协方差均为发布坐标系(见 GeodeticFrame::publishFrame())，
+ *          不随跟踪原点移动，查询坐标使用同一坐标系
+ */
+class TrackSnapshot
+{
+public:
+    /**
+     * @brief 非空网格
+     */
+    struct Cell {
+        long long key;  ///< 网格散列键，见 cellKey()
+        int x;      ///< 网格坐标
+        int y;      ///< 网格坐标
+        int z;      ///< 网格坐标
+        int begin;  ///< 在 m_order 中的起始位置
+        int end;    ///< 在 m_order 中的结束位置(不含)
+    };
+
+    /**
+     * @brief 构造函数
+     * @param sequence 快照序号，每个周期递增
+     * @param timestamp 航迹状态对应的时间戳(秒)
+     * @param cellSize 网格边长(米)
+     * @param records 航迹记录，按航迹ID升序
+     * @param cells 非空网格，按网格排列的航迹区间，按散列键升序
+     * @param order 按网格排列的记录下标
+     * @param frame 坐标系名称，"enu" 或 "ecef"
+     */
+    TrackSnapshot(long long sequence, double timestamp, double cellSize,
+                  std::vector<TrackRecord> records, std::vector<Cell> cells, std::vector<int> order,
+                  const char* frame);
+
+    /**
+     * @brief 获取快照序号
+     * @return 序号
+     */
+    long long sequence() const;
+
+    /**
+     * @brief 获取航迹状态对应的时间戳
+     * @return 时间戳(秒)
+     */
+    double timestamp() const;
+
+    /**
+     * @brief 获取坐标系名称
+     * @return "enu" 或 "ecef"
+     */
+    const char* frame() const;
+
+    /**
+     * @brief 获取全部航迹记录
+     * @return 航迹记录数组
+     */
+    const std::vector<TrackRecord>& records() const;
+
+    /**
+     * @brief 获取非空网格数
+     * @return 网格数
+     */
+    int cellCount() const;
+
+    /**
+     * @brief 按ID查找航迹
+     * @param id 航迹ID
+     * @return 航迹记录指针，不存在时返回nullptr
+     */
+    const TrackRecord* findById(int id) const;
+
+    /**
+     * @brief 区域查询
+     * @param minCorner 区域最小角
+     * @param maxCorner 区域最大角
+     * @return 位于区域内(含边界)的记录下标
+     */
+    std::vector<int> queryBox(const Vector3& minCorner, const Vector3& maxCorner) const;
+
+    /**
+     * @brief 半径查询
+     * @param center 球心
+     * @param radius 半径(米)
+     * @return 与球心距离不超过半径的记录下标，按距离升序
+     */
+    std::vector<int> queryRadius(const Vector3& center, double radius) const;
+
+    /**
+     * @brief 最近邻查询
+     * @param point 查询点
+     * @param k 返回的航迹数
+     * @return 距离最近的至多k条记录下标，按距离升序
+     */
+    std::vector<int> queryNearest(const Vector3& point, int k) const;
+
+    /**
+     * @brief 网格坐标编码为散列键
+     * @param x 网格坐标
+     * @param y 网格坐标
+     * @param z 网格坐标
+     * @return 散列键，每个坐标占21位
+     */
+    static long long cellKey(long long x, long long y, long long z);
+
+    /**
+     * @brief 计算位置所在网格
+     * @param position 位置
+     * @param cellSize 网格边长(米)
+     * @param x 输出，网格坐标
+     * @param y 输出，网格坐标
+     * @param z 输出，网格坐标
+     * @details 网格坐标截断到散列键可表示的范围
+     */
+    static void cellOf(const Vector3& position, double cellSize, int& x, int& y, int& z);
+
+private:
+    /**
+     * @brief 查找网格
+     * @param x 网格坐标
+     * @param y 网格坐标
+     * @param z 网格坐标
+     * @return 网格指针，空网格返回nullptr
+     */
+    const Cell* findCell(int x, int y, int z) const;
+
+private:
+    /**
+     * @brief 快照序号
+     */
+    long long m_sequence;
+
+    /**
+     * @brief 航迹状态对应的时间戳
+     */
+    double m_timestamp;
+
+    /**
+     * @brief 网格边长(米)
+     */
+    double m_cellSize;
+
+    /**
+     * @brief 航迹记录，按航迹ID升序
+     */
+    std::vector<TrackRecord> m_records;
+
+    /**
+     * @brief 非空网格，按散列键升序
+     */
+    std::vector<Cell> m_cells;
+
+    /**
+     * @brief 按网格排列的记录下标
+     */
+    std::vector<int> m_order;
+
+    /**
+     * @brief 坐标系名称
+     */
+    const char* m_frame;
+
+    /**
+     * @brief 非空网格坐标的最小值
+     */
+    int m_minCell[3];
+
+    /**
+     * @brief 非空网格坐标的最大值
+     */
+    int m_maxCell[3];
+};
+
+#endif // TRACKSNAPSHOT_H
@@ -0,0 +1,201 @@
+/**
+ * @file TrackSnapshotStore.cpp
+ * @brief 航迹快照发布实现文件
+ * @details 实现了确认航迹快照的生成、网格索引的增量维护和快照的原子替换
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TrackSnapshotStore.h"
+#include "GeodeticFrame.h"
+#include "LogManager.h"
+#include "MetricsRegistry.h"
+#include <QSettings>
+#include <QElapsedTimer>
+#include <algorithm>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[TrackSnapshotStore::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[TrackSnapshotStore::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[TrackSnapshotStore::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[TrackSnapshotStore::" << __FUNCTION__ << "] " << msg
+
+
+TrackSnapshotStore& TrackSnapshotStore::instance()
+{
+    // C++11 保证了静态局部变量的初始化是线程安全的
+    static TrackSnapshotStore instance;
+    return instance;
+}
+
+
+TrackSnapshotStore::TrackSnapshotStore()
+    : m_sequence(0)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_cellSize = settings.value("Query/cellSize", 1000.0).toDouble();
+    if (m_cellSize <= 0) {
+        LOG_WARN("查询网格边长无效: " + QString::number(m_cellSize) + "，使用1000米");
+        m_cellSize = 1000.0;
+    }
+}
+
+
+void TrackSnapshotStore::publish(const std::vector<TrackPtr>& tracks, double timestamp)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 1. 收集确认航迹，按ID排序后展开，状态统一展开为 [p, v, a]；快照按ID二分查找
+    std::vector<const Track*> confirmed;
+    confirmed.reserve(tracks.size());
+    for (const auto& track : tracks) {
+        if (track->isConfirmed()) {
+            confirmed.push_back(track.get());
+        }
+    }
+    std::sort(confirmed.begin(), confirmed.end(),
+              [](const Track* a, const Track* b) { return a->getId() < b->getId(); });
+
+    // 状态变换到发布坐标系，跟踪原点移动前后快照中的坐标连续，网格桶也不必重建。
+    // 状态按 [p, v, a] 的3维块排列，变换矩阵为块对角的旋转
+    const GeodeticFrame& frame = GeodeticFrame::instance();
+    Eigen::Matrix3d rotation;
+    Vector3 translation;
+    const bool transform = frame.publishTransform(rotation, translation);
+    Eigen::Matrix<double, 9, 9> T = Eigen::Matrix<double, 9, 9>::Zero();
+    for (int k = 0; k < 9; k += 3) {
+        T.block<3, 3>(k, k) = rotation;
+    }
+
+    std::vector<TrackRecord> records;
+    records.reserve(confirmed.size());
+    for (const Track* track : confirmed) {
+        const StateVector& x = track->getState();
+        const StateMatrix& P = track->getCovariance();
+        const int n = static_cast<int>(std::min<Eigen::Index>(x.size(), 9));
+
+        TrackRecord record;
+        record.id = track->getId();
+        record.hits = track->getHits();
+        record.model = track->getModelName();
+        record.stateDim = n;
+        record.position = x.head<3>();
+        record.velocity = x.segment<3>(3);
+        if (n >= 9) {
+            record.acceleration = x.segment<3>(6);
+        }
+        record.extent = track->getExtent();
+        record.covariance.topLeftCorner(n, n) = P.topLeftCorner(n, n);
+        if (transform) {
+            record.position = rotation * record.position + translation;
+            record.velocity = rotation * record.velocity;
+            record.acceleration = rotation * record.acceleration;
+            record.covariance = T * record.covariance * T.transpose();
+        }
+
+        records.push_back(record);
+    }
+    auto recordOf = [&records](int id) {
+        auto it = std::lower_bound(records.begin(), records.end(), id,
+                                   [](const TrackRecord& record, int value) { return record.id < value; });
+        return it != records.end() && it->id == id ? static_cast<int>(it - records.begin()) : -1;
+    };
+
+    // 2. 删除已不在快照中的航迹
+    int moved = 0;
+    for (auto it = m_cellOfTrack.begin(); it != m_cellOfTrack.end();) {
+        if (recordOf(it->first) < 0) {
+            removeFromBucket(it->second, it->first);
+            it = m_cellOfTrack.erase(it);
+            moved++;
+        } else {
+            ++it;
+        }
+    }
+
+    // 3. 新增航迹和跨网格移动的航迹更新网格桶，其余航迹不动
+    for (const auto& record : records) {
+        int x, y, z;
+        TrackSnapshot::cellOf(record.position, m_cellSize, x, y, z);
+        const long long key = TrackSnapshot::cellKey(x, y, z);
+
+        auto it = m_cellOfTrack.find(record.id);
+        if (it != m_cellOfTrack.end()) {
+            if (it->second == key) {
+                continue;
+            }
+            removeFromBucket(it->second, record.id);
+            it->second = key;
+        } else {
+            m_cellOfTrack.emplace(record.id, key);
+        }
+
+        auto bucket = m_grid.find(key);
+        if (bucket == m_grid.end()) {
+            bucket = m_grid.emplace(key, Bucket{x, y, z, {}}).first;
+        }
+        bucket->second.ids.push_back(record.id);
+        moved++;
+    }
+
+    // 4. 按网格桶展开为快照中的连续区间，网格桶按散列键有序，快照按键二分查找网格
+    std::vector<TrackSnapshot::Cell> cells;
+    cells.reserve(m_grid.size());
+    std::vector<int> order;
+    order.reserve(records.size());
+    for (const auto& pair : m_grid) {
+        const Bucket& bucket = pair.second;
+        TrackSnapshot::Cell cell;
+        cell.key = pair.first;
+        cell.x = bucket.x;
+        cell.y = bucket.y;
+        cell.z = bucket.z;
+        cell.begin = static_cast<int>(order.size());
+        for (int id : bucket.ids) {
+            order.push_back(recordOf(id));
+        }
+        cell.end = static_cast<int>(order.size());
+        cells.push_back(cell);
+    }
+
+    const int trackCount = static_cast<int>(records.size());
+    const int cellCount = static_cast<int>(cells.size());
+    std::shared_ptr<const TrackSnapshot> snapshot =
+            std::make_shared<const TrackSnapshot>(++m_sequence, timestamp, m_cellSize,
+                                                  std::move(records), std::move(cells), std::move(order),
+                                                  frame.publishFrameName());
+    std::atomic_store(&m_current, snapshot);
+
+    nlohmann::json metrics;
+    metrics["sequence"] = m_sequence;
+    metrics["tracks"] = trackCount;
+    metrics["cells"] = cellCount;
+    metrics["indexUpdates"] = moved;
+    metrics["buildMicros"] = timer.nsecsElapsed() / 1000;
+    g_Metrics.setSection("snapshot", metrics);
+}
+
+
+std::shared_ptr<const TrackSnapshot> TrackSnapshotStore::current() const
+{
+    return std::atomic_load(&m_current);
+}
+
+
+void TrackSnapshotStore::removeFromBucket(long long key, int id)
+{
+    auto bucket = m_grid.find(key);
+    if (bucket == m_grid.end()) {
+        return;
+    }
+    std::vector<int>& ids = bucket->second.ids;
+    auto it = std::find(ids.begin(), ids.end(), id);
+    if (it != ids.end()) {
+        *it = ids.back();
+        ids.pop_back();
+    }
+    if (ids.empty()) {
+        m_grid.erase(bucket);
+    }
+}
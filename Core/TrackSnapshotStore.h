@@ -0,0 +1,113 @@
+/**
+ * @file TrackSnapshotStore.h
+ * @brief 航迹快照发布头文件
+ * @details 定义了TrackSnapshotStore类，每个处理周期发布一份只读的航迹快照，供查询接口无锁读取
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef TRACKSNAPSHOTSTORE_H
+#define TRACKSNAPSHOTSTORE_H
+
+#include "Track.h"
+#include "TrackSnapshot.h"
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 航迹快照发布类
+ * @details 工作线程在周期结束时调用publish()，由确认航迹生成新快照后以原子操作替换当前快照，
+ *          航迹状态在发布时一次变换到发布坐标系，快照的各个读者(查询、外推、共享内存航迹表)都不再转换；
+ *          查询线程通过current()取得快照的共享指针后即可任意查询，不接触TrackManager的锁，
+ *          旧快照在最后一个读者释放后自动回收。
+ *          空间索引在周期之间增量维护: 只有新增、删除和跨网格移动的航迹修改网格桶，
+ *          发布时按网格桶顺序展开为快照中的连续区间。网格桶按散列键有序保存，快照直接沿用这一顺序
+ *          二分查找网格，航迹记录按ID排序后二分查找航迹，快照构造时不再重建散列索引。
+ *          使用单例模式，publish()只在工作线程中调用，current()可在任意线程调用
+ */
+class TrackSnapshotStore
+{
+public:
+    /**
+     * @brief 获取航迹快照发布单例实例
+     * @return 快照发布实例的引用
+     */
+    static TrackSnapshotStore& instance();
+
+    /**
+     * @brief 发布本周期的航迹快照
+     * @param tracks 当前全部航迹，只收录确认航迹
+     * @param timestamp 航迹状态对应的时间戳(秒)
+     */
+    void publish(const std::vector<TrackPtr>& tracks, double timestamp);
+
+    /**
+     * @brief 获取当前快照
+     * @return 快照的共享指针，尚未发布时为空
+     */
+    std::shared_ptr<const TrackSnapshot> current() const;
+
+private:
+    /**
+     * @brief 增量维护的网格桶
+     */
+    struct Bucket {
+        int x;                  ///< 网格坐标
+        int y;                  ///< 网格坐标
+        int z;                  ///< 网格坐标
+        std::vector<int> ids;   ///< 网格内的航迹ID
+    };
+
+    /**
+     * @brief 私有构造函数
+     * @details 从配置文件 Query 分组读取网格边长
+     */
+    TrackSnapshotStore();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    TrackSnapshotStore(const TrackSnapshotStore&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    TrackSnapshotStore& operator=(const TrackSnapshotStore&) = delete;
+
+    /**
+     * @brief 从网格桶中移除航迹
+     * @param key 网格散列键
+     * @param id 航迹ID
+     */
+    void removeFromBucket(long long key, int id);
+
+private:
+    /**
+     * @brief 网格边长(米)
+     */
+    double m_cellSize;
+
+    /**
+     * @brief 已发布的快照数
+     */
+    long long m_sequence;
+
+    /**
+     * @brief 当前快照，以 std::atomic_load/atomic_store 访问
+     */
+    std::shared_ptr<const TrackSnapshot> m_current;
+
+    /**
+     * @brief 网格桶，键为网格散列键，按键有序，跨周期保留
+     */
+    std::map<long long, Bucket> m_grid;
+
+    /**
+     * @brief 各航迹上一周期所在网格的散列键
+     */
+    std::unordered_map<int, long long> m_cellOfTrack;
+};
+
+#endif // TRACKSNAPSHOTSTORE_H
@@ -28,12 +28,17 @@ msvc{
 CONFIG(release, debug|release) {
     DEFINES += NDEBUG
     # 上面这行通常是qmake自动添加的，但显式写出来可以保证它一定生效
+    # 服务运行时关闭了调试日志；编译期去掉qDebug后，LOG_DEBUG的参数不再求值，不产生字符串拼接和内存分配
+    DEFINES += QT_NO_DEBUG_OUTPUT
 }
 # 否则 (debug模式)
 else {
     DEFINES += DEBUG
 }
 
+# 统计全局new/delete的次数和字节数，结果见健康检查的 metrics.allocations
+#DEFINES += MTT_ALLOCATION_TRACKING
+
 
 INCLUDEPATH += $$PWD/dds
 INCLUDEPATH += $$PWD/Core
@@ -48,31 +53,83 @@ DESTDIR += $$PWD/binr
 SOURCES += main.cpp \
     Core/SRCKF.cpp \
     Tools/LogManager.cpp \
+    Tools/MetricsRegistry.cpp \
+    Tools/ObserverRegistry.cpp \
+    Tools/SharedTrackReader.cpp \
+    Tools/AllocationTracker.cpp \
+    Tools/MonotonicArena.cpp \
     Service/MessageRelayManager.cpp \
     Service/Service.cpp \
     Service/Worker.cpp \
+    Service/LoadGovernor.cpp \
+    Service/SharedTrackTable.cpp \
     Core/DataStructures.cpp \
     Core/ConstantVelocityModel.cpp \
     Core/Track.cpp \
     Core/TrackManager.cpp \
     Core/CKF.cpp \
+    Core/CompactCvFilter.cpp \
+    Core/GeodeticFrame.cpp \
+    Core/ClockOffsetEstimator.cpp \
+    Core/TrackSnapshot.cpp \
+    Core/TrackSnapshotStore.cpp \
+    Core/TrackExtrapolator.cpp \
+    Core/ImmFilter.cpp \
+    Core/TentativeTrackPool.cpp \
+    Core/TimerWheel.cpp \
+    Core/SensorRegistry.cpp \
+    Core/CartesianMeasurementModel.cpp \
+    Core/SphericalMeasurementModel.cpp \
+    Core/BearingTriangulator.cpp \
+    Core/PointCloudClusterer.cpp \
+    Core/MeasurementCoalescer.cpp \
     Service/HealthCheckServer.cpp \
+    Service/ExtrapolationServer.cpp \
+    Service/TrackStreamServer.cpp \
+    Service/OutputEncoder.cpp \
     Core/ConstantAccelerationModel.cpp
 
 
 HEADERS += \
     Core/SRCKF.h \
     Tools/LogManager.h \
+    Tools/MetricsRegistry.h \
+    Tools/ObserverRegistry.h \
+    Tools/SharedTrackLayout.h \
+    Tools/SharedTrackReader.h \
+    Tools/AllocationTracker.h \
+    Tools/MonotonicArena.h \
     Service/MessageRelayManager.h \
     Service/Service.h \
     Service/Worker.h \
+    Service/LoadGovernor.h \
+    Service/SharedTrackTable.h \
     Core/DataStructures.h \
     Core/ConstantVelocityModel.h \
     Core/IMotionModel.h \
     Core/Track.h \
     Core/TrackManager.h \
     Core/CKF.h \
+    Core/CompactCvFilter.h \
+    Core/GeodeticFrame.h \
+    Core/ClockOffsetEstimator.h \
+    Core/TrackSnapshot.h \
+    Core/TrackSnapshotStore.h \
+    Core/TrackExtrapolator.h \
+    Core/ImmFilter.h \
+    Core/TentativeTrackPool.h \
+    Core/TimerWheel.h \
+    Core/SensorRegistry.h \
+    Core/IMeasurementModel.h \
+    Core/CartesianMeasurementModel.h \
+    Core/SphericalMeasurementModel.h \
+    Core/BearingTriangulator.h \
+    Core/PointCloudClusterer.h \
+    Core/MeasurementCoalescer.h \
     Service/HealthCheckServer.h \
+    Service/ExtrapolationServer.h \
+    Service/TrackStreamServer.h \
+    Service/OutputEncoder.h \
     Core/ConstantAccelerationModel.h
 
 win32 {
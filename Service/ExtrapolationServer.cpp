@@ -0,0 +1,205 @@
+/**
+ * @file ExtrapolationServer.cpp
+ * @brief 航迹外推服务器实现文件
+ * @details 实现了本地套接字上的航迹外推查询协议
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "ExtrapolationServer.h"
+#include "TrackExtrapolator.h"
+#include "TrackSnapshotStore.h"
+#include "LogManager.h"
+#include <QLocalSocket>
+#include <QElapsedTimer>
+#include "nlohmann/json.hpp"
+#include <vector>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[ExtrapolationServer::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[ExtrapolationServer::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[ExtrapolationServer::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[ExtrapolationServer::" << __FUNCTION__ << "] " << msg
+
+using json = nlohmann::json;
+
+namespace {
+
+/**
+ * @brief 单行请求的最大长度，超过时断开连接
+ */
+const int kMaxLineLength = 64 * 1024;
+
+/**
+ * @brief 外推状态转为JSON
+ * @param state 外推后的状态
+ * @return 航迹JSON，协方差按滤波状态维数以行优先展开
+ */
+json stateJson(const ExtrapolatedState& state)
+{
+    json item;
+    item["id"] = state.id;
+    item["horizon"] = state.horizon;
+    item["position"] = { {"x", state.position.x()}, {"y", state.position.y()}, {"z", state.position.z()} };
+    item["velocity"] = { {"x", state.velocity.x()}, {"y", state.velocity.y()}, {"z", state.velocity.z()} };
+    if (state.stateDim >= 9) {
+        item["acceleration"] = { {"x", state.acceleration.x()}, {"y", state.acceleration.y()}, {"z", state.acceleration.z()} };
+    }
+    const int n = state.stateDim >= 9 ? 9 : 6;
+    std::vector<double> covariance;
+    covariance.reserve(n * n);
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            covariance.push_back(state.covariance(r, c));
+        }
+    }
+    item["stateDim"] = n;
+    item["covariance"] = covariance;
+    return item;
+}
+
+/**
+ * @brief 外推结果对应的错误描述
+ * @param result 外推结果
+ * @return 错误描述
+ */
+const char* resultText(TrackExtrapolator::Result result)
+{
+    switch (result) {
+    case TrackExtrapolator::Result::NoSnapshot:
+        return "no snapshot published yet";
+    case TrackExtrapolator::Result::NotFound:
+        return "track not found";
+    case TrackExtrapolator::Result::OutOfHorizon:
+        return "requested time outside extrapolation horizon";
+    default:
+        return "ok";
+    }
+}
+
+} // namespace
+
+
+ExtrapolationServer::ExtrapolationServer(QObject *parent)
+    : QObject(parent)
+{
+    m_server = new QLocalServer(this);
+    connect(m_server, &QLocalServer::newConnection, this, &ExtrapolationServer::onNewConnection);
+    LOG_INFO("航迹外推服务器已创建");
+}
+
+
+ExtrapolationServer::~ExtrapolationServer()
+{
+    LOG_INFO("航迹外推服务器已销毁");
+}
+
+
+bool ExtrapolationServer::startListen(const QString& name)
+{
+    // 进程异常退出后可能残留同名套接字文件
+    QLocalServer::removeServer(name);
+    const bool success = m_server->listen(name);
+    if (success) {
+        LOG_INFO("成功在本地套接字 " + name + " 上启动监听，最大外推时长: " +
+                 QString::number(TrackExtrapolator::instance().maxHorizon()) + "秒");
+    } else {
+        LOG_ERROR("无法在本地套接字 " + name + " 上启动监听: " + m_server->errorString());
+    }
+    return success;
+}
+
+
+void ExtrapolationServer::stopListen()
+{
+    m_server->close();
+    LOG_INFO("服务器已停止监听");
+}
+
+
+std::string ExtrapolationServer::handleRequest(const QByteArray& line) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    json response;
+    json request = json::parse(line.constData(), line.constData() + line.size(), nullptr, false);
+    if (request.is_discarded() || !request.is_object() || !request.contains("time") || !request["time"].is_number()) {
+        response["ok"] = false;
+        response["error"] = "invalid request";
+        return response.dump();
+    }
+
+    const double time = request["time"].get<double>();
+    const TrackExtrapolator& extrapolator = TrackExtrapolator::instance();
+    TrackExtrapolator::Result result;
+    json tracks = json::array();
+    if (request.contains("id") && request["id"].is_number_integer()) {
+        ExtrapolatedState state;
+        result = extrapolator.extrapolate(request["id"].get<int>(), time, state);
+        if (result == TrackExtrapolator::Result::Ok) {
+            tracks.push_back(stateJson(state));
+        }
+    } else {
+        std::vector<ExtrapolatedState> states;
+        result = extrapolator.extrapolateAll(time, states);
+        for (const auto& state : states) {
+            tracks.push_back(stateJson(state));
+        }
+    }
+
+    response["ok"] = result == TrackExtrapolator::Result::Ok;
+    if (result != TrackExtrapolator::Result::Ok) {
+        response["error"] = resultText(result);
+    }
+    response["time"] = time;
+    if (std::shared_ptr<const TrackSnapshot> snapshot = TrackSnapshotStore::instance().current()) {
+        response["frame"] = snapshot->frame();
+    }
+    response["tracks"] = tracks;
+    response["elapsedMicros"] = timer.nsecsElapsed() / 1000;
+    return response.dump();
+}
+
+
+void ExtrapolationServer::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, &ExtrapolationServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, this, &ExtrapolationServer::onDisconnected);
+        LOG_DEBUG("接受新的本地连接");
+    }
+}
+
+
+void ExtrapolationServer::onReadyRead()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket) {
+        LOG_ERROR("无效的socket对象");
+        return;
+    }
+
+    while (socket->canReadLine()) {
+        const QByteArray line = socket->readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+        socket->write(QByteArray::fromStdString(handleRequest(line)) + '\n');
+    }
+
+    // 缓冲中没有换行却已超长，视为异常客户端
+    if (socket->bytesAvailable() > kMaxLineLength) {
+        LOG_WARN("请求行过长，断开连接");
+        socket->disconnectFromServer();
+    }
+}
+
+
+void ExtrapolationServer::onDisconnected()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+    if (socket) {
+        socket->deleteLater();
+    }
+}
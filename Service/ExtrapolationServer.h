@@ -0,0 +1,85 @@
+/**
+ * @file ExtrapolationServer.h
+ * @brief 航迹外推服务器头文件
+ * @details 定义了ExtrapolationServer类，通过本地套接字提供任意时刻的航迹状态查询
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef EXTRAPOLATIONSERVER_H
+#define EXTRAPOLATIONSERVER_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QByteArray>
+#include <QString>
+#include <string>
+
+/**
+ * @brief 航迹外推服务器类
+ * @details 本机客户端(显示、火控等)按各自的渲染或决策时刻查询航迹状态，不必等待周期输出。
+ *          协议为按行分隔的JSON: 请求 {"id":航迹ID,"time":时刻} 外推单条航迹，
+ *          省略 id 时外推全部确认航迹；每个请求返回一行JSON响应，坐标为发布坐标系，由 frame 字段给出。
+ *          计算由 TrackExtrapolator 基于最近发布的航迹快照完成，不访问航迹管理器
+ */
+class ExtrapolationServer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     */
+    explicit ExtrapolationServer(QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     */
+    ~ExtrapolationServer();
+
+    /**
+     * @brief 启动监听
+     * @param name 本地套接字名称
+     * @return 是否成功启动
+     * @details 启动前移除同名的残留套接字
+     */
+    bool startListen(const QString& name);
+
+    /**
+     * @brief 停止监听
+     */
+    void stopListen();
+
+private slots:
+    /**
+     * @brief 新连接处理槽函数
+     */
+    void onNewConnection();
+
+    /**
+     * @brief 数据可读处理槽函数
+     * @details 逐行解析请求并写回响应，不完整的行留待下次读取
+     */
+    void onReadyRead();
+
+    /**
+     * @brief 连接断开处理槽函数
+     */
+    void onDisconnected();
+
+private:
+    /**
+     * @brief 处理一行请求
+     * @param line 请求JSON文本
+     * @return 响应JSON文本(不含换行)
+     */
+    std::string handleRequest(const QByteArray& line) const;
+
+private:
+    /**
+     * @brief 本地套接字服务器对象
+     */
+    QLocalServer* m_server;
+};
+
+#endif // EXTRAPOLATIONSERVER_H
@@ -1,18 +1,27 @@
 /**
  * @file HealthCheckServer.cpp
  * @brief 健康检查服务器实现文件
- * @details 实现了HealthCheckServer类的各种功能，包括HTTP服务和健康状态检查
+ * @details 实现了HealthCheckServer类的各种功能，包括HTTP/1.1连接管理、请求路由、响应缓存和健康状态检查
  * @author xubb
  * @date 20250711
  */
 
 #include "HealthCheckServer.h"
 #include "Service.h"
+#include "MetricsRegistry.h"
+#include "ObserverRegistry.h"
+#include "TrackSnapshotStore.h"
 #include <QTcpSocket>
 #include <QDateTime>
 #include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSettings>
 #include "nlohmann/json.hpp"
 #include <string>
+#include <map>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
 
 // 定义统一的日志宏
 #define LOG_DEBUG(msg) qDebug() << "[HealthCheckServer::" << __FUNCTION__ << "] " << msg
@@ -26,20 +35,125 @@
 
 using json = nlohmann::json;
 
+namespace {
+
+/**
+ * @brief 请求头的最大字节数，超过时返回431并断开连接
+ */
+const int kMaxHeaderBytes = 16 * 1024;
+
+/**
+ * @brief 请求体的最大字节数，超过时返回413并断开连接
+ */
+const int kMaxBodyBytes = 64 * 1024;
+
+/**
+ * @brief HTTP状态码对应的原因短语
+ * @param statusCode HTTP状态码
+ * @return 原因短语
+ */
+const char* reasonPhrase(int statusCode)
+{
+    switch (statusCode) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 503: return "Service Unavailable";
+    default: return "Internal Server Error";
+    }
+}
+
+/**
+ * @brief 构造错误响应体
+ * @param message 错误描述
+ * @return JSON响应体
+ */
+QByteArray errorBody(const char* message)
+{
+    json body;
+    body["error"] = message;
+    return QByteArray::fromStdString(body.dump());
+}
+
+/**
+ * @brief 解析URL查询串
+ * @param query 形如 "a=1&b=2" 的查询串
+ * @return 参数名到参数值的映射
+ */
+std::map<std::string, std::string> parseQuery(const QByteArray& query)
+{
+    std::map<std::string, std::string> params;
+    for (const QByteArray& pair : query.split('&')) {
+        const int eq = pair.indexOf('=');
+        if (eq > 0) {
+            params[pair.left(eq).toStdString()] = pair.mid(eq + 1).toStdString();
+        }
+    }
+    return params;
+}
+
+/**
+ * @brief 解析以逗号分隔的三维坐标
+ * @param text 形如 "x,y,z" 的文本
+ * @param value 输出，坐标
+ * @return 解析成功返回true
+ */
+bool parseVector(const std::string& text, Vector3& value)
+{
+    std::istringstream stream(text);
+    char comma1 = 0, comma2 = 0;
+    stream >> value.x() >> comma1 >> value.y() >> comma2 >> value.z();
+    return !stream.fail() && comma1 == ',' && comma2 == ',' && value.allFinite();
+}
+
+/**
+ * @brief 航迹记录转为JSON
+ * @param record 航迹记录
+ * @return 与周期输出一致的航迹JSON
+ */
+json recordJson(const TrackRecord& record)
+{
+    json item;
+    item["id"] = record.id;
+    item["hits"] = record.hits;
+    item["model"] = record.model;
+    item["position"] = { {"x", record.position.x()}, {"y", record.position.y()}, {"z", record.position.z()} };
+    item["velocity"] = { {"x", record.velocity.x()}, {"y", record.velocity.y()}, {"z", record.velocity.z()} };
+    if (!record.extent.isZero()) {
+        item["extent"] = { {"x", record.extent.x()}, {"y", record.extent.y()}, {"z", record.extent.z()} };
+    }
+    return item;
+}
+
+} // namespace
+
 /**
  * @brief 构造函数
  * @param service 服务对象指针
  * @param parent 父对象指针
- * @details 初始化健康检查服务器，创建TCP服务器并设置信号槽连接
+ * @details 初始化健康检查服务器，创建TCP服务器、空闲检查定时器和路由表
  */
 HealthCheckServer::HealthCheckServer(Service* service, QObject *parent)
     : QObject(parent), m_service(service)
 {
     LOG_FUNCTION_BEGIN();
 
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_cacheTtlMs = std::max(0, settings.value("HealthCheck/cacheTtlMs", 1000).toInt());
+    m_idleTimeoutMs = std::max(1, settings.value("HealthCheck/idleTimeout", 30).toInt()) * 1000;
+
+    // 定时器和TCP服务器均为本对象的子对象，随本对象一起移入服务器线程
     m_server = new QTcpServer(this);
     connect(m_server, &QTcpServer::newConnection, this, &HealthCheckServer::onNewConnection);
 
+    m_idleTimer = new QTimer(this);
+    connect(m_idleTimer, &QTimer::timeout, this, &HealthCheckServer::onIdleCheck);
+
+    registerRoutes();
+
     LOG_INFO("健康检查服务器已创建");
     LOG_FUNCTION_END();
 }
@@ -72,7 +186,9 @@ bool HealthCheckServer::startListen(quint16 port)
     bool success = m_server->listen(QHostAddress::Any, port);
 
     if (success) {
-        LOG_INFO("成功在端口 " + QString::number(port) + " 上启动监听");
+        m_idleTimer->start(1000);
+        LOG_INFO("成功在端口 " + QString::number(port) + " 上启动监听，响应缓存有效期: " +
+                 QString::number(m_cacheTtlMs) + "毫秒");
     } else {
         LOG_ERROR("无法在端口 " + QString::number(port) + " 上启动监听: " + m_server->errorString());
     }
@@ -83,12 +199,23 @@ bool HealthCheckServer::startListen(quint16 port)
 
 /**
  * @brief 停止监听
- * @details 关闭HTTP服务
+ * @details 关闭HTTP服务并断开全部连接
  */
 void HealthCheckServer::stopListen()
 {
     LOG_FUNCTION_BEGIN();
 
+    m_idleTimer->stop();
+
+    // 断开连接可能同步触发onDisconnected修改连接表，先复制出socket列表
+    std::vector<QTcpSocket*> sockets;
+    for (const auto& pair : m_connections) {
+        sockets.push_back(pair.first);
+    }
+    for (QTcpSocket* socket : sockets) {
+        socket->disconnectFromHost();
+    }
+
     if (m_server) {
         m_server->close();
         LOG_INFO("服务器已停止监听");
@@ -146,8 +273,41 @@ std::string HealthCheckServer::getHealthStatus()
         LOG_ERROR("服务对象为空，无法获取健康状态");
     }
 
+    // 任一容量上限在最近一个周期触发了丢弃，说明服务正在卸载负载
+    json metrics = g_Metrics.snapshot();
+    json sheddingAt = json::array();
+    json sheddingPolicy = json::object();
+    if (metrics.contains("capacity")) {
+        for (const auto& item : metrics["capacity"].items()) {
+            if (item.value().value("shedLastCycle", 0) > 0) {
+                sheddingAt.push_back(item.key());
+                if (item.value().contains("policy")) {
+                    sheddingPolicy[item.key()] = item.value()["policy"];
+                }
+            }
+        }
+    }
+    const bool isShedding = !sheddingAt.empty();
+    if (isShedding) {
+        details["sheddingAt"] = sheddingAt;
+        if (!sheddingPolicy.empty()) {
+            details["sheddingPolicy"] = sheddingPolicy;
+        }
+        LOG_WARN("容量已达上限，正在丢弃: " + QString::fromStdString(sheddingAt.dump()));
+    }
+
+    // 负载调节器处于降级等级时同样视为降级运行
+    bool isThrottled = false;
+    if (metrics.contains("loadGovernor")) {
+        const json& governor = metrics["loadGovernor"];
+        status["loadLevel"] = governor.value("levelName", std::string("normal"));
+        isThrottled = governor.value("level", 0) > 0;
+    }
+
     status["healthy"] = isHealthy;
+    status["degraded"] = isShedding || isThrottled;
     status["details"] = details;
+    status["metrics"] = metrics;
 
     std::string result = status.dump();
     LOG_DEBUG("生成的健康状态报告: " + QString::fromStdString(result));
@@ -156,6 +316,177 @@ std::string HealthCheckServer::getHealthStatus()
     return result;
 }
 
+/**
+ * @brief 处理航迹查询
+ * @param path 请求路径
+ * @param query 查询串
+ * @param statusCode 输出，HTTP状态码
+ * @return 响应JSON字符串
+ */
+std::string HealthCheckServer::handleTrackQuery(const QByteArray& path, const QByteArray& query, int& statusCode)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    json response;
+    std::shared_ptr<const TrackSnapshot> snapshot = TrackSnapshotStore::instance().current();
+    if (!snapshot) {
+        statusCode = 503;
+        response["error"] = "no snapshot published yet";
+        return response.dump();
+    }
+
+    const std::map<std::string, std::string> params = parseQuery(query);
+    auto param = [&params](const char* name) {
+        auto it = params.find(name);
+        return it != params.end() ? it->second : std::string();
+    };
+
+    const std::vector<TrackRecord>& records = snapshot->records();
+    std::vector<int> indices;
+    bool ok = true;
+    if (path == "/tracks") {
+        indices.resize(records.size());
+        for (int i = 0; i < static_cast<int>(records.size()); ++i) {
+            indices[i] = i;
+        }
+    } else if (path == "/tracks/box") {
+        Vector3 minCorner, maxCorner;
+        ok = parseVector(param("min"), minCorner) && parseVector(param("max"), maxCorner);
+        if (ok) {
+            indices = snapshot->queryBox(minCorner, maxCorner);
+        }
+    } else if (path == "/tracks/radius") {
+        Vector3 center;
+        bool numeric = false;
+        const double radius = QByteArray::fromStdString(param("r")).toDouble(&numeric);
+        ok = parseVector(param("center"), center) && numeric && radius >= 0;
+        if (ok) {
+            indices = snapshot->queryRadius(center, radius);
+        }
+    } else if (path == "/tracks/nearest") {
+        Vector3 point;
+        bool numeric = false;
+        const int k = QByteArray::fromStdString(param("k")).toInt(&numeric);
+        ok = parseVector(param("point"), point) && numeric && k > 0;
+        if (ok) {
+            indices = snapshot->queryNearest(point, k);
+        }
+    } else {
+        // /tracks/<id>
+        bool numeric = false;
+        const int id = path.mid(static_cast<int>(std::strlen("/tracks/"))).toInt(&numeric);
+        const TrackRecord* record = numeric ? snapshot->findById(id) : nullptr;
+        if (!record) {
+            statusCode = numeric ? 404 : 400;
+            response["error"] = numeric ? "track not found" : "unknown query";
+            return response.dump();
+        }
+        indices.push_back(static_cast<int>(record - records.data()));
+    }
+
+    if (!ok) {
+        statusCode = 400;
+        response["error"] = "invalid query parameters";
+        return response.dump();
+    }
+
+    json tracks = json::array();
+    for (int index : indices) {
+        tracks.push_back(recordJson(records[index]));
+    }
+    response["sequence"] = snapshot->sequence();
+    response["timestamp"] = snapshot->timestamp();
+    response["frame"] = snapshot->frame();
+    response["count"] = indices.size();
+    response["tracks"] = tracks;
+    response["elapsedMicros"] = timer.nsecsElapsed() / 1000;
+    return response.dump();
+}
+
+/**
+ * @brief 注册路由
+ * @details 健康状态、指标和观测者统计与查询串无关，响应可缓存；航迹查询每次由最新快照回答
+ */
+void HealthCheckServer::registerRoutes()
+{
+    auto health = [this](const QByteArray&, const QByteArray&, int&) {
+        return getHealthStatus();
+    };
+    m_routes.push_back(Route{"/", false, true, health});
+    m_routes.push_back(Route{"/health", false, true, health});
+    m_routes.push_back(Route{"/metrics", false, true, [](const QByteArray&, const QByteArray&, int&) {
+        return g_Metrics.snapshot().dump();
+    }});
+    m_routes.push_back(Route{"/observers", false, true, [](const QByteArray&, const QByteArray&, int&) {
+        return g_Observers.snapshot().dump();
+    }});
+    m_routes.push_back(Route{"/tracks", true, false, [this](const QByteArray& path, const QByteArray& query, int& statusCode) {
+        return handleTrackQuery(path, query, statusCode);
+    }});
+}
+
+/**
+ * @brief 处理一个请求
+ * @param request 已解析的请求
+ * @return 完整的HTTP响应
+ */
+QByteArray HealthCheckServer::handleRequest(const Request& request)
+{
+    const bool head = request.method == "HEAD";
+    if (request.method != "GET" && !head) {
+        return buildResponse(405, errorBody("method not allowed"), request.keepAlive);
+    }
+
+    const Route* route = nullptr;
+    for (const Route& candidate : m_routes) {
+        if (candidate.prefix ? request.path.startsWith(candidate.path) : request.path == candidate.path) {
+            route = &candidate;
+            break;
+        }
+    }
+    if (!route) {
+        return buildResponse(404, errorBody("unknown path"), request.keepAlive, !head);
+    }
+
+    // 可缓存的路由与查询串无关，以路径为键，缓存条目数不超过路由数
+    const bool cacheable = route->cacheable && m_cacheTtlMs > 0;
+    const std::string key = request.path.toStdString();
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    if (cacheable) {
+        auto it = m_cache.find(key);
+        if (it != m_cache.end() && it->second.expiresMs > nowMs) {
+            return buildResponse(it->second.statusCode, it->second.body, request.keepAlive, !head);
+        }
+    }
+
+    int statusCode = 200;
+    const QByteArray body = QByteArray::fromStdString(route->handler(request.path, request.query, statusCode));
+    if (cacheable) {
+        m_cache[key] = CachedResponse{statusCode, body, nowMs + m_cacheTtlMs};
+    }
+    return buildResponse(statusCode, body, request.keepAlive, !head);
+}
+
+/**
+ * @brief 构造HTTP响应
+ * @param statusCode HTTP状态码
+ * @param body 响应体
+ * @param keepAlive 是否保持连接
+ * @param includeBody 为false时只发送响应头
+ * @return 完整的HTTP响应
+ */
+QByteArray HealthCheckServer::buildResponse(int statusCode, const QByteArray& body, bool keepAlive, bool includeBody)
+{
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(statusCode) + " " + reasonPhrase(statusCode) +
+            "\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(body.size()) +
+            (keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n");
+    if (includeBody) {
+        response += body;
+    }
+    return response;
+}
+
 /**
  * @brief 新连接处理槽函数
  * @details 处理新的TCP连接请求
@@ -164,15 +495,13 @@ void HealthCheckServer::onNewConnection()
 {
     LOG_FUNCTION_BEGIN();
 
-    QTcpSocket *socket = m_server->nextPendingConnection();
-    if (socket) {
-        LOG_INFO("接受来自 " + socket->peerAddress().toString() + ":" +
-                 QString::number(socket->peerPort()) + " 的新连接");
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        LOG_DEBUG("接受来自 " + socket->peerAddress().toString() + ":" +
+                  QString::number(socket->peerPort()) + " 的新连接");
 
+        m_connections[socket] = Connection{QByteArray(), QDateTime::currentMSecsSinceEpoch()};
         connect(socket, &QTcpSocket::readyRead, this, &HealthCheckServer::onReadyRead);
         connect(socket, &QTcpSocket::disconnected, this, &HealthCheckServer::onDisconnected);
-    } else {
-        LOG_WARN("无效的连接请求");
     }
 
     LOG_FUNCTION_END();
@@ -180,34 +509,93 @@ void HealthCheckServer::onNewConnection()
 
 /**
  * @brief 数据可读处理槽函数
- * @details 处理客户端发送的HTTP请求并返回健康状态
+ * @details 解析连接缓冲中的全部完整请求并按顺序写回响应
  */
 void HealthCheckServer::onReadyRead()
 {
-    LOG_FUNCTION_BEGIN();
-
     QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
-    if (socket) {
-        LOG_DEBUG("收到来自 " + socket->peerAddress().toString() + ":" +
-                  QString::number(socket->peerPort()) + " 的请求");
+    auto found = m_connections.find(socket);
+    if (!socket || found == m_connections.end()) {
+        LOG_ERROR("无效的socket对象");
+        return;
+    }
 
-        // 获取健康状态
-        std::string status_str = getHealthStatus();
-        QByteArray response_body = QByteArray::fromStdString(status_str);
+    Connection& connection = found->second;
+    connection.buffer += socket->readAll();
+    connection.lastActivityMs = QDateTime::currentMSecsSinceEpoch();
+
+    // 流水线请求依次处理，响应按请求顺序拼接后一次写回
+    QByteArray responses;
+    bool close = false;
+    while (!close) {
+        const int headerEnd = connection.buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) {
+            if (connection.buffer.size() > kMaxHeaderBytes) {
+                responses += buildResponse(431, errorBody("request header too large"), false);
+                close = true;
+            }
+            break;
+        }
 
-        // 构造HTTP响应
-        socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n");
-        socket->write(response_body);
+        // 请求行形如 "GET /observers HTTP/1.1"
+        const QList<QByteArray> lines = connection.buffer.left(headerEnd).split('\n');
+        const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+        if (requestLine.size() != 3 || !requestLine.at(2).startsWith("HTTP/1.")) {
+            responses += buildResponse(400, errorBody("malformed request line"), false);
+            close = true;
+            break;
+        }
 
-        LOG_INFO("已发送健康状态响应，大小: " + QString::number(response_body.size()) + " 字节");
+        // 头部字段只关心连接管理和请求体长度
+        QByteArray connectionHeader;
+        int contentLength = 0;
+        for (int i = 1; i < lines.size(); ++i) {
+            const int colon = lines.at(i).indexOf(':');
+            if (colon <= 0) {
+                continue;
+            }
+            const QByteArray name = lines.at(i).left(colon).trimmed().toLower();
+            if (name == "connection") {
+                connectionHeader = lines.at(i).mid(colon + 1).trimmed().toLower();
+            } else if (name == "content-length") {
+                contentLength = lines.at(i).mid(colon + 1).trimmed().toInt();
+            }
+        }
+        if (contentLength < 0 || contentLength > kMaxBodyBytes) {
+            responses += buildResponse(413, errorBody("request body too large"), false);
+            close = true;
+            break;
+        }
+        const int requestBytes = headerEnd + 4 + contentLength;
+        if (connection.buffer.size() < requestBytes) {
+            // 请求体尚未收全，等待后续数据
+            break;
+        }
 
-        // 发送完成后主动断开连接
-        socket->disconnectFromHost();
-    } else {
-        LOG_ERROR("无效的socket对象");
+        Request request;
+        request.method = requestLine.at(0);
+        const QByteArray& target = requestLine.at(1);
+        const int question = target.indexOf('?');
+        request.path = question >= 0 ? target.left(question) : target;
+        request.query = question >= 0 ? target.mid(question + 1) : QByteArray();
+        // HTTP/1.1 默认保持连接，HTTP/1.0 需显式要求
+        request.keepAlive = requestLine.at(2) == "HTTP/1.1" ? !connectionHeader.contains("close")
+                                                           : connectionHeader.contains("keep-alive");
+        connection.buffer.remove(0, requestBytes);
+
+        responses += handleRequest(request);
+        close = !request.keepAlive;
+        LOG_DEBUG("已处理 " + QString::fromLatin1(request.method) + " " + QString::fromLatin1(request.path));
     }
 
-    LOG_FUNCTION_END();
+    if (!responses.isEmpty()) {
+        socket->write(responses);
+    }
+    if (close) {
+        // 断开可能同步触发onDisconnected并移除连接状态，此后不再访问connection
+        connection.buffer.clear();
+        socket->disconnectFromHost();
+    }
 }
 
 /**
@@ -216,15 +604,31 @@ void HealthCheckServer::onReadyRead()
  */
 void HealthCheckServer::onDisconnected()
 {
-    LOG_FUNCTION_BEGIN();
-
     QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
     if (socket) {
-        LOG_INFO("连接已断开: " + socket->peerAddress().toString() + ":" +
-                 QString::number(socket->peerPort()));
+        LOG_DEBUG("连接已断开: " + socket->peerAddress().toString() + ":" +
+                  QString::number(socket->peerPort()));
 
+        m_connections.erase(socket);
         socket->deleteLater();
     }
+}
 
-    LOG_FUNCTION_END();
+/**
+ * @brief 空闲检查槽函数
+ * @details 关闭超过空闲超时没有收到数据的连接
+ */
+void HealthCheckServer::onIdleCheck()
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    std::vector<QTcpSocket*> idle;
+    for (const auto& pair : m_connections) {
+        if (nowMs - pair.second.lastActivityMs > m_idleTimeoutMs) {
+            idle.push_back(pair.first);
+        }
+    }
+    for (QTcpSocket* socket : idle) {
+        LOG_DEBUG("关闭空闲连接: " + socket->peerAddress().toString() + ":" + QString::number(socket->peerPort()));
+        socket->disconnectFromHost();
+    }
 }
@@ -1,7 +1,7 @@
 /**
  * @file HealthCheckServer.h
  * @brief 健康检查服务器头文件
- * @details 定义了HealthCheckServer类，提供HTTP接口监控服务健康状态
+ * @details 定义了HealthCheckServer类，以HTTP/1.1接口提供健康状态、指标和航迹查询
  * @author xubb
  * @date 20250711
  */
@@ -11,6 +11,13 @@
 
 #include <QObject>
 #include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QByteArray>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @brief Service类前向声明
@@ -20,7 +27,11 @@ class Service;
 
 /**
  * @brief 健康检查服务器类
- * @details 提供HTTP接口，允许外部系统检查服务的健康状态
+ * @details 提供HTTP接口，允许外部系统检查服务的健康状态。
+ *          运行在独立线程中，由Service创建后移入该线程，startListen()/stopListen()需在该线程中调用。
+ *          支持HTTP/1.1长连接和流水线请求: 每个连接缓存未处理完的字节，按顺序解析出全部完整请求后一次写回响应；
+ *          按路由表分发请求，健康状态、指标和观测者统计的响应在配置的有效期内缓存复用。
+ *          空闲超时的连接由定时器关闭
  */
 class HealthCheckServer : public QObject
 {
@@ -30,7 +41,7 @@ public:
      * @brief 构造函数
      * @param service 服务对象指针
      * @param parent 父对象指针
-     * @details 初始化健康检查服务器，需要Service指针以获取服务状态
+     * @details 初始化健康检查服务器，需要Service指针以获取服务状态；从配置文件 HealthCheck 分组读取缓存有效期和空闲超时
      */
     explicit HealthCheckServer(Service* service, QObject *parent = nullptr);
 
@@ -45,13 +56,13 @@ public:
      * @return 是否成功启动
      * @details 在指定端口上启动HTTP服务
      */
-    bool startListen(quint16 port);
+    Q_INVOKABLE bool startListen(quint16 port);
 
     /**
      * @brief 停止监听
-     * @details 关闭HTTP服务
+     * @details 关闭HTTP服务并断开全部连接
      */
-    void stopListen();
+    Q_INVOKABLE void stopListen();
 
 private slots:
     /**
@@ -62,7 +73,7 @@ private slots:
 
     /**
      * @brief 数据可读处理槽函数
-     * @details 处理客户端发送的HTTP请求
+     * @details 追加到连接缓冲后依次处理其中的完整请求，连接要求关闭时写回响应后断开
      */
     void onReadyRead();
 
@@ -72,7 +83,72 @@ private slots:
      */
     void onDisconnected();
 
+    /**
+     * @brief 空闲检查槽函数
+     * @details 关闭超过空闲超时没有收到数据的连接
+     */
+    void onIdleCheck();
+
 private:
+    /**
+     * @brief 已解析的请求
+     */
+    struct Request {
+        QByteArray method;      ///< 请求方法
+        QByteArray path;        ///< 路径
+        QByteArray query;       ///< 查询串，不含'?'
+        bool keepAlive;         ///< 响应后是否保持连接
+    };
+
+    /**
+     * @brief 路由
+     */
+    struct Route {
+        QByteArray path;        ///< 路径
+        bool prefix;            ///< 为true时匹配以 path 开头的全部路径
+        bool cacheable;         ///< 响应是否缓存
+        std::function<std::string(const QByteArray& path, const QByteArray& query, int& statusCode)> handler; ///< 处理函数
+    };
+
+    /**
+     * @brief 缓存的响应
+     */
+    struct CachedResponse {
+        int statusCode;         ///< HTTP状态码
+        QByteArray body;        ///< 响应体
+        qint64 expiresMs;       ///< 过期时间(毫秒)
+    };
+
+    /**
+     * @brief 连接状态
+     */
+    struct Connection {
+        QByteArray buffer;      ///< 尚未处理的请求字节
+        qint64 lastActivityMs;  ///< 最近收到数据的时间(毫秒)
+    };
+
+    /**
+     * @brief 注册路由
+     */
+    void registerRoutes();
+
+    /**
+     * @brief 处理一个请求
+     * @param request 已解析的请求
+     * @return 完整的HTTP响应
+     */
+    QByteArray handleRequest(const Request& request);
+
+    /**
+     * @brief 构造HTTP响应
+     * @param statusCode HTTP状态码
+     * @param body 响应体
+     * @param keepAlive 是否保持连接
+     * @param includeBody 为false时只发送响应头(HEAD请求)
+     * @return 完整的HTTP响应
+     */
+    static QByteArray buildResponse(int statusCode, const QByteArray& body, bool keepAlive, bool includeBody = true);
+
     /**
      * @brief 获取健康状态
      * @return 包含健康状态的JSON字符串
@@ -80,12 +156,53 @@ private:
      */
     std::string getHealthStatus();
 
+    /**
+     * @brief 处理航迹查询
+     * @param path 请求路径: /tracks、/tracks/<id>、/tracks/box、/tracks/radius 或 /tracks/nearest
+     * @param query 查询串: box 为 min=x,y,z&max=x,y,z，radius 为 center=x,y,z&r=半径，nearest 为 point=x,y,z&k=数量
+     * @param statusCode 输出，HTTP状态码
+     * @return 响应JSON字符串
+     * @details 由最近发布的航迹快照及其网格索引回答，不访问航迹管理器；
+     *          查询坐标和返回的航迹均为发布坐标系，响应的 frame 字段给出坐标系名称
+     */
+    std::string handleTrackQuery(const QByteArray& path, const QByteArray& query, int& statusCode);
+
 private:
     /**
      * @brief TCP服务器对象
      */
     QTcpServer* m_server;
 
+    /**
+     * @brief 空闲检查定时器
+     */
+    QTimer* m_idleTimer;
+
+    /**
+     * @brief 路由表，按注册顺序匹配
+     */
+    std::vector<Route> m_routes;
+
+    /**
+     * @brief 响应缓存，键为请求目标(路径和查询串)
+     */
+    std::unordered_map<std::string, CachedResponse> m_cache;
+
+    /**
+     * @brief 各连接的状态
+     */
+    std::unordered_map<QTcpSocket*, Connection> m_connections;
+
+    /**
+     * @brief 响应缓存有效期(毫秒)，为0时不缓存
+     */
+    int m_cacheTtlMs;
+
+    /**
+     * @brief 连接空闲超时(毫秒)
+     */
+    int m_idleTimeoutMs;
+
     /**
      * @brief 服务对象指针
      * @details 用于获取服务的状态信息
@@ -0,0 +1,154 @@
+/**
+ * @file LoadGovernor.cpp
+ * @brief 负载调节器实现文件
+ * @details 实现了周期耗时平滑、带回滞的降级等级调整和指标发布
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "LoadGovernor.h"
+#include "LogManager.h"
+#include "MetricsRegistry.h"
+#include <QSettings>
+#include <algorithm>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[LoadGovernor::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[LoadGovernor::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[LoadGovernor::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[LoadGovernor::" << __FUNCTION__ << "] " << msg
+
+
+LoadGovernor::LoadGovernor(int budgetMs)
+    : m_enabled(true),
+      m_budgetMs(budgetMs),
+      m_smoothing(0.3),
+      m_highWater(0.9),
+      m_lowWater(0.5),
+      m_escalateCycles(3),
+      m_recoverCycles(20),
+      m_maxLevel(CapBirths),
+      m_outputDecimation(4),
+      m_birthCap(10),
+      m_level(Normal),
+      m_smoothedMs(0.0),
+      m_lastMs(0.0),
+      m_overCount(0),
+      m_underCount(0),
+      m_outputCounter(0),
+      m_escalations(0),
+      m_recoveries(0),
+      m_overruns(0)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_enabled = settings.value("LoadGovernor/enabled", true).toBool();
+    m_smoothing = settings.value("LoadGovernor/smoothing", 0.3).toDouble();
+    m_highWater = settings.value("LoadGovernor/highWater", 0.9).toDouble();
+    m_lowWater = settings.value("LoadGovernor/lowWater", 0.5).toDouble();
+    m_escalateCycles = settings.value("LoadGovernor/escalateCycles", 3).toInt();
+    m_recoverCycles = settings.value("LoadGovernor/recoverCycles", 20).toInt();
+    m_maxLevel = settings.value("LoadGovernor/maxLevel", static_cast<int>(CapBirths)).toInt();
+    m_outputDecimation = settings.value("LoadGovernor/outputDecimation", 4).toInt();
+    m_birthCap = settings.value("LoadGovernor/birthCap", 10).toInt();
+
+    m_budgetMs = std::max(1.0, m_budgetMs);
+    m_maxLevel = std::max(static_cast<int>(Normal), std::min(m_maxLevel, static_cast<int>(CapBirths)));
+    m_outputDecimation = std::max(1, m_outputDecimation);
+    m_birthCap = std::max(0, m_birthCap);
+
+    LOG_INFO("负载调节" + QString(m_enabled ? "已启用" : "已禁用") + "，周期预算: " +
+             QString::number(m_budgetMs) + "毫秒，高/低水位: " + QString::number(m_highWater) +
+             "/" + QString::number(m_lowWater) + "，最高等级: " + QString::number(m_maxLevel));
+}
+
+
+void LoadGovernor::recordCycle(double elapsedMs)
+{
+    m_lastMs = elapsedMs;
+    m_smoothedMs = (m_smoothedMs == 0.0) ? elapsedMs
+                                         : m_smoothing * elapsedMs + (1.0 - m_smoothing) * m_smoothedMs;
+    if (elapsedMs > m_budgetMs) {
+        m_overruns++;
+    }
+
+    if (!m_enabled) {
+        return;
+    }
+
+    if (m_smoothedMs > m_highWater * m_budgetMs) {
+        m_underCount = 0;
+        if (++m_overCount >= m_escalateCycles && m_level < m_maxLevel) {
+            m_level = static_cast<Level>(m_level + 1);
+            m_overCount = 0;
+            m_escalations++;
+            LOG_WARN("周期耗时 " + QString::number(m_smoothedMs, 'f', 1) + "毫秒超过预算 " +
+                     QString::number(m_budgetMs) + "毫秒，降级等级升至 " + QString::number(m_level) +
+                     " (" + levelName(m_level) + ")");
+        }
+    } else if (m_smoothedMs < m_lowWater * m_budgetMs) {
+        m_overCount = 0;
+        if (++m_underCount >= m_recoverCycles && m_level > Normal) {
+            m_level = static_cast<Level>(m_level - 1);
+            m_underCount = 0;
+            m_recoveries++;
+            LOG_INFO("周期耗时 " + QString::number(m_smoothedMs, 'f', 1) + "毫秒，负载恢复，降级等级降至 " +
+                     QString::number(m_level) + " (" + levelName(m_level) + ")");
+        }
+    } else {
+        // 处于高低水位之间时保持当前等级
+        m_overCount = 0;
+        m_underCount = 0;
+    }
+}
+
+
+LoadGovernor::Level LoadGovernor::level() const
+{
+    return m_level;
+}
+
+
+bool LoadGovernor::shouldOutput()
+{
+    if (m_level < ReduceOutputRate) {
+        m_outputCounter = 0;
+        return true;
+    }
+    const bool output = (m_outputCounter == 0);
+    m_outputCounter = (m_outputCounter + 1) % m_outputDecimation;
+    return output;
+}
+
+
+int LoadGovernor::birthCap() const
+{
+    return m_birthCap;
+}
+
+
+void LoadGovernor::publishMetrics() const
+{
+    nlohmann::json metrics;
+    metrics["level"] = static_cast<int>(m_level);
+    metrics["levelName"] = levelName(m_level);
+    metrics["budgetMs"] = m_budgetMs;
+    metrics["lastCycleMs"] = m_lastMs;
+    metrics["smoothedCycleMs"] = m_smoothedMs;
+    metrics["overruns"] = m_overruns;
+    metrics["escalations"] = m_escalations;
+    metrics["recoveries"] = m_recoveries;
+    g_Metrics.setSection("loadGovernor", metrics);
+}
+
+
+const char* LoadGovernor::levelName(Level level)
+{
+    switch (level) {
+    case Normal: return "normal";
+    case SkipTrajectories: return "skipTrajectories";
+    case ReduceOutputRate: return "reduceOutputRate";
+    case CheapInitiation: return "cheapInitiation";
+    case CapBirths: return "capBirths";
+    }
+    return "unknown";
+}
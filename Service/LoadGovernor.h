@@ -0,0 +1,180 @@
+/**
+ * @file LoadGovernor.h
+ * @brief 负载调节器头文件
+ * @details 定义了LoadGovernor类，按工作周期耗时相对周期预算的比例逐级启用降级措施
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef LOADGOVERNOR_H
+#define LOADGOVERNOR_H
+
+/**
+ * @brief 负载调节器类
+ * @details 以指数平滑的周期耗时与周期预算(workerInterval)比较:
+ *          连续若干周期超过高水位时升高一级降级等级，连续若干周期低于低水位时降低一级。
+ *          高低水位之间的区间和不对称的确认周期数构成回滞，避免等级来回抖动。
+ *          各等级的措施逐级叠加:
+ *          1. 不再计算未来轨迹;
+ *          2. 降低输出频率，并不再打印完整输出日志;
+ *          3. 新航迹以低开销的匀速模型起始;
+ *          4. 限制每周期创建的新航迹数
+ */
+class LoadGovernor
+{
+public:
+    /**
+     * @brief 降级等级
+     */
+    enum Level {
+        Normal = 0,              ///< 正常
+        SkipTrajectories = 1,    ///< 跳过未来轨迹预测
+        ReduceOutputRate = 2,    ///< 降低输出频率
+        CheapInitiation = 3,     ///< 新航迹使用低开销滤波器
+        CapBirths = 4            ///< 限制新航迹数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param budgetMs 周期预算(毫秒)，即工作周期间隔
+     * @details 从配置文件 LoadGovernor 分组读取水位、确认周期数等参数
+     */
+    explicit LoadGovernor(int budgetMs);
+
+    /**
+     * @brief 记录一个周期的耗时并调整降级等级
+     * @param elapsedMs 本周期处理耗时(毫秒)
+     */
+    void recordCycle(double elapsedMs);
+
+    /**
+     * @brief 获取当前降级等级
+     * @return 降级等级
+     */
+    Level level() const;
+
+    /**
+     * @brief 本周期是否输出航迹
+     * @return 未降低输出频率时总是返回true，否则每 outputDecimation 个周期返回一次true
+     */
+    bool shouldOutput();
+
+    /**
+     * @brief 获取限制新航迹时每周期允许的新航迹数
+     * @return 每周期新航迹上限
+     */
+    int birthCap() const;
+
+    /**
+     * @brief 发布负载调节指标
+     * @details 当前等级、平滑耗时、预算及累计升降级次数发布到 "loadGovernor" 分区
+     */
+    void publishMetrics() const;
+
+    /**
+     * @brief 获取降级等级名称
+     * @param level 降级等级
+     * @return 等级名称
+     */
+    static const char* levelName(Level level);
+
+private:
+    /**
+     * @brief 是否启用负载调节
+     */
+    bool m_enabled;
+
+    /**
+     * @brief 周期预算(毫秒)
+     */
+    double m_budgetMs;
+
+    /**
+     * @brief 周期耗时指数平滑系数
+     */
+    double m_smoothing;
+
+    /**
+     * @brief 高水位(预算比例)
+     * @details 平滑耗时超过 预算 x 高水位 视为过载
+     */
+    double m_highWater;
+
+    /**
+     * @brief 低水位(预算比例)
+     * @details 平滑耗时低于 预算 x 低水位 视为有余量
+     */
+    double m_lowWater;
+
+    /**
+     * @brief 升级前需连续过载的周期数
+     */
+    int m_escalateCycles;
+
+    /**
+     * @brief 降级前需连续有余量的周期数
+     */
+    int m_recoverCycles;
+
+    /**
+     * @brief 允许的最高降级等级
+     */
+    int m_maxLevel;
+
+    /**
+     * @brief 降低输出频率时的输出间隔(周期数)
+     */
+    int m_outputDecimation;
+
+    /**
+     * @brief 限制新航迹时每周期的新航迹上限
+     */
+    int m_birthCap;
+
+    /**
+     * @brief 当前降级等级
+     */
+    Level m_level;
+
+    /**
+     * @brief 平滑后的周期耗时(毫秒)
+     */
+    double m_smoothedMs;
+
+    /**
+     * @brief 最近一个周期的耗时(毫秒)
+     */
+    double m_lastMs;
+
+    /**
+     * @brief 连续过载的周期数
+     */
+    int m_overCount;
+
+    /**
+     * @brief 连续有余量的周期数
+     */
+    int m_underCount;
+
+    /**
+     * @brief 输出间隔计数器
+     */
+    int m_outputCounter;
+
+    /**
+     * @brief 累计升级次数
+     */
+    long long m_escalations;
+
+    /**
+     * @brief 累计降级次数
+     */
+    long long m_recoveries;
+
+    /**
+     * @brief 累计超出预算的周期数
+     */
+    long long m_overruns;
+};
+
+#endif // LOADGOVERNOR_H
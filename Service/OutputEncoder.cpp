@@ -0,0 +1,480 @@
+/**
+ * @file OutputEncoder.cpp
+ * @brief 航迹输出编码实现文件
+ * @details 实现了输出配置的读取、按配置的字段投影和每周期一次的共享编码
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "OutputEncoder.h"
+#include "GeodeticFrame.h"
+#include "LogManager.h"
+#include "MetricsRegistry.h"
+#include <QSettings>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[OutputEncoder::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[OutputEncoder::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[OutputEncoder::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[OutputEncoder::" << __FUNCTION__ << "] " << msg
+
+using json = nlohmann::json;
+
+namespace {
+
+/**
+ * @brief 配置文件中输出配置分组名的前缀
+ */
+const QString kGroupPrefix = "OutputProfile_";
+
+/**
+ * @brief 字段名称，顺序与 OutputProfile::Field 的位一致
+ */
+const char* const kFieldNames[] = {"hits", "model", "position", "velocity", "acceleration",
+                                   "extent", "covariance", "future_trajectory"};
+
+/**
+ * @brief 字段数
+ */
+const int kFieldCount = sizeof(kFieldNames) / sizeof(kFieldNames[0]);
+
+/**
+ * @brief 临时输出配置名称的前缀，配置文件的分组名不会以此开头
+ */
+const std::string kSubscriptionPrefix = "~";
+
+/**
+ * @brief 同一(时长, 步长)下全部确认航迹的未来轨迹
+ */
+struct FutureSet {
+    std::vector<Eigen::Index> offsets;  ///< 第i条航迹的轨迹点为 points 的第 offsets[i] 到 offsets[i+1]-1 列
+    Eigen::Matrix3Xd points;            ///< 输出坐标系下的轨迹点
+};
+
+} // namespace
+
+
+bool OutputProfile::contains(const Vector3& position) const
+{
+    if (region == Region::Box) {
+        return (position.array() >= minCorner.array()).all() && (position.array() <= maxCorner.array()).all();
+    }
+    if (region == Region::Sphere) {
+        return (position - center).squaredNorm() <= radius * radius;
+    }
+    return true;
+}
+
+
+double OutputProfile::round(double value) const
+{
+    if (precision < 0) {
+        return value;
+    }
+    const double scale = std::pow(10.0, precision);
+    return std::round(value * scale) / scale;
+}
+
+
+std::string OutputProfile::key() const
+{
+    std::ostringstream stream;
+    stream.precision(17);
+    stream << fields << ':' << precision << ':' << horizon << ',' << step << ':' << static_cast<int>(region);
+    if (region == Region::Box) {
+        stream << ':' << minCorner.x() << ',' << minCorner.y() << ',' << minCorner.z()
+               << ':' << maxCorner.x() << ',' << maxCorner.y() << ',' << maxCorner.z();
+    } else if (region == Region::Sphere) {
+        stream << ':' << center.x() << ',' << center.y() << ',' << center.z() << ':' << radius;
+    }
+    return stream.str();
+}
+
+
+unsigned OutputProfile::fieldFromName(const std::string& name)
+{
+    for (int i = 0; i < kFieldCount; ++i) {
+        if (name == kFieldNames[i]) {
+            return 1u << i;
+        }
+    }
+    return 0;
+}
+
+
+std::vector<std::string> OutputProfile::fieldNames(unsigned fields)
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < kFieldCount; ++i) {
+        if (fields & (1u << i)) {
+            names.push_back(kFieldNames[i]);
+        }
+    }
+    return names;
+}
+
+
+OutputEncoder& OutputEncoder::instance()
+{
+    static OutputEncoder instance;
+    return instance;
+}
+
+
+OutputEncoder::OutputEncoder()
+{
+    loadProfiles();
+}
+
+
+void OutputEncoder::loadProfiles()
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+
+    // default 始终存在，未配置时与原有的DDS输出一致
+    m_profiles.push_back(OutputProfile());
+
+    for (const QString& group : settings.childGroups()) {
+        if (!group.startsWith(kGroupPrefix)) {
+            continue;
+        }
+        const std::string name = group.mid(kGroupPrefix.size()).toStdString();
+        if (name.empty()) {
+            LOG_WARN("输出配置组名缺少名称: " + group);
+            continue;
+        }
+
+        settings.beginGroup(group);
+        OutputProfile profile;
+        profile.name = name;
+
+        // fields 以逗号分隔，未配置时使用默认字段
+        if (settings.contains("fields")) {
+            profile.fields = 0;
+            for (const QString& field : settings.value("fields").toStringList()) {
+                const unsigned bit = OutputProfile::fieldFromName(field.trimmed().toStdString());
+                if (bit == 0) {
+                    LOG_WARN("输出配置 " + group + " 中未知的字段: " + field);
+                    continue;
+                }
+                profile.fields |= bit;
+            }
+        }
+
+        profile.precision = settings.value("precision", -1).toInt();
+        const double rate = settings.value("maxRate", 0.0).toDouble();
+        profile.minIntervalMs = rate > 0 ? static_cast<int>(1000.0 / rate) : 0;
+        profile.horizon = std::max(0.0, settings.value("horizon", 2.0).toDouble());
+        profile.step = settings.value("step", 0.5).toDouble();
+        if (profile.step <= 0) {
+            LOG_WARN("输出配置 " + group + " 的未来轨迹步长无效，使用0.5秒");
+            profile.step = 0.5;
+        }
+
+        const QString region = settings.value("region", "none").toString();
+        if (region == "box") {
+            profile.region = OutputProfile::Region::Box;
+            profile.minCorner = Vector3(settings.value("minX", 0.0).toDouble(),
+                                        settings.value("minY", 0.0).toDouble(),
+                                        settings.value("minZ", 0.0).toDouble());
+            profile.maxCorner = Vector3(settings.value("maxX", 0.0).toDouble(),
+                                        settings.value("maxY", 0.0).toDouble(),
+                                        settings.value("maxZ", 0.0).toDouble());
+        } else if (region == "sphere") {
+            profile.region = OutputProfile::Region::Sphere;
+            profile.center = Vector3(settings.value("centerX", 0.0).toDouble(),
+                                     settings.value("centerY", 0.0).toDouble(),
+                                     settings.value("centerZ", 0.0).toDouble());
+            profile.radius = std::max(0.0, settings.value("radius", 0.0).toDouble());
+        } else if (region != "none") {
+            LOG_WARN("输出配置 " + group + " 中未知的区域: " + region + "，不做区域过滤");
+        }
+        settings.endGroup();
+
+        if (name == "default") {
+            m_profiles[0] = profile;
+        } else {
+            m_profiles.push_back(profile);
+        }
+    }
+
+    for (int i = 0; i < static_cast<int>(m_profiles.size()); ++i) {
+        m_index[m_profiles[i].name] = i;
+    }
+    m_latest.resize(m_profiles.size());
+    m_lastEncodedMs.assign(m_profiles.size(), 0);
+
+    m_ddsProfile = settings.value("Output/ddsProfile", "default").toString().toStdString();
+    if (!hasProfile(m_ddsProfile)) {
+        LOG_WARN("DDS输出配置 " + QString::fromStdString(m_ddsProfile) + " 不存在，使用 default");
+        m_ddsProfile = "default";
+    }
+    LOG_INFO("已加载输出配置数: " + QString::number(m_profiles.size()) +
+             "，DDS输出配置: " + QString::fromStdString(m_ddsProfile));
+}
+
+
+bool OutputEncoder::hasProfile(const std::string& profile) const
+{
+    return m_index.find(profile) != m_index.end();
+}
+
+
+const std::string& OutputEncoder::ddsProfile() const
+{
+    return m_ddsProfile;
+}
+
+
+std::string OutputEncoder::acquireProfile(const OutputProfile& profile)
+{
+    const std::string name = kSubscriptionPrefix + profile.key();
+    QMutexLocker locker(&m_subscriptionMutex);
+    Subscription& subscription = m_subscriptions[name];
+    if (subscription.references == 0) {
+        subscription.profile = profile;
+        subscription.profile.name = name;
+        subscription.profile.minIntervalMs = 0;
+    }
+    subscription.references++;
+    return name;
+}
+
+
+void OutputEncoder::releaseProfile(const std::string& profile)
+{
+    QMutexLocker locker(&m_subscriptionMutex);
+    auto it = m_subscriptions.find(profile);
+    if (it != m_subscriptions.end() && --it->second.references <= 0) {
+        m_subscriptions.erase(it);
+    }
+}
+
+
+std::shared_ptr<const EncodedOutput> OutputEncoder::latest(const std::string& profile) const
+{
+    auto it = m_index.find(profile);
+    if (it != m_index.end()) {
+        return std::atomic_load(&m_latest[it->second]);
+    }
+    QMutexLocker locker(&m_subscriptionMutex);
+    auto subscription = m_subscriptions.find(profile);
+    return subscription != m_subscriptions.end() ? subscription->second.latest : nullptr;
+}
+
+
+void OutputEncoder::encode(const std::vector<TrackPtr>& confirmed, bool withTrajectories, long long sequence)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const long long nowMs = QDateTime::currentMSecsSinceEpoch();
+
+    // 1. 选出本周期到期的配置，并求所需字段的并集。推送订阅的临时配置每个输出周期都编码，
+    //    复制一份后释放锁，编码期间订阅可以照常注册和释放
+    std::vector<const OutputProfile*> due;
+    unsigned wanted = 0;
+    for (int p = 0; p < static_cast<int>(m_profiles.size()); ++p) {
+        const OutputProfile& profile = m_profiles[p];
+        if (profile.minIntervalMs > 0 && nowMs - m_lastEncodedMs[p] < profile.minIntervalMs) {
+            continue;
+        }
+        due.push_back(&profile);
+        wanted |= profile.fields;
+    }
+    std::vector<OutputProfile> subscriptions;
+    {
+        QMutexLocker locker(&m_subscriptionMutex);
+        subscriptions.reserve(m_subscriptions.size());
+        for (const auto& pair : m_subscriptions) {
+            subscriptions.push_back(pair.second.profile);
+            wanted |= pair.second.profile.fields;
+        }
+    }
+    const size_t fileProfiles = due.size();
+    for (const OutputProfile& profile : subscriptions) {
+        due.push_back(&profile);
+    }
+    if (due.empty()) {
+        return;
+    }
+
+    // 2. 位置、速度和加速度按列收集一次，批量转换到输出坐标系
+    GeodeticFrame& frame = GeodeticFrame::instance();
+    const Eigen::Index count = static_cast<Eigen::Index>(confirmed.size());
+    Eigen::Matrix3Xd local(3, count);
+    Eigen::Matrix3Xd velocities(3, count);
+    Eigen::Matrix3Xd accelerations(3, count);
+    for (Eigen::Index i = 0; i < count; ++i) {
+        const StateVector& state = confirmed[i]->getState();
+        local.col(i) = state.head<3>();
+        velocities.col(i) = state.segment<3>(3);
+        accelerations.col(i) = state.size() >= 9 ? Vector3(state.segment<3>(6)) : Vector3::Zero();
+    }
+    // 区域过滤和协方差使用发布坐标系，与航迹快照的查询一致，不随跟踪原点移动
+    Eigen::Matrix3d rotation;
+    Vector3 translation;
+    const bool transform = frame.publishTransform(rotation, translation);
+    Eigen::Matrix3Xd published = local;
+    if (transform) {
+        published = (rotation * local).colwise() + translation;
+    }
+    Eigen::Matrix3Xd positions = local;
+    frame.toOutputFrame(positions, &velocities);
+    if (wanted & OutputProfile::Acceleration) {
+        // 加速度与速度按同样的方式旋转，位置副本仅用于确定各点的旋转
+        Eigen::Matrix3Xd anchors = local;
+        frame.toOutputFrame(anchors, &accelerations);
+    }
+
+    // 3. 未来轨迹按不同的(时长, 步长)各计算一次
+    std::map<std::pair<double, double>, FutureSet> futures;
+    if (withTrajectories) {
+        for (const OutputProfile* candidate : due) {
+            const OutputProfile& profile = *candidate;
+            const auto key = std::make_pair(profile.horizon, profile.step);
+            if (!(profile.fields & OutputProfile::FutureTrajectory) || futures.count(key)) {
+                continue;
+            }
+            FutureSet& set = futures[key];
+            std::vector<std::vector<Vector3>> paths;
+            paths.reserve(confirmed.size());
+            set.offsets.assign(1, 0);
+            for (const auto& track : confirmed) {
+                paths.push_back(track->predictFutureTrajectory(profile.horizon, profile.step));
+                set.offsets.push_back(set.offsets.back() + static_cast<Eigen::Index>(paths.back().size()));
+            }
+            set.points.resize(3, set.offsets.back());
+            Eigen::Index column = 0;
+            for (const auto& path : paths) {
+                for (const auto& point : path) {
+                    set.points.col(column++) = point;
+                }
+            }
+            frame.toOutputFrame(set.points, nullptr);
+        }
+    }
+
+    // 4. 每个到期配置编码一次，结果供DDS输出和推送服务共用
+    const bool geodetic = frame.outputFrame() == GeodeticFrame::OutputFrame::Geodetic;
+    const std::string timestamp = QDateTime::currentDateTimeUtc().toString(Qt::ISODate).toStdString();
+    json metrics;
+    for (size_t d = 0; d < due.size(); ++d) {
+        const OutputProfile& profile = *due[d];
+        auto positionJson = [geodetic, &profile](const Vector3& v) {
+            return geodetic ? json{ {"latitude", profile.round(v.x())}, {"longitude", profile.round(v.y())},
+                                    {"altitude", profile.round(v.z())} }
+                            : json{ {"x", profile.round(v.x())}, {"y", profile.round(v.y())}, {"z", profile.round(v.z())} };
+        };
+        auto velocityJson = [geodetic, &profile](const Vector3& v) {
+            return geodetic ? json{ {"east", profile.round(v.x())}, {"north", profile.round(v.y())},
+                                    {"up", profile.round(v.z())} }
+                            : json{ {"x", profile.round(v.x())}, {"y", profile.round(v.y())}, {"z", profile.round(v.z())} };
+        };
+        const FutureSet* future = nullptr;
+        if (profile.fields & OutputProfile::FutureTrajectory) {
+            auto it = futures.find(std::make_pair(profile.horizon, profile.step));
+            future = it != futures.end() ? &it->second : nullptr;
+        }
+
+        json tracks = json::array();
+        for (Eigen::Index i = 0; i < count; ++i) {
+            if (!profile.contains(published.col(i))) {
+                continue;
+            }
+            const TrackPtr& track = confirmed[i];
+            json item;
+            item["id"] = track->getId();
+            if (profile.fields & OutputProfile::Hits) {
+                item["hits"] = track->getHits();
+            }
+            if (profile.fields & OutputProfile::Model) {
+                item["model"] = track->getModelName();
+            }
+            if (profile.fields & OutputProfile::Position) {
+                item["position"] = positionJson(positions.col(i));
+            }
+            if (profile.fields & OutputProfile::Velocity) {
+                item["velocity"] = velocityJson(velocities.col(i));
+            }
+            if ((profile.fields & OutputProfile::Acceleration) && track->getState().size() >= 9) {
+                item["acceleration"] = velocityJson(accelerations.col(i));
+            }
+            const Vector3& extent = track->getExtent();
+            if ((profile.fields & OutputProfile::Extent) && !extent.isZero()) {
+                item["extent"] = { {"x", profile.round(extent.x())}, {"y", profile.round(extent.y())},
+                                   {"z", profile.round(extent.z())} };
+            }
+            if (profile.fields & OutputProfile::Covariance) {
+                // 发布坐标系下的协方差，状态按 [p, v, a] 的3维块旋转，按滤波状态维数以行优先展开
+                StateMatrix P = track->getCovariance();
+                if (transform) {
+                    const int n = static_cast<int>(P.rows());
+                    StateMatrix T = StateMatrix::Identity(n, n);
+                    for (int k = 0; k + 3 <= n; k += 3) {
+                        T.block<3, 3>(k, k) = rotation;
+                    }
+                    P = T * P * T.transpose();
+                }
+                std::vector<double> covariance;
+                covariance.reserve(P.size());
+                for (Eigen::Index r = 0; r < P.rows(); ++r) {
+                    for (Eigen::Index c = 0; c < P.cols(); ++c) {
+                        covariance.push_back(profile.round(P(r, c)));
+                    }
+                }
+                item["covariance"] = covariance;
+            }
+            if (future) {
+                json path = json::array();
+                for (Eigen::Index k = future->offsets[i]; k < future->offsets[i + 1]; ++k) {
+                    path.push_back(positionJson(future->points.col(k)));
+                }
+                item["future_trajectory"] = path;
+            }
+            tracks.push_back(item);
+        }
+
+        json output;
+        output["sequence"] = sequence;
+        output["timestamp"] = timestamp;
+        output["frame"] = frame.outputFrameName();
+        const int trackCount = static_cast<int>(tracks.size());
+        output["tracks"] = std::move(tracks);
+
+        auto encoded = std::make_shared<EncodedOutput>();
+        encoded->profile = profile.name;
+        encoded->sequence = sequence;
+        encoded->trackCount = trackCount;
+        try {
+            encoded->json = output.dump();
+        } catch (const json::exception& e) {
+            LOG_ERROR("序列化输出配置 " + QString::fromStdString(profile.name) + " 失败: " + e.what());
+            continue;
+        }
+        if (d >= fileProfiles) {
+            QMutexLocker locker(&m_subscriptionMutex);
+            auto it = m_subscriptions.find(profile.name);
+            if (it != m_subscriptions.end()) {
+                it->second.latest = std::move(encoded);
+            }
+            continue;
+        }
+        const int p = static_cast<int>(&profile - m_profiles.data());
+        metrics["profiles"][profile.name] = { {"bytes", encoded->json.size()}, {"tracks", trackCount} };
+        std::atomic_store(&m_latest[p], std::shared_ptr<const EncodedOutput>(std::move(encoded)));
+        m_lastEncodedMs[p] = nowMs;
+    }
+
+    metrics["encodedLastCycle"] = due.size();
+    metrics["subscriptionProfiles"] = subscriptions.size();
+    metrics["trajectorySets"] = futures.size();
+    metrics["encodeMicros"] = timer.nsecsElapsed() / 1000;
+    g_Metrics.setSection("output", metrics);
+}
@@ -0,0 +1,235 @@
+/**
+ * @file OutputEncoder.h
+ * @brief 航迹输出编码头文件
+ * @details 定义了OutputProfile、EncodedOutput结构和OutputEncoder类，按命名的输出配置编码每个周期的航迹输出
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef OUTPUTENCODER_H
+#define OUTPUTENCODER_H
+
+#include "Track.h"
+#include <QMutex>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 命名的输出配置
+ * @details 决定一份航迹输出包含哪些字段、数值精度、输出速率、未来轨迹时长和区域过滤。
+ *          默认值与原有的DDS输出一致: 命中次数、位置、速度、外形尺寸和2秒内每0.5秒一点的未来轨迹
+ */
+struct OutputProfile {
+    /**
+     * @brief 可输出的航迹字段，航迹ID始终输出
+     */
+    enum Field {
+        Hits = 1 << 0,
+        Model = 1 << 1,
+        Position = 1 << 2,
+        Velocity = 1 << 3,
+        Acceleration = 1 << 4,
+        Extent = 1 << 5,
+        Covariance = 1 << 6,
+        FutureTrajectory = 1 << 7
+    };
+
+    /**
+     * @brief 区域过滤方式
+     */
+    enum class Region {
+        None,       ///< 不过滤
+        Box,        ///< 轴对齐长方体
+        Sphere      ///< 球
+    };
+
+    std::string name = "default";                       ///< 配置名称
+    unsigned fields = Hits | Position | Velocity | Extent | FutureTrajectory; ///< 输出字段位掩码
+    int precision = -1;                                 ///< 数值保留的小数位数，负数为不舍入
+    int minIntervalMs = 0;                              ///< 两次编码的最小间隔(毫秒)，0为每个输出周期编码
+    double horizon = 2.0;                               ///< 未来轨迹时长(秒)
+    double step = 0.5;                                  ///< 未来轨迹步长(秒)
+    Region region = Region::None;                       ///< 区域过滤方式，坐标为发布坐标系
+    Vector3 minCorner = Vector3::Zero();                ///< 长方体最小角
+    Vector3 maxCorner = Vector3::Zero();                ///< 长方体最大角
+    Vector3 center = Vector3::Zero();                   ///< 球心
+    double radius = 0.0;                                ///< 球半径(米)
+
+    /**
+     * @brief 判断位置是否在过滤区域内
+     * @param position 发布坐标系位置
+     * @return 不过滤或位于区域内(含边界)时返回true
+     */
+    bool contains(const Vector3& position) const;
+
+    /**
+     * @brief 按精度舍入
+     * @param value 数值
+     * @return 舍入后的数值
+     */
+    double round(double value) const;
+
+    /**
+     * @brief 输出内容的键
+     * @return 字段、精度、未来轨迹和区域相同的配置键相同，与名称和速率无关
+     */
+    std::string key() const;
+
+    /**
+     * @brief 按名称查找字段
+     * @param name 字段名称，如 "position"、"future_trajectory"
+     * @return 字段位，未知名称返回0
+     */
+    static unsigned fieldFromName(const std::string& name);
+
+    /**
+     * @brief 字段位掩码转为名称列表
+     * @param fields 字段位掩码
+     * @return 字段名称，按字段位顺序
+     */
+    static std::vector<std::string> fieldNames(unsigned fields);
+};
+
+/**
+ * @brief 一份已编码的输出
+ */
+struct EncodedOutput {
+    std::string profile;        ///< 输出配置名称
+    long long sequence = 0;     ///< 对应的快照序号
+    int trackCount = 0;         ///< 航迹数
+    std::string json;           ///< JSON文本
+};
+
+/**
+ * @brief 航迹输出编码类
+ * @details 输出配置在构造时从配置文件读取，之后不变；推送服务的字段/区域订阅以acquireProfile()
+ *          注册临时配置，与配置文件中的配置走同一条编码路径。工作线程每个输出周期调用一次encode():
+ *          先按到期配置所需字段的并集收集一次航迹数据并批量转换到输出坐标系，
+ *          未来轨迹按不同的(时长, 步长)各计算一次，再为每个到期配置编码一次，
+ *          结果以原子操作发布，DDS输出和推送服务中订阅同一配置的全部客户端共用这一份编码。
+ *          使用单例模式，encode()只在工作线程中调用，latest()可在任意线程调用
+ */
+class OutputEncoder
+{
+public:
+    /**
+     * @brief 获取输出编码单例实例
+     * @return 输出编码实例的引用
+     */
+    static OutputEncoder& instance();
+
+    /**
+     * @brief 编码本周期到期的全部输出配置
+     * @param confirmed 确认航迹
+     * @param withTrajectories 是否输出未来轨迹，过载降级时为false
+     * @param sequence 本周期的快照序号
+     */
+    void encode(const std::vector<TrackPtr>& confirmed, bool withTrajectories, long long sequence);
+
+    /**
+     * @brief 获取输出配置最近一次的编码
+     * @param profile 配置名称
+     * @return 编码结果，配置不存在或尚未编码时为空
+     */
+    std::shared_ptr<const EncodedOutput> latest(const std::string& profile) const;
+
+    /**
+     * @brief 判断配置文件中的输出配置是否存在
+     * @param profile 配置名称
+     * @return 存在返回true
+     */
+    bool hasProfile(const std::string& profile) const;
+
+    /**
+     * @brief 注册推送订阅使用的临时输出配置
+     * @param profile 输出配置，名称和速率不使用
+     * @return 临时配置名称，内容相同的订阅共用同一个临时配置和同一份编码
+     * @details 从下一个输出周期起每个输出周期编码一次，可在任意线程调用
+     */
+    std::string acquireProfile(const OutputProfile& profile);
+
+    /**
+     * @brief 释放临时输出配置
+     * @param profile acquireProfile()返回的名称
+     * @details 最后一个订阅释放后不再编码，可在任意线程调用
+     */
+    void releaseProfile(const std::string& profile);
+
+    /**
+     * @brief 获取DDS输出使用的配置名称
+     * @return 配置名称
+     */
+    const std::string& ddsProfile() const;
+
+private:
+    /**
+     * @brief 私有构造函数
+     * @details 读取内置的 default 配置和配置文件中 OutputProfile_<名称> 分组定义的配置
+     */
+    OutputEncoder();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    OutputEncoder(const OutputEncoder&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    OutputEncoder& operator=(const OutputEncoder&) = delete;
+
+    /**
+     * @brief 读取输出配置
+     */
+    void loadProfiles();
+
+    /**
+     * @brief 推送订阅注册的临时输出配置
+     */
+    struct Subscription {
+        OutputProfile profile;                          ///< 输出配置
+        int references = 0;                             ///< 使用该配置的订阅数
+        std::shared_ptr<const EncodedOutput> latest;    ///< 最近一次的编码
+    };
+
+private:
+    /**
+     * @brief 输出配置，构造后不变
+     */
+    std::vector<OutputProfile> m_profiles;
+
+    /**
+     * @brief 配置名称到下标的映射，构造后不变
+     */
+    std::unordered_map<std::string, int> m_index;
+
+    /**
+     * @brief 各配置最近一次的编码，以 std::atomic_load/atomic_store 访问
+     */
+    std::vector<std::shared_ptr<const EncodedOutput>> m_latest;
+
+    /**
+     * @brief 各配置最近一次编码的时间(毫秒)
+     */
+    std::vector<long long> m_lastEncodedMs;
+
+    /**
+     * @brief DDS输出使用的配置名称
+     */
+    std::string m_ddsProfile;
+
+    /**
+     * @brief 临时输出配置，键为配置名称
+     */
+    std::unordered_map<std::string, Subscription> m_subscriptions;
+
+    /**
+     * @brief 临时输出配置互斥锁
+     * @details 推送服务线程注册和释放，工作线程编码时复制一次到期列表，编码过程中不持有
+     */
+    mutable QMutex m_subscriptionMutex;
+};
+
+#endif // OUTPUTENCODER_H
@@ -8,6 +8,8 @@
 
 #include "Service.h"
 #include "HealthCheckServer.h"
+#include "ExtrapolationServer.h"
+#include "TrackStreamServer.h"
 #include <QCoreApplication>
 #include <QSettings>
 #include <csignal>
@@ -33,6 +35,9 @@
 Service::Service(int argc, char **argv)
     : QtService<QCoreApplication>(argc, argv, "MultiTargetTrackerService"),
       m_worker(nullptr),
+      m_healthCheckServer(nullptr),
+      m_trackStreamServer(nullptr),
+      m_extrapolationServer(nullptr),
       m_isServiceRunning(false)
 {
     // 设置服务的描述信息
@@ -47,6 +52,11 @@ Service::Service(int argc, char **argv)
  */
 Service::~Service()
 {
+    if (m_healthCheckThread.isRunning()) {
+        m_healthCheckThread.quit();
+        m_healthCheckThread.wait(3000);
+    }
+
     // 确保线程在析构前已停止
     if (m_workerThread.isRunning()) {
         LOG_INFO("正在停止工作线程");
@@ -127,7 +137,9 @@ void Service::initConfig()
         settings.setValue("associationGateDistance", 10.0);
         settings.setValue("newTrackGateDistance", 5.0);
         settings.setValue("confirmationHits", 3);
-        settings.setValue("maxMissesToDelete", 5);
+        settings.setValue("maxCoastTime", 0.6);
+        settings.setValue("multiSensorFusion", true);
+        settings.setValue("motionModel", "ca");
         LOG_DEBUG("完成卡尔曼滤波器默认配置设置");
         settings.endGroup();
 
@@ -224,14 +236,22 @@ void Service::start()
 
         // 2. 初始化并启动健康检查服务器
         LOG_INFO("【阶段2】初始化健康检查服务器");
-        m_healthCheckServer = new HealthCheckServer(this, this);
+        // 服务器对象移入独立线程，线程结束时销毁；监听须在该线程中启动
+        m_healthCheckServer = new HealthCheckServer(this);
+        m_healthCheckServer->moveToThread(&m_healthCheckThread);
+        connect(&m_healthCheckThread, &QThread::finished, m_healthCheckServer, &QObject::deleteLater);
+        m_healthCheckThread.start();
+
         QString configPath = QCoreApplication::applicationDirPath() + "/Server.ini";
         QSettings settings(configPath, QSettings::IniFormat);
 
         quint16 port = settings.value("HealthCheck/port", 8899).toUInt();
         LOG_DEBUG("健康检查服务器端口: " + QString::number(port));
 
-        if (!m_healthCheckServer->startListen(port))
+        bool listening = false;
+        QMetaObject::invokeMethod(m_healthCheckServer, "startListen", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(bool, listening), Q_ARG(quint16, port));
+        if (!listening)
         {
             LOG_ERROR("健康检查服务器启动失败，端口: " + QString::number(port));
             return;
@@ -239,6 +259,29 @@ void Service::start()
 
         LOG_INFO("健康检查服务器已启动，端口: " + QString::number(port));
 
+        // 航迹推送服务与健康检查服务器同一线程，由工作线程的输出发布信号驱动，启动失败不影响主服务
+        m_trackStreamServer = new TrackStreamServer();
+        m_trackStreamServer->moveToThread(&m_healthCheckThread);
+        connect(&m_healthCheckThread, &QThread::finished, m_trackStreamServer, &QObject::deleteLater);
+        connect(m_worker, &Worker::outputPublished, m_trackStreamServer, &TrackStreamServer::onOutputPublished);
+
+        quint16 streamPort = settings.value("TrackStream/port", 8900).toUInt();
+        bool streaming = false;
+        QMetaObject::invokeMethod(m_trackStreamServer, "startListen", Qt::BlockingQueuedConnection,
+                                  Q_RETURN_ARG(bool, streaming), Q_ARG(quint16, streamPort));
+        if (!streaming)
+        {
+            LOG_WARN("航迹推送服务器启动失败，端口: " + QString::number(streamPort));
+        }
+
+        // 航迹外推服务为本机客户端提供，启动失败不影响主服务
+        m_extrapolationServer = new ExtrapolationServer(this);
+        QString extrapolationName = settings.value("Extrapolation/serverName", "mtt_extrapolation").toString();
+        if (!m_extrapolationServer->startListen(extrapolationName))
+        {
+            LOG_WARN("航迹外推服务器启动失败: " + extrapolationName);
+        }
+
         // 3. 启动工作线程
         LOG_INFO("【阶段3】启动工作线程");
         m_workerThread.start();
@@ -274,10 +317,27 @@ void Service::stop()
     if (m_healthCheckServer)
     {
         LOG_INFO("【阶段1】停止健康检查服务器");
-        m_healthCheckServer->stopListen();
+        QMetaObject::invokeMethod(m_healthCheckServer, "stopListen", Qt::BlockingQueuedConnection);
+        if (m_trackStreamServer)
+        {
+            QMetaObject::invokeMethod(m_trackStreamServer, "stopListen", Qt::BlockingQueuedConnection);
+        }
+        m_healthCheckThread.quit();
+        if (!m_healthCheckThread.wait(3000))
+        {
+            LOG_WARN("健康检查服务器线程在3秒内没有退出");
+        }
+        m_healthCheckServer = nullptr;
+        m_trackStreamServer = nullptr;
         LOG_INFO("健康检查服务器已停止");
     }
 
+    if (m_extrapolationServer)
+    {
+        m_extrapolationServer->stopListen();
+        LOG_INFO("航迹外推服务器已停止");
+    }
+
     // 工作线程应自行处理关闭。我们只需请求退出并等待。
     if (m_workerThread.isRunning())
     {
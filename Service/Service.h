@@ -12,6 +12,7 @@
 #include "qtservice.h"
 #include <QObject>
 #include <QThread>
+#include <atomic>
 #include "Worker.h"
 
 /**
@@ -19,6 +20,16 @@
  */
 class HealthCheckServer;
 
+/**
+ * @brief 航迹外推服务器的前向声明
+ */
+class ExtrapolationServer;
+
+/**
+ * @brief 航迹推送服务器的前向声明
+ */
+class TrackStreamServer;
+
 /**
  * @brief 服务类，负责管理应用的核心功能
  * @details 继承自QtService<QCoreApplication>和QObject，提供应用程序的服务管理功能
@@ -112,11 +123,29 @@ private:
      */
     Worker* m_worker;
 
+    /**
+     * @brief 健康检查服务器线程
+     * @details 健康检查请求在独立线程中处理，不占用服务主线程的事件循环
+     */
+    QThread m_healthCheckThread;
+
     /**
      * @brief 健康检查服务器指针
+     * @details 对象位于健康检查服务器线程，线程结束时自动销毁
      */
     HealthCheckServer* m_healthCheckServer;
 
+    /**
+     * @brief 航迹推送服务器指针
+     * @details 与健康检查服务器同在健康检查服务器线程，线程结束时自动销毁
+     */
+    TrackStreamServer* m_trackStreamServer;
+
+    /**
+     * @brief 航迹外推服务器指针
+     */
+    ExtrapolationServer* m_extrapolationServer;
+
     /**
      * @brief 工作线程最后心跳时间
      */
@@ -130,9 +159,9 @@ private:
 
     /**
      * @brief 服务运行状态标志
-     * @details 用于跟踪服务是否正在运行
+     * @details 用于跟踪服务是否正在运行，健康检查服务器线程也会读取
      */
-    bool m_isServiceRunning;
+    std::atomic<bool> m_isServiceRunning;
 };
 
 #endif // SERVICE_H
@@ -0,0 +1,194 @@
+/**
+ * @file SharedTrackTable.cpp
+ * @brief 共享内存航迹表写端实现文件
+ * @details 实现了共享内存的创建、槽位分配和顺序锁写入
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "SharedTrackTable.h"
+#include "LogManager.h"
+#include "MetricsRegistry.h"
+#include <QSettings>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cstring>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[SharedTrackTable::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[SharedTrackTable::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[SharedTrackTable::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[SharedTrackTable::" << __FUNCTION__ << "] " << msg
+
+
+SharedTrackTable::SharedTrackTable()
+    : m_failed(false), m_header(nullptr), m_slotsInUse(0), m_overflow(0)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_enabled = settings.value("SharedMemory/enabled", true).toBool();
+    m_capacity = static_cast<uint32_t>(std::max(1, settings.value("SharedMemory/capacity", 1024).toInt()));
+    m_memory.setKey(settings.value("SharedMemory/key", "MultiTargetTracker.tracks").toString());
+}
+
+
+SharedTrackTable::~SharedTrackTable()
+{
+    if (m_memory.isAttached()) {
+        m_memory.detach();
+    }
+}
+
+
+bool SharedTrackTable::open()
+{
+    const size_t size = SharedTrackLayout::segmentSize(m_capacity);
+    if (!m_memory.create(static_cast<int>(size))) {
+        if (m_memory.error() != QSharedMemory::AlreadyExists || !m_memory.attach() ||
+                static_cast<size_t>(m_memory.size()) < size) {
+            LOG_ERROR("无法创建共享内存 " + m_memory.key() + ": " + m_memory.errorString());
+            if (m_memory.isAttached()) {
+                m_memory.detach();
+            }
+            return false;
+        }
+        LOG_WARN("共享内存 " + m_memory.key() + " 已存在，重新初始化");
+    }
+
+    // 先清除魔数，使仍附着的读端在初始化期间校验失败
+    m_header = static_cast<SharedTrackHeader*>(m_memory.data());
+    m_header->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memset(static_cast<void*>(m_header), 0, size);
+    m_header->version = SharedTrackLayout::kVersion;
+    m_header->headerSize = sizeof(SharedTrackHeader);
+    m_header->slotSize = sizeof(SharedTrackSlot);
+    m_header->capacity = m_capacity;
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->magic = SharedTrackLayout::kMagic;
+
+    m_occupied.assign(m_capacity, false);
+    for (uint32_t i = 0; i < m_capacity; ++i) {
+        m_freeSlots.push(i);
+    }
+
+    LOG_INFO("共享内存航迹表已创建: " + m_memory.key() + "，槽位数: " + QString::number(m_capacity) +
+             "，大小: " + QString::number(size) + " 字节");
+    return true;
+}
+
+
+void SharedTrackTable::writeSlot(uint32_t index, const SharedTrackRecord& record)
+{
+    SharedTrackSlot* slot = SharedTrackLayout::slotAt(m_header, index);
+    const uint64_t seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot->record, &record, sizeof(SharedTrackRecord));
+    slot->seq.store(seq + 2, std::memory_order_release);
+}
+
+
+void SharedTrackTable::publish(const TrackSnapshot& snapshot)
+{
+    if (!m_enabled || m_failed) {
+        return;
+    }
+    if (!m_header && !open()) {
+        m_failed = true;
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const uint64_t sequence = static_cast<uint64_t>(snapshot.sequence());
+
+    // 1. 已消失航迹的槽位归还空闲队列，空槽位在第3步统一重写
+    SharedTrackRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.sequence = sequence;
+    for (auto it = m_slotOf.begin(); it != m_slotOf.end();) {
+        if (snapshot.findById(it->first)) {
+            ++it;
+            continue;
+        }
+        m_occupied[it->second] = false;
+        m_freeSlots.push(it->second);
+        it = m_slotOf.erase(it);
+    }
+
+    // 2. 写入全部航迹，新航迹占用下标最小的空闲槽位
+    int written = 0;
+    for (const TrackRecord& track : snapshot.records()) {
+        uint32_t index;
+        auto it = m_slotOf.find(track.id);
+        if (it != m_slotOf.end()) {
+            index = it->second;
+        } else if (!m_freeSlots.empty()) {
+            index = m_freeSlots.top();
+            m_freeSlots.pop();
+            m_slotOf.emplace(track.id, index);
+            m_occupied[index] = true;
+        } else {
+            m_overflow++;
+            continue;
+        }
+
+        record.id = track.id;
+        record.occupied = 1;
+        record.hits = track.hits;
+        record.stateDim = track.stateDim;
+        std::memset(record.model, 0, sizeof(record.model));
+        std::strncpy(record.model, track.model, sizeof(record.model) - 1);
+        record.timestamp = snapshot.timestamp();
+        for (int k = 0; k < 3; ++k) {
+            record.position[k] = track.position[k];
+            record.velocity[k] = track.velocity[k];
+            record.acceleration[k] = track.acceleration[k];
+            record.extent[k] = track.extent[k];
+        }
+        Eigen::Map<Eigen::Matrix<double, 9, 9, Eigen::RowMajor>>(record.covariance) = track.covariance;
+        writeSlot(index, record);
+        written++;
+    }
+
+    // 3. 重写上一次发布的已用范围内的全部空槽位，使读端按快照序号判断整表一致；
+    //    已用槽位上界随尾部槽位的释放而收缩
+    std::memset(&record, 0, sizeof(record));
+    record.sequence = sequence;
+    uint32_t slotsInUse = m_slotsInUse;
+    for (const auto& pair : m_slotOf) {
+        slotsInUse = std::max(slotsInUse, pair.second + 1);
+    }
+    for (uint32_t i = 0; i < slotsInUse; ++i) {
+        if (!m_occupied[i]) {
+            writeSlot(i, record);
+        }
+    }
+    while (slotsInUse > 0 && !m_occupied[slotsInUse - 1]) {
+        slotsInUse--;
+    }
+    m_slotsInUse = slotsInUse;
+
+    // 4. 更新表头
+    const uint64_t seq = m_header->seq.load(std::memory_order_relaxed);
+    m_header->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->frame = std::strcmp(snapshot.frame(), "ecef") == 0 ? SharedTrackLayout::kFrameEcef
+                                                                 : SharedTrackLayout::kFrameEnu;
+    m_header->sequence = sequence;
+    m_header->timestamp = snapshot.timestamp();
+    m_header->publishTimeMs = QDateTime::currentMSecsSinceEpoch();
+    m_header->slotsInUse = m_slotsInUse;
+    m_header->trackCount = static_cast<uint32_t>(written);
+    m_header->overflow = m_overflow;
+    m_header->seq.store(seq + 2, std::memory_order_release);
+
+    nlohmann::json metrics;
+    metrics["tracks"] = written;
+    metrics["slotsInUse"] = m_slotsInUse;
+    metrics["capacity"] = m_capacity;
+    metrics["overflow"] = m_overflow;
+    metrics["writeMicros"] = timer.nsecsElapsed() / 1000;
+    g_Metrics.setSection("sharedMemory", metrics);
+}
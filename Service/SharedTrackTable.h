@@ -0,0 +1,128 @@
+/**
+ * @file SharedTrackTable.h
+ * @brief 共享内存航迹表写端头文件
+ * @details 定义了SharedTrackTable类，每个周期将确认航迹写入共享内存，供本机其他进程直接读取
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef SHAREDTRACKTABLE_H
+#define SHAREDTRACKTABLE_H
+
+#include "SharedTrackLayout.h"
+#include "TrackSnapshot.h"
+#include <QSharedMemory>
+#include <QString>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 共享内存航迹表写端类
+ * @details 布局见 SharedTrackLayout.h。每条航迹存续期间固定占用同一槽位，
+ *          空出的槽位优先按下标从小到大复用，使已用槽位保持紧凑；
+ *          每个周期先写入全部航迹，再以本周期的快照序号重写已用范围内的空槽位，最后更新表头。
+ *          写端不等待读端，读端通过顺序锁自行检测并重读被改写的槽位。
+ *          共享内存在首次发布时创建，创建失败后不再重试。
+ *          非线程安全，只在工作线程中使用
+ */
+class SharedTrackTable
+{
+public:
+    /**
+     * @brief 构造函数
+     * @details 从配置文件 SharedMemory 分组读取开关、键名和槽位数
+     */
+    SharedTrackTable();
+
+    /**
+     * @brief 析构函数
+     * @details 分离共享内存，最后一个分离的进程销毁共享内存
+     */
+    ~SharedTrackTable();
+
+    /**
+     * @brief 发布航迹快照
+     * @param snapshot 本周期发布的航迹快照
+     */
+    void publish(const TrackSnapshot& snapshot);
+
+private:
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    SharedTrackTable(const SharedTrackTable&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    SharedTrackTable& operator=(const SharedTrackTable&) = delete;
+
+    /**
+     * @brief 创建并初始化共享内存
+     * @return 成功返回true
+     * @details 同名共享内存已存在(如上次异常退出后仍有读端附着)且尺寸足够时附着后重新初始化
+     */
+    bool open();
+
+    /**
+     * @brief 在顺序锁保护下写入槽位
+     * @param index 槽位下标
+     * @param record 航迹数据
+     */
+    void writeSlot(uint32_t index, const SharedTrackRecord& record);
+
+private:
+    /**
+     * @brief 是否启用
+     */
+    bool m_enabled;
+
+    /**
+     * @brief 共享内存打开失败后不再重试
+     */
+    bool m_failed;
+
+    /**
+     * @brief 槽位数
+     */
+    uint32_t m_capacity;
+
+    /**
+     * @brief 共享内存对象
+     */
+    QSharedMemory m_memory;
+
+    /**
+     * @brief 表头，即共享内存起始地址
+     */
+    SharedTrackHeader* m_header;
+
+    /**
+     * @brief 航迹ID到槽位下标的映射
+     */
+    std::unordered_map<int, uint32_t> m_slotOf;
+
+    /**
+     * @brief 空闲槽位，小下标优先
+     */
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> m_freeSlots;
+
+    /**
+     * @brief 各槽位是否被占用
+     */
+    std::vector<bool> m_occupied;
+
+    /**
+     * @brief 已用槽位上界
+     */
+    uint32_t m_slotsInUse;
+
+    /**
+     * @brief 因槽位不足而未写入的航迹累计数
+     */
+    uint64_t m_overflow;
+};
+
+#endif // SHAREDTRACKTABLE_H
@@ -0,0 +1,385 @@
+/**
+ * @file TrackStreamServer.cpp
+ * @brief 航迹推送服务器实现文件
+ * @details 实现了订阅解析、按输出配置推送和有界队列发送
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TrackStreamServer.h"
+#include "LogManager.h"
+#include "MetricsRegistry.h"
+#include <QSettings>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <vector>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[TrackStreamServer::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[TrackStreamServer::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[TrackStreamServer::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[TrackStreamServer::" << __FUNCTION__ << "] " << msg
+
+using json = nlohmann::json;
+
+namespace {
+
+/**
+ * @brief 单行请求的最大长度，超过时断开连接
+ */
+const int kMaxLineLength = 64 * 1024;
+
+/**
+ * @brief 推送最小间隔的上限(毫秒)，maxRate 极小时截断到该值，避免换算溢出
+ */
+const double kMaxIntervalMs = 3600.0 * 1000.0;
+
+/**
+ * @brief 未指定字段时订阅的字段: 除未来轨迹外的全部字段
+ */
+const unsigned kDefaultFields = OutputProfile::Hits | OutputProfile::Model | OutputProfile::Position |
+                                OutputProfile::Velocity | OutputProfile::Acceleration | OutputProfile::Extent |
+                                OutputProfile::Covariance;
+
+/**
+ * @brief 解析形如 [x, y, z] 的JSON数组
+ * @param value JSON值
+ * @param vector 输出，坐标
+ * @return 解析成功返回true
+ */
+bool parseVector(const json& value, Vector3& vector)
+{
+    if (!value.is_array() || value.size() != 3) {
+        return false;
+    }
+    for (int k = 0; k < 3; ++k) {
+        if (!value[k].is_number()) {
+            return false;
+        }
+        vector[k] = value[k].get<double>();
+    }
+    return vector.allFinite();
+}
+
+/**
+ * @brief 构造一行错误消息
+ * @param message 错误描述
+ * @return 一行JSON消息(含换行)
+ */
+QByteArray errorLine(const std::string& message)
+{
+    json error;
+    error["error"] = message;
+    return QByteArray::fromStdString(error.dump()) + "\n";
+}
+
+} // namespace
+
+
+TrackStreamServer::Subscription::Subscription()
+{
+    output.fields = kDefaultFields;
+    output.region = OutputProfile::Region::None;
+}
+
+
+TrackStreamServer::TrackStreamServer(QObject *parent)
+    : QObject(parent), m_pushed(0), m_dropped(0)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    m_maxClients = std::max(1, settings.value("TrackStream/maxClients", 256).toInt());
+    m_maxQueuedMessages = std::max(1, settings.value("TrackStream/maxQueuedMessages", 4).toInt());
+    m_maxSocketBytes = std::max<qint64>(1, settings.value("TrackStream/maxSocketBytes", 1024 * 1024).toLongLong());
+
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &TrackStreamServer::onNewConnection);
+    LOG_INFO("航迹推送服务器已创建");
+}
+
+
+TrackStreamServer::~TrackStreamServer()
+{
+    LOG_INFO("航迹推送服务器已销毁");
+}
+
+
+bool TrackStreamServer::startListen(quint16 port)
+{
+    const bool success = m_server->listen(QHostAddress::Any, port);
+    if (success) {
+        LOG_INFO("成功在端口 " + QString::number(port) + " 上启动监听，最大客户端数: " +
+                 QString::number(m_maxClients) + "，队列长度: " + QString::number(m_maxQueuedMessages));
+    } else {
+        LOG_ERROR("无法在端口 " + QString::number(port) + " 上启动监听: " + m_server->errorString());
+    }
+    return success;
+}
+
+
+void TrackStreamServer::stopListen()
+{
+    // 断开连接可能同步触发onDisconnected修改客户端表，先复制出socket列表
+    std::vector<QTcpSocket*> sockets;
+    for (const auto& pair : m_clients) {
+        sockets.push_back(pair.first);
+    }
+    for (QTcpSocket* socket : sockets) {
+        socket->disconnectFromHost();
+    }
+    m_server->close();
+    LOG_INFO("服务器已停止监听");
+}
+
+
+bool TrackStreamServer::parseSubscription(const QByteArray& line, Subscription& subscription, std::string& error)
+{
+    const json request = json::parse(line.constData(), line.constData() + line.size(), nullptr, false);
+    if (request.is_discarded() || !request.is_object()) {
+        error = "invalid subscription";
+        return false;
+    }
+
+    Subscription result;
+    if (request.contains("profile")) {
+        const std::string profile = request["profile"].is_string() ? request["profile"].get<std::string>() : std::string();
+        if (!OutputEncoder::instance().hasProfile(profile)) {
+            error = "unknown profile: " + profile;
+            return false;
+        }
+        result.profile = profile;
+    }
+
+    if (request.contains("fields")) {
+        const json& fields = request["fields"];
+        if (!fields.is_array()) {
+            error = "fields must be an array";
+            return false;
+        }
+        result.output.fields = 0;
+        for (const auto& field : fields) {
+            const std::string name = field.is_string() ? field.get<std::string>() : std::string();
+            const unsigned bit = OutputProfile::fieldFromName(name);
+            if (bit == 0) {
+                error = "unknown field: " + name;
+                return false;
+            }
+            result.output.fields |= bit;
+        }
+    }
+
+    if (request.contains("box")) {
+        const json& box = request["box"];
+        if (!box.is_object() || !box.contains("min") || !box.contains("max") ||
+                !parseVector(box["min"], result.output.minCorner) || !parseVector(box["max"], result.output.maxCorner)) {
+            error = "box requires min and max as [x, y, z]";
+            return false;
+        }
+        result.output.region = OutputProfile::Region::Box;
+    } else if (request.contains("sphere")) {
+        const json& sphere = request["sphere"];
+        if (!sphere.is_object() || !sphere.contains("center") || !sphere.contains("radius") ||
+                !parseVector(sphere["center"], result.output.center) || !sphere["radius"].is_number() ||
+                sphere["radius"].get<double>() < 0) {
+            error = "sphere requires center as [x, y, z] and a non-negative radius";
+            return false;
+        }
+        result.output.radius = sphere["radius"].get<double>();
+        result.output.region = OutputProfile::Region::Sphere;
+    }
+
+    if (request.contains("maxRate")) {
+        if (!request["maxRate"].is_number() || request["maxRate"].get<double>() < 0) {
+            error = "maxRate must be a non-negative number";
+            return false;
+        }
+        const double rate = request["maxRate"].get<double>();
+        result.minIntervalMs = rate > 0 ? static_cast<int>(std::min(1000.0 / rate, kMaxIntervalMs)) : 0;
+    }
+
+    subscription = result;
+    return true;
+}
+
+
+void TrackStreamServer::subscribe(Client& client, const Subscription& subscription)
+{
+    // 先注册新的临时配置再释放旧的，内容不变的重复订阅不会丢掉已有的编码
+    OutputEncoder& encoder = OutputEncoder::instance();
+    const std::string previous = client.temporaryProfile ? client.profile : std::string();
+    client.subscription = subscription;
+    client.temporaryProfile = subscription.profile.empty();
+    client.profile = client.temporaryProfile ? encoder.acquireProfile(subscription.output) : subscription.profile;
+    if (!previous.empty()) {
+        encoder.releaseProfile(previous);
+    }
+    client.lastPushMs = 0;
+    client.lastOutputSequence = 0;
+}
+
+
+void TrackStreamServer::enqueue(QTcpSocket* socket, Client& client, const QByteArray& message)
+{
+    // 航迹消息只有最新的有意义，队列满时丢弃最旧的一条
+    if (static_cast<int>(client.queue.size()) >= m_maxQueuedMessages) {
+        client.queue.pop_front();
+        client.dropped++;
+        m_dropped++;
+    }
+    client.queue.push_back(message);
+    flush(socket, client);
+}
+
+
+void TrackStreamServer::flush(QTcpSocket* socket, Client& client)
+{
+    while (!client.queue.empty() && socket->bytesToWrite() < m_maxSocketBytes) {
+        socket->write(client.queue.front());
+        client.queue.pop_front();
+    }
+}
+
+
+void TrackStreamServer::onOutputPublished()
+{
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+
+    // 编码已由工作线程按输出配置完成，订阅同一配置的客户端共用一条消息，每个配置只转换一次
+    std::unordered_map<std::string, std::pair<long long, QByteArray>> lines;
+    int pushed = 0;
+    for (auto& pair : m_clients) {
+        Client& client = pair.second;
+        if (client.profile.empty()) {
+            continue;
+        }
+        if (client.subscription.minIntervalMs > 0 && nowMs - client.lastPushMs < client.subscription.minIntervalMs) {
+            continue;
+        }
+        auto it = lines.find(client.profile);
+        if (it == lines.end()) {
+            std::shared_ptr<const EncodedOutput> output = OutputEncoder::instance().latest(client.profile);
+            it = lines.emplace(client.profile,
+                               output ? std::make_pair(output->sequence, QByteArray::fromStdString(output->json) + "\n")
+                                      : std::make_pair(0LL, QByteArray())).first;
+        }
+        if (it->second.second.isEmpty() || it->second.first == client.lastOutputSequence) {
+            continue;
+        }
+        enqueue(pair.first, client, it->second.second);
+        client.lastOutputSequence = it->second.first;
+        client.lastPushMs = nowMs;
+        pushed++;
+    }
+    m_pushed += pushed;
+
+    json metrics;
+    metrics["clients"] = m_clients.size();
+    metrics["pushedLastCycle"] = pushed;
+    metrics["profilesLastCycle"] = lines.size();
+    metrics["pushed"] = m_pushed;
+    metrics["dropped"] = m_dropped;
+    metrics["fanoutMicros"] = timer.nsecsElapsed() / 1000;
+    g_Metrics.setSection("stream", metrics);
+}
+
+
+void TrackStreamServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        if (static_cast<int>(m_clients.size()) >= m_maxClients) {
+            LOG_WARN("客户端数已达上限 " + QString::number(m_maxClients) + "，拒绝连接: " +
+                     socket->peerAddress().toString());
+            socket->write(errorLine("too many clients"));
+            socket->disconnectFromHost();
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            continue;
+        }
+
+        // 连接后即按默认订阅接收航迹
+        subscribe(m_clients[socket], Subscription());
+        connect(socket, &QTcpSocket::readyRead, this, &TrackStreamServer::onReadyRead);
+        connect(socket, &QTcpSocket::bytesWritten, this, &TrackStreamServer::onBytesWritten);
+        connect(socket, &QTcpSocket::disconnected, this, &TrackStreamServer::onDisconnected);
+        LOG_INFO("新的订阅客户端: " + socket->peerAddress().toString() + ":" + QString::number(socket->peerPort()));
+    }
+}
+
+
+void TrackStreamServer::onReadyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    auto found = m_clients.find(socket);
+    if (!socket || found == m_clients.end()) {
+        return;
+    }
+
+    Client& client = found->second;
+    client.buffer += socket->readAll();
+    int newline;
+    while ((newline = client.buffer.indexOf('\n')) >= 0) {
+        const QByteArray line = client.buffer.left(newline).trimmed();
+        client.buffer.remove(0, newline + 1);
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        Subscription subscription;
+        std::string error;
+        if (!parseSubscription(line, subscription, error)) {
+            enqueue(socket, client, errorLine(error));
+            continue;
+        }
+        subscribe(client, subscription);
+
+        json ack;
+        if (!subscription.profile.empty()) {
+            ack["subscribed"]["profile"] = subscription.profile;
+        } else {
+            const OutputProfile& output = subscription.output;
+            ack["subscribed"]["fields"] = OutputProfile::fieldNames(output.fields);
+            ack["subscribed"]["region"] = output.region == OutputProfile::Region::Box ? "box" :
+                                          output.region == OutputProfile::Region::Sphere ? "sphere" : "none";
+        }
+        ack["subscribed"]["minIntervalMs"] = subscription.minIntervalMs;
+        enqueue(socket, client, QByteArray::fromStdString(ack.dump()) + "\n");
+    }
+
+    // 缓冲中没有换行却已超长，视为异常客户端
+    if (client.buffer.size() > kMaxLineLength) {
+        LOG_WARN("订阅请求过长，断开连接");
+        client.buffer.clear();
+        socket->disconnectFromHost();
+    }
+}
+
+
+void TrackStreamServer::onBytesWritten()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    auto found = m_clients.find(socket);
+    if (socket && found != m_clients.end()) {
+        flush(socket, found->second);
+    }
+}
+
+
+void TrackStreamServer::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+    auto found = m_clients.find(socket);
+    if (found != m_clients.end()) {
+        LOG_INFO("订阅客户端断开: " + socket->peerAddress().toString() + "，丢弃消息数: " +
+                 QString::number(found->second.dropped));
+        if (found->second.temporaryProfile) {
+            OutputEncoder::instance().releaseProfile(found->second.profile);
+        }
+        m_clients.erase(found);
+    }
+    socket->deleteLater();
+}
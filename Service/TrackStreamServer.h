@@ -0,0 +1,198 @@
+/**
+ * @file TrackStreamServer.h
+ * @brief 航迹推送服务器头文件
+ * @details 定义了TrackStreamServer类，通过TCP连接向订阅客户端推送每个输出周期的航迹
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef TRACKSTREAMSERVER_H
+#define TRACKSTREAMSERVER_H
+
+#include "OutputEncoder.h"
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QByteArray>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief 航迹推送服务器类
+ * @details 本机客户端无需DDS库即可获取航迹。协议为按行分隔的JSON:
+ *          客户端连接后即按默认订阅(除未来轨迹外的全部字段、不限区域、不限速率)接收每个输出周期的航迹，
+ *          随时可发送一行订阅请求修改订阅:
+ *          {"fields":["position","velocity"],"box":{"min":[x,y,z],"max":[x,y,z]},"maxRate":5}，
+ *          区域也可用 "sphere":{"center":[x,y,z],"radius":r} 指定，坐标为发布坐标系，服务器回复一行确认或错误。
+ *          maxRate 为每秒最多推送的次数，0为不限，最小间隔截断到一小时。
+ *          字段名称与输出配置相同，含 "future_trajectory"。
+ *          订阅 {"profile":"名称","maxRate":5} 时改为接收配置文件中该输出配置的编码结果，
+ *          字段、精度、区域和未来轨迹由输出配置决定。
+ *          按字段和区域的订阅注册为OutputEncoder的临时输出配置，与配置文件中的配置走同一条编码路径，
+ *          消息格式与DDS输出一致；订阅内容相同的客户端共用同一个临时配置和同一份编码。
+ *          工作线程编码完成后通过信号通知本服务器，本服务器在自己的线程中只做发送，
+ *          每个客户端的发送队列有上限，
+ *          慢客户端的队列满时丢弃最旧的一条，不会阻塞工作线程或其他客户端。
+ *          startListen()/stopListen()需在本对象所在线程中调用
+ */
+class TrackStreamServer : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父对象指针
+     * @details 从配置文件 TrackStream 分组读取连接数、队列长度和发送缓冲上限
+     */
+    explicit TrackStreamServer(QObject *parent = nullptr);
+
+    /**
+     * @brief 析构函数
+     */
+    ~TrackStreamServer();
+
+    /**
+     * @brief 启动监听
+     * @param port 监听端口号
+     * @return 是否成功启动
+     */
+    Q_INVOKABLE bool startListen(quint16 port);
+
+    /**
+     * @brief 停止监听
+     * @details 关闭服务并断开全部客户端
+     */
+    Q_INVOKABLE void stopListen();
+
+public slots:
+    /**
+     * @brief 输出发布通知槽函数
+     * @details 将各输出配置的最新编码推送给订阅了该配置的客户端；积压的多次通知对同一编码只推送一次
+     */
+    void onOutputPublished();
+
+private slots:
+    /**
+     * @brief 新连接处理槽函数
+     */
+    void onNewConnection();
+
+    /**
+     * @brief 数据可读处理槽函数
+     * @details 逐行解析订阅请求
+     */
+    void onReadyRead();
+
+    /**
+     * @brief 数据已写出处理槽函数
+     * @details 发送缓冲腾出空间后继续发送队列中的消息
+     */
+    void onBytesWritten();
+
+    /**
+     * @brief 连接断开处理槽函数
+     */
+    void onDisconnected();
+
+private:
+    /**
+     * @brief 客户端订阅
+     */
+    struct Subscription {
+        std::string profile;            ///< 配置文件中的输出配置名称，为空时按 output 订阅
+        OutputProfile output;           ///< 按字段和区域订阅时的输出内容，注册为编码器的临时输出配置
+        int minIntervalMs = 0;          ///< 两次推送的最小间隔(毫秒)，0为每个输出周期推送
+
+        /**
+         * @brief 构造默认订阅
+         * @details 除未来轨迹外的全部字段、不限区域、不限速率
+         */
+        Subscription();
+    };
+
+    /**
+     * @brief 客户端状态
+     */
+    struct Client {
+        Subscription subscription;          ///< 订阅
+        QByteArray buffer;                  ///< 尚未处理完的请求字节
+        std::deque<QByteArray> queue;       ///< 待发送消息
+        qint64 lastPushMs = 0;              ///< 最近一次推送的时间(毫秒)
+        long long dropped = 0;              ///< 因队列满而丢弃的消息数
+        long long lastOutputSequence = 0;   ///< 最近推送的输出配置编码对应的快照序号
+        std::string profile;                ///< 读取编码的输出配置名称
+        bool temporaryProfile = false;      ///< profile 是否为本客户端注册的临时输出配置
+    };
+
+    /**
+     * @brief 解析订阅请求
+     * @param line 请求JSON文本
+     * @param subscription 输出，订阅
+     * @param error 输出，失败原因
+     * @return 成功返回true
+     */
+    static bool parseSubscription(const QByteArray& line, Subscription& subscription, std::string& error);
+
+    /**
+     * @brief 修改客户端订阅
+     * @param client 客户端状态
+     * @param subscription 新订阅
+     * @details 按字段和区域的订阅向输出编码器注册临时输出配置，并释放客户端原有的临时配置
+     */
+    void subscribe(Client& client, const Subscription& subscription);
+
+    /**
+     * @brief 消息加入客户端发送队列
+     * @param socket 客户端连接
+     * @param client 客户端状态
+     * @param message 消息
+     * @details 队列已满时丢弃最旧的一条
+     */
+    void enqueue(QTcpSocket* socket, Client& client, const QByteArray& message);
+
+    /**
+     * @brief 在发送缓冲上限内写出队列中的消息
+     * @param socket 客户端连接
+     * @param client 客户端状态
+     */
+    void flush(QTcpSocket* socket, Client& client);
+
+private:
+    /**
+     * @brief TCP服务器对象
+     */
+    QTcpServer* m_server;
+
+    /**
+     * @brief 各客户端的状态
+     */
+    std::unordered_map<QTcpSocket*, Client> m_clients;
+
+    /**
+     * @brief 最大客户端数
+     */
+    int m_maxClients;
+
+    /**
+     * @brief 每个客户端发送队列的最大消息数
+     */
+    int m_maxQueuedMessages;
+
+    /**
+     * @brief 每个客户端套接字发送缓冲的上限(字节)，超过时消息留在队列中
+     */
+    qint64 m_maxSocketBytes;
+
+    /**
+     * @brief 累计推送的消息数
+     */
+    long long m_pushed;
+
+    /**
+     * @brief 累计因队列满而丢弃的消息数
+     */
+    long long m_dropped;
+};
+
+#endif // TRACKSTREAMSERVER_H
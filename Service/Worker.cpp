@@ -2,23 +2,35 @@
 #include <QTime>
 #include <QThread>
 #include <QSettings>
+#include <QElapsedTimer>
 #include "LogManager.h"
 #include "nlohmann/json.hpp"
 #include "MessageRelayManager.h"
+#include "SensorRegistry.h"
+#include "GeodeticFrame.h"
+#include "ClockOffsetEstimator.h"
+#include "TrackSnapshotStore.h"
+#include "MetricsRegistry.h"
+#include "ObserverRegistry.h"
+#include "OutputEncoder.h"
 #include <algorithm>
 
 using json = nlohmann::json;
 
 Worker::Worker(QObject *parent)
-    : QObject(parent), m_timer(nullptr), m_running(false)
+    : QObject(parent), m_timer(nullptr), m_running(false),
+      m_maxBufferedMeasurements(50000), m_shedMeasurements(0), m_shedMeasurementsPending(0),
+      m_allocations("worker"), m_lastOutputBytes(0)
 {
 
     qRegisterMetaType<std::string>("std::string");
 
     QSettings settings("Server.ini", QSettings::IniFormat);
     m_interval = settings.value("General/workerInterval", 100).toInt();
+    m_maxBufferedMeasurements = settings.value("Capacity/maxBufferedMeasurements", 50000).toInt();
 
     m_trackManager = std::make_unique<TrackManager>();
+    m_governor = std::make_unique<LoadGovernor>(m_interval);
 
     m_lastHeartbeat = QDateTime::currentDateTimeUtc();
 
@@ -66,16 +78,62 @@ void Worker::onMessageReceived(const std::string& message)
         // 使用 .at() 方法访问，如果键不存在会抛出异常，更安全
         int observerId = data.at("ObserverId");
         double timestamp = data.at("Timestamp");
+        g_Observers.recordMessage(observerId);
+
+        Measurement m;
+        if (data.contains("Polar")) {
+            // 球坐标观测: 距离(米)、方位/俯仰(度)、可选径向速度(米/秒)，
+            // 笛卡尔位置在处理周期内按观测者批量换算
+            const json& polar = data.at("Polar");
+            const double deg2rad = EIGEN_PI / 180.0;
+            ObservationVector raw(polar.contains("rangeRate") ? 4 : 3);
+            raw(0) = polar.at("range");
+            raw(1) = polar.at("azimuth").get<double>() * deg2rad;
+            raw(2) = polar.at("elevation").get<double>() * deg2rad;
+            if (raw.size() == 4) {
+                raw(3) = polar.at("rangeRate");
+            }
+            m = Measurement(raw, timestamp, observerId);
+        } else if (data.contains("Bearing")) {
+            // 纯方位观测: 方位/俯仰(度)，由交叉定位阶段生成三维伪观测
+            const json& bearing = data.at("Bearing");
+            const double deg2rad = EIGEN_PI / 180.0;
+            ObservationVector raw(2);
+            raw(0) = bearing.at("azimuth").get<double>() * deg2rad;
+            raw(1) = bearing.at("elevation").get<double>() * deg2rad;
+            m = Measurement(raw, timestamp, observerId);
+        } else if (data.contains("Geodetic")) {
+            // 经纬高观测: 纬度/经度(度)、椭球高(米)，在处理周期内批量换算到跟踪坐标系
+            const json& geodetic = data.at("Geodetic");
+            const double deg2rad = EIGEN_PI / 180.0;
+            m = Measurement(Vector3(geodetic.at("latitude").get<double>() * deg2rad,
+                                    geodetic.at("longitude").get<double>() * deg2rad,
+                                    geodetic.at("altitude").get<double>()),
+                            timestamp, observerId);
+            m.isGeodetic = true;
+        } else {
+            // 访问嵌套对象
+            const json& position = data.at("Position");
+            double x = position.at("x");
+            double y = position.at("y");
+            double z = position.at("z");
+
+            m = Measurement(Vector3(x,y,z), timestamp, observerId);
+        }
 
-        // 访问嵌套对象
-        const json& position = data.at("Position");
-        double x = position.at("x");
-        double y = position.at("y");
-        double z = position.at("z");
-
-        Measurement m{Vector3(x,y,z),timestamp,observerId};
+        // 按观测者的时钟偏差估计修正时间戳，并以到达时刻统计传输时延
+        const double arrivalTime = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+        m.timestamp = ClockOffsetEstimator::instance().correct(observerId, timestamp, arrivalTime);
+        m.arrivalTime = arrivalTime;
 
         QMutexLocker locker(&m_bufferMutex);
+        // 缓冲区已满时丢弃新到的观测(dropNewest)，保证单个周期的处理量有界。
+        // 丢弃只在入口判断，不搬移缓冲区内的观测；代价是过载时本周期保留的是较早到达的观测
+        if (static_cast<int>(m_measurementBuffer.size()) >= m_maxBufferedMeasurements) {
+            m_shedMeasurementsPending++;
+            g_Observers.recordDropped(observerId);
+            return;
+        }
         m_measurementBuffer.push_back(m);
 
 
@@ -89,15 +147,58 @@ void Worker::onTimeout()
 {
     if (!m_running) return;
 
-    // 1. 从缓冲区取出本周期的所有观测数据
-    std::vector<Measurement> currentMeasurements;
+    QElapsedTimer cycleTimer;
+    cycleTimer.start();
+    m_allocations.beginCycle();
+
+    // 按上一周期结束时的降级等级配置本周期的可选工作
+    const LoadGovernor::Level level = m_governor->level();
+    m_trackManager->setDegradation(level >= LoadGovernor::CheapInitiation,
+                                   level >= LoadGovernor::CapBirths ? m_governor->birthCap() : -1);
+
+    // 1. 从缓冲区取出本周期的所有观测数据。上一周期的观测清空后与缓冲区交换，两个数组都保留容量
+    std::vector<Measurement>& currentMeasurements = m_cycleMeasurements;
+    currentMeasurements.clear();
+    int shedMeasurements = 0;
+    size_t bufferedCapacity = 0;
     {
         QMutexLocker locker(&m_bufferMutex);
-        if (!m_measurementBuffer.empty()) {
-            currentMeasurements.swap(m_measurementBuffer);
-        }
+        currentMeasurements.swap(m_measurementBuffer);
+        shedMeasurements = m_shedMeasurementsPending;
+        m_shedMeasurementsPending = 0;
+        bufferedCapacity = currentMeasurements.capacity() + m_measurementBuffer.capacity();
+    }
+    const size_t drainedCount = currentMeasurements.size();
+    m_shedMeasurements += shedMeasurements;
+
+    const double drainTime = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+    for (const auto& m : currentMeasurements) {
+        g_Observers.recordLatency(m.observerId, drainTime - m.arrivalTime);
+    }
+    m_allocations.markStage("drain");
+
+    // 经纬高观测批量换算到跟踪坐标系，跟踪原点移动后基准坐标系下的笛卡尔观测一并变换
+    GeodeticFrame& frame = GeodeticFrame::instance();
+    frame.convertToLocal(currentMeasurements);
+
+    // 纯方位观测先进行多观测者交叉定位，替换为带协方差的三维伪观测
+    m_triangulator.process(currentMeasurements);
+
+    // 非笛卡尔传感器的原始观测按观测者批量换算为笛卡尔位置，供数据关联使用
+    SensorRegistry::instance().convertToCartesian(currentMeasurements);
+
+    // 点云类传感器的密集观测聚类为质心观测，减少后续关联和起始的工作量
+    m_clusterer.process(currentMeasurements);
+
+    // 观测数按观测者统计，在合并之前计数，融合观测不归属任何单一观测者
+    for (const auto& m : currentMeasurements) {
+        g_Observers.recordMeasurement(m.observerId);
     }
 
+    // 不同观测者对同一目标的重复观测合并为一条融合观测(默认关闭)
+    m_coalescer.process(currentMeasurements);
+    m_allocations.markStage("preprocess");
+
     // 如果有数据，则进行处理
     if (!currentMeasurements.empty()) {
         // 2. 对本批次的观测数据按时间戳排序，确保时间顺序正确
@@ -113,54 +214,98 @@ void Worker::onTimeout()
         // 为后续的批量数据关联做好了准备。
         double latestTimestamp = currentMeasurements.back().timestamp;
         m_trackManager->predictTo(latestTimestamp);
+        m_allocations.markStage("predict");
 
         // 4. (新) 用本周期的所有观测数据，一次性更新所有航迹
         // 将整个观测数据批次传递给TrackManager。TrackManager内部的数据关联、
         // 更新、创建和删除逻辑将一次性完成，避免了在Worker层进行高开销的循环。
         m_trackManager->processMeasurements(currentMeasurements);
+        ClockOffsetEstimator::instance().endCycle();
+        m_allocations.markStage("associate");
+
+        // 活动区域远离跟踪原点时移动原点，航迹、候选和传感器位姿随之变换
+        Vector3 center = Vector3::Zero();
+        for (const auto& m : currentMeasurements) {
+            center += m.position;
+        }
+        center /= static_cast<double>(currentMeasurements.size());
+        if (frame.needsRecenter(center)) {
+            Eigen::Matrix3d rotation;
+            Vector3 translation;
+            frame.recenter(center, rotation, translation);
+            m_trackManager->transformFrame(rotation, translation);
+            SensorRegistry::instance().transformFrame(rotation, translation);
+        }
 
         // ========================[核心修改部分结束]========================
+    } else {
+        // 没有观测时也推进航迹的超时删除，输入中断后不再发布过期航迹
+        m_trackManager->expireIdle();
     }
 
-    // 5. 定时输出跟踪和预测结果，并将确认航迹打包成JSON发送
+    // 5. 发布本周期的航迹快照，查询接口由快照回答，不再读取航迹管理器
     auto tracks = m_trackManager->getTracks();
-
-    json outputJson;
-    outputJson["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate).toStdString();
-    outputJson["tracks"] = json::array();
-
-    for (const auto& track : tracks) {
-        if (track->isConfirmed()) {
-            StateVector state = track->getState();
-            Vector3 pos = state.head<3>();
-            Vector3 vel = state.segment<3>(3); // 注意：匀加速模型中，速度在中间3个维度
-
-            json trackJson;
-            trackJson["id"] = track->getId();
-            trackJson["hits"] = track->getHits();
-            trackJson["position"] = { {"x", pos.x()}, {"y", pos.y()}, {"z", pos.z()} };
-            trackJson["velocity"] = { {"x", vel.x()}, {"y", vel.y()}, {"z", vel.z()} };
-
-            std::vector<Vector3> future = track->predictFutureTrajectory(2.0, 0.5);
-            json futurePathJson = json::array();
-            for(const auto& p : future) {
-                futurePathJson.push_back({ {"x", p.x()}, {"y", p.y()}, {"z", p.z()} });
+    TrackSnapshotStore::instance().publish(tracks, m_trackManager->getLastProcessTime());
+    m_sharedTable.publish(*TrackSnapshotStore::instance().current());
+
+    // 6. 定时输出跟踪和预测结果，并将确认航迹打包成JSON发送
+    // 降低输出频率时只在部分周期输出
+    if (m_governor->shouldOutput()) {
+        std::vector<TrackPtr> confirmed;
+        for (const auto& track : tracks) {
+            if (track->isConfirmed()) {
+                confirmed.push_back(track);
             }
-            trackJson["future_trajectory"] = futurePathJson;
+        }
 
-            outputJson["tracks"].push_back(trackJson);
+        // 各输出配置每周期只编码一次，DDS输出和推送服务共用编码结果
+        const long long sequence = TrackSnapshotStore::instance().current()->sequence();
+        OutputEncoder& encoder = OutputEncoder::instance();
+        encoder.encode(confirmed, level < LoadGovernor::SkipTrajectories, sequence); // 过载时跳过未来轨迹预测
+
+        std::shared_ptr<const EncodedOutput> output = encoder.latest(encoder.ddsProfile());
+        if (output && output->sequence == sequence && output->trackCount > 0) {
+            m_lastOutputBytes = output->json.size();
+            g_MessageManager.sendMessage(output->json);
+            if (level < LoadGovernor::ReduceOutputRate) {
+                qInfo()<<"outputJson " <<QString::fromStdString(output->json);
+            }
         }
+        emit outputPublished();
     }
 
-    if (!outputJson["tracks"].empty()) {
-        try {
-            std::string jsonData = outputJson.dump();
-            g_MessageManager.sendMessage(jsonData);
-            qInfo()<<"outputJson " <<QString::fromStdString(jsonData);
-        } catch (const json::exception& e) {
-            qCritical() << "序列化要发送的航迹JSON失败: " << e.what();
-        }
+    m_allocations.markAllocatingStage("output");
+
+    // 记录本周期耗时，调整下一周期的降级等级
+    m_governor->recordCycle(cycleTimer.nsecsElapsed() / 1e6);
+
+    // 各模块的指标在最后一个阶段之后发布，JSON构建的分配不计入周期分配统计
+    if (shedMeasurements > 0) {
+        qWarning() << "观测缓冲区已达上限" << m_maxBufferedMeasurements << "，上一周期丢弃观测" << shedMeasurements << "条";
     }
+    json bufferCapacity;
+    bufferCapacity["count"] = drainedCount;
+    bufferCapacity["limit"] = m_maxBufferedMeasurements;
+    bufferCapacity["shed"] = m_shedMeasurements;
+    bufferCapacity["shedLastCycle"] = shedMeasurements;
+    bufferCapacity["policy"] = "dropNewest";
+    g_Metrics.setValue("capacity", "measurementBuffer", bufferCapacity);
+
+    json bufferMemory;
+    bufferMemory["count"] = drainedCount;
+    bufferMemory["bytes"] = bufferedCapacity * sizeof(Measurement);
+    g_Metrics.setValue("memory", "measurementBuffer", bufferMemory);
+
+    json outputMemory;
+    outputMemory["bytes"] = m_lastOutputBytes;
+    g_Metrics.setValue("memory", "output", outputMemory);
+
+    m_governor->publishMetrics();
+    m_trackManager->publishMetrics();
+    frame.publishMetrics();
+    ClockOffsetEstimator::instance().publishMetrics();
+    g_Observers.endCycle();
+    m_allocations.endCycle();
 
     m_lastHeartbeat = QDateTime::currentDateTimeUtc();
     emit heartbeat(m_lastHeartbeat);
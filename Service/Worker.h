@@ -14,6 +14,12 @@
 #include <QDateTime>
 #include <QMutex>
 #include "TrackManager.h"
+#include "BearingTriangulator.h"
+#include "PointCloudClusterer.h"
+#include "MeasurementCoalescer.h"
+#include "LoadGovernor.h"
+#include "AllocationTracker.h"
+#include "SharedTrackTable.h"
 #include <memory>
 #include <vector>
 #include "DataStructures.h"
@@ -45,6 +51,12 @@ signals:
      */
     void heartbeat(const QDateTime& lastHeartbeat);
 
+    /**
+     * @brief 输出发布信号
+     * @details 输出周期编码完成后发出，推送服务据此从 OutputEncoder 取各输出配置的最新编码
+     */
+    void outputPublished();
+
 public slots:
     /**
      * @brief 开始工作
@@ -103,17 +115,81 @@ private:
      */
     std::unique_ptr<TrackManager> m_trackManager;
 
+    /**
+     * @brief 负载调节器
+     * @details 按周期耗时相对周期预算的比例逐级启用降级措施
+     */
+    std::unique_ptr<LoadGovernor> m_governor;
+
+    /**
+     * @brief 纯方位交叉定位器
+     * @details 在数据关联之前将多观测者的方位线交叉为三维伪观测
+     */
+    BearingTriangulator m_triangulator;
+
+    /**
+     * @brief 点云预聚类器
+     * @details 在数据关联之前将点云类传感器的密集观测归约为聚类质心
+     */
+    PointCloudClusterer m_clusterer;
+
+    /**
+     * @brief 重复观测合并器
+     * @details 在数据关联之前合并不同观测者对同一目标的重复观测
+     */
+    MeasurementCoalescer m_coalescer;
+
+    /**
+     * @brief 共享内存航迹表
+     * @details 每个周期将快照中的确认航迹写入共享内存，供本机其他进程读取
+     */
+    SharedTrackTable m_sharedTable;
+
     /**
      * @brief 观测数据缓冲区
      */
     std::vector<Measurement> m_measurementBuffer;
 
+    /**
+     * @brief 本周期处理的观测
+     * @details 每个周期与观测数据缓冲区交换，两者交替使用并保留各自的容量，稳态下取出观测不分配内存
+     */
+    std::vector<Measurement> m_cycleMeasurements;
+
     /**
      * @brief 缓冲区互斥锁
      * @details 保护观测数据缓冲区的线程安全访问
      */
     QMutex m_bufferMutex;
 
+    /**
+     * @brief 观测缓冲区容量上限
+     * @details 缓冲区满时新到的观测被丢弃(dropNewest)，丢弃策略和计数发布在 capacity 指标的 measurementBuffer 项
+     */
+    int m_maxBufferedMeasurements;
+
+    /**
+     * @brief 累计因缓冲区满而丢弃的观测数
+     */
+    long long m_shedMeasurements;
+
+    /**
+     * @brief 上次取出缓冲区后丢弃的观测数
+     * @details 受缓冲区互斥锁保护
+     */
+    int m_shedMeasurementsPending;
+
+    /**
+     * @brief 内存分配统计
+     * @details 按处理阶段采样工作线程的分配次数，编译时未启用时为空操作
+     */
+    AllocationTracker m_allocations;
+
+    /**
+     * @brief 最近一次输出的航迹JSON字节数
+     */
+    size_t m_lastOutputBytes;
+
     /**
      * @brief 最后心跳时间
      */
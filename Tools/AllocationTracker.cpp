@@ -0,0 +1,339 @@
+/**
+ * @file AllocationTracker.cpp
+ * @brief 内存分配统计实现文件
+ * @details 实现了全局new/delete的计数替换、按阶段采样和指标发布
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "AllocationTracker.h"
+#include "MetricsRegistry.h"
+
+#ifdef MTT_ALLOCATION_TRACKING
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+/**
+ * @brief 每块内存前附加的头部大小，保存请求的字节数，保持malloc的对齐
+ */
+const std::size_t kHeaderSize = alignof(std::max_align_t) > sizeof(std::size_t)
+                                    ? alignof(std::max_align_t) : sizeof(std::size_t);
+
+/**
+ * @brief 当前线程的计数，平凡类型，零初始化，不需要动态构造
+ */
+thread_local AllocationCounters t_counters = {0, 0, 0, 0};
+
+/**
+ * @brief 全进程的计数
+ */
+std::atomic<long long> g_allocations(0);
+std::atomic<long long> g_deallocations(0);
+std::atomic<long long> g_bytesAllocated(0);
+std::atomic<long long> g_bytesFreed(0);
+
+void* countedAllocate(std::size_t size)
+{
+    for (;;) {
+        void* block = std::malloc(size + kHeaderSize);
+        if (block) {
+            *static_cast<std::size_t*>(block) = size;
+            t_counters.allocations++;
+            t_counters.bytesAllocated += static_cast<long long>(size);
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+            g_bytesAllocated.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+            return static_cast<char*>(block) + kHeaderSize;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            return nullptr;
+        }
+        handler();
+    }
+}
+
+void countedFree(void* ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    void* block = static_cast<char*>(ptr) - kHeaderSize;
+    const std::size_t size = *static_cast<std::size_t*>(block);
+    t_counters.deallocations++;
+    t_counters.bytesFreed += static_cast<long long>(size);
+    g_deallocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytesFreed.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* ptr = countedAllocate(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* ptr = countedAllocate(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    countedFree(ptr);
+}
+
+#endif // MTT_ALLOCATION_TRACKING
+
+
+/**
+ * @brief 构造函数
+ * @param name 线程名称
+ */
+AllocationTracker::AllocationTracker(const std::string& name)
+    : m_name(name),
+      m_last(threadCounters()),
+      m_cycleAllocations(0),
+      m_lastCycleAllocations(0),
+      m_cycles(0),
+      m_zeroAllocationStreak(0),
+      m_inCycle(false)
+{
+    m_stages.reserve(16);
+}
+
+/**
+ * @brief 是否已编译分配统计
+ * @return 是否启用
+ */
+bool AllocationTracker::isEnabled()
+{
+#ifdef MTT_ALLOCATION_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 获取当前线程的累计计数
+ * @return 分配计数
+ */
+AllocationCounters AllocationTracker::threadCounters()
+{
+#ifdef MTT_ALLOCATION_TRACKING
+    return t_counters;
+#else
+    return AllocationCounters{0, 0, 0, 0};
+#endif
+}
+
+/**
+ * @brief 获取全进程的累计计数
+ * @return 分配计数
+ */
+AllocationCounters AllocationTracker::processCounters()
+{
+#ifdef MTT_ALLOCATION_TRACKING
+    return AllocationCounters{g_allocations.load(std::memory_order_relaxed),
+                              g_deallocations.load(std::memory_order_relaxed),
+                              g_bytesAllocated.load(std::memory_order_relaxed),
+                              g_bytesFreed.load(std::memory_order_relaxed)};
+#else
+    return AllocationCounters{0, 0, 0, 0};
+#endif
+}
+
+/**
+ * @brief 开始一个处理周期
+ */
+void AllocationTracker::beginCycle()
+{
+    if (!isEnabled()) {
+        return;
+    }
+    record("ingest", threadCounters());
+    m_cycleAllocations = 0;
+    m_inCycle = true;
+}
+
+/**
+ * @brief 结束一个处理阶段
+ * @param stage 阶段名称
+ */
+void AllocationTracker::markStage(const char* stage)
+{
+    if (!isEnabled() || !m_inCycle) {
+        return;
+    }
+    const AllocationCounters now = threadCounters();
+    const long long allocations = now.allocations - m_last.allocations;
+    record(stage, now);
+    m_cycleAllocations += allocations;
+}
+
+/**
+ * @brief 结束一个按设计分配内存的阶段
+ * @param stage 阶段名称
+ */
+void AllocationTracker::markAllocatingStage(const char* stage)
+{
+    if (!isEnabled() || !m_inCycle) {
+        return;
+    }
+    record(stage, threadCounters());
+}
+
+/**
+ * @brief 结束一个处理周期并发布指标
+ */
+void AllocationTracker::endCycle()
+{
+    if (!isEnabled()) {
+        g_Metrics.setValue("allocations", "enabled", false);
+        return;
+    }
+    if (!m_inCycle) {
+        return;
+    }
+    m_inCycle = false;
+    m_lastCycleAllocations = m_cycleAllocations;
+    m_cycles++;
+    m_zeroAllocationStreak = (m_cycleAllocations == 0) ? m_zeroAllocationStreak + 1 : 0;
+
+    publish();
+
+    // 重置基准，发布指标本身的分配(含JSON析构时的分配)不归入任何阶段
+    m_last = threadCounters();
+}
+
+/**
+ * @brief 发布指标
+ */
+void AllocationTracker::publish() const
+{
+    const AllocationCounters thread = m_last;
+    nlohmann::json stages = nlohmann::json::object();
+    for (const auto& sample : m_stages) {
+        stages[sample.name] = {{"allocationsLastCycle", sample.allocations},
+                               {"bytesLastCycle", sample.bytes},
+                               {"allocations", sample.total}};
+    }
+
+    nlohmann::json metrics;
+    metrics["cycles"] = m_cycles;
+    metrics["lastCycleAllocations"] = m_lastCycleAllocations;
+    metrics["zeroAllocationStreak"] = m_zeroAllocationStreak;
+    metrics["allocations"] = thread.allocations;
+    metrics["deallocations"] = thread.deallocations;
+    metrics["bytesAllocated"] = thread.bytesAllocated;
+    metrics["bytesFreed"] = thread.bytesFreed;
+    metrics["stages"] = stages;
+
+    const AllocationCounters process = processCounters();
+    nlohmann::json processMetrics;
+    processMetrics["allocations"] = process.allocations;
+    processMetrics["deallocations"] = process.deallocations;
+    processMetrics["liveAllocations"] = process.allocations - process.deallocations;
+    processMetrics["bytesAllocated"] = process.bytesAllocated;
+    processMetrics["bytesFreed"] = process.bytesFreed;
+    processMetrics["liveBytes"] = process.bytesAllocated - process.bytesFreed;
+
+    g_Metrics.setValue("allocations", "enabled", true);
+    g_Metrics.setValue("allocations", "process", processMetrics);
+    g_Metrics.setValue("allocations", m_name, metrics);
+}
+
+/**
+ * @brief 获取上一周期各阶段分配次数之和
+ * @return 分配次数
+ */
+long long AllocationTracker::lastCycleAllocations() const
+{
+    return m_lastCycleAllocations;
+}
+
+/**
+ * @brief 获取连续零分配的周期数
+ * @return 周期数
+ */
+long long AllocationTracker::zeroAllocationStreak() const
+{
+    return m_zeroAllocationStreak;
+}
+
+/**
+ * @brief 记录一个阶段的计数增量
+ * @param stage 阶段名称
+ * @param now 当前线程计数
+ */
+void AllocationTracker::record(const char* stage, const AllocationCounters& now)
+{
+    const long long allocations = now.allocations - m_last.allocations;
+    const long long bytes = now.bytesAllocated - m_last.bytesAllocated;
+
+    // 阶段名称为字符串常量，按指针比较
+    auto it = m_stages.begin();
+    for (; it != m_stages.end(); ++it) {
+        if (it->name == stage) {
+            break;
+        }
+    }
+    if (it == m_stages.end()) {
+        m_stages.push_back(StageSample{stage, 0, 0, 0});
+        it = m_stages.end() - 1;
+    }
+    it->allocations = allocations;
+    it->bytes = bytes;
+    it->total += allocations;
+
+    m_last = now;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file AllocationTracker.h
+ * @brief 内存分配统计头文件
+ * @details 定义了AllocationTracker类，统计全局new/delete的次数和字节数，并按处理阶段采样
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief 内存分配计数
+ */
+struct AllocationCounters {
+    long long allocations;     ///< 分配次数
+    long long deallocations;   ///< 释放次数
+    long long bytesAllocated;  ///< 分配字节数
+    long long bytesFreed;      ///< 释放字节数
+};
+
+/**
+ * @brief 内存分配统计类
+ * @details 编译时定义 MTT_ALLOCATION_TRACKING 后替换全局 operator new/delete，
+ *          按线程和全进程统计分配、释放的次数和字节数；未定义时不替换，计数恒为零，没有任何开销。
+ *          每个处理线程持有一个实例，周期内在各阶段结束处调用markStage()采样本线程的计数增量，
+ *          发布快照等按设计分配内存的阶段调用markAllocatingStage()，
+ *          周期结束时发布到指标注册表的 allocations 分区，稳态下 lastCycleAllocations() 应为零。
+ *          Eigen动态矩阵直接使用malloc，不经过operator new，不计入统计；
+ *          滤波器使用定长上限的Eigen类型，由 bench/AllocationBench 在 EIGEN_RUNTIME_NO_MALLOC 下检查
+ */
+class AllocationTracker
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param name 线程名称，作为指标中的分区键
+     */
+    explicit AllocationTracker(const std::string& name);
+
+    /**
+     * @brief 是否已编译分配统计
+     * @return 定义了 MTT_ALLOCATION_TRACKING 时返回true
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief 获取当前线程的累计计数
+     * @return 分配计数
+     */
+    static AllocationCounters threadCounters();
+
+    /**
+     * @brief 获取全进程的累计计数
+     * @return 分配计数
+     */
+    static AllocationCounters processCounters();
+
+    /**
+     * @brief 开始一个处理周期
+     * @details 上一周期结束到本周期开始之间本线程的分配(如接收观测时的解析)记入 ingest 阶段
+     */
+    void beginCycle();
+
+    /**
+     * @brief 结束一个处理阶段
+     * @param stage 阶段名称，须为字符串常量
+     * @details 记录自上一次采样以来本线程的分配次数和字节数
+     */
+    void markStage(const char* stage);
+
+    /**
+     * @brief 结束一个按设计分配内存的阶段
+     * @param stage 阶段名称，须为字符串常量
+     * @details 发布快照、编码输出等阶段每周期生成新的共享数据，其分配照常按阶段统计，
+     *          但不计入周期分配次数，lastCycleAllocations() 和 zeroAllocationStreak() 只反映处理流水线
+     */
+    void markAllocatingStage(const char* stage);
+
+    /**
+     * @brief 结束一个处理周期并发布指标
+     * @details 周期计数取最后一次采样为止，发布指标本身的分配不计入本周期
+     */
+    void endCycle();
+
+    /**
+     * @brief 获取上一周期各阶段分配次数之和
+     * @return 分配次数，不含 ingest 阶段和按设计分配内存的阶段
+     */
+    long long lastCycleAllocations() const;
+
+    /**
+     * @brief 获取连续零分配的周期数
+     * @return 截至上一周期连续零分配的周期数，稳态下应随周期递增
+     */
+    long long zeroAllocationStreak() const;
+
+private:
+    /**
+     * @brief 单个阶段的采样
+     */
+    struct StageSample {
+        const char* name;       ///< 阶段名称
+        long long allocations;  ///< 上一周期的分配次数
+        long long bytes;        ///< 上一周期的分配字节数
+        long long total;        ///< 累计分配次数
+    };
+
+    /**
+     * @brief 记录一个阶段的计数增量
+     * @param stage 阶段名称
+     * @param now 当前线程计数
+     */
+    void record(const char* stage, const AllocationCounters& now);
+
+    /**
+     * @brief 发布指标
+     * @details 写入 allocations 分区的 enabled、process 和以线程名称为键的三项
+     */
+    void publish() const;
+
+private:
+    /**
+     * @brief 线程名称
+     */
+    std::string m_name;
+
+    /**
+     * @brief 各阶段的采样，按首次出现顺序排列，稳态下不再增长
+     */
+    std::vector<StageSample> m_stages;
+
+    /**
+     * @brief 上一次采样时的线程计数
+     */
+    AllocationCounters m_last;
+
+    /**
+     * @brief 本周期各阶段分配次数之和
+     */
+    long long m_cycleAllocations;
+
+    /**
+     * @brief 上一周期各阶段分配次数之和
+     */
+    long long m_lastCycleAllocations;
+
+    /**
+     * @brief 已完成的周期数
+     */
+    long long m_cycles;
+
+    /**
+     * @brief 连续零分配的周期数
+     */
+    long long m_zeroAllocationStreak;
+
+    /**
+     * @brief 是否处于周期内
+     */
+    bool m_inCycle;
+};
+
+#endif // ALLOCATIONTRACKER_H
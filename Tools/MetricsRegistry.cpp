@@ -0,0 +1,61 @@
+/**
+ * @file MetricsRegistry.cpp
+ * @brief 运行指标注册表实现文件
+ * @details 实现了运行指标的发布和快照读取
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "MetricsRegistry.h"
+
+/**
+ * @brief 获取指标注册表单例实例
+ * @return 指标注册表实例的引用
+ */
+MetricsRegistry& MetricsRegistry::instance()
+{
+    // C++11 保证了静态局部变量的初始化是线程安全的
+    static MetricsRegistry instance;
+    return instance;
+}
+
+/**
+ * @brief 构造函数
+ */
+MetricsRegistry::MetricsRegistry()
+    : m_sections(nlohmann::json::object())
+{
+}
+
+/**
+ * @brief 发布一个分区的指标
+ * @param section 分区名称
+ * @param value 指标内容
+ */
+void MetricsRegistry::setSection(const std::string& section, const nlohmann::json& value)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sections[section] = value;
+}
+
+/**
+ * @brief 发布分区中的一项指标
+ * @param section 分区名称
+ * @param key 指标名称
+ * @param value 指标内容
+ */
+void MetricsRegistry::setValue(const std::string& section, const std::string& key, const nlohmann::json& value)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sections[section][key] = value;
+}
+
+/**
+ * @brief 获取全部指标的快照
+ * @return 以分区名称为键的JSON对象
+ */
+nlohmann::json MetricsRegistry::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_sections;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file MetricsRegistry.h
+ * @brief 运行指标注册表头文件
+ * @details 定义了MetricsRegistry类，汇总各处理阶段发布的运行指标，供健康检查接口输出
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QMutex>
+#include <string>
+#include "nlohmann/json.hpp"
+
+/**
+ * @brief 运行指标注册表类
+ * @details 各模块在工作线程中按分区发布自己的指标(每个分区为一个JSON对象)，
+ *          健康检查服务器在自己的线程中读取快照。
+ *          使用单例模式确保全局只有一个指标注册表实例
+ */
+class MetricsRegistry
+{
+public:
+    /**
+     * @brief 获取指标注册表单例实例
+     * @return 指标注册表实例的引用
+     */
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief 发布一个分区的指标
+     * @param section 分区名称
+     * @param value 指标内容，整体替换该分区原有内容
+     */
+    void setSection(const std::string& section, const nlohmann::json& value);
+
+    /**
+     * @brief 发布分区中的一项指标
+     * @param section 分区名称
+     * @param key 指标名称
+     * @param value 指标内容，只替换该项，分区中其他项保持不变
+     * @details 供多个模块共同填写同一分区
+     */
+    void setValue(const std::string& section, const std::string& key, const nlohmann::json& value);
+
+    /**
+     * @brief 获取全部指标的快照
+     * @return 以分区名称为键的JSON对象
+     */
+    nlohmann::json snapshot() const;
+
+private:
+    /**
+     * @brief 私有构造函数
+     */
+    MetricsRegistry();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    MetricsRegistry(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+private:
+    /**
+     * @brief 线程安全互斥锁
+     */
+    mutable QMutex m_mutex;
+
+    /**
+     * @brief 各分区的指标
+     */
+    nlohmann::json m_sections;
+};
+
+/**
+ * @brief 全局指标注册表访问宏
+ */
+#define g_Metrics MetricsRegistry::instance()
+
+#endif // METRICSREGISTRY_H
@@ -0,0 +1,185 @@
+/**
+ * @file MonotonicArena.cpp
+ * @brief 单调分配区实现文件
+ * @details 实现了内存块的申请、指针前移分配和周期回收
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "MonotonicArena.h"
+#include <algorithm>
+#include <new>
+
+/**
+ * @brief 构造函数
+ * @param initialBytes 首个内存块的大小
+ */
+MonotonicArena::MonotonicArena(size_t initialBytes)
+    : m_current(0),
+      m_offset(0),
+      m_retiredBytes(0),
+      m_nextBlockSize(std::max<size_t>(initialBytes, 1024)),
+      m_lastCycleBytes(0),
+      m_highWater(0),
+      m_blockAllocations(0),
+      m_cycleBlockAllocations(0),
+      m_lastCycleBlockAllocations(0)
+{
+}
+
+/**
+ * @brief 析构函数
+ */
+MonotonicArena::~MonotonicArena()
+{
+    releaseBlocks();
+}
+
+/**
+ * @brief 分配内存
+ * @param bytes 字节数
+ * @param alignment 对齐字节数
+ * @return 内存地址
+ */
+void* MonotonicArena::allocate(size_t bytes, size_t alignment)
+{
+    if (!m_blocks.empty()) {
+        const Block& block = m_blocks[m_current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+        const uintptr_t aligned = (base + m_offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        const size_t end = static_cast<size_t>(aligned - base) + bytes;
+        if (end <= block.size) {
+            m_offset = end;
+            return reinterpret_cast<void*>(aligned);
+        }
+    }
+
+    grow(bytes + alignment);
+    const uintptr_t base = reinterpret_cast<uintptr_t>(m_blocks[m_current].data);
+    const uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    m_offset = static_cast<size_t>(aligned - base) + bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+/**
+ * @brief 回收本周期的全部分配
+ */
+void MonotonicArena::reset()
+{
+    m_lastCycleBytes = bytesUsed();
+    m_highWater = std::max(m_highWater, m_lastCycleBytes);
+
+    // 本周期用到了多个块时合并为一个，下个周期起不再需要追加块
+    if (m_blocks.size() > 1) {
+        const size_t total = capacity();
+        releaseBlocks();
+        m_nextBlockSize = total;
+        grow(total);
+    }
+
+    m_current = 0;
+    m_offset = 0;
+    m_retiredBytes = 0;
+    m_lastCycleBlockAllocations = m_cycleBlockAllocations;
+    m_cycleBlockAllocations = 0;
+}
+
+/**
+ * @brief 获取本周期已分配的字节数
+ * @return 字节数
+ */
+size_t MonotonicArena::bytesUsed() const
+{
+    return m_retiredBytes + m_offset;
+}
+
+/**
+ * @brief 获取上一个周期分配的字节数
+ * @return 字节数
+ */
+size_t MonotonicArena::lastCycleBytes() const
+{
+    return m_lastCycleBytes;
+}
+
+/**
+ * @brief 获取单个周期分配字节数的最大值
+ * @return 字节数
+ */
+size_t MonotonicArena::highWater() const
+{
+    return std::max(m_highWater, bytesUsed());
+}
+
+/**
+ * @brief 获取持有的内存块总大小
+ * @return 字节数
+ */
+size_t MonotonicArena::capacity() const
+{
+    size_t total = 0;
+    for (const auto& block : m_blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+/**
+ * @brief 获取累计新增内存块的次数
+ * @return 次数
+ */
+long long MonotonicArena::blockAllocations() const
+{
+    return m_blockAllocations;
+}
+
+/**
+ * @brief 获取上一个周期新增内存块的次数
+ * @return 次数
+ */
+int MonotonicArena::lastCycleBlockAllocations() const
+{
+    return m_lastCycleBlockAllocations;
+}
+
+/**
+ * @brief 申请一个新内存块并设为当前块
+ * @param minBytes 至少需要的字节数
+ */
+void MonotonicArena::grow(size_t minBytes)
+{
+    if (!m_blocks.empty()) {
+        m_retiredBytes += m_offset;
+    }
+
+    // reset()后保留的后续块足够大时直接复用
+    if (m_current + 1 < m_blocks.size() && m_blocks[m_current + 1].size >= minBytes) {
+        m_current++;
+        m_offset = 0;
+        return;
+    }
+
+    Block block;
+    block.size = std::max(minBytes, m_nextBlockSize);
+    block.data = static_cast<char*>(::operator new(block.size));
+    m_blockAllocations++;
+    m_cycleBlockAllocations++;
+    m_nextBlockSize = block.size * 2;
+
+    m_blocks.push_back(block);
+    m_current = m_blocks.size() - 1;
+    m_offset = 0;
+}
+
+/**
+ * @brief 释放全部内存块
+ */
+void MonotonicArena::releaseBlocks()
+{
+    for (const auto& block : m_blocks) {
+        ::operator delete(block.data);
+    }
+    m_blocks.clear();
+    m_current = 0;
+    m_offset = 0;
+}
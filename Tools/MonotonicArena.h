@@ -0,0 +1,383 @@
+/**
+ * @file MonotonicArena.h
+ * @brief 单调分配区头文件
+ * @details 定义了MonotonicArena类及其STL分配器和位集，用于每个处理周期内的临时数据
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef MONOTONICARENA_H
+#define MONOTONICARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 单调分配区类
+ * @details 分配只向前移动指针，释放为空操作，周期结束时调用reset()整体回收。
+ *          内存块在reset()后保留复用；一个周期用到多个块时，reset()把它们合并为一个足够大的块，
+ *          因此负载稳定后每个周期不再向系统申请内存。
+ *          新增内存块的次数被计数，只反映分配区自身是否还在增长，
+ *          不代表使用方的全部堆分配，后者由 AllocationTracker 统计。
+ *          非线程安全，每个分配区只在一个线程中使用
+ */
+class MonotonicArena
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param initialBytes 首个内存块的大小(字节)，首次分配时才申请
+     */
+    explicit MonotonicArena(size_t initialBytes = 64 * 1024);
+
+    /**
+     * @brief 析构函数
+     * @details 释放全部内存块
+     */
+    ~MonotonicArena();
+
+    /**
+     * @brief 分配内存
+     * @param bytes 字节数
+     * @param alignment 对齐字节数(2的幂)
+     * @return 内存地址，在下一次reset()之前有效
+     */
+    void* allocate(size_t bytes, size_t alignment);
+
+    /**
+     * @brief 回收本周期的全部分配
+     * @details 之前分配的内存全部失效，使用它们的容器必须已经销毁
+     */
+    void reset();
+
+    /**
+     * @brief 获取本周期已分配的字节数
+     * @return 字节数(含对齐填充)
+     */
+    size_t bytesUsed() const;
+
+    /**
+     * @brief 获取上一个周期(两次reset之间)分配的字节数
+     * @return 字节数(含对齐填充)
+     */
+    size_t lastCycleBytes() const;
+
+    /**
+     * @brief 获取单个周期分配字节数的最大值
+     * @return 字节数
+     */
+    size_t highWater() const;
+
+    /**
+     * @brief 获取持有的内存块总大小
+     * @return 字节数
+     */
+    size_t capacity() const;
+
+    /**
+     * @brief 获取累计新增内存块的次数
+     * @return 次数
+     */
+    long long blockAllocations() const;
+
+    /**
+     * @brief 获取上一个周期(两次reset之间)新增内存块的次数
+     * @return 次数，负载稳定后为零
+     */
+    int lastCycleBlockAllocations() const;
+
+private:
+    /**
+     * @brief 内存块
+     */
+    struct Block {
+        char* data;     ///< 起始地址
+        size_t size;    ///< 大小(字节)
+    };
+
+    /**
+     * @brief 申请一个新内存块并设为当前块
+     * @param minBytes 至少需要的字节数
+     */
+    void grow(size_t minBytes);
+
+    /**
+     * @brief 释放全部内存块
+     */
+    void releaseBlocks();
+
+private:
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    MonotonicArena(const MonotonicArena&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    /**
+     * @brief 内存块列表
+     */
+    std::vector<Block> m_blocks;
+
+    /**
+     * @brief 当前块索引
+     */
+    size_t m_current;
+
+    /**
+     * @brief 当前块内的已用偏移
+     */
+    size_t m_offset;
+
+    /**
+     * @brief 已用完的块的字节数之和
+     */
+    size_t m_retiredBytes;
+
+    /**
+     * @brief 下一次申请的默认块大小
+     */
+    size_t m_nextBlockSize;
+
+    /**
+     * @brief 上一个周期分配的字节数
+     */
+    size_t m_lastCycleBytes;
+
+    /**
+     * @brief 单个周期分配字节数的最大值
+     */
+    size_t m_highWater;
+
+    /**
+     * @brief 累计新增内存块的次数
+     */
+    long long m_blockAllocations;
+
+    /**
+     * @brief 本周期新增内存块的次数
+     */
+    int m_cycleBlockAllocations;
+
+    /**
+     * @brief 上一个周期新增内存块的次数
+     */
+    int m_lastCycleBlockAllocations;
+};
+
+/**
+ * @brief 单调分配区的STL分配器
+ * @tparam T 元素类型
+ * @details deallocate为空操作，内存随分配区reset()一起回收
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    /**
+     * @brief 构造函数
+     * @param arena 单调分配区
+     */
+    ArenaAllocator(MonotonicArena& arena) : m_arena(&arena) {}
+
+    /**
+     * @brief 其他元素类型分配器的转换构造函数
+     * @param other 其他分配器
+     */
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena()) {}
+
+    /**
+     * @brief 分配n个元素的内存
+     * @param n 元素个数
+     * @return 内存地址
+     */
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief 释放内存(空操作)
+     */
+    void deallocate(T*, size_t) {}
+
+    /**
+     * @brief 获取所属的单调分配区
+     * @return 单调分配区指针
+     */
+    MonotonicArena* arena() const { return m_arena; }
+
+private:
+    /**
+     * @brief 所属的单调分配区
+     */
+    MonotonicArena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() == b.arena(); }
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena() != b.arena(); }
+
+/**
+ * @brief 在单调分配区上分配的vector
+ */
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+/**
+ * @brief 在单调分配区上分配的定长位集
+ * @details 按下标(航迹槽位、观测索引)置位和查询，代替 std::set<int> 和 std::vector<bool>
+ */
+class ArenaBitset
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param size 位数
+     * @param arena 单调分配区
+     */
+    ArenaBitset(size_t size, MonotonicArena& arena)
+        : m_words((size + 63) / 64, 0, arena), m_size(size) {}
+
+    /**
+     * @brief 置位
+     * @param i 下标
+     */
+    void set(size_t i) { m_words[i >> 6] |= (uint64_t(1) << (i & 63)); }
+
+    /**
+     * @brief 查询某一位
+     * @param i 下标
+     * @return 该位是否置位
+     */
+    bool test(size_t i) const { return (m_words[i >> 6] >> (i & 63)) & 1u; }
+
+    /**
+     * @brief 获取位数
+     * @return 位数
+     */
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief 统计置位的个数
+     * @return 置位个数
+     */
+    size_t count() const
+    {
+        size_t total = 0;
+        for (uint64_t word : m_words) {
+            for (; word; word &= word - 1) {
+                total++;
+            }
+        }
+        return total;
+    }
+
+private:
+    /**
+     * @brief 位数据
+     */
+    ArenaVector<uint64_t> m_words;
+
+    /**
+     * @brief 位数
+     */
+    size_t m_size;
+};
+
+/**
+ * @brief 在单调分配区上分配的网格索引
+ * @details 以网格哈希键索引整数值(观测索引、候选索引)的链式哈希表，桶和节点都在分配区上，
+ *          代替每周期 clear() 后重建的 std::unordered_map<long long, std::vector<int>>
+ */
+class ArenaCellIndex
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最多插入的元素个数
+     * @param arena 单调分配区
+     */
+    ArenaCellIndex(size_t capacity, MonotonicArena& arena)
+        : m_heads(bucketCount(capacity), -1, arena), m_entries(ArenaAllocator<Entry>(arena))
+    {
+        m_entries.reserve(capacity);
+    }
+
+    /**
+     * @brief 插入一个值
+     * @param key 网格哈希键
+     * @param value 值
+     */
+    void insert(long long key, int value)
+    {
+        int& head = m_heads[bucket(key)];
+        m_entries.push_back({key, value, head});
+        head = static_cast<int>(m_entries.size()) - 1;
+    }
+
+    /**
+     * @brief 遍历网格内的值
+     * @param key 网格哈希键
+     * @param fn 对每个值调用，返回true时停止遍历
+     * @return fn是否返回过true
+     */
+    template <typename Fn>
+    bool forEach(long long key, Fn fn) const
+    {
+        for (int e = m_heads[bucket(key)]; e >= 0; e = m_entries[e].next) {
+            if (m_entries[e].key == key && fn(m_entries[e].value)) return true;
+        }
+        return false;
+    }
+
+private:
+    /**
+     * @brief 链表节点
+     */
+    struct Entry {
+        long long key;
+        int value;
+        int next;
+    };
+
+    /**
+     * @brief 桶数取不小于两倍容量的2的幂
+     */
+    static size_t bucketCount(size_t capacity)
+    {
+        size_t count = 16;
+        while (count < 2 * capacity) count <<= 1;
+        return count;
+    }
+
+    /**
+     * @brief 键到桶的映射(Fibonacci哈希)
+     */
+    size_t bucket(long long key) const
+    {
+        return static_cast<size_t>((static_cast<unsigned long long>(key) * 0x9E3779B97F4A7C15ULL) >> 32) &
+               (m_heads.size() - 1);
+    }
+
+    /**
+     * @brief 各桶链表头的节点下标，空桶为-1
+     */
+    ArenaVector<int> m_heads;
+
+    /**
+     * @brief 链表节点
+     */
+    ArenaVector<Entry> m_entries;
+};
+
+#endif // MONOTONICARENA_H
@@ -0,0 +1,244 @@
+/**
+ * @file ObserverRegistry.cpp
+ * @brief 观测者统计注册表实现文件
+ * @details 实现了无锁的观测者计数和按统计窗口计算的统计快照
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "ObserverRegistry.h"
+#include "LogManager.h"
+#include <QSettings>
+#include <QDateTime>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[ObserverRegistry::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[ObserverRegistry::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[ObserverRegistry::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[ObserverRegistry::" << __FUNCTION__ << "] " << msg
+
+const int ObserverRegistry::kEmpty = INT_MIN;
+
+
+ObserverRegistry& ObserverRegistry::instance()
+{
+    // C++11 保证了静态局部变量的初始化是线程安全的
+    static ObserverRegistry instance;
+    return instance;
+}
+
+
+ObserverRegistry::ObserverRegistry()
+    : m_overflow(0), m_windowStartMs(QDateTime::currentMSecsSinceEpoch()), m_lastWindowSeconds(0.0)
+{
+    QSettings settings("Server.ini", QSettings::IniFormat);
+    const int requested = std::max(1, settings.value("Observers/capacity", 256).toInt());
+    m_staleAfter = settings.value("Observers/staleAfter", 5.0).toDouble();
+    m_windowMs = std::max(1LL, std::llround(settings.value("Observers/window", 1.0).toDouble() * 1000.0));
+
+    size_t capacity = 1;
+    while (capacity < static_cast<size_t>(requested)) {
+        capacity <<= 1;
+    }
+    m_mask = capacity - 1;
+
+    m_slots.reset(new Slot[capacity]);
+    m_windows.reset(new Window[capacity]);
+    for (size_t i = 0; i < capacity; ++i) {
+        Slot& s = m_slots[i];
+        s.observerId.store(kEmpty, std::memory_order_relaxed);
+        s.messages.store(0, std::memory_order_relaxed);
+        s.dropped.store(0, std::memory_order_relaxed);
+        s.latencySamples.store(0, std::memory_order_relaxed);
+        s.latencyMicros.store(0, std::memory_order_relaxed);
+        s.latencyMaxMicros.store(0, std::memory_order_relaxed);
+        s.measurements.store(0, std::memory_order_relaxed);
+        s.associated.store(0, std::memory_order_relaxed);
+        s.innovationMicros.store(0, std::memory_order_relaxed);
+        s.lastSeenMs.store(0, std::memory_order_relaxed);
+    }
+
+    LOG_INFO("观测者统计槽位数: " + QString::number(capacity) +
+             "，统计窗口: " + QString::number(m_windowMs / 1000.0) + "秒" +
+             "，失联判定: " + QString::number(m_staleAfter) + "秒");
+}
+
+
+ObserverRegistry::Slot* ObserverRegistry::slot(int observerId)
+{
+    // 乘法散列后线性探测，槽位一旦被占用不再释放，查找无需加锁
+    size_t index = (static_cast<uint32_t>(observerId) * 2654435761u) & m_mask;
+    for (size_t probe = 0; probe <= m_mask; ++probe, index = (index + 1) & m_mask) {
+        Slot& s = m_slots[index];
+        int current = s.observerId.load(std::memory_order_acquire);
+        if (current == observerId) {
+            return &s;
+        }
+        if (current == kEmpty) {
+            if (s.observerId.compare_exchange_strong(current, observerId, std::memory_order_acq_rel)) {
+                return &s;
+            }
+            // 其他线程抢先占用了该槽位，可能正是同一观测者
+            if (current == observerId) {
+                return &s;
+            }
+        }
+    }
+    m_overflow.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+
+void ObserverRegistry::recordMessage(int observerId)
+{
+    if (Slot* s = slot(observerId)) {
+        s->messages.fetch_add(1, std::memory_order_relaxed);
+        s->lastSeenMs.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+    }
+}
+
+
+void ObserverRegistry::recordDropped(int observerId)
+{
+    if (Slot* s = slot(observerId)) {
+        s->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+void ObserverRegistry::recordLatency(int observerId, double seconds)
+{
+    if (Slot* s = slot(observerId)) {
+        const long long micros = std::llround(std::max(0.0, seconds) * 1e6);
+        s->latencySamples.fetch_add(1, std::memory_order_relaxed);
+        s->latencyMicros.fetch_add(micros, std::memory_order_relaxed);
+        long long previous = s->latencyMaxMicros.load(std::memory_order_relaxed);
+        while (micros > previous &&
+               !s->latencyMaxMicros.compare_exchange_weak(previous, micros, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+
+void ObserverRegistry::recordMeasurement(int observerId)
+{
+    if (Slot* s = slot(observerId)) {
+        s->measurements.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+void ObserverRegistry::recordAssociation(int observerId, double innovation)
+{
+    if (Slot* s = slot(observerId)) {
+        s->associated.fetch_add(1, std::memory_order_relaxed);
+        s->innovationMicros.fetch_add(std::llround(std::max(0.0, innovation) * 1e6), std::memory_order_relaxed);
+    }
+}
+
+
+void ObserverRegistry::endCycle()
+{
+    const long long nowMs = QDateTime::currentMSecsSinceEpoch();
+    QMutexLocker locker(&m_windowMutex);
+    if (nowMs - m_windowStartMs < m_windowMs) {
+        return;
+    }
+    const double elapsed = (nowMs - m_windowStartMs) / 1000.0;
+    m_windowStartMs = nowMs;
+    m_lastWindowSeconds = elapsed;
+
+    for (size_t i = 0; i <= m_mask; ++i) {
+        Slot& s = m_slots[i];
+        if (s.observerId.load(std::memory_order_acquire) == kEmpty) {
+            continue;
+        }
+
+        Counts now;
+        now.messages = s.messages.load(std::memory_order_relaxed);
+        now.dropped = s.dropped.load(std::memory_order_relaxed);
+        now.latencySamples = s.latencySamples.load(std::memory_order_relaxed);
+        now.latencyMicros = s.latencyMicros.load(std::memory_order_relaxed);
+        now.measurements = s.measurements.load(std::memory_order_relaxed);
+        now.associated = s.associated.load(std::memory_order_relaxed);
+        now.innovationMicros = s.innovationMicros.load(std::memory_order_relaxed);
+        // 只有窗口滚动时清零最大时延，读取快照不改变它
+        const long long latencyMax = s.latencyMaxMicros.exchange(0, std::memory_order_relaxed);
+
+        Window& window = m_windows[i];
+        const Counts& before = window.start;
+        const long long latencySamples = now.latencySamples - before.latencySamples;
+        const long long measurements = now.measurements - before.measurements;
+        const long long associated = now.associated - before.associated;
+
+        window.messageRate = (now.messages - before.messages) / elapsed;
+        window.measurementRate = measurements / elapsed;
+        window.dropRate = (now.dropped - before.dropped) / elapsed;
+        window.latencyMean = latencySamples > 0 ?
+                    (now.latencyMicros - before.latencyMicros) / 1e6 / latencySamples : 0.0;
+        window.latencyMax = latencyMax / 1e6;
+        window.associationRatio = measurements > 0 ? static_cast<double>(associated) / measurements : 0.0;
+        window.meanInnovation = associated > 0 ?
+                    (now.innovationMicros - before.innovationMicros) / 1e6 / associated : 0.0;
+        window.start = now;
+    }
+}
+
+
+nlohmann::json ObserverRegistry::snapshot() const
+{
+    const long long nowMs = QDateTime::currentMSecsSinceEpoch();
+    QMutexLocker locker(&m_windowMutex);
+
+    std::vector<nlohmann::json> observers;
+    for (size_t i = 0; i <= m_mask; ++i) {
+        const Slot& s = m_slots[i];
+        const int observerId = s.observerId.load(std::memory_order_acquire);
+        if (observerId == kEmpty) {
+            continue;
+        }
+        const Window& window = m_windows[i];
+        const long long lastSeenMs = s.lastSeenMs.load(std::memory_order_relaxed);
+
+        nlohmann::json item;
+        item["observerId"] = observerId;
+        item["messages"] = s.messages.load(std::memory_order_relaxed);
+        item["measurements"] = s.measurements.load(std::memory_order_relaxed);
+        item["associated"] = s.associated.load(std::memory_order_relaxed);
+        item["dropped"] = s.dropped.load(std::memory_order_relaxed);
+        item["messageRate"] = window.messageRate;
+        item["measurementRate"] = window.measurementRate;
+        item["dropRate"] = window.dropRate;
+        item["latencyMean"] = window.latencyMean;
+        item["latencyMax"] = window.latencyMax;
+        item["associationRatio"] = window.associationRatio;
+        item["meanInnovation"] = window.meanInnovation;
+        // 处理阶段生成的观测(如交叉定位伪观测)可能使用未发送过消息的观测者ID，不判定失联
+        if (lastSeenMs > 0) {
+            const double age = (nowMs - lastSeenMs) / 1000.0;
+            item["lastSeenAge"] = age;
+            item["stale"] = age > m_staleAfter;
+        } else {
+            item["lastSeenAge"] = nullptr;
+            item["stale"] = false;
+        }
+        observers.push_back(item);
+    }
+
+    std::sort(observers.begin(), observers.end(), [](const nlohmann::json& a, const nlohmann::json& b) {
+        return a["observerId"].get<int>() < b["observerId"].get<int>();
+    });
+
+    nlohmann::json result;
+    result["timestamp"] = QDateTime::fromMSecsSinceEpoch(nowMs).toUTC().toString(Qt::ISODate).toStdString();
+    result["interval"] = m_lastWindowSeconds;
+    result["capacity"] = m_mask + 1;
+    result["overflow"] = m_overflow.load(std::memory_order_relaxed);
+    result["observers"] = observers;
+    return result;
+}
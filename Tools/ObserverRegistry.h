@@ -0,0 +1,209 @@
+/**
+ * @file ObserverRegistry.h
+ * @brief 观测者统计注册表头文件
+ * @details 定义了ObserverRegistry类，按观测者ID统计各传感器的吞吐、时延和关联质量
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef OBSERVERREGISTRY_H
+#define OBSERVERREGISTRY_H
+
+#include <QMutex>
+#include <atomic>
+#include <memory>
+#include "nlohmann/json.hpp"
+
+/**
+ * @brief 观测者统计注册表类
+ * @details 接收和处理路径上的计数全部为原子操作，不加锁:
+ *          观测者槽位是定长的开放寻址表，新观测者以CAS占用空槽，此后只做原子累加；
+ *          表满后新观测者不再单独统计，只计入溢出数。
+ *          速率、平均时延、最大时延、关联率和平均新息按统计窗口计算: 工作线程每周期结束时调用endCycle()，
+ *          距上一次滚动达到窗口时长时由计数增量算出上一个窗口的统计值；
+ *          健康检查服务器在自己的线程中读取快照，快照只读取最近一个完整窗口的结果，
+ *          多个调用方、任意的读取频率都得到相同的统计值。窗口结果由互斥锁保护，不影响写入路径。
+ *          使用单例模式确保全局只有一个注册表实例
+ */
+class ObserverRegistry
+{
+public:
+    /**
+     * @brief 获取观测者统计注册表单例实例
+     * @return 注册表实例的引用
+     */
+    static ObserverRegistry& instance();
+
+    /**
+     * @brief 记录收到一条观测消息
+     * @param observerId 观测者ID
+     */
+    void recordMessage(int observerId);
+
+    /**
+     * @brief 记录一条因缓冲区已满被丢弃的观测
+     * @param observerId 观测者ID
+     */
+    void recordDropped(int observerId);
+
+    /**
+     * @brief 记录一条观测从接收到进入处理周期的时延
+     * @param observerId 观测者ID
+     * @param seconds 时延(秒)
+     */
+    void recordLatency(int observerId, double seconds);
+
+    /**
+     * @brief 记录一条进入数据关联的观测
+     * @param observerId 观测者ID
+     */
+    void recordMeasurement(int observerId);
+
+    /**
+     * @brief 记录一条关联到航迹的观测
+     * @param observerId 观测者ID
+     * @param innovation 观测位置与航迹预测位置的距离(米)
+     */
+    void recordAssociation(int observerId, double innovation);
+
+    /**
+     * @brief 结束一个处理周期
+     * @details 由工作线程每周期调用一次，距上一次滚动达到统计窗口时长时滚动窗口，
+     *          不分配内存
+     */
+    void endCycle();
+
+    /**
+     * @brief 获取所有观测者的统计快照
+     * @return JSON对象，observers 为按观测者ID排序的数组，速率等统计值取自最近一个完整窗口
+     * @details 只读取，不改变任何计数和窗口状态
+     */
+    nlohmann::json snapshot() const;
+
+private:
+    /**
+     * @brief 单个观测者的计数槽位
+     * @details 时延和新息以微秒、微米为单位的整数累加
+     */
+    struct Slot {
+        std::atomic<int> observerId;                ///< 观测者ID，空槽为kEmpty
+        std::atomic<long long> messages;            ///< 收到的消息数
+        std::atomic<long long> dropped;             ///< 丢弃的观测数
+        std::atomic<long long> latencySamples;      ///< 时延样本数
+        std::atomic<long long> latencyMicros;       ///< 时延之和(微秒)
+        std::atomic<long long> latencyMaxMicros;    ///< 当前窗口内的最大时延(微秒)
+        std::atomic<long long> measurements;        ///< 进入数据关联的观测数
+        std::atomic<long long> associated;          ///< 关联到航迹的观测数
+        std::atomic<long long> innovationMicros;    ///< 新息距离之和(微米)
+        std::atomic<long long> lastSeenMs;          ///< 最近一条消息的接收时刻(UTC毫秒)
+    };
+
+    /**
+     * @brief 窗口开始时的计数
+     */
+    struct Counts {
+        long long messages = 0;
+        long long dropped = 0;
+        long long latencySamples = 0;
+        long long latencyMicros = 0;
+        long long measurements = 0;
+        long long associated = 0;
+        long long innovationMicros = 0;
+    };
+
+    /**
+     * @brief 单个观测者的窗口统计，与槽位一一对应
+     */
+    struct Window {
+        Counts start;                   ///< 当前窗口开始时的计数
+        double messageRate = 0.0;       ///< 上一个窗口的消息速率(条/秒)
+        double measurementRate = 0.0;   ///< 上一个窗口的观测速率(条/秒)
+        double dropRate = 0.0;          ///< 上一个窗口的丢弃速率(条/秒)
+        double latencyMean = 0.0;       ///< 上一个窗口的平均时延(秒)
+        double latencyMax = 0.0;        ///< 上一个窗口的最大时延(秒)
+        double associationRatio = 0.0;  ///< 上一个窗口的关联率
+        double meanInnovation = 0.0;    ///< 上一个窗口的平均新息距离(米)
+    };
+
+    /**
+     * @brief 私有构造函数
+     * @details 从配置文件 Observers 分组读取槽位数、统计窗口时长和失联判定时间
+     */
+    ObserverRegistry();
+
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    ObserverRegistry(const ObserverRegistry&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    ObserverRegistry& operator=(const ObserverRegistry&) = delete;
+
+    /**
+     * @brief 查找或占用观测者的槽位
+     * @param observerId 观测者ID
+     * @return 槽位指针，表满时返回nullptr
+     */
+    Slot* slot(int observerId);
+
+private:
+    /**
+     * @brief 空槽的观测者ID
+     */
+    static const int kEmpty;
+
+    /**
+     * @brief 槽位数组，长度为2的幂
+     */
+    std::unique_ptr<Slot[]> m_slots;
+
+    /**
+     * @brief 槽位数减一，用于取模
+     */
+    size_t m_mask;
+
+    /**
+     * @brief 表满后未能单独统计的事件数
+     */
+    std::atomic<long long> m_overflow;
+
+    /**
+     * @brief 超过此时长(秒)未收到消息的观测者标记为失联
+     */
+    double m_staleAfter;
+
+    /**
+     * @brief 统计窗口时长(毫秒)
+     */
+    long long m_windowMs;
+
+    /**
+     * @brief 窗口结果互斥锁
+     * @details 保护窗口数组和窗口时刻，滚动窗口和读取快照时持有
+     */
+    mutable QMutex m_windowMutex;
+
+    /**
+     * @brief 窗口统计数组，与槽位数组下标一致
+     */
+    std::unique_ptr<Window[]> m_windows;
+
+    /**
+     * @brief 当前窗口的开始时刻(UTC毫秒)
+     */
+    long long m_windowStartMs;
+
+    /**
+     * @brief 上一个完整窗口的时长(秒)，尚无完整窗口时为0
+     */
+    double m_lastWindowSeconds;
+};
+
+/**
+ * @brief 全局观测者统计注册表访问宏
+ */
+#define g_Observers ObserverRegistry::instance()
+
+#endif // OBSERVERREGISTRY_H
@@ -0,0 +1,143 @@
+/**
+ * @file SharedTrackLayout.h
+ * @brief 共享内存航迹表布局头文件
+ * @details 定义了共享内存航迹表的二进制布局: 表头和定长槽位，写端与读端共用。
+ *          本文件只依赖标准库，可直接提供给其他进程使用
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef SHAREDTRACKLAYOUT_H
+#define SHAREDTRACKLAYOUT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief 共享内存航迹表布局常量
+ */
+namespace SharedTrackLayout {
+
+/**
+ * @brief 表头魔数，ASCII "MTTS"
+ */
+const uint32_t kMagic = 0x5354544D;
+
+/**
+ * @brief 布局版本，布局有任何变化时递增
+ */
+const uint32_t kVersion = 3;
+
+/**
+ * @brief 运动模型名称的最大长度(含结尾的'\0')
+ */
+const int kModelNameLength = 8;
+
+/**
+ * @brief 坐标系: 基准东北天坐标系
+ */
+const uint32_t kFrameEnu = 0;
+
+/**
+ * @brief 坐标系: 地心地固坐标系(ECEF)
+ */
+const uint32_t kFrameEcef = 1;
+
+} // namespace SharedTrackLayout
+
+/**
+ * @brief 槽位中的航迹数据
+ * @details 平凡可复制，读端整体拷贝后使用。位置、速度等均为发布坐标系坐标(见表头 frame)，
+ *          协方差按 [p, v, a] 9维行优先存放，匀速模型航迹的加速度部分为零
+ */
+struct SharedTrackRecord {
+    int32_t id;                                             ///< 航迹ID，空槽位时无意义
+    int32_t hits;                                           ///< 命中次数
+    int32_t stateDim;                                       ///< 滤波状态维数，6为匀速、9为匀加速/IMM
+    char model[SharedTrackLayout::kModelNameLength];        ///< 运动模型名称
+    int32_t occupied;                                       ///< 槽位是否有航迹，0为空槽位(航迹ID可以为0)
+    uint64_t sequence;                                      ///< 写入该槽位时的快照序号
+    double timestamp;                                       ///< 航迹状态对应的时间戳(秒)
+    double position[3];                                     ///< 位置
+    double velocity[3];                                     ///< 速度
+    double acceleration[3];                                 ///< 加速度
+    double extent[3];                                       ///< 外形尺寸
+    double covariance[81];                                  ///< [p, v, a] 协方差，行优先
+};
+
+/**
+ * @brief 航迹表槽位
+ * @details 每个槽位有独立的顺序锁: 写端写入前后各将 seq 加一，奇数表示正在写入；
+ *          读端在拷贝前后读取 seq，两次相同且为偶数时拷贝有效。
+ *          一条航迹存续期间固定占用同一槽位；[0, slotsInUse) 内的空槽位每次发布也会重写，
+ *          因此该范围内全部槽位的 record.sequence 均与表头一致
+ */
+struct alignas(64) SharedTrackSlot {
+    std::atomic<uint64_t> seq;      ///< 槽位顺序锁
+    SharedTrackRecord record;       ///< 航迹数据
+};
+
+/**
+ * @brief 航迹表表头
+ * @details 魔数、版本和尺寸字段在初始化后不变，读端据此校验布局；
+ *          其余字段描述最近一次发布，由表头顺序锁保护
+ */
+struct alignas(64) SharedTrackHeader {
+    uint32_t magic;                 ///< 魔数，初始化完成后最后写入
+    uint32_t version;               ///< 布局版本
+    uint32_t headerSize;            ///< 表头字节数
+    uint32_t slotSize;              ///< 槽位字节数
+    uint32_t capacity;              ///< 槽位数
+    uint32_t frame;                 ///< 坐标系，kFrameEnu 或 kFrameEcef，每次发布时写入，运行期间不变
+    std::atomic<uint64_t> seq;      ///< 表头顺序锁
+    uint64_t sequence;              ///< 最近发布的快照序号
+    double timestamp;               ///< 最近发布的航迹时间戳(秒)
+    int64_t publishTimeMs;          ///< 最近发布的系统时间(毫秒，UTC)
+    uint32_t slotsInUse;            ///< 已用槽位上界，读端只需扫描 [0, slotsInUse)
+    uint32_t trackCount;            ///< 航迹数
+    uint64_t overflow;              ///< 因槽位不足而未写入的航迹累计数
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared memory seqlock requires lock-free 64-bit atomics");
+static_assert(std::is_trivially_copyable<SharedTrackRecord>::value, "SharedTrackRecord must be trivially copyable");
+static_assert(sizeof(SharedTrackHeader) % 64 == 0 && sizeof(SharedTrackSlot) % 64 == 0, "layout must be cache-line aligned");
+
+namespace SharedTrackLayout {
+
+/**
+ * @brief 计算航迹表所需的字节数
+ * @param capacity 槽位数
+ * @return 字节数
+ */
+inline size_t segmentSize(uint32_t capacity)
+{
+    return sizeof(SharedTrackHeader) + static_cast<size_t>(capacity) * sizeof(SharedTrackSlot);
+}
+
+/**
+ * @brief 取得第 index 个槽位
+ * @param header 表头，即共享内存起始地址
+ * @param index 槽位下标
+ * @return 槽位指针
+ */
+inline SharedTrackSlot* slotAt(SharedTrackHeader* header, uint32_t index)
+{
+    return reinterpret_cast<SharedTrackSlot*>(reinterpret_cast<char*>(header) + sizeof(SharedTrackHeader)) + index;
+}
+
+/**
+ * @brief 取得第 index 个槽位(只读)
+ * @param header 表头，即共享内存起始地址
+ * @param index 槽位下标
+ * @return 槽位指针
+ */
+inline const SharedTrackSlot* slotAt(const SharedTrackHeader* header, uint32_t index)
+{
+    return reinterpret_cast<const SharedTrackSlot*>(reinterpret_cast<const char*>(header) + sizeof(SharedTrackHeader)) + index;
+}
+
+} // namespace SharedTrackLayout
+
+#endif // SHAREDTRACKLAYOUT_H
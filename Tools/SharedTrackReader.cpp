@@ -0,0 +1,215 @@
+/**
+ * @file SharedTrackReader.cpp
+ * @brief 共享内存航迹表读端实现文件
+ * @details 实现了共享内存的附着校验和顺序锁读取
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "SharedTrackReader.h"
+#include "LogManager.h"
+#include <cstring>
+
+// 定义统一的日志宏
+#define LOG_DEBUG(msg) qDebug() << "[SharedTrackReader::" << __FUNCTION__ << "] " << msg
+#define LOG_INFO(msg) qInfo() << "[SharedTrackReader::" << __FUNCTION__ << "] " << msg
+#define LOG_WARN(msg) qWarning() << "[SharedTrackReader::" << __FUNCTION__ << "] " << msg
+#define LOG_ERROR(msg) qCritical() << "[SharedTrackReader::" << __FUNCTION__ << "] " << msg
+
+
+SharedTrackReader::SharedTrackReader(const QString& key, int maxRetries)
+    : m_memory(key), m_header(nullptr), m_capacity(0), m_maxRetries(maxRetries)
+{
+}
+
+
+SharedTrackReader::~SharedTrackReader()
+{
+    detach();
+}
+
+
+bool SharedTrackReader::attach()
+{
+    if (m_header) {
+        return true;
+    }
+    if (!m_memory.attach(QSharedMemory::ReadOnly)) {
+        LOG_WARN("无法附着共享内存 " + m_memory.key() + ": " + m_memory.errorString());
+        return false;
+    }
+
+    const SharedTrackHeader* header = static_cast<const SharedTrackHeader*>(m_memory.constData());
+    const bool valid = static_cast<size_t>(m_memory.size()) >= sizeof(SharedTrackHeader) &&
+            header->magic == SharedTrackLayout::kMagic &&
+            header->version == SharedTrackLayout::kVersion &&
+            header->headerSize == sizeof(SharedTrackHeader) &&
+            header->slotSize == sizeof(SharedTrackSlot) &&
+            static_cast<size_t>(m_memory.size()) >= SharedTrackLayout::segmentSize(header->capacity);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid) {
+        LOG_WARN("共享内存 " + m_memory.key() + " 布局不匹配或尚未初始化");
+        m_memory.detach();
+        return false;
+    }
+
+    m_header = header;
+    m_capacity = header->capacity;
+    m_slotHint.clear();
+    return true;
+}
+
+
+void SharedTrackReader::detach()
+{
+    m_header = nullptr;
+    m_slotHint.clear();
+    if (m_memory.isAttached()) {
+        m_memory.detach();
+    }
+}
+
+
+bool SharedTrackReader::isAttached() const
+{
+    return m_header != nullptr;
+}
+
+
+bool SharedTrackReader::readInfo(TableInfo& info) const
+{
+    if (!m_header) {
+        return false;
+    }
+    for (int attempt = 0; attempt <= m_maxRetries; ++attempt) {
+        const uint64_t before = m_header->seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        info.sequence = m_header->sequence;
+        info.timestamp = m_header->timestamp;
+        info.publishTimeMs = m_header->publishTimeMs;
+        info.slotsInUse = m_header->slotsInUse;
+        info.trackCount = m_header->trackCount;
+        info.overflow = m_header->overflow;
+        info.frame = m_header->frame;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_header->seq.load(std::memory_order_relaxed) == before) {
+            // 写端重新初始化期间表头不可信，槽位上界不得超过附着时校验过的容量
+            return info.slotsInUse <= m_capacity;
+        }
+    }
+    return false;
+}
+
+
+bool SharedTrackReader::readSlot(uint32_t index, SharedTrackRecord& record) const
+{
+    const SharedTrackSlot* slot = SharedTrackLayout::slotAt(m_header, index);
+    const uint64_t before = slot->seq.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+    std::memcpy(&record, &slot->record, sizeof(SharedTrackRecord));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->seq.load(std::memory_order_relaxed) == before;
+}
+
+
+bool SharedTrackReader::readSlotId(uint32_t index, int32_t& id, bool& occupied) const
+{
+    const SharedTrackSlot* slot = SharedTrackLayout::slotAt(m_header, index);
+    const uint64_t before = slot->seq.load(std::memory_order_acquire);
+    if (before & 1) {
+        return false;
+    }
+    int32_t flag = 0;
+    std::memcpy(&id, &slot->record.id, sizeof(id));
+    std::memcpy(&flag, &slot->record.occupied, sizeof(flag));
+    occupied = flag != 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->seq.load(std::memory_order_relaxed) == before;
+}
+
+
+bool SharedTrackReader::readTable(std::vector<SharedTrackRecord>& records, TableInfo& info) const
+{
+    if (!m_header) {
+        return false;
+    }
+
+    // 表头在全部槽位写完之后更新，槽位的快照序号均与表头一致时整表属于同一周期
+    SharedTrackRecord record;
+    for (int attempt = 0; attempt <= m_maxRetries; ++attempt) {
+        if (!readInfo(info)) {
+            return false;
+        }
+        records.clear();
+        records.reserve(info.trackCount);
+        bool consistent = true;
+        for (uint32_t i = 0; i < info.slotsInUse && consistent; ++i) {
+            int retries = 0;
+            while (!readSlot(i, record)) {
+                if (++retries > m_maxRetries) {
+                    return false;
+                }
+            }
+            if (record.sequence != info.sequence) {
+                consistent = false;
+            } else if (record.occupied) {
+                records.push_back(record);
+            }
+        }
+        if (consistent) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool SharedTrackReader::readTrack(int id, SharedTrackRecord& record)
+{
+    if (!m_header) {
+        return false;
+    }
+
+    auto hint = m_slotHint.find(id);
+    if (hint != m_slotHint.end()) {
+        for (int attempt = 0; attempt <= m_maxRetries; ++attempt) {
+            if (readSlot(hint->second, record)) {
+                if (record.occupied && record.id == id) {
+                    return true;
+                }
+                break;
+            }
+        }
+        m_slotHint.erase(hint);
+    }
+
+    TableInfo info;
+    if (!readInfo(info)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < info.slotsInUse; ++i) {
+        int32_t slotId = 0;
+        bool occupied = false;
+        int retries = 0;
+        while (!readSlotId(i, slotId, occupied)) {
+            if (++retries > m_maxRetries) {
+                return false;
+            }
+        }
+        if (!occupied || slotId != id) {
+            continue;
+        }
+        for (int attempt = 0; attempt <= m_maxRetries; ++attempt) {
+            if (readSlot(i, record) && record.occupied && record.id == id) {
+                m_slotHint[id] = i;
+                return true;
+            }
+        }
+        return false;
+    }
+    return false;
+}
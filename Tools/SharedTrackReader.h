@@ -0,0 +1,150 @@
+/**
+ * @file SharedTrackReader.h
+ * @brief 共享内存航迹表读端头文件
+ * @details 定义了SharedTrackReader类，供本机其他进程附着到航迹表并读取最新航迹
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef SHAREDTRACKREADER_H
+#define SHAREDTRACKREADER_H
+
+#include "SharedTrackLayout.h"
+#include <QSharedMemory>
+#include <QString>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 共享内存航迹表读端类
+ * @details 以只读方式附着到写端创建的共享内存，附着后读取不经过系统调用:
+ *          readTable() 读取同一快照序号下的完整航迹表，readTrack() 读取单条航迹。
+ *          读取与写端并发进行，槽位或表头在拷贝期间被改写时自动重读，
+ *          重读次数超过上限(写端连续发布)时返回false。
+ *          每个线程应使用各自的读端实例
+ */
+class SharedTrackReader
+{
+public:
+    /**
+     * @brief 表头中描述最近一次发布的字段
+     */
+    struct TableInfo {
+        uint64_t sequence = 0;          ///< 快照序号，尚未发布时为0
+        double timestamp = 0.0;         ///< 航迹时间戳(秒)
+        int64_t publishTimeMs = 0;      ///< 发布时的系统时间(毫秒，UTC)
+        uint32_t slotsInUse = 0;        ///< 已用槽位上界
+        uint32_t trackCount = 0;        ///< 航迹数
+        uint64_t overflow = 0;          ///< 因槽位不足而未写入的航迹累计数
+        uint32_t frame = 0;             ///< 坐标系，SharedTrackLayout::kFrameEnu 或 kFrameEcef
+    };
+
+    /**
+     * @brief 构造函数
+     * @param key 共享内存键名，与写端配置 SharedMemory/key 一致
+     * @param maxRetries 单次读取的最大重读次数
+     */
+    explicit SharedTrackReader(const QString& key = "MultiTargetTracker.tracks", int maxRetries = 64);
+
+    /**
+     * @brief 析构函数
+     */
+    ~SharedTrackReader();
+
+    /**
+     * @brief 附着到共享内存
+     * @return 附着成功且布局魔数、版本和尺寸均匹配时返回true
+     */
+    bool attach();
+
+    /**
+     * @brief 分离共享内存
+     */
+    void detach();
+
+    /**
+     * @brief 是否已附着
+     * @return 已附着返回true
+     */
+    bool isAttached() const;
+
+    /**
+     * @brief 读取表头
+     * @param info 输出，表头信息
+     * @return 成功返回true
+     */
+    bool readInfo(TableInfo& info) const;
+
+    /**
+     * @brief 读取完整航迹表
+     * @param records 输出，航迹数据，按槽位顺序
+     * @param info 输出，对应的表头信息
+     * @return 成功返回true，此时全部航迹属于同一快照序号
+     */
+    bool readTable(std::vector<SharedTrackRecord>& records, TableInfo& info) const;
+
+    /**
+     * @brief 读取单条航迹
+     * @param id 航迹ID
+     * @param record 输出，航迹数据
+     * @return 找到返回true
+     * @details 优先检查上次找到该航迹的槽位，航迹存续期间槽位不变，通常无需扫描
+     */
+    bool readTrack(int id, SharedTrackRecord& record);
+
+private:
+    /**
+     * @brief 禁用拷贝构造函数
+     */
+    SharedTrackReader(const SharedTrackReader&) = delete;
+
+    /**
+     * @brief 禁用赋值操作符
+     */
+    SharedTrackReader& operator=(const SharedTrackReader&) = delete;
+
+    /**
+     * @brief 在顺序锁保护下拷贝槽位
+     * @param index 槽位下标
+     * @param record 输出，航迹数据
+     * @return 拷贝一致返回true
+     */
+    bool readSlot(uint32_t index, SharedTrackRecord& record) const;
+
+    /**
+     * @brief 在顺序锁保护下读取槽位中的航迹ID
+     * @param index 槽位下标
+     * @param id 输出，航迹ID
+     * @param occupied 输出，槽位是否有航迹
+     * @return 读取一致返回true
+     */
+    bool readSlotId(uint32_t index, int32_t& id, bool& occupied) const;
+
+private:
+    /**
+     * @brief 共享内存对象
+     */
+    QSharedMemory m_memory;
+
+    /**
+     * @brief 表头，即共享内存起始地址
+     */
+    const SharedTrackHeader* m_header;
+
+    /**
+     * @brief 附着时校验过的槽位数
+     */
+    uint32_t m_capacity;
+
+    /**
+     * @brief 最大重读次数
+     */
+    int m_maxRetries;
+
+    /**
+     * @brief 航迹ID到上次所在槽位的缓存
+     */
+    std::unordered_map<int, uint32_t> m_slotHint;
+};
+
+#endif // SHAREDTRACKREADER_H
@@ -0,0 +1,13 @@
+include(../bench.pri)
+
+TARGET = AllocationBench
+
+# 统计 operator new，并在检查的代码段内禁止Eigen分配堆内存；Eigen的检查通过断言报告，因此不定义NDEBUG
+DEFINES += MTT_ALLOCATION_TRACKING EIGEN_RUNTIME_NO_MALLOC
+DEFINES -= NDEBUG
+
+SOURCES += main.cpp \
+    $$ROOT/Tools/AllocationTracker.cpp
+
+HEADERS += \
+    $$ROOT/Tools/AllocationTracker.h
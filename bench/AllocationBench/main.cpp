@@ -0,0 +1,491 @@
+/**
+ * @file main.cpp
+ * @brief 稳态堆内存分配检查程序
+ * @details 检查滤波和跟踪周期在预热之后不再分配堆内存。
+ *          以 EIGEN_RUNTIME_NO_MALLOC 编译，预热后在被检查的代码段内禁止Eigen分配堆内存，一旦分配即断言失败并指出位置；
+ *          同时以 MTT_ALLOCATION_TRACKING 编译，统计同一代码段内 operator new 的次数。
+ *          依次检查:
+ *          1. 立方卡尔曼滤波在匀速、匀加速模型下的预测和堆叠更新，观测分别为两个笛卡尔传感器(线性更新)、
+ *             含径向速度的球坐标传感器加笛卡尔传感器(立方点更新)、四部球坐标传感器(超过单次堆叠上限，分组更新)；
+ *          2. 交互式多模型滤波的预测和更新，观测分别为两个笛卡尔传感器(融合后位置更新)和球坐标加笛卡尔传感器(堆叠更新)；
+ *          3. 航迹在匀速、匀加速、交互式多模型、CV/CA自动切换和单精度滤波下的预测和多观测联合更新；
+ *          4. 按工作线程的阶段顺序执行完整的处理周期，以AllocationTracker按阶段采样，
+ *             检查 lastCycleAllocations() 为零、zeroAllocationStreak() 连续递增。
+ *          任一检查在预热后出现 operator new 分配时返回1。
+ *          用法: AllocationBench [目标数=50] [周期数=200]
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "CKF.h"
+#include "ImmFilter.h"
+#include "Track.h"
+#include "TrackManager.h"
+#include "ConstantVelocityModel.h"
+#include "ConstantAccelerationModel.h"
+#include "CartesianMeasurementModel.h"
+#include "SphericalMeasurementModel.h"
+#include "ClockOffsetEstimator.h"
+#include "GeodeticFrame.h"
+#include "SensorRegistry.h"
+#include "BearingTriangulator.h"
+#include "PointCloudClusterer.h"
+#include "MeasurementCoalescer.h"
+#include "TrackSnapshotStore.h"
+#include "ObserverRegistry.h"
+#include "AllocationTracker.h"
+#include "BenchUtils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 周期(秒)
+ */
+const double kDt = 0.1;
+
+/**
+ * @brief 不计入检查的预热步数，缓冲区在此期间增长到稳态大小
+ */
+const int kWarmupSteps = 10;
+
+/**
+ * @brief 笛卡尔观测噪声标准差(米)
+ */
+const double kCartesianStd = 2.0;
+
+/**
+ * @brief 允许或禁止Eigen分配堆内存
+ * @param allowed 是否允许
+ * @details 未定义 EIGEN_RUNTIME_NO_MALLOC 时不做检查
+ */
+void setEigenMallocAllowed(bool allowed)
+{
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+    Eigen::internal::set_is_malloc_allowed(allowed);
+#else
+    (void)allowed;
+#endif
+}
+
+/**
+ * @brief 匀速运动的目标真值
+ */
+struct Target {
+    Vector3 position;   ///< 位置
+    Vector3 velocity;   ///< 速度
+};
+
+/**
+ * @brief 观测的传感器
+ */
+struct Sensors {
+    CartesianMeasurementModel cartesian;                ///< 笛卡尔传感器
+    std::vector<SphericalMeasurementModel> radars;      ///< 含径向速度的球坐标传感器
+    ObservationVector radarStd;                         ///< 球坐标观测噪声标准差
+
+    Sensors() : radarStd(4)
+    {
+        const Eigen::Matrix3d orientation = Eigen::Matrix3d::Identity();
+        radars.emplace_back(Vector3(-20000.0, 0.0, 0.0), orientation, true);
+        radars.emplace_back(Vector3(20000.0, 0.0, 0.0), orientation, true);
+        radars.emplace_back(Vector3(0.0, -20000.0, 0.0), orientation, true);
+        radars.emplace_back(Vector3(0.0, 20000.0, 0.0), orientation, true);
+        radarStd << 5.0, 0.002, 0.002, 1.0;
+    }
+};
+
+/**
+ * @brief 在10公里范围内生成目标
+ * @param count 目标数
+ * @param rng 随机数发生器
+ * @return 目标真值
+ */
+std::vector<Target> makeTargets(int count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> horizontal(-10000.0, 10000.0);
+    std::uniform_real_distribution<double> vertical(1000.0, 5000.0);
+    std::uniform_real_distribution<double> speed(-200.0, 200.0);
+    std::vector<Target> targets(count);
+    for (Target& target : targets) {
+        target.position = Vector3(horizontal(rng), horizontal(rng), vertical(rng));
+        target.velocity = Vector3(speed(rng), speed(rng), 0.0);
+    }
+    return targets;
+}
+
+/**
+ * @brief 推进全部目标一个周期
+ * @param targets 目标真值
+ */
+void advance(std::vector<Target>& targets)
+{
+    for (Target& target : targets) {
+        target.position += target.velocity * kDt;
+    }
+}
+
+/**
+ * @brief 生成笛卡尔观测块
+ * @param sensors 传感器
+ * @param target 目标真值
+ * @param rng 随机数发生器
+ * @return 观测块
+ */
+ObservationBlock cartesianBlock(const Sensors& sensors, const Target& target, std::mt19937& rng)
+{
+    std::normal_distribution<double> noise(0.0, kCartesianStd);
+    ObservationBlock block;
+    block.model = &sensors.cartesian;
+    block.z = target.position + Vector3(noise(rng), noise(rng), noise(rng));
+    block.R = ObservationNoise::Identity(3, 3) * (kCartesianStd * kCartesianStd);
+    return block;
+}
+
+/**
+ * @brief 生成球坐标观测块
+ * @param sensors 传感器
+ * @param radar 球坐标传感器序号
+ * @param target 目标真值
+ * @param rng 随机数发生器
+ * @return 观测块
+ */
+ObservationBlock radarBlock(const Sensors& sensors, int radar, const Target& target, std::mt19937& rng)
+{
+    std::normal_distribution<double> noise(0.0, 1.0);
+    StateVector truth(6);
+    truth << target.position, target.velocity;
+
+    ObservationBlock block;
+    block.model = &sensors.radars[radar];
+    block.z = block.model->observe(truth);
+    for (int i = 0; i < 4; ++i) {
+        block.z(i) += sensors.radarStd(i) * noise(rng);
+    }
+    block.R = sensors.radarStd.cwiseAbs2().asDiagonal();
+    return block;
+}
+
+/**
+ * @brief 观测组合
+ */
+enum Observation {
+    TwoCartesian,       ///< 两个笛卡尔传感器
+    RadarAndCartesian,  ///< 一部球坐标传感器加一个笛卡尔传感器
+    FourRadars          ///< 四部球坐标传感器，超过单次堆叠上限
+};
+
+/**
+ * @brief 生成一个目标本周期的观测块
+ * @param observation 观测组合
+ * @param sensors 传感器
+ * @param target 目标真值
+ * @param rng 随机数发生器
+ * @param blocks 观测块(输出)，复用调用方的缓冲
+ */
+void observe(Observation observation, const Sensors& sensors, const Target& target, std::mt19937& rng,
+             std::vector<ObservationBlock>& blocks)
+{
+    blocks.clear();
+    switch (observation) {
+    case TwoCartesian:
+        blocks.push_back(cartesianBlock(sensors, target, rng));
+        blocks.push_back(cartesianBlock(sensors, target, rng));
+        break;
+    case RadarAndCartesian:
+        blocks.push_back(radarBlock(sensors, 0, target, rng));
+        blocks.push_back(cartesianBlock(sensors, target, rng));
+        break;
+    default:
+        for (int radar = 0; radar < static_cast<int>(sensors.radars.size()); ++radar) {
+            blocks.push_back(radarBlock(sensors, radar, target, rng));
+        }
+        break;
+    }
+}
+
+/**
+ * @brief 运行一项检查
+ * @param name 名称
+ * @param steps 步数
+ * @param step 执行一步，参数为步序号
+ * @return 预热后没有 operator new 分配时返回true
+ * @details 预热后每一步都在禁止Eigen分配堆内存的状态下执行
+ */
+template <typename Step>
+bool runCheck(const char* name, int steps, Step step)
+{
+    long long allocations = 0;
+    double micros = 0.0;
+    for (int k = 0; k < steps; ++k) {
+        const bool checked = k >= kWarmupSteps;
+        const AllocationCounters before = AllocationTracker::threadCounters();
+        BenchUtils::Stopwatch watch;
+        if (checked) {
+            setEigenMallocAllowed(false);
+        }
+        step(k);
+        if (checked) {
+            setEigenMallocAllowed(true);
+            micros += watch.micros();
+            allocations += AllocationTracker::threadCounters().allocations - before.allocations;
+        }
+    }
+    const bool ok = allocations == 0;
+    std::printf("%-44s %8.1f us/step  %lld allocations%s\n", name, micros / std::max(1, steps - kWarmupSteps),
+                allocations, ok ? "" : "  FAILED");
+    return ok;
+}
+
+/**
+ * @brief 检查立方卡尔曼滤波
+ * @param name 名称
+ * @param model 运动模型
+ * @param observation 观测组合
+ * @param targetCount 目标数
+ * @param steps 步数
+ * @return 检查是否通过
+ */
+bool checkCkf(const char* name, const IMotionModel& model, Observation observation, int targetCount, int steps)
+{
+    std::mt19937 rng(5);
+    const Sensors sensors;
+    std::vector<Target> targets = makeTargets(targetCount, rng);
+    std::vector<StateVector> states(targetCount);
+    std::vector<StateMatrix> covariances(targetCount, model.getInitialCovariance());
+    for (int i = 0; i < targetCount; ++i) {
+        states[i] = StateVector::Zero(model.stateDim());
+        states[i].head<6>() << targets[i].position, targets[i].velocity;
+    }
+
+    CKF filter;
+    std::vector<ObservationBlock> blocks;
+    return runCheck(name, steps, [&](int) {
+        advance(targets);
+        for (int i = 0; i < targetCount; ++i) {
+            filter.predict(states[i], covariances[i], model, kDt);
+            observe(observation, sensors, targets[i], rng, blocks);
+            filter.updateStacked(states[i], covariances[i], blocks);
+        }
+    });
+}
+
+/**
+ * @brief 检查交互式多模型滤波
+ * @param name 名称
+ * @param observation 观测组合
+ * @param targetCount 目标数
+ * @param steps 步数
+ * @return 检查是否通过
+ */
+bool checkImm(const char* name, Observation observation, int targetCount, int steps)
+{
+    std::mt19937 rng(6);
+    const Sensors sensors;
+    std::vector<Target> targets = makeTargets(targetCount, rng);
+    std::vector<std::unique_ptr<ImmFilter>> filters;
+    for (const Target& target : targets) {
+        filters.emplace_back(new ImmFilter(target.position));
+    }
+
+    std::vector<ObservationBlock> blocks;
+    return runCheck(name, steps, [&](int) {
+        advance(targets);
+        for (int i = 0; i < targetCount; ++i) {
+            filters[i]->predict(kDt);
+            observe(observation, sensors, targets[i], rng, blocks);
+            filters[i]->update(blocks);
+        }
+    });
+}
+
+/**
+ * @brief 航迹的滤波方式
+ */
+enum TrackFilter {
+    CvTrack,
+    CaTrack,
+    ImmTrack,
+    SwitchingTrack,
+    SinglePrecisionTrack
+};
+
+/**
+ * @brief 检查航迹的预测和多观测联合更新
+ * @param name 名称
+ * @param filter 滤波方式
+ * @param targetCount 目标数
+ * @param steps 步数
+ * @return 检查是否通过
+ * @details 观测来自两个未配置的观测者，按默认笛卡尔传感器处理
+ */
+bool checkTracks(const char* name, TrackFilter filter, int targetCount, int steps)
+{
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, kCartesianStd);
+    std::vector<Target> targets = makeTargets(targetCount, rng);
+    std::vector<std::unique_ptr<Track>> tracks;
+    for (int i = 0; i < targetCount; ++i) {
+        const Measurement initial(targets[i].position, 0.0, 1);
+        Track* track;
+        if (filter == ImmTrack) {
+            track = new Track(initial, i, std::unique_ptr<ImmFilter>(new ImmFilter(initial.position)));
+        } else if (filter == CaTrack) {
+            track = new Track(initial, i, std::unique_ptr<IMotionModel>(new ConstantAccelerationModel()));
+        } else {
+            track = new Track(initial, i, std::unique_ptr<IMotionModel>(new ConstantVelocityModel()));
+        }
+        if (filter == SwitchingTrack) {
+            track->enableModelSwitching();
+        } else if (filter == SinglePrecisionTrack) {
+            track->enableSinglePrecision(1000.0);
+        }
+        tracks.emplace_back(track);
+    }
+
+    std::vector<Measurement> measurements(2);
+    std::vector<const Measurement*> associated = {&measurements[0], &measurements[1]};
+    return runCheck(name, steps, [&](int k) {
+        advance(targets);
+        const double timestamp = (k + 1) * kDt;
+        for (int i = 0; i < targetCount; ++i) {
+            tracks[i]->predict(kDt);
+            for (int o = 0; o < 2; ++o) {
+                measurements[o] = Measurement(Vector3(targets[i].position + Vector3(noise(rng), noise(rng), noise(rng))),
+                                              timestamp, o + 1);
+            }
+            tracks[i]->update(associated);
+        }
+    });
+}
+
+/**
+ * @brief 检查工作线程处理周期的稳态分配
+ * @param targetCount 目标数
+ * @param cycles 周期数
+ * @return 预热后 lastCycleAllocations() 始终为零且 zeroAllocationStreak() 连续递增时返回true
+ * @details 按 Worker::onTimeout 的阶段顺序执行一个周期: 接收的观测写入缓冲区，取出时与上一周期的
+ *          观测数组交换(drain)，坐标换算、交叉定位、聚类和合并(preprocess)，预测(predict)，
+ *          关联和起始(associate)，发布快照(output，按设计分配内存，不计入周期)。
+ *          Worker依赖DDS和消息服务，不能在基准程序中构建，这里逐阶段调用与其相同的核心接口
+ */
+bool checkWorkerCycle(int targetCount, int cycles)
+{
+    std::mt19937 rng(8);
+    std::normal_distribution<double> noise(0.0, kCartesianStd);
+    std::vector<Target> targets = makeTargets(targetCount, rng);
+
+    TrackManager manager;
+    BearingTriangulator triangulator;
+    PointCloudClusterer clusterer;
+    MeasurementCoalescer coalescer;
+    AllocationTracker allocations("bench");
+    std::vector<Measurement> buffer;
+    std::vector<Measurement> cycleMeasurements;
+    long long failedCycles = 0;
+    BenchUtils::Samples cycleMicros;
+
+    for (int k = 0; k < cycles; ++k) {
+        advance(targets);
+        const double timestamp = (k + 1) * kDt;
+        for (const Target& target : targets) {
+            for (int o = 1; o <= 2; ++o) {
+                buffer.emplace_back(Vector3(target.position + Vector3(noise(rng), noise(rng), noise(rng))),
+                                    timestamp, o);
+            }
+        }
+
+        const bool checked = k >= kWarmupSteps;
+        allocations.beginCycle();
+        BenchUtils::Stopwatch watch;
+        if (checked) {
+            setEigenMallocAllowed(false);
+        }
+        cycleMeasurements.clear();
+        cycleMeasurements.swap(buffer);
+        for (const auto& m : cycleMeasurements) {
+            g_Observers.recordLatency(m.observerId, 0.0);
+        }
+        allocations.markStage("drain");
+
+        GeodeticFrame::instance().convertToLocal(cycleMeasurements);
+        triangulator.process(cycleMeasurements);
+        SensorRegistry::instance().convertToCartesian(cycleMeasurements);
+        clusterer.process(cycleMeasurements);
+        for (const auto& m : cycleMeasurements) {
+            g_Observers.recordMeasurement(m.observerId);
+        }
+        coalescer.process(cycleMeasurements);
+        allocations.markStage("preprocess");
+
+        std::sort(cycleMeasurements.begin(), cycleMeasurements.end(),
+                  [](const Measurement& a, const Measurement& b) { return a.timestamp < b.timestamp; });
+        manager.predictTo(cycleMeasurements.back().timestamp);
+        allocations.markStage("predict");
+        manager.processMeasurements(cycleMeasurements);
+        ClockOffsetEstimator::instance().endCycle();
+        allocations.markStage("associate");
+        if (checked) {
+            setEigenMallocAllowed(true);
+            cycleMicros.add(watch.micros());
+        }
+
+        TrackSnapshotStore::instance().publish(manager.getTracks(), manager.getLastProcessTime());
+        allocations.markAllocatingStage("output");
+        allocations.endCycle();
+
+        if (checked && allocations.lastCycleAllocations() != 0) {
+            failedCycles++;
+        }
+    }
+
+    const long long expectedStreak = cycles - kWarmupSteps;
+    const bool ok = failedCycles == 0 && allocations.zeroAllocationStreak() >= expectedStreak;
+    std::printf("worker cycle: %d targets, %d tracks, %d cycles, %lld cycles with allocations, "
+                "zero allocation streak %lld%s\n",
+                targetCount, static_cast<int>(manager.getTracks().size()), cycles - kWarmupSteps, failedCycles,
+                allocations.zeroAllocationStreak(), ok ? "" : "  FAILED");
+    cycleMicros.print("drain .. associate (us)");
+    return ok;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    const int targetCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 50;
+    const int steps = argc > 2 ? std::max(kWarmupSteps + 1, std::atoi(argv[2])) : 200;
+
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+    const bool eigenChecked = true;
+#else
+    const bool eigenChecked = false;
+#endif
+    std::printf("operator new counting %s, Eigen heap allocation check %s\n",
+                AllocationTracker::isEnabled() ? "on" : "OFF (define MTT_ALLOCATION_TRACKING)",
+                eigenChecked ? "on" : "OFF (define EIGEN_RUNTIME_NO_MALLOC)");
+
+    const ConstantVelocityModel cv;
+    const ConstantAccelerationModel ca;
+    bool ok = true;
+    ok = checkCkf("CKF cv, two cartesian (linear)", cv, TwoCartesian, targetCount, steps) && ok;
+    ok = checkCkf("CKF ca, two cartesian (linear)", ca, TwoCartesian, targetCount, steps) && ok;
+    ok = checkCkf("CKF cv, radar + cartesian (cubature)", cv, RadarAndCartesian, targetCount, steps) && ok;
+    ok = checkCkf("CKF ca, radar + cartesian (cubature)", ca, RadarAndCartesian, targetCount, steps) && ok;
+    ok = checkCkf("CKF cv, four radars (grouped)", cv, FourRadars, targetCount, steps) && ok;
+    ok = checkImm("IMM, two cartesian (fused position)", TwoCartesian, targetCount, steps) && ok;
+    ok = checkImm("IMM, radar + cartesian (stacked)", RadarAndCartesian, targetCount, steps) && ok;
+    ok = checkTracks("track cv", CvTrack, targetCount, steps) && ok;
+    ok = checkTracks("track ca", CaTrack, targetCount, steps) && ok;
+    ok = checkTracks("track imm", ImmTrack, targetCount, steps) && ok;
+    ok = checkTracks("track cv/ca switching", SwitchingTrack, targetCount, steps) && ok;
+    ok = checkTracks("track single precision", SinglePrecisionTrack, targetCount, steps) && ok;
+    ok = checkWorkerCycle(targetCount, steps) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,5 @@
+include(../bench.pri)
+
+TARGET = CvPrecisionBench
+
+SOURCES += main.cpp
@@ -0,0 +1,182 @@
+/**
+ * @file main.cpp
+ * @brief 匀速模型单精度滤波基准程序
+ * @details 对同一组真值轨迹和观测分别以双精度立方卡尔曼滤波和单精度定长滤波(Precision/singlePrecision)跟踪，
+ *          比较两者相对真值的位置均方根误差、两者估计之间的最大偏差和每次预测加更新的耗时。
+ *          分别在跟踪原点附近和远离原点(地心坐标量级)两种场景下运行，后者检验单精度滤波的局部原点重定中心。
+ *          单精度的均方根误差比双精度大1%以上，或两者位置偏差超过观测噪声标准差的10%时返回1。
+ *          用法: CvPrecisionBench [航迹数=1000] [步数=600] [观测噪声标准差(米)=1.0]
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "Track.h"
+#include "ConstantVelocityModel.h"
+#include "BenchUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 单精度滤波的局部原点重定中心距离(米)，与 Precision/recenterDistance 的默认值一致
+ */
+const double kRecenterDistance = 1000.0;
+
+/**
+ * @brief 周期(秒)
+ */
+const double kDt = 0.1;
+
+/**
+ * @brief 计入误差统计前的收敛步数
+ */
+const int kWarmupSteps = 50;
+
+/**
+ * @brief 测试场景
+ */
+struct Scenario {
+    const char* name;   ///< 名称
+    Vector3 origin;     ///< 目标起始位置的中心
+};
+
+/**
+ * @brief 一次跟踪的结果
+ */
+struct PassResult {
+    double micros = 0.0;            ///< 预测和更新的总耗时(微秒)
+    double sumSquaredError = 0.0;   ///< 收敛后位置误差平方和
+    long long samples = 0;          ///< 收敛后的样本数
+    std::vector<Vector3> position;  ///< 各航迹各步的位置估计，按 步 * 航迹数 + 航迹 排列
+    std::vector<Vector3> velocity;  ///< 各航迹各步的速度估计
+
+    double rmse() const { return samples ? std::sqrt(sumSquaredError / samples) : 0.0; }
+};
+
+/**
+ * @brief 以给定精度跟踪全部航迹
+ * @param singlePrecision 是否启用单精度滤波
+ * @param truth 真值位置，按 步 * 航迹数 + 航迹 排列
+ * @param measurements 观测位置，排列同上
+ * @param trackCount 航迹数
+ * @param steps 步数
+ * @return 跟踪结果
+ */
+PassResult run(bool singlePrecision, const std::vector<Vector3>& truth, const std::vector<Vector3>& measurements,
+               int trackCount, int steps)
+{
+    PassResult result;
+    result.position.resize(measurements.size());
+    result.velocity.resize(measurements.size());
+
+    std::vector<std::unique_ptr<Track>> tracks;
+    tracks.reserve(trackCount);
+    for (int i = 0; i < trackCount; ++i) {
+        tracks.emplace_back(new Track(Measurement(measurements[i], 0.0, 0), i,
+                                      std::unique_ptr<IMotionModel>(new ConstantVelocityModel())));
+        if (singlePrecision) {
+            tracks.back()->enableSinglePrecision(kRecenterDistance);
+        }
+    }
+
+    for (int k = 1; k < steps; ++k) {
+        const size_t base = static_cast<size_t>(k) * trackCount;
+        BenchUtils::Stopwatch watch;
+        for (int i = 0; i < trackCount; ++i) {
+            tracks[i]->predict(kDt);
+            tracks[i]->update(Measurement(measurements[base + i], k * kDt, 0));
+        }
+        result.micros += watch.micros();
+
+        for (int i = 0; i < trackCount; ++i) {
+            const StateVector& state = tracks[i]->getState();
+            result.position[base + i] = state.head<3>();
+            result.velocity[base + i] = state.segment<3>(3);
+            if (k >= kWarmupSteps) {
+                result.sumSquaredError += (state.head<3>() - truth[base + i]).squaredNorm();
+                result.samples++;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 运行一个场景并输出结果
+ * @param scenario 场景
+ * @param trackCount 航迹数
+ * @param steps 步数
+ * @param noise 观测噪声标准差(米)
+ * @return 单精度结果满足精度要求时返回true
+ */
+bool runScenario(const Scenario& scenario, int trackCount, int steps, double noise)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> spread(-5000.0, 5000.0);
+    std::uniform_real_distribution<double> speed(-250.0, 250.0);
+    std::normal_distribution<double> error(0.0, noise);
+
+    // 真值为匀速直线运动，观测为真值加高斯噪声
+    std::vector<Vector3> truth(static_cast<size_t>(trackCount) * steps);
+    std::vector<Vector3> measurements(truth.size());
+    for (int i = 0; i < trackCount; ++i) {
+        const Vector3 start = scenario.origin + Vector3(spread(rng), spread(rng), spread(rng) / 10.0);
+        const Vector3 velocity(speed(rng), speed(rng), speed(rng) / 10.0);
+        for (int k = 0; k < steps; ++k) {
+            const size_t index = static_cast<size_t>(k) * trackCount + i;
+            truth[index] = start + velocity * (k * kDt);
+            measurements[index] = truth[index] + Vector3(error(rng), error(rng), error(rng));
+        }
+    }
+
+    const PassResult reference = run(false, truth, measurements, trackCount, steps);
+    const PassResult single = run(true, truth, measurements, trackCount, steps);
+
+    double maxPositionDiff = 0.0;
+    double maxVelocityDiff = 0.0;
+    for (size_t i = trackCount; i < reference.position.size(); ++i) {
+        maxPositionDiff = std::max(maxPositionDiff, (reference.position[i] - single.position[i]).norm());
+        maxVelocityDiff = std::max(maxVelocityDiff, (reference.velocity[i] - single.velocity[i]).norm());
+    }
+
+    const double updates = static_cast<double>(trackCount) * (steps - 1);
+    std::printf("%s: origin (%.0f, %.0f, %.0f), %d tracks x %d steps, noise %.2f m\n",
+                scenario.name, scenario.origin.x(), scenario.origin.y(), scenario.origin.z(), trackCount, steps, noise);
+    std::printf("  double  %8.3f us/update  position rmse %.4f m\n", reference.micros / updates, reference.rmse());
+    std::printf("  float   %8.3f us/update  position rmse %.4f m\n", single.micros / updates, single.rmse());
+    std::printf("  speedup %.2fx, max position diff %.6f m, max velocity diff %.6f m/s\n",
+                single.micros > 0.0 ? reference.micros / single.micros : 0.0, maxPositionDiff, maxVelocityDiff);
+
+    const bool ok = single.rmse() <= reference.rmse() * 1.01 && maxPositionDiff <= 0.1 * noise;
+    if (!ok) {
+        std::printf("  FAILED: single precision accuracy out of tolerance\n");
+    }
+    return ok;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    const int trackCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+    const int steps = argc > 2 ? std::max(kWarmupSteps + 1, std::atoi(argv[2])) : 600;
+    const double noise = argc > 3 ? std::atof(argv[3]) : 1.0;
+
+    const Scenario scenarios[] = {
+        {"near origin", Vector3(0.0, 0.0, 0.0)},
+        {"far from origin", Vector3(4.1e6, 3.2e5, 4.8e6)}
+    };
+
+    bool ok = true;
+    for (const Scenario& scenario : scenarios) {
+        ok = runScenario(scenario, trackCount, steps, noise) && ok;
+    }
+    return ok ? 0 : 1;
+}
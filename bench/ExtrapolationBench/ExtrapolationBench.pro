@@ -0,0 +1,5 @@
+include(../bench.pri)
+
+TARGET = ExtrapolationBench
+
+SOURCES += main.cpp
@@ -0,0 +1,140 @@
+/**
+ * @file main.cpp
+ * @brief 航迹外推基准程序
+ * @details 以合成的确认航迹发布快照，先在单线程下统计单条外推和全部外推的耗时，
+ *          再由多个线程并发外推随机航迹到随机时刻，同时主线程按周期推进航迹并发布新快照，
+ *          统计每秒外推次数和延迟分位数。外推时长在 [0, 最大时长] 内均匀分布。
+ *          用法: ExtrapolationBench [航迹数=5000] [外推线程数=4] [秒数=3] [最大外推时长(秒)=2]
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TrackSnapshotStore.h"
+#include "TrackExtrapolator.h"
+#include "BenchTracks.h"
+#include "BenchUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 快照发布周期(秒)
+ */
+const double kCycle = 0.1;
+
+/**
+ * @brief 外推线程的统计
+ */
+struct WorkerStats {
+    BenchUtils::Samples micros;     ///< 单次外推耗时(微秒)
+    long long failures = 0;         ///< 外推失败次数
+};
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    const int trackCount = std::max(1, argc > 1 ? std::atoi(argv[1]) : 5000);
+    const int threadCount = argc > 2 ? std::atoi(argv[2]) : 4;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 3.0;
+    const double horizon = std::min(argc > 4 ? std::atof(argv[4]) : 2.0, TrackExtrapolator::instance().maxHorizon());
+
+    std::mt19937 rng(13);
+    double timestamp = 0.0;
+    std::vector<TrackPtr> tracks = BenchTracks::makeConfirmedTracks(trackCount, 20000.0, timestamp, rng);
+    TrackSnapshotStore& store = TrackSnapshotStore::instance();
+    store.publish(tracks, timestamp);
+    const TrackExtrapolator& extrapolator = TrackExtrapolator::instance();
+
+    std::printf("tracks %d, horizon %.2f s\n", trackCount, horizon);
+
+    // 1. 单线程单条外推
+    {
+        std::uniform_int_distribution<int> id(0, trackCount - 1);
+        std::uniform_real_distribution<double> ahead(0.0, horizon);
+        BenchUtils::Samples samples;
+        ExtrapolatedState state;
+        long long failures = 0;
+        BenchUtils::Stopwatch total;
+        for (int q = 0; q < 200000; ++q) {
+            BenchUtils::Stopwatch watch;
+            if (extrapolator.extrapolate(id(rng), timestamp + ahead(rng), state) != TrackExtrapolator::Result::Ok) {
+                failures++;
+            }
+            samples.add(watch.micros());
+        }
+        std::printf("single thread: %.0f extrapolations/s, failures %lld\n", samples.count() / total.seconds(), failures);
+        samples.print("extrapolate (us)");
+    }
+
+    // 2. 单线程全部外推
+    {
+        BenchUtils::Samples samples;
+        std::vector<ExtrapolatedState> states;
+        for (int q = 0; q < 200; ++q) {
+            BenchUtils::Stopwatch watch;
+            extrapolator.extrapolateAll(timestamp + horizon, states);
+            samples.add(watch.micros());
+        }
+        samples.print("extrapolateAll (us)");
+        std::printf("%-28s %.0f track states/s at p50\n", "", states.size() / (samples.percentile(0.5) * 1e-6));
+    }
+
+    // 3. 并发外推，主线程同时按周期发布新快照
+    std::atomic<bool> stop(false);
+    std::atomic<double> latest(timestamp);
+    std::vector<WorkerStats> stats(threadCount);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threadCount; ++t) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 local(200 + t);
+            std::uniform_int_distribution<int> id(0, trackCount - 1);
+            std::uniform_real_distribution<double> ahead(0.0, horizon);
+            WorkerStats& result = stats[t];
+            ExtrapolatedState state;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const double time = latest.load(std::memory_order_relaxed) + ahead(local);
+                BenchUtils::Stopwatch watch;
+                if (extrapolator.extrapolate(id(local), time, state) != TrackExtrapolator::Result::Ok) {
+                    result.failures++;
+                }
+                result.micros.add(watch.micros());
+            }
+        });
+    }
+
+    BenchUtils::Stopwatch total;
+    while (total.seconds() < seconds) {
+        BenchUtils::Stopwatch cycle;
+        timestamp += kCycle;
+        BenchTracks::advance(tracks, kCycle, timestamp, rng);
+        store.publish(tracks, timestamp);
+        latest.store(timestamp, std::memory_order_relaxed);
+        const double remaining = kCycle - cycle.seconds();
+        if (remaining > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
+        }
+    }
+    stop = true;
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    const double elapsed = total.seconds();
+
+    WorkerStats merged;
+    for (const WorkerStats& s : stats) {
+        merged.micros.merge(s.micros);
+        merged.failures += s.failures;
+    }
+    std::printf("concurrent: %d threads, %.1f s, %.0f extrapolations/s, failures %lld\n",
+                threadCount, elapsed, merged.micros.count() / elapsed, merged.failures);
+    merged.micros.print("extrapolate (us)");
+    return merged.failures > 0 ? 1 : 0;
+}
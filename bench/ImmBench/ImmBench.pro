@@ -0,0 +1,5 @@
+include(../bench.pri)
+
+TARGET = ImmBench
+
+SOURCES += main.cpp
@@ -0,0 +1,203 @@
+/**
+ * @file main.cpp
+ * @brief 交互式多模型滤波开销基准程序
+ * @details 对同一组真值轨迹和观测分别以匀速(CV)、匀加速(CA)单模型航迹和IMM航迹跟踪，
+ *          比较每条航迹每周期预测加更新的耗时(纳秒)和相对真值的位置均方根误差。
+ *          IMM分两种配置运行: 休眠阈值为0时三个模型始终全部交互、预测和更新(完全交互)；
+ *          休眠阈值较高时概率低的模型休眠，只有活跃模型参与计算，同时输出平均活跃模型数。
+ *          真值轨迹交替为匀速直线段和协调转弯段，观测为单个笛卡尔观测者的位置加高斯噪声。
+ *          用法: ImmBench [航迹数=1000] [步数=600] [休眠阈值=0.5] [观测噪声标准差(米)=5.0]
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "Track.h"
+#include "ImmFilter.h"
+#include "ConstantVelocityModel.h"
+#include "ConstantAccelerationModel.h"
+#include "BenchUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 周期(秒)
+ */
+const double kDt = 0.1;
+
+/**
+ * @brief 计入误差和活跃模型统计前的收敛步数
+ */
+const int kWarmupSteps = 50;
+
+/**
+ * @brief 直线段和转弯段各自的步数
+ */
+const int kLegSteps = 100;
+
+/**
+ * @brief 航迹类型
+ */
+enum class Filter {
+    Cv,     ///< 匀速单模型
+    Ca,     ///< 匀加速单模型
+    Imm     ///< 交互式多模型
+};
+
+/**
+ * @brief 一种配置
+ */
+struct Config {
+    const char* name;       ///< 名称
+    Filter filter;          ///< 航迹类型
+    double skipThreshold;   ///< IMM休眠阈值，单模型时不使用
+};
+
+/**
+ * @brief 一次跟踪的结果
+ */
+struct PassResult {
+    double micros = 0.0;            ///< 预测和更新的总耗时(微秒)
+    double sumSquaredError = 0.0;   ///< 收敛后位置误差平方和
+    double activeModels = 0.0;      ///< 收敛后活跃模型数之和(仅IMM)
+    long long samples = 0;          ///< 收敛后的样本数
+
+    double rmse() const { return samples ? std::sqrt(sumSquaredError / samples) : 0.0; }
+};
+
+/**
+ * @brief 以一种配置跟踪全部航迹
+ * @param config 配置
+ * @param truth 真值位置，按 步 * 航迹数 + 航迹 排列
+ * @param measurements 观测位置，排列同上
+ * @param trackCount 航迹数
+ * @param steps 步数
+ * @return 跟踪结果
+ */
+PassResult run(const Config& config, const std::vector<Vector3>& truth, const std::vector<Vector3>& measurements,
+               int trackCount, int steps)
+{
+    PassResult result;
+
+    std::vector<std::unique_ptr<Track>> tracks;
+    tracks.reserve(trackCount);
+    for (int i = 0; i < trackCount; ++i) {
+        const Measurement initial(measurements[i], 0.0, 0);
+        switch (config.filter) {
+        case Filter::Cv:
+            tracks.emplace_back(new Track(initial, i, std::unique_ptr<IMotionModel>(new ConstantVelocityModel())));
+            break;
+        case Filter::Ca:
+            tracks.emplace_back(new Track(initial, i, std::unique_ptr<IMotionModel>(new ConstantAccelerationModel())));
+            break;
+        case Filter::Imm: {
+            std::unique_ptr<ImmFilter> imm(new ImmFilter(initial.position));
+            imm->setSkipThreshold(config.skipThreshold);
+            tracks.emplace_back(new Track(initial, i, std::move(imm)));
+            break;
+        }
+        }
+    }
+
+    for (int k = 1; k < steps; ++k) {
+        const size_t base = static_cast<size_t>(k) * trackCount;
+        BenchUtils::Stopwatch watch;
+        for (int i = 0; i < trackCount; ++i) {
+            tracks[i]->predict(kDt);
+            tracks[i]->update(Measurement(measurements[base + i], k * kDt, 0));
+        }
+        result.micros += watch.micros();
+
+        if (k < kWarmupSteps) {
+            continue;
+        }
+        for (int i = 0; i < trackCount; ++i) {
+            result.sumSquaredError += (tracks[i]->getState().head<3>() - truth[base + i]).squaredNorm();
+            if (const ImmFilter* imm = tracks[i]->getImm()) {
+                result.activeModels += imm->activeModelCount();
+            }
+            result.samples++;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    const int trackCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000;
+    const int steps = argc > 2 ? std::max(kWarmupSteps + 1, std::atoi(argv[2])) : 600;
+    const double dormantThreshold = argc > 3 ? std::atof(argv[3]) : 0.5;
+    const double noise = argc > 4 ? std::atof(argv[4]) : 5.0;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> spread(-20000.0, 20000.0);
+    std::uniform_real_distribution<double> speed(50.0, 300.0);
+    std::uniform_real_distribution<double> heading(-EIGEN_PI, EIGEN_PI);
+    std::uniform_real_distribution<double> turnRate(0.02, 0.1);
+    std::normal_distribution<double> error(0.0, noise);
+
+    // 1. 真值交替为匀速直线段和水平协调转弯段，转弯方向和转弯率每条航迹随机
+    std::vector<Vector3> truth(static_cast<size_t>(trackCount) * steps);
+    std::vector<Vector3> measurements(truth.size());
+    for (int i = 0; i < trackCount; ++i) {
+        Vector3 position(spread(rng), spread(rng), 1000.0 + spread(rng) / 20.0);
+        const double v = speed(rng);
+        const double h = heading(rng);
+        Vector3 velocity(v * std::cos(h), v * std::sin(h), 0.0);
+        const double omega = (rng() % 2 ? 1.0 : -1.0) * turnRate(rng);
+        for (int k = 0; k < steps; ++k) {
+            if (k > 0) {
+                if ((k / kLegSteps) % 2 == 1) {
+                    const double c = std::cos(omega * kDt);
+                    const double s = std::sin(omega * kDt);
+                    velocity = Vector3(c * velocity.x() - s * velocity.y(), s * velocity.x() + c * velocity.y(), 0.0);
+                }
+                position += velocity * kDt;
+            }
+            const size_t index = static_cast<size_t>(k) * trackCount + i;
+            truth[index] = position;
+            measurements[index] = position + Vector3(error(rng), error(rng), error(rng));
+        }
+    }
+
+    // 2. 各配置依次跟踪同一组观测
+    const Config configs[] = {
+        {"cv", Filter::Cv, 0.0},
+        {"ca", Filter::Ca, 0.0},
+        {"imm, dormant models", Filter::Imm, dormantThreshold},
+        {"imm, full mixing", Filter::Imm, 0.0}
+    };
+
+    std::printf("%d tracks x %d steps, noise %.2f m, dormant threshold %.3f\n",
+                trackCount, steps, noise, dormantThreshold);
+    const double updates = static_cast<double>(trackCount) * (steps - 1);
+    double caNanos = 0.0;
+    for (const Config& config : configs) {
+        const PassResult result = run(config, truth, measurements, trackCount, steps);
+        const double nanos = result.micros * 1000.0 / updates;
+        if (config.filter == Filter::Ca) {
+            caNanos = nanos;
+        }
+        std::printf("  %-22s %9.1f ns/track", config.name, nanos);
+        if (caNanos > 0.0) {
+            std::printf("  %5.2fx ca", nanos / caNanos);
+        } else {
+            std::printf("  %8s", "");
+        }
+        std::printf("  position rmse %.3f m", result.rmse());
+        if (config.filter == Filter::Imm) {
+            std::printf("  active models %.2f", result.samples ? result.activeModels / result.samples : 0.0);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
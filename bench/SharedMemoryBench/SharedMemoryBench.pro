@@ -0,0 +1,12 @@
+include(../bench.pri)
+
+TARGET = SharedMemoryBench
+
+SOURCES += main.cpp \
+    $$ROOT/Service/SharedTrackTable.cpp \
+    $$ROOT/Tools/SharedTrackReader.cpp
+
+HEADERS += \
+    $$ROOT/Service/SharedTrackTable.h \
+    $$ROOT/Tools/SharedTrackLayout.h \
+    $$ROOT/Tools/SharedTrackReader.h
@@ -0,0 +1,203 @@
+/**
+ * @file main.cpp
+ * @brief 共享内存航迹表基准程序
+ * @details 写线程不间断地发布航迹表并更替航迹(随机消失、数量在满额和3/4之间往复，留下未复用的空槽位)，
+ *          多个读线程并发读取整表和单条航迹，统计读取延迟分位数、读取失败次数和撕裂读取次数。
+ *          每条记录的数值字段均由快照序号和航迹ID确定，读到的字段与记录自身的序号不符即为撕裂读取。
+ *          写端使用配置 SharedMemory/key，运行前需停止服务。
+ *          写周期为0时写线程不间断发布，用于压力测试；此时读端与写入重叠的概率很高，整表读取失败属预期。
+ *          用法: SharedMemoryBench [航迹数=500] [读线程数=4] [秒数=5] [写周期毫秒=100]
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "SharedTrackTable.h"
+#include "SharedTrackReader.h"
+#include "BenchUtils.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 按快照序号和航迹ID生成航迹记录
+ * @param id 航迹ID
+ * @param sequence 快照序号
+ * @return 航迹记录
+ */
+TrackRecord makeRecord(int id, long long sequence)
+{
+    const double s = static_cast<double>(sequence);
+    TrackRecord record;
+    record.id = id;
+    record.hits = static_cast<int>(sequence % 1000000);
+    record.stateDim = 9;
+    record.model = "ca";
+    record.position = Vector3(s, id, s + id);
+    record.velocity = 2.0 * record.position;
+    record.acceleration = 3.0 * record.position;
+    record.extent = Vector3(1.0, 2.0, 3.0);
+    record.covariance = Eigen::Matrix<double, 9, 9>::Identity() * s;
+    return record;
+}
+
+/**
+ * @brief 检查读到的记录各字段是否属于同一次写入
+ * @param record 读到的记录
+ * @return 一致返回true
+ */
+bool consistent(const SharedTrackRecord& record)
+{
+    const double s = static_cast<double>(record.sequence);
+    return record.hits == static_cast<int32_t>(record.sequence % 1000000) &&
+            record.position[0] == s && record.position[1] == record.id && record.position[2] == s + record.id &&
+            record.velocity[0] == 2.0 * s && record.acceleration[2] == 3.0 * (s + record.id) &&
+            record.covariance[0] == s && record.covariance[80] == s && record.covariance[1] == 0.0 &&
+            record.timestamp == s * 0.1;
+}
+
+/**
+ * @brief 读线程的统计
+ */
+struct ReaderStats {
+    BenchUtils::Samples tableMicros;    ///< 整表读取耗时(微秒)
+    BenchUtils::Samples trackMicros;    ///< 单条读取耗时(微秒)
+    long long tableFailures = 0;        ///< 整表读取失败次数
+    long long trackMisses = 0;          ///< 单条读取未找到次数(航迹已消失时属正常)
+    long long torn = 0;                 ///< 撕裂读取次数
+    long long countMismatch = 0;        ///< 整表记录数与表头航迹数不一致的次数
+};
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    const int trackCount = argc > 1 ? std::atoi(argv[1]) : 500;
+    const int readerCount = argc > 2 ? std::atoi(argv[2]) : 4;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 5.0;
+    const int intervalMs = argc > 4 ? std::atoi(argv[4]) : 100;
+
+    SharedTrackTable table;
+    std::atomic<bool> stop(false);
+    std::atomic<long long> publishes(0);
+
+    // 先发布一次，读端才能附着
+    long long sequence = 1;
+    std::vector<int> ids;
+    std::vector<TrackRecord> records;
+    for (int i = 0; i < trackCount; ++i) {
+        ids.push_back(i);
+        records.push_back(makeRecord(i, sequence));
+    }
+    table.publish(TrackSnapshot(sequence, sequence * 0.1, 1000.0, records, {}, {}, "enu"));
+
+    std::thread writer([&]() {
+        std::mt19937 rng(1);
+        int nextId = trackCount;
+        while (!stop.load(std::memory_order_relaxed)) {
+            ++sequence;
+            // 约5%的航迹消失；航迹数每10个周期在满额和3/4之间切换
+            std::vector<int> alive;
+            for (int id : ids) {
+                if (rng() % 20 != 0) {
+                    alive.push_back(id);
+                }
+            }
+            const int target = (sequence / 10) % 2 ? trackCount * 3 / 4 : trackCount;
+            while (static_cast<int>(alive.size()) < target) {
+                alive.push_back(nextId++);
+            }
+            ids.swap(alive);
+
+            records.clear();
+            for (int id : ids) {
+                records.push_back(makeRecord(id, sequence));
+            }
+            table.publish(TrackSnapshot(sequence, sequence * 0.1, 1000.0, records, {}, {}, "enu"));
+            publishes.fetch_add(1, std::memory_order_relaxed);
+            if (intervalMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+            }
+        }
+    });
+
+    std::vector<ReaderStats> stats(readerCount);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&, r]() {
+            ReaderStats& result = stats[r];
+            SharedTrackReader reader;
+            if (!reader.attach()) {
+                std::fprintf(stderr, "reader %d: attach failed\n", r);
+                return;
+            }
+            std::mt19937 rng(100 + r);
+            std::vector<SharedTrackRecord> table;
+            SharedTrackReader::TableInfo info;
+            SharedTrackRecord record;
+            int lastId = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                BenchUtils::Stopwatch watch;
+                const bool ok = reader.readTable(table, info);
+                result.tableMicros.add(watch.micros());
+                if (!ok) {
+                    result.tableFailures++;
+                    continue;
+                }
+                if (table.size() != info.trackCount) {
+                    result.countMismatch++;
+                }
+                for (const SharedTrackRecord& item : table) {
+                    if (item.sequence != info.sequence || !consistent(item)) {
+                        result.torn++;
+                    }
+                }
+                if (!table.empty()) {
+                    lastId = table[rng() % table.size()].id;
+                }
+
+                // 每次整表读取后做若干次单条读取
+                for (int k = 0; k < 16; ++k) {
+                    BenchUtils::Stopwatch trackWatch;
+                    const bool found = reader.readTrack(lastId, record);
+                    result.trackMicros.add(trackWatch.micros());
+                    if (!found) {
+                        result.trackMisses++;
+                    } else if (record.id != lastId || !consistent(record)) {
+                        result.torn++;
+                    }
+                }
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(seconds * 1000)));
+    stop = true;
+    writer.join();
+    for (std::thread& thread : readers) {
+        thread.join();
+    }
+
+    std::printf("tracks %d, readers %d, %.1f s, write interval %d ms, publishes %lld (%.0f/s)\n",
+                trackCount, readerCount, seconds, intervalMs, publishes.load(), publishes.load() / seconds);
+    ReaderStats total;
+    for (const ReaderStats& s : stats) {
+        total.tableMicros.merge(s.tableMicros);
+        total.trackMicros.merge(s.trackMicros);
+        total.tableFailures += s.tableFailures;
+        total.trackMisses += s.trackMisses;
+        total.torn += s.torn;
+        total.countMismatch += s.countMismatch;
+    }
+    total.tableMicros.print("readTable (us)");
+    total.trackMicros.print("readTrack (us)");
+    std::printf("table failures %lld, track misses %lld, count mismatches %lld, torn reads %lld\n",
+                total.tableFailures, total.trackMisses, total.countMismatch, total.torn);
+    const bool failed = total.torn > 0 || total.countMismatch > 0 || (intervalMs > 0 && total.tableFailures > 0);
+    return failed ? 1 : 0;
+}
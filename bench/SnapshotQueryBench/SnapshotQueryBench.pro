@@ -0,0 +1,5 @@
+include(../bench.pri)
+
+TARGET = SnapshotQueryBench
+
+SOURCES += main.cpp
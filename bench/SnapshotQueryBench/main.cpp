@@ -0,0 +1,173 @@
+/**
+ * @file main.cpp
+ * @brief 航迹快照查询基准程序
+ * @details 以合成的确认航迹发布快照，先在单线程下分别统计区域、半径和最近邻查询的延迟分位数，
+ *          再由多个查询线程并发混合查询，同时主线程按周期推进航迹并发布新快照，
+ *          统计并发查询的吞吐量、延迟分位数和快照发布(含空间索引增量维护)耗时。
+ *          网格大小取配置 Query/cellSize。
+ *          用法: SnapshotQueryBench [航迹数=5000] [查询线程数=4] [秒数=3] [区域半边长(米)=20000]
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TrackSnapshotStore.h"
+#include "BenchTracks.h"
+#include "BenchUtils.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 快照发布周期(秒)
+ */
+const double kCycle = 0.1;
+
+/**
+ * @brief 查询参数
+ */
+struct QueryShape {
+    double boxHalfSize = 1000.0;    ///< 区域查询的半边长(米)
+    double radius = 1000.0;         ///< 半径查询的半径(米)
+    int nearest = 10;               ///< 最近邻查询的航迹数
+};
+
+/**
+ * @brief 查询种类
+ */
+enum QueryKind {
+    Box,
+    Radius,
+    Nearest,
+    KindCount
+};
+
+const char* const kKindNames[KindCount] = {"queryBox (us)", "queryRadius (us)", "queryNearest (us)"};
+
+/**
+ * @brief 执行一次查询
+ * @param snapshot 快照
+ * @param kind 查询种类
+ * @param point 查询点
+ * @param shape 查询参数
+ * @return 结果数
+ */
+size_t query(const TrackSnapshot& snapshot, int kind, const Vector3& point, const QueryShape& shape)
+{
+    switch (kind) {
+    case Box: {
+        const Vector3 half = Vector3::Constant(shape.boxHalfSize);
+        return snapshot.queryBox(point - half, point + half).size();
+    }
+    case Radius:
+        return snapshot.queryRadius(point, shape.radius).size();
+    default:
+        return snapshot.queryNearest(point, shape.nearest).size();
+    }
+}
+
+/**
+ * @brief 查询线程的统计
+ */
+struct ReaderStats {
+    BenchUtils::Samples micros;     ///< 查询耗时(微秒)，含取得当前快照
+    long long results = 0;          ///< 结果总数
+};
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    const int trackCount = argc > 1 ? std::atoi(argv[1]) : 5000;
+    const int threadCount = argc > 2 ? std::atoi(argv[2]) : 4;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 3.0;
+    const double halfSize = argc > 4 ? std::atof(argv[4]) : 20000.0;
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> horizontal(-halfSize, halfSize);
+    std::uniform_real_distribution<double> vertical(0.0, halfSize / 20.0);
+    const QueryShape shape;
+
+    double timestamp = 0.0;
+    std::vector<TrackPtr> tracks = BenchTracks::makeConfirmedTracks(trackCount, halfSize, timestamp, rng);
+    TrackSnapshotStore& store = TrackSnapshotStore::instance();
+    store.publish(tracks, timestamp);
+
+    std::printf("tracks %d, area %.0f m, cells %d\n", trackCount, 2.0 * halfSize, store.current()->cellCount());
+
+    // 1. 单线程查询延迟
+    {
+        const std::shared_ptr<const TrackSnapshot> snapshot = store.current();
+        const int queries = 20000;
+        for (int kind = 0; kind < KindCount; ++kind) {
+            BenchUtils::Samples samples;
+            long long results = 0;
+            for (int q = 0; q < queries; ++q) {
+                const Vector3 point(horizontal(rng), horizontal(rng), vertical(rng));
+                BenchUtils::Stopwatch watch;
+                results += static_cast<long long>(query(*snapshot, kind, point, shape));
+                samples.add(watch.micros());
+            }
+            samples.print(kKindNames[kind]);
+            std::printf("%-28s mean results %.1f\n", "", static_cast<double>(results) / queries);
+        }
+    }
+
+    // 2. 并发查询，主线程同时按周期发布新快照
+    std::atomic<bool> stop(false);
+    std::vector<ReaderStats> stats(threadCount);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < threadCount; ++t) {
+        readers.emplace_back([&, t]() {
+            std::mt19937 local(100 + t);
+            std::uniform_real_distribution<double> x(-halfSize, halfSize);
+            std::uniform_real_distribution<double> z(0.0, halfSize / 20.0);
+            ReaderStats& result = stats[t];
+            int kind = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const Vector3 point(x(local), x(local), z(local));
+                BenchUtils::Stopwatch watch;
+                const std::shared_ptr<const TrackSnapshot> snapshot = store.current();
+                result.results += static_cast<long long>(query(*snapshot, kind, point, shape));
+                result.micros.add(watch.micros());
+                kind = (kind + 1) % KindCount;
+            }
+        });
+    }
+
+    BenchUtils::Samples publishMicros;
+    BenchUtils::Stopwatch total;
+    while (total.seconds() < seconds) {
+        BenchUtils::Stopwatch cycle;
+        timestamp += kCycle;
+        BenchTracks::advance(tracks, kCycle, timestamp, rng);
+        BenchUtils::Stopwatch publish;
+        store.publish(tracks, timestamp);
+        publishMicros.add(publish.micros());
+        const double remaining = kCycle - cycle.seconds();
+        if (remaining > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
+        }
+    }
+    stop = true;
+    for (std::thread& thread : readers) {
+        thread.join();
+    }
+    const double elapsed = total.seconds();
+
+    ReaderStats merged;
+    for (const ReaderStats& s : stats) {
+        merged.micros.merge(s.micros);
+        merged.results += s.results;
+    }
+    std::printf("concurrent: %d threads, %.1f s, %lld queries, %.0f queries/s\n",
+                threadCount, elapsed, merged.micros.count(), merged.micros.count() / elapsed);
+    merged.micros.print("mixed query (us)");
+    publishMicros.print("publish (us)");
+    return 0;
+}
@@ -0,0 +1,11 @@
+include(../bench.pri)
+
+TARGET = TrackStreamBench
+
+SOURCES += main.cpp \
+    $$ROOT/Service/TrackStreamServer.cpp \
+    $$ROOT/Service/OutputEncoder.cpp
+
+HEADERS += \
+    $$ROOT/Service/TrackStreamServer.h \
+    $$ROOT/Service/OutputEncoder.h
@@ -0,0 +1,168 @@
+/**
+ * @file main.cpp
+ * @brief 航迹推送基准程序
+ * @details 在本进程内启动航迹推送服务器，连接大量本地订阅客户端(订阅内容在全字段、位置速度、长方体区域和球形区域之间轮换)，
+ *          按周期推进合成航迹、由输出编码器编码(含各订阅注册的临时输出配置)并触发推送，统计每次推送的扇出耗时、消息从发布到客户端收到的延迟分位数、
+ *          每条消息的字节数以及因客户端队列满而未收到的消息数。
+ *          服务器与客户端在同一个事件循环中运行，延迟包含事件循环处理其他客户端的排队时间。
+ *          客户端数超过配置 TrackStream/maxClients 的部分会被拒绝。
+ *          用法: TrackStreamBench [客户端数=200] [秒数=5] [航迹数=500] [端口=19100]
+ * @author xubb
+ * @date 20250711
+ */
+
+#include "TrackStreamServer.h"
+#include "OutputEncoder.h"
+#include "BenchTracks.h"
+#include "BenchUtils.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QTcpSocket>
+#include <QTimer>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief 输出周期(毫秒)
+ */
+const int kCycleMs = 100;
+
+/**
+ * @brief 轮换使用的订阅请求
+ */
+const char* const kSubscriptions[] = {
+    "{}\n",
+    "{\"fields\":[\"position\",\"velocity\"]}\n",
+    "{\"box\":{\"min\":[-10000,-10000,-100],\"max\":[10000,10000,2000]}}\n",
+    "{\"sphere\":{\"center\":[5000,5000,0],\"radius\":8000}}\n"
+};
+
+/**
+ * @brief 一个订阅客户端
+ */
+struct BenchClient {
+    QTcpSocket* socket = nullptr;   ///< 连接
+    QByteArray buffer;              ///< 尚未成行的字节
+    bool subscribed = false;        ///< 是否已收到订阅确认
+    long long received = 0;         ///< 收到的航迹消息数
+};
+
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    const int clientCount = argc > 1 ? std::atoi(argv[1]) : 200;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 5.0;
+    const int trackCount = argc > 3 ? std::atoi(argv[3]) : 500;
+    const quint16 port = static_cast<quint16>(argc > 4 ? std::atoi(argv[4]) : 19100);
+
+    TrackStreamServer server;
+    if (!server.startListen(port)) {
+        std::fprintf(stderr, "listen on port %u failed\n", static_cast<unsigned>(port));
+        return 1;
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    std::unordered_map<long long, qint64> publishedAt;     // 输出序号 -> 编码开始时刻(纳秒)
+    BenchUtils::Samples latencyMicros;
+    BenchUtils::Samples fanoutMicros;
+    long long messageBytes = 0;
+    long long errors = 0;
+    int subscribedCount = 0;
+
+    // 1. 建立订阅客户端
+    std::vector<BenchClient> clients(clientCount);
+    for (int i = 0; i < clientCount; ++i) {
+        BenchClient* client = &clients[i];
+        client->socket = new QTcpSocket(&app);
+        const char* request = kSubscriptions[i % (sizeof(kSubscriptions) / sizeof(kSubscriptions[0]))];
+        QObject::connect(client->socket, &QTcpSocket::connected, [client, request]() {
+            client->socket->write(request);
+        });
+        QObject::connect(client->socket, &QTcpSocket::readyRead, [&, client]() {
+            client->buffer += client->socket->readAll();
+            int newline;
+            while ((newline = client->buffer.indexOf('\n')) >= 0) {
+                const QByteArray line = client->buffer.left(newline);
+                client->buffer.remove(0, newline + 1);
+                const int key = line.indexOf("\"sequence\":");
+                if (key >= 0) {
+                    const long long sequence = std::atoll(line.constData() + key + 11);
+                    auto it = publishedAt.find(sequence);
+                    if (it != publishedAt.end()) {
+                        latencyMicros.add((clock.nsecsElapsed() - it->second) / 1000.0);
+                    }
+                    messageBytes += line.size() + 1;
+                    client->received++;
+                } else if (line.contains("\"subscribed\"")) {
+                    client->subscribed = true;
+                    subscribedCount++;
+                } else if (line.contains("\"error\"")) {
+                    errors++;
+                }
+            }
+        });
+        client->socket->connectToHost(QHostAddress::LocalHost, port);
+    }
+
+    // 2. 等待订阅确认后按周期编码输出
+    std::mt19937 rng(17);
+    double timestamp = 0.0;
+    std::vector<TrackPtr> tracks = BenchTracks::makeConfirmedTracks(trackCount, 20000.0, timestamp, rng);
+    long long published = 0;
+
+    QTimer publisher;
+    publisher.setInterval(kCycleMs);
+    QObject::connect(&publisher, &QTimer::timeout, [&]() {
+        timestamp += kCycleMs / 1000.0;
+        BenchTracks::advance(tracks, kCycleMs / 1000.0, timestamp, rng);
+        published++;
+        publishedAt[published] = clock.nsecsElapsed();
+        OutputEncoder::instance().encode(tracks, true, published);
+        BenchUtils::Stopwatch watch;
+        server.onOutputPublished();
+        fanoutMicros.add(watch.micros());
+    });
+
+    QTimer waitSubscribed;
+    waitSubscribed.setInterval(10);
+    QObject::connect(&waitSubscribed, &QTimer::timeout, [&]() {
+        if (subscribedCount + errors < clientCount && clock.elapsed() < 5000) {
+            return;
+        }
+        waitSubscribed.stop();
+        publisher.start();
+        // 发布结束后留出半秒让已发送的消息到达
+        QTimer::singleShot(static_cast<int>(seconds * 1000), [&]() {
+            publisher.stop();
+            QTimer::singleShot(500, &app, &QCoreApplication::quit);
+        });
+    });
+    waitSubscribed.start();
+
+    app.exec();
+
+    long long received = 0;
+    for (const BenchClient& client : clients) {
+        received += client.received;
+    }
+    const long long expected = published * subscribedCount;
+    std::printf("clients %d, subscribed %d, error replies %lld, tracks %d, cycle %d ms\n",
+                clientCount, subscribedCount, errors, trackCount, kCycleMs);
+    std::printf("published %lld, messages received %lld of %lld, missing %lld, mean message %.0f bytes\n",
+                published, received, expected, expected - received,
+                received ? static_cast<double>(messageBytes) / received : 0.0);
+    fanoutMicros.print("fanout (us)");
+    latencyMicros.print("delivery latency (us)");
+    return 0;
+}
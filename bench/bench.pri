@@ -0,0 +1,62 @@
+# 各基准程序共用的构建配置，直接编译服务的跟踪核心源文件，不链接服务本身
+QT       += core network concurrent
+QT       -= gui
+TEMPLATE = app
+CONFIG += console c++14
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+msvc{
+ QMAKE_CFLAGS += /utf-8
+ QMAKE_CXXFLAGS += /utf-8
+}
+
+# 基准程序只在release模式下有意义，与服务的release配置一致
+CONFIG(release, debug|release) {
+    DEFINES += NDEBUG
+    DEFINES += QT_NO_DEBUG_OUTPUT
+}
+else {
+    DEFINES += DEBUG
+}
+
+ROOT = $$PWD/..
+
+INCLUDEPATH += $$ROOT/dds
+INCLUDEPATH += $$ROOT/Core
+INCLUDEPATH += $$ROOT/Service
+INCLUDEPATH += $$ROOT/External
+INCLUDEPATH += $$ROOT/Tools
+INCLUDEPATH += $$PWD/common
+
+DESTDIR += $$ROOT/binr/bench
+
+SOURCES += \
+    $$ROOT/Tools/MetricsRegistry.cpp \
+    $$ROOT/Tools/ObserverRegistry.cpp \
+    $$ROOT/Tools/MonotonicArena.cpp \
+    $$ROOT/Core/DataStructures.cpp \
+    $$ROOT/Core/ConstantVelocityModel.cpp \
+    $$ROOT/Core/ConstantAccelerationModel.cpp \
+    $$ROOT/Core/Track.cpp \
+    $$ROOT/Core/TrackManager.cpp \
+    $$ROOT/Core/CKF.cpp \
+    $$ROOT/Core/CompactCvFilter.cpp \
+    $$ROOT/Core/GeodeticFrame.cpp \
+    $$ROOT/Core/ClockOffsetEstimator.cpp \
+    $$ROOT/Core/TrackSnapshot.cpp \
+    $$ROOT/Core/TrackSnapshotStore.cpp \
+    $$ROOT/Core/TrackExtrapolator.cpp \
+    $$ROOT/Core/ImmFilter.cpp \
+    $$ROOT/Core/TentativeTrackPool.cpp \
+    $$ROOT/Core/TimerWheel.cpp \
+    $$ROOT/Core/SensorRegistry.cpp \
+    $$ROOT/Core/CartesianMeasurementModel.cpp \
+    $$ROOT/Core/SphericalMeasurementModel.cpp \
+    $$ROOT/Core/BearingTriangulator.cpp \
+    $$ROOT/Core/PointCloudClusterer.cpp \
+    $$ROOT/Core/MeasurementCoalescer.cpp
+
+HEADERS += \
+    $$PWD/common/BenchUtils.h
@@ -0,0 +1,12 @@
+# 基准程序，与服务分开构建: qmake bench/bench.pro
+# 各程序为独立的命令行程序，输出到 binr/bench，运行方法见各 main.cpp 的文件头
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    CvPrecisionBench \
+    SnapshotQueryBench \
+    ExtrapolationBench \
+    TrackStreamBench \
+    SharedMemoryBench \
+    AllocationBench \
+    ImmBench
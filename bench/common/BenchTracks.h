@@ -0,0 +1,76 @@
+/**
+ * @file BenchTracks.h
+ * @brief 基准程序合成航迹头文件
+ * @details 定义了合成确认航迹的生成和推进，供快照查询、外推等需要航迹快照的基准程序使用
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef BENCHTRACKS_H
+#define BENCHTRACKS_H
+
+#include "Track.h"
+#include "ConstantVelocityModel.h"
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace BenchTracks {
+
+/**
+ * @brief 确认所需命中次数，不小于 KalmanFilter/confirmationHits 的默认值
+ */
+const int kConfirmedHits = 10;
+
+/**
+ * @brief 在水平 [-halfSize, halfSize] 的区域内生成匀速运动的确认航迹
+ * @param count 航迹数
+ * @param halfSize 区域半边长(米)，高度取其1/20
+ * @param timestamp 航迹起始时间(秒)
+ * @param rng 随机数发生器
+ * @return 航迹，ID为0..count-1
+ */
+inline std::vector<TrackPtr> makeConfirmedTracks(int count, double halfSize, double timestamp, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> horizontal(-halfSize, halfSize);
+    std::uniform_real_distribution<double> vertical(0.0, halfSize / 20.0);
+    std::uniform_real_distribution<double> speed(-250.0, 250.0);
+
+    StateMatrix covariance = StateMatrix::Identity(6, 6);
+    covariance.topLeftCorner<3, 3>() *= 4.0;
+    covariance.bottomRightCorner<3, 3>() *= 25.0;
+
+    std::vector<TrackPtr> tracks;
+    tracks.reserve(count);
+    for (int id = 0; id < count; ++id) {
+        const Vector3 position(horizontal(rng), horizontal(rng), vertical(rng));
+        const Vector3 velocity(speed(rng), speed(rng), speed(rng) / 10.0);
+        TrackPtr track = std::make_shared<Track>(Measurement(position, timestamp, 0), id,
+                                                 std::unique_ptr<IMotionModel>(new ConstantVelocityModel()));
+        track->seed(velocity, covariance, kConfirmedHits);
+        tracks.push_back(track);
+    }
+    return tracks;
+}
+
+/**
+ * @brief 将全部航迹推进一个周期
+ * @param tracks 航迹
+ * @param dt 周期(秒)
+ * @param timestamp 推进后的时间(秒)
+ * @param rng 随机数发生器，用于生成观测噪声
+ * @details 每条航迹预测后以带噪声的预测位置更新，使航迹持续移动并保持确认
+ */
+inline void advance(const std::vector<TrackPtr>& tracks, double dt, double timestamp, std::mt19937& rng)
+{
+    std::normal_distribution<double> noise(0.0, 1.0);
+    for (const TrackPtr& track : tracks) {
+        track->predict(dt);
+        const Vector3 position = track->getState().head<3>() + Vector3(noise(rng), noise(rng), noise(rng));
+        track->update(Measurement(position, timestamp, 0));
+    }
+}
+
+} // namespace BenchTracks
+
+#endif // BENCHTRACKS_H
@@ -0,0 +1,141 @@
+/**
+ * @file BenchUtils.h
+ * @brief 基准程序公共工具头文件
+ * @details 定义了计时和延迟分位数统计，供 bench 下的各基准程序使用
+ * @author xubb
+ * @date 20250711
+ */
+
+#ifndef BENCHUTILS_H
+#define BENCHUTILS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace BenchUtils {
+
+/**
+ * @brief 计时器，构造时开始计时
+ */
+class Stopwatch
+{
+public:
+    Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief 重新开始计时
+     */
+    void restart() { m_start = std::chrono::steady_clock::now(); }
+
+    /**
+     * @brief 已经过的时间
+     * @return 微秒
+     */
+    double micros() const
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    /**
+     * @brief 已经过的时间
+     * @return 秒
+     */
+    double seconds() const { return micros() * 1e-6; }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief 延迟样本
+ * @details 次数、均值和最大值精确统计；分位数由等间隔抽取的样本计算，
+ *          样本数达到上限时隔一丢一并加倍抽取间隔，内存占用有界
+ */
+class Samples
+{
+public:
+    /**
+     * @brief 添加一个样本
+     * @param value 样本值
+     */
+    void add(double value)
+    {
+        m_count++;
+        m_sum += value;
+        m_max = std::max(m_max, value);
+        if (++m_skipped < m_stride) {
+            return;
+        }
+        m_skipped = 0;
+        m_values.push_back(value);
+        if (m_values.size() >= kMaxValues) {
+            for (size_t i = 0; i < m_values.size() / 2; ++i) {
+                m_values[i] = m_values[2 * i];
+            }
+            m_values.resize(m_values.size() / 2);
+            m_stride *= 2;
+        }
+    }
+
+    /**
+     * @brief 合并另一组样本
+     * @param other 另一组样本
+     */
+    void merge(const Samples& other)
+    {
+        m_count += other.m_count;
+        m_sum += other.m_sum;
+        m_max = std::max(m_max, other.m_max);
+        m_values.insert(m_values.end(), other.m_values.begin(), other.m_values.end());
+    }
+
+    /**
+     * @brief 样本总数
+     * @return 次数
+     */
+    long long count() const { return m_count; }
+
+    /**
+     * @brief 分位数
+     * @param q 分位(0~1)
+     * @return 分位数，无样本时为0
+     */
+    double percentile(double q) const
+    {
+        if (m_values.empty()) {
+            return 0.0;
+        }
+        std::vector<double> sorted = m_values;
+        const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(q * (sorted.size() - 1) + 0.5));
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+        return sorted[index];
+    }
+
+    /**
+     * @brief 输出一行统计
+     * @param name 名称
+     */
+    void print(const char* name) const
+    {
+        std::printf("%-28s n=%-10lld mean=%-9.3f p50=%-9.3f p99=%-9.3f p99.9=%-9.3f max=%.3f\n",
+                    name, m_count, m_count ? m_sum / m_count : 0.0,
+                    percentile(0.5), percentile(0.99), percentile(0.999), m_max);
+    }
+
+private:
+    static const size_t kMaxValues = 1 << 20;
+
+    std::vector<double> m_values;
+    long long m_count = 0;
+    double m_sum = 0.0;
+    double m_max = 0.0;
+    long long m_stride = 1;
+    long long m_skipped = 0;
+};
+
+} // namespace BenchUtils
+
+#endif // BENCHUTILS_H